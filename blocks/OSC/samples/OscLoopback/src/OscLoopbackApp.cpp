@@ -0,0 +1,331 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+
+#include "OscBatchListener.h"
+#include "OscBatchSender.h"
+#include "OscListener.h"
+#include "OscSender.h"
+#include "osc/OscOutboundPacketStream.h"
+#include "ip/UdpSocket.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Sends OSC messages over the loopback interface and measures how fast osc::BatchListener and osc::Listener receive them, and how fast
+// osc::BatchSender and osc::Sender send a frame's parameter updates. First checks that BatchListener decodes every argument type, flattens
+// bundles and drops bad packets, and that BatchSender encodes every argument type and splits bundles at the maximum packet size. Results are
+// written to the console.
+class OscLoopbackApp : public App {
+  public:
+	void setup() override;
+	void draw() override;
+
+  private:
+	void	testDecoding();
+	void	testEncoding();
+	void	benchmark( const string &name, int port, size_t messagesPerPacket, const function<size_t()> &receive );
+	void	benchmarkBatchListener( size_t messagesPerPacket );
+	void	benchmarkListener();
+	void	benchmarkSender( const string &name, const function<void( int32_t frame )> &sendFrame );
+};
+
+namespace {
+
+const int BATCH_LISTENER_PORT = 10110;
+const int LISTENER_PORT = 10111;
+const size_t NUM_MESSAGES = 200000;
+// the sender stays at most this many packets ahead of the receiver, so the socket's receive buffer never overflows
+const size_t MAX_PACKETS_IN_FLIGHT = 64;
+// parameter updates sent per frame, like a lighting rig's fixtures, kept below what fits in the socket's receive buffer as separate datagrams
+const int32_t NUM_PARAMETERS = 200;
+const int32_t NUM_FRAMES = 500;
+
+// a typical sensor update: a sequence number, three floats and a device name
+void appendSensorMessage( ::osc::OutboundPacketStream &stream, int32_t sequence )
+{
+	stream << ::osc::BeginMessage( "/rig/sensor" ) << sequence << sequence * 0.5f << 1.0f << 2.0f << "imu" << ::osc::EndMessage;
+}
+
+} // anonymous namespace
+
+void OscLoopbackApp::setup()
+{
+	testDecoding();
+
+	benchmarkBatchListener( 1 );
+	benchmarkBatchListener( 16 );
+	benchmarkListener();
+
+	testEncoding();
+
+	// the addresses are built up front, as an app would hold them
+	vector<string> addresses;
+	for( int32_t i = 0; i < NUM_PARAMETERS; ++i )
+		addresses.push_back( "/fixture/" + to_string( i ) + "/level" );
+
+	ci::osc::Sender sender;
+	sender.setup( "127.0.0.1", BATCH_LISTENER_PORT );
+	benchmarkSender( "Sender", [&]( int32_t frame ) {
+		for( int32_t i = 0; i < NUM_PARAMETERS; ++i ) {
+			ci::osc::Message message;
+			message.setAddress( addresses[i] );
+			message.addIntArg( frame );
+			message.addFloatArg( i * 0.5f );
+			sender.sendMessage( message );
+		}
+	} );
+
+	for( bool bundle : { false, true } ) {
+		auto batchSender = ci::osc::BatchSender::create( "127.0.0.1", BATCH_LISTENER_PORT, ci::osc::BatchSender::Options().bundleMessages( bundle ) );
+		benchmarkSender( bundle ? "BatchSender, bundled" : "BatchSender, a datagram per message", [&]( int32_t frame ) {
+			for( int32_t i = 0; i < NUM_PARAMETERS; ++i )
+				batchSender->send( addresses[i].c_str(), frame, i * 0.5f );
+			batchSender->flush();
+		} );
+	}
+}
+
+void OscLoopbackApp::testDecoding()
+{
+	auto listener = ci::osc::BatchListener::create( BATCH_LISTENER_PORT, ci::osc::BatchListener::Options().maxPacketSize( 1024 ) );
+	UdpTransmitSocket socket( IpEndpointName( "127.0.0.1", BATCH_LISTENER_PORT ) );
+
+	char buffer[4096];
+	const char blob[] = { 1, 2, 3, 4, 5 };
+	::osc::OutboundPacketStream stream( buffer, sizeof( buffer ) );
+	stream << ::osc::BeginBundleImmediate
+		<< ::osc::BeginMessage( "/first" ) << 7 << 1.5f << "text" << ::osc::Symbol( "symbol" ) << ::osc::Blob( blob, sizeof( blob ) ) << true << ::osc::EndMessage
+		<< ::osc::BeginBundleImmediate << ::osc::BeginMessage( "/nested" ) << 8 << ::osc::EndMessage << ::osc::EndBundle
+		<< ::osc::EndBundle;
+	socket.Send( stream.Data(), stream.Size() );
+
+	// a truncated message, and one larger than the maximum packet size
+	socket.Send( stream.Data() + 16, 7 );
+	::osc::OutboundPacketStream large( buffer, sizeof( buffer ) );
+	large << ::osc::BeginMessage( "/large" ) << ::osc::Blob( buffer, 2000 ) << ::osc::EndMessage;
+	socket.Send( large.Data(), large.Size() );
+
+	::osc::OutboundPacketStream last( buffer, sizeof( buffer ) );
+	last << ::osc::BeginMessage( "/last" ) << ::osc::EndMessage;
+	socket.Send( last.Data(), last.Size() );
+
+	vector<string> addresses;
+	bool passed = true;
+	auto start = chrono::steady_clock::now();
+	while( addresses.size() < 3 && chrono::steady_clock::now() - start < chrono::seconds( 2 ) ) {
+		listener->processMessages( [&]( const ci::osc::MessageView &message ) {
+			addresses.push_back( message.getAddress() );
+			if( message.isAddress( "/first" ) ) {
+				size_t blobSize = 0;
+				const char *blobData = static_cast<const char*>( message.getArgAsBlob( 4, &blobSize ) );
+				passed = passed && message.getNumArgs() == 6 && message.getArgAsInt32( 0 ) == 7 && message.getArgAsFloat( 1 ) == 1.5f
+					&& string( message.getArgAsString( 2 ) ) == "text" && string( message.getArgAsString( 3 ) ) == "symbol"
+					&& blobSize == sizeof( blob ) && equal( blob, blob + sizeof( blob ), blobData ) && message.getArgType( 5 ) == ci::osc::TYPE_NONE
+					&& message.getArgAsFloat( 0, true ) == 7 && message.getRemoteAddress() == 0x7F000001;
+				try {
+					message.getArgAsString( 0 );
+					passed = false;
+				}
+				catch( ci::osc::OscExcInvalidArgumentType & ) {
+				}
+			}
+		} );
+		this_thread::sleep_for( chrono::milliseconds( 1 ) );
+	}
+
+	passed = passed && addresses == vector<string>( { "/first", "/nested", "/last" } ) && listener->getNumDropped() == 2;
+	console() << "BatchListener decoding: " << ( passed ? "passed" : "FAILED" ) << endl;
+}
+
+void OscLoopbackApp::testEncoding()
+{
+	auto listener = ci::osc::BatchListener::create( BATCH_LISTENER_PORT );
+	const char blob[] = { 1, 2, 3, 4, 5 };
+	bool passed = true;
+	{
+		auto sender = ci::osc::BatchSender::create( "127.0.0.1", BATCH_LISTENER_PORT, ci::osc::BatchSender::Options().maxPacketSize( 256 ) );
+		sender->send( "/all", 7, 1.5f, 2.25, true, "text", string( "string" ), ci::osc::BlobArg( blob, sizeof( blob ) ) );
+		sender->flush();
+		passed = passed && sender->getNumPacketsSent() == 1;
+
+		// a 256 byte bundle fits 12 of these 16 byte messages and their sizes, after its 16 byte header
+		for( int32_t i = 0; i < 60; ++i )
+			sender->send( "/split", i );
+		passed = passed && sender->getNumQueuedMessages() == 60;
+		sender->flush();
+		passed = passed && sender->getNumPacketsSent() == 6 && sender->getNumQueuedMessages() == 0;
+
+		try {
+			sender->send( "/large", ci::osc::BlobArg( blob, 300 ) );
+			passed = false;
+		}
+		catch( ci::osc::OscExcMessageTooLarge & ) {
+		}
+
+		// sent when the sender is destroyed
+		sender->send( "/last" );
+	}
+	{
+		// without bundling a message fills the whole packet: an 8 byte address, 4 byte tags and a 4 byte size before 240 bytes of blob
+		auto sender = ci::osc::BatchSender::create( "127.0.0.1", BATCH_LISTENER_PORT, ci::osc::BatchSender::Options().maxPacketSize( 256 ).bundleMessages( false ) );
+		vector<char> full( 240, 3 );
+		sender->send( "/full", ci::osc::BlobArg( full.data(), full.size() ) );
+		sender->flush();
+		passed = passed && sender->getNumPacketsSent() == 1;
+	}
+
+	int32_t numReceived = 0, nextSplit = 0;
+	auto start = chrono::steady_clock::now();
+	while( numReceived < 63 && chrono::steady_clock::now() - start < chrono::seconds( 2 ) ) {
+		numReceived += (int32_t)listener->processMessages( [&]( const ci::osc::MessageView &message ) {
+			if( message.isAddress( "/all" ) ) {
+				size_t blobSize = 0;
+				const char *blobData = static_cast<const char*>( message.getArgAsBlob( 6, &blobSize ) );
+				passed = passed && message.getNumArgs() == 7 && message.getArgAsInt32( 0 ) == 7 && message.getArgAsFloat( 1 ) == 1.5f
+					&& message.getArgType( 2 ) == ci::osc::TYPE_NONE && message.getArgType( 3 ) == ci::osc::TYPE_NONE
+					&& string( message.getArgAsString( 4 ) ) == "text" && string( message.getArgAsString( 5 ) ) == "string"
+					&& blobSize == sizeof( blob ) && equal( blob, blob + sizeof( blob ), blobData );
+			}
+			else if( message.isAddress( "/split" ) )
+				passed = passed && message.getArgAsInt32( 0 ) == nextSplit++;
+			else if( message.isAddress( "/full" ) ) {
+				size_t blobSize = 0;
+				message.getArgAsBlob( 0, &blobSize );
+				passed = passed && blobSize == 240;
+			}
+			else
+				passed = passed && message.isAddress( "/last" ) && message.getNumArgs() == 0;
+		} );
+		this_thread::sleep_for( chrono::milliseconds( 1 ) );
+	}
+
+	passed = passed && numReceived == 63 && listener->getNumDropped() == 0;
+	console() << "BatchSender encoding: " << ( passed ? "passed" : "FAILED" ) << endl;
+}
+
+void OscLoopbackApp::benchmark( const string &name, int port, size_t messagesPerPacket, const function<size_t()> &receive )
+{
+	atomic<size_t> numReceived( 0 );
+	thread sender( [&] {
+		UdpTransmitSocket socket( IpEndpointName( "127.0.0.1", port ) );
+		char buffer[4096];
+		for( size_t sent = 0; sent < NUM_MESSAGES; ) {
+			while( sent - numReceived >= MAX_PACKETS_IN_FLIGHT * messagesPerPacket )
+				this_thread::yield();
+
+			::osc::OutboundPacketStream stream( buffer, sizeof( buffer ) );
+			if( messagesPerPacket > 1 ) {
+				stream << ::osc::BeginBundleImmediate;
+				for( size_t i = 0; i < messagesPerPacket; ++i )
+					appendSensorMessage( stream, static_cast<int32_t>( sent++ ) );
+				stream << ::osc::EndBundle;
+			}
+			else
+				appendSensorMessage( stream, static_cast<int32_t>( sent++ ) );
+			socket.Send( stream.Data(), stream.Size() );
+		}
+	} );
+
+	// stops early if datagrams are lost
+	auto start = chrono::steady_clock::now(), lastProgress = start;
+	while( numReceived < NUM_MESSAGES && chrono::steady_clock::now() - lastProgress < chrono::milliseconds( 500 ) ) {
+		size_t count = receive();
+		if( count ) {
+			numReceived += count;
+			lastProgress = chrono::steady_clock::now();
+		}
+		else
+			this_thread::yield();
+	}
+	double seconds = chrono::duration<double>( lastProgress - start ).count();
+	sender.join();
+
+	console() << name << ": " << numReceived / seconds / 1000 << "k messages/s";
+	if( numReceived < NUM_MESSAGES )
+		console() << ", " << NUM_MESSAGES - numReceived << " lost";
+	console() << endl;
+}
+
+void OscLoopbackApp::benchmarkBatchListener( size_t messagesPerPacket )
+{
+	auto listener = ci::osc::BatchListener::create( BATCH_LISTENER_PORT );
+	int32_t expected = 0;
+	size_t numOutOfOrder = 0;
+	float sum = 0;
+	benchmark( "BatchListener, " + to_string( messagesPerPacket ) + " messages per packet", BATCH_LISTENER_PORT, messagesPerPacket, [&] {
+		return listener->processMessages( [&]( const ci::osc::MessageView &message ) {
+			int32_t sequence = message.getArgAsInt32( 0 );
+			if( ! message.isAddress( "/rig/sensor" ) || sequence != expected || message.getArgAsFloat( 1 ) != sequence * 0.5f )
+				++numOutOfOrder;
+			expected = sequence + 1;
+			sum += message.getArgAsFloat( 1 ) + message.getArgAsFloat( 2 ) + message.getArgAsFloat( 3 );
+		} );
+	} );
+	if( numOutOfOrder || listener->getNumDropped() )
+		console() << "  " << numOutOfOrder << " messages out of order or mismatched, " << listener->getNumDropped() << " packets dropped" << endl;
+}
+
+void OscLoopbackApp::benchmarkListener()
+{
+	ci::osc::Listener listener;
+	listener.setup( LISTENER_PORT );
+	float sum = 0;
+	benchmark( "Listener", LISTENER_PORT, 1, [&] {
+		size_t count = 0;
+		ci::osc::Message message;
+		while( listener.getNextMessage( &message ) ) {
+			sum += message.getArgAsFloat( 1 ) + message.getArgAsFloat( 2 ) + message.getArgAsFloat( 3 );
+			++count;
+		}
+		return count;
+	} );
+	listener.shutdown();
+}
+
+// sends a frame at a time, once the previous one has been received, and reports the time spent sending
+void OscLoopbackApp::benchmarkSender( const string &name, const function<void( int32_t frame )> &sendFrame )
+{
+	auto listener = ci::osc::BatchListener::create( BATCH_LISTENER_PORT );
+	double sendSeconds = 0;
+	size_t numLost = 0, numMismatched = 0;
+	auto start = chrono::steady_clock::now();
+	for( int32_t frame = 0; frame < NUM_FRAMES; ++frame ) {
+		auto sendStart = chrono::steady_clock::now();
+		sendFrame( frame );
+		sendSeconds += chrono::duration<double>( chrono::steady_clock::now() - sendStart ).count();
+
+		int32_t numReceived = 0;
+		auto receiveStart = chrono::steady_clock::now();
+		while( numReceived < NUM_PARAMETERS && chrono::steady_clock::now() - receiveStart < chrono::milliseconds( 200 ) ) {
+			numReceived += (int32_t)listener->processMessages( [&]( const ci::osc::MessageView &message ) {
+				int32_t index = (int32_t)( message.getArgAsFloat( 1 ) * 2 );
+				if( message.getArgAsInt32( 0 ) != frame || index < 0 || index >= NUM_PARAMETERS )
+					++numMismatched;
+			} );
+			if( numReceived < NUM_PARAMETERS )
+				this_thread::yield();
+		}
+		numLost += NUM_PARAMETERS - numReceived;
+	}
+	double seconds = chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+
+	size_t numMessages = NUM_PARAMETERS * NUM_FRAMES;
+	console() << name << ": " << sendSeconds / NUM_FRAMES * 1000 << " ms sending " << NUM_PARAMETERS << " messages per frame, "
+			<< numMessages / seconds / 1000 << "k messages/s sent and received";
+	if( numLost || numMismatched )
+		console() << ", " << numLost << " lost, " << numMismatched << " mismatched";
+	console() << endl;
+}
+
+void OscLoopbackApp::draw()
+{
+	gl::clear();
+}
+
+CINDER_APP( OscLoopbackApp, RendererGl )
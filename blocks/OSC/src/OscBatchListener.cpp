@@ -0,0 +1,254 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "OscBatchListener.h"
+#include "OscMessage.h"
+#include "osc/OscReceivedElements.h"
+#include "ip/UdpSocket.h"
+
+using namespace std;
+
+namespace cinder { namespace osc {
+
+namespace {
+
+// the most datagrams read from the socket at once
+const size_t RECEIVE_BATCH_SIZE = 64;
+// how often the receive thread checks for shutdown while the socket is idle
+const int RECEIVE_TIMEOUT_MS = 100;
+// datagrams larger than the maximum packet size are detected by receiving into a slightly larger buffer, as OSC packets are multiples of 4 bytes
+const size_t PACKET_SLACK = 4;
+
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// MessageView
+const MessageView::ArgView& MessageView::getArg( int index ) const
+{
+	if( index < 0 || index >= static_cast<int>( mNumArgs ) )
+		throw OscExcOutOfBounds();
+	return mArgs[index];
+}
+
+ArgType MessageView::getArgType( int index ) const
+{
+	return getArg( index ).mType;
+}
+
+int32_t MessageView::getArgAsInt32( int index, bool typeConvert ) const
+{
+	const ArgView &arg = getArg( index );
+	if( arg.mType == TYPE_INT32 )
+		return arg.mInt32;
+	else if( typeConvert && arg.mType == TYPE_FLOAT )
+		return static_cast<int32_t>( arg.mFloat );
+	else
+		throw OscExcInvalidArgumentType();
+}
+
+float MessageView::getArgAsFloat( int index, bool typeConvert ) const
+{
+	const ArgView &arg = getArg( index );
+	if( arg.mType == TYPE_FLOAT )
+		return arg.mFloat;
+	else if( typeConvert && arg.mType == TYPE_INT32 )
+		return static_cast<float>( arg.mInt32 );
+	else
+		throw OscExcInvalidArgumentType();
+}
+
+const char* MessageView::getArgAsString( int index ) const
+{
+	const ArgView &arg = getArg( index );
+	if( arg.mType != TYPE_STRING )
+		throw OscExcInvalidArgumentType();
+	return arg.mData;
+}
+
+const void* MessageView::getArgAsBlob( int index, size_t *size ) const
+{
+	const ArgView &arg = getArg( index );
+	if( arg.mType != TYPE_BLOB )
+		throw OscExcInvalidArgumentType();
+	*size = arg.mSize;
+	return arg.mData;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// BatchListener
+BatchListenerRef BatchListener::create( int port, const Options &options )
+{
+	return BatchListenerRef( new BatchListener( port, options ) );
+}
+
+BatchListener::BatchListener( int port, const Options &options )
+	: mOptions( options ), mFreePackets( std::max<size_t>( options.getNumPackets(), 1 ) ), mReceivedPackets( std::max<size_t>( options.getNumPackets(), 1 ) ),
+		mNumDropped( 0 ), mQuit( false )
+{
+	mOptions.numPackets( std::max<size_t>( mOptions.getNumPackets(), 1 ) );
+	const size_t numPackets = mOptions.getNumPackets(), packetCapacity = mOptions.getMaxPacketSize() + PACKET_SLACK;
+	mDataArena.reset( new char[numPackets * packetCapacity] );
+	mMessageArena.reset( new MessageView[numPackets * mOptions.getMaxMessagesPerPacket()] );
+	mArgArena.reset( new MessageView::ArgView[numPackets * mOptions.getMaxArgsPerPacket()] );
+	mPackets.reset( new Packet[numPackets] );
+	for( size_t i = 0; i < numPackets; ++i ) {
+		Packet &packet = mPackets[i];
+		packet.mData = mDataArena.get() + i * packetCapacity;
+		packet.mMessages = mMessageArena.get() + i * mOptions.getMaxMessagesPerPacket();
+		packet.mArgs = mArgArena.get() + i * mOptions.getMaxArgsPerPacket();
+		mFreePackets.tryPush( &packet );
+	}
+
+	mSocket.reset( new UdpReceiveSocket( IpEndpointName( IpEndpointName::ANY_ADDRESS, port ) ) );
+	mThread = thread( &BatchListener::receiveThread, this );
+}
+
+BatchListener::~BatchListener()
+{
+	mQuit = true;
+	mFreePackets.cancel();
+	mThread.join();
+}
+
+void BatchListener::receiveThread()
+{
+	Packet *packets[RECEIVE_BATCH_SIZE];
+	UdpDatagram datagrams[RECEIVE_BATCH_SIZE];
+	size_t numPackets = 0;
+
+	while( ! mQuit ) {
+		// claim a buffer for every datagram of the next batch, waiting while processMessages() holds all of them
+		numPackets += mFreePackets.tryPopBatch( packets + numPackets, RECEIVE_BATCH_SIZE - numPackets );
+		if( numPackets == 0 ) {
+			if( ! mFreePackets.pop( &packets[0] ) )
+				break;
+			numPackets = 1;
+		}
+
+		for( size_t i = 0; i < numPackets; ++i ) {
+			datagrams[i].data = packets[i]->mData;
+			datagrams[i].size = mOptions.getMaxPacketSize() + PACKET_SLACK;
+		}
+		size_t numReceived = mSocket->ReceiveBatch( datagrams, numPackets, RECEIVE_TIMEOUT_MS );
+
+		// decoded packets are handed over, and the rest are kept for the next batch
+		Packet *decoded[RECEIVE_BATCH_SIZE];
+		size_t numDecoded = 0, numKept = 0;
+		for( size_t i = 0; i < numPackets; ++i ) {
+			Packet *packet = packets[i];
+			if( i < numReceived ) {
+				packet->mSize = datagrams[i].size;
+				packet->mRemoteAddress = static_cast<uint32_t>( datagrams[i].remoteEndpoint.address );
+				packet->mRemotePort = datagrams[i].remoteEndpoint.port;
+				if( decodePacket( packet ) ) {
+					decoded[numDecoded++] = packet;
+					continue;
+				}
+				++mNumDropped;
+			}
+			packets[numKept++] = packet;
+		}
+		numPackets = numKept;
+
+		// never full, as it has room for every packet
+		mReceivedPackets.tryPushBatch( decoded, numDecoded );
+	}
+}
+
+bool BatchListener::decodePacket( Packet *packet )
+{
+	if( packet->mSize > mOptions.getMaxPacketSize() )
+		return false;
+
+	packet->mNumMessages = 0;
+	size_t numArgs = 0;
+	try {
+		return decodeElement( packet->mData, packet->mSize, packet, &numArgs );
+	}
+	catch( ::osc::Exception & ) {
+		return false;
+	}
+}
+
+bool BatchListener::decodeElement( const char *data, size_t size, Packet *packet, size_t *numArgs )
+{
+	::osc::ReceivedPacket received( data, static_cast< ::osc::osc_bundle_element_size_t>( size ) );
+	if( received.IsBundle() ) {
+		::osc::ReceivedBundle bundle( received );
+		for( auto element = bundle.ElementsBegin(); element != bundle.ElementsEnd(); ++element ) {
+			if( ! decodeElement( element->Contents(), element->Size(), packet, numArgs ) )
+				return false;
+		}
+		return true;
+	}
+
+	if( packet->mNumMessages == mOptions.getMaxMessagesPerPacket() )
+		return false;
+
+	::osc::ReceivedMessage message( received );
+	MessageView &view = packet->mMessages[packet->mNumMessages++];
+	view.mAddress = message.AddressPattern();
+	view.mArgs = packet->mArgs + *numArgs;
+	view.mNumArgs = 0;
+	view.mRemoteAddress = packet->mRemoteAddress;
+	view.mRemotePort = packet->mRemotePort;
+
+	for( auto arg = message.ArgumentsBegin(); arg != message.ArgumentsEnd(); ++arg ) {
+		if( *numArgs == mOptions.getMaxArgsPerPacket() )
+			return false;
+
+		MessageView::ArgView &argView = packet->mArgs[(*numArgs)++];
+		++view.mNumArgs;
+		argView.mData = nullptr;
+		switch( arg->TypeTag() ) {
+			case ::osc::INT32_TYPE_TAG:
+				argView.mType = TYPE_INT32;
+				argView.mInt32 = arg->AsInt32Unchecked();
+			break;
+			case ::osc::FLOAT_TYPE_TAG:
+				argView.mType = TYPE_FLOAT;
+				argView.mFloat = arg->AsFloatUnchecked();
+			break;
+			case ::osc::STRING_TYPE_TAG:
+			case ::osc::SYMBOL_TYPE_TAG:
+				argView.mType = TYPE_STRING;
+				argView.mData = arg->AsStringUnchecked();
+			break;
+			case ::osc::BLOB_TYPE_TAG: {
+				const void *blob;
+				::osc::osc_bundle_element_size_t blobSize;
+				arg->AsBlobUnchecked( blob, blobSize );
+				argView.mType = TYPE_BLOB;
+				argView.mData = static_cast<const char*>( blob );
+				argView.mSize = static_cast<uint32_t>( blobSize );
+			}
+			break;
+			default:
+				argView.mType = TYPE_NONE;
+		}
+	}
+
+	return true;
+}
+
+} } // namespace cinder::osc
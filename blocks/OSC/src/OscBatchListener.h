@@ -0,0 +1,190 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/ConcurrentQueue.h"
+
+#include "OscArg.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+class UdpSocket;
+
+namespace cinder { namespace osc {
+
+typedef std::shared_ptr<class BatchListener>	BatchListenerRef;
+
+//! A received message, decoded in place in the packet that carried it. Strings and blobs point into the packet, so a MessageView is only
+//! valid during the BatchListener::processMessages() callback it is passed to.
+class MessageView {
+  public:
+	const char*	getAddress() const							{ return mAddress; }
+	//! Returns whether the message's address is \a address, without constructing a std::string.
+	bool		isAddress( const char *address ) const		{ return std::strcmp( mAddress, address ) == 0; }
+	//! Returns the sender's IPv4 address in host byte order.
+	uint32_t	getRemoteAddress() const					{ return mRemoteAddress; }
+	int			getRemotePort() const						{ return mRemotePort; }
+
+	int			getNumArgs() const							{ return static_cast<int>( mNumArgs ); }
+	//! Returns TYPE_NONE for arguments other than int32, float, string, symbol and blob. Throws OscExcOutOfBounds if \a index is out of range.
+	ArgType		getArgType( int index ) const;
+
+	int32_t		getArgAsInt32( int index, bool typeConvert = false ) const;
+	float		getArgAsFloat( int index, bool typeConvert = false ) const;
+	//! Returns the null-terminated string in the packet. Symbols are returned as strings.
+	const char*	getArgAsString( int index ) const;
+	//! Returns the blob's data in the packet, and sets \a size to its size in bytes.
+	const void*	getArgAsBlob( int index, size_t *size ) const;
+
+  private:
+	struct ArgView {
+		ArgType			mType;
+		union {
+			int32_t		mInt32;
+			float		mFloat;
+			uint32_t	mSize;
+		};
+		const char		*mData;
+	};
+
+	const ArgView&	getArg( int index ) const;
+
+	const char		*mAddress;
+	const ArgView	*mArgs;
+	uint32_t		mNumArgs;
+	uint32_t		mRemoteAddress;
+	int				mRemotePort;
+
+	friend class BatchListener;
+};
+
+//! Receives OSC messages on a background thread without allocating per message. Datagrams are drained from the socket in batches, with a
+//! single recvmmsg() call on Linux, into a fixed set of packet buffers. They are decoded in place, and handed to the thread calling
+//! processMessages() through lock-free queues. Messages in bundles are delivered individually.
+class BatchListener {
+  public:
+	class Options {
+	  public:
+		Options() : mMaxPacketSize( 4096 ), mNumPackets( 1024 ), mMaxMessagesPerPacket( 64 ), mMaxArgsPerPacket( 256 ) {}
+
+		//! Sets the size of the largest datagram accepted. Larger ones are dropped. Default 4096 bytes.
+		Options&	maxPacketSize( size_t size )			{ mMaxPacketSize = size; return *this; }
+		//! Sets how many received packets can wait for processMessages(). Once they all are, the socket isn't read until some are processed. Default 1024.
+		Options&	numPackets( size_t numPackets )			{ mNumPackets = numPackets; return *this; }
+		//! Sets the most messages decoded from a single packet, which limits the size of bundles. Default 64.
+		Options&	maxMessagesPerPacket( size_t count )	{ mMaxMessagesPerPacket = count; return *this; }
+		//! Sets the most arguments decoded from a single packet, across all of its messages. Default 256.
+		Options&	maxArgsPerPacket( size_t count )		{ mMaxArgsPerPacket = count; return *this; }
+
+		size_t		getMaxPacketSize() const				{ return mMaxPacketSize; }
+		size_t		getNumPackets() const					{ return mNumPackets; }
+		size_t		getMaxMessagesPerPacket() const			{ return mMaxMessagesPerPacket; }
+		size_t		getMaxArgsPerPacket() const				{ return mMaxArgsPerPacket; }
+
+	  private:
+		size_t		mMaxPacketSize, mNumPackets, mMaxMessagesPerPacket, mMaxArgsPerPacket;
+	};
+
+	//! Listens on \a port. Throws std::runtime_error if the port can't be bound.
+	static BatchListenerRef	create( int port, const Options &options = Options() );
+	~BatchListener();
+
+	//! Calls \a fn, which takes a const MessageView&, with every message received before the call, in the order received, and returns the number
+	//! of messages. Must only be called from one thread at a time.
+	template<typename MessageFn>
+	size_t		processMessages( MessageFn fn );
+	//! Returns whether there are received messages waiting for processMessages().
+	bool		hasWaitingMessages() const		{ return ! mReceivedPackets.isEmpty(); }
+	//! Returns the number of packets dropped because they were malformed, larger than the maximum packet size, or exceeded the per packet limits.
+	size_t		getNumDropped() const			{ return mNumDropped; }
+
+  private:
+	struct Packet {
+		char					*mData;
+		size_t					mSize;
+		uint32_t				mRemoteAddress;
+		int						mRemotePort;
+		MessageView				*mMessages;
+		size_t					mNumMessages;
+		MessageView::ArgView	*mArgs;
+	};
+
+	// the most packets popped from mReceivedPackets at once
+	enum { PROCESS_BATCH_SIZE = 64 };
+
+	BatchListener( int port, const Options &options );
+
+	void		receiveThread();
+	// Decodes the received datagram in \a packet into its arenas, and returns false if it can't be.
+	bool		decodePacket( Packet *packet );
+	bool		decodeElement( const char *data, size_t size, Packet *packet, size_t *numArgs );
+
+	Options							mOptions;
+	std::unique_ptr<UdpSocket>		mSocket;
+
+	// every packet's data, messages and arguments, allocated once up front
+	std::unique_ptr<char[]>					mDataArena;
+	std::unique_ptr<MessageView[]>			mMessageArena;
+	std::unique_ptr<MessageView::ArgView[]>	mArgArena;
+	std::unique_ptr<Packet[]>				mPackets;
+
+	// packets cycle from mFreePackets to the receive thread, to mReceivedPackets, to processMessages() and back
+	SpscQueue<Packet*>				mFreePackets, mReceivedPackets;
+	std::atomic<size_t>				mNumDropped;
+	std::atomic<bool>				mQuit;
+	std::thread						mThread;
+};
+
+template<typename MessageFn>
+size_t BatchListener::processMessages( MessageFn fn )
+{
+	// only what has arrived so far, so a steady stream of messages can't keep this from returning
+	size_t numPackets = mReceivedPackets.getSize(), numMessages = 0;
+	while( numPackets > 0 ) {
+		Packet *packets[PROCESS_BATCH_SIZE];
+		size_t numPopped = mReceivedPackets.tryPopBatch( packets, std::min( numPackets, static_cast<size_t>( PROCESS_BATCH_SIZE ) ) );
+		numPackets -= numPopped;
+
+		try {
+			for( size_t i = 0; i < numPopped; ++i ) {
+				for( size_t m = 0; m < packets[i]->mNumMessages; ++m )
+					fn( static_cast<const MessageView&>( packets[i]->mMessages[m] ) );
+				numMessages += packets[i]->mNumMessages;
+			}
+		}
+		catch( ... ) {
+			mFreePackets.tryPushBatch( packets, numPopped );
+			throw;
+		}
+		mFreePackets.tryPushBatch( packets, numPopped );
+	}
+
+	return numMessages;
+}
+
+} } // namespace cinder::osc
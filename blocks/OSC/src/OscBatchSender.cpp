@@ -0,0 +1,152 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "OscBatchSender.h"
+#include "ip/UdpSocket.h"
+
+using namespace std;
+
+namespace cinder { namespace osc {
+
+namespace {
+
+// "#bundle", and a time tag of 1 meaning immediately
+const char BUNDLE_HEADER[] = { '#', 'b', 'u', 'n', 'd', 'l', 'e', 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+const size_t BUNDLE_HEADER_SIZE = sizeof( BUNDLE_HEADER );
+// every bundle element is preceded by its size
+const size_t ELEMENT_SIZE_SIZE = 4;
+
+} // anonymous namespace
+
+BatchSenderRef BatchSender::create( const std::string &hostname, int port, const Options &options )
+{
+	return BatchSenderRef( new BatchSender( hostname, port, options ) );
+}
+
+BatchSender::BatchSender( const std::string &hostname, int port, const Options &options )
+	: mOptions( options ), mNumQueuedPackets( 0 ), mPacketSize( BUNDLE_HEADER_SIZE ), mPacketNumMessages( 0 ), mNumQueuedMessages( 0 ),
+		mNumPacketsSent( 0 )
+{
+	mOptions.numPackets( std::max<size_t>( mOptions.getNumPackets(), 1 ) );
+	const size_t numPackets = mOptions.getNumPackets(), maxPacketSize = mOptions.getMaxPacketSize();
+	mArena.reset( new char[numPackets * maxPacketSize] );
+	mDatagrams.reset( new UdpDatagram[numPackets] );
+	for( size_t i = 0; i < numPackets; ++i ) {
+		mDatagrams[i].data = mArena.get() + i * maxPacketSize;
+		if( maxPacketSize >= BUNDLE_HEADER_SIZE )
+			memcpy( mDatagrams[i].data, BUNDLE_HEADER, BUNDLE_HEADER_SIZE );
+	}
+	mPacket = mDatagrams[0].data;
+
+	mSocket.reset( new UdpTransmitSocket( IpEndpointName( hostname.c_str(), port ) ) );
+	mSocket->SetEnableBroadcast( mOptions.getBroadcast() );
+}
+
+BatchSender::~BatchSender()
+{
+	flush();
+}
+
+char* BatchSender::reserveMessage( size_t size )
+{
+	const size_t maxPacketSize = mOptions.getMaxPacketSize();
+	// without bundling every message is a bare packet of its own, so it can use the whole packet
+	if( ! mOptions.getBundleMessages() ) {
+		if( size > maxPacketSize )
+			throw OscExcMessageTooLarge();
+
+		closePacket();
+		mPacketSize = size;
+		mPacketNumMessages = 1;
+		++mNumQueuedMessages;
+		return mPacket;
+	}
+
+	if( BUNDLE_HEADER_SIZE + ELEMENT_SIZE_SIZE + size > maxPacketSize )
+		throw OscExcMessageTooLarge();
+
+	if( mPacketSize + ELEMENT_SIZE_SIZE + size > maxPacketSize )
+		closePacket();
+
+	char *dst = writeUint32( mPacket + mPacketSize, static_cast<uint32_t>( size ) );
+	mPacketSize += ELEMENT_SIZE_SIZE + size;
+	++mPacketNumMessages;
+	++mNumQueuedMessages;
+	return dst;
+}
+
+void BatchSender::closePacket()
+{
+	if( mPacketNumMessages == 0 )
+		return;
+
+	// a single bundled message is sent without its bundle header and size
+	UdpDatagram &datagram = mDatagrams[mNumQueuedPackets++];
+	size_t offset = ( mPacketNumMessages == 1 && mOptions.getBundleMessages() ) ? BUNDLE_HEADER_SIZE + ELEMENT_SIZE_SIZE : 0;
+	datagram.data = mPacket + offset;
+	datagram.size = mPacketSize - offset;
+
+	mPacketSize = BUNDLE_HEADER_SIZE;
+	mPacketNumMessages = 0;
+	if( mNumQueuedPackets == mOptions.getNumPackets() )
+		flush();
+	else
+		mPacket = mArena.get() + mNumQueuedPackets * mOptions.getMaxPacketSize();
+}
+
+void BatchSender::flush()
+{
+	closePacket();
+	if( mNumQueuedPackets == 0 )
+		return;
+
+	mNumPacketsSent += mSocket->SendBatch( mDatagrams.get(), mNumQueuedPackets );
+	mNumQueuedPackets = 0;
+	mNumQueuedMessages = 0;
+	mPacket = mArena.get();
+}
+
+char* BatchSender::writeUint32( char *dst, uint32_t value )
+{
+	dst[0] = static_cast<char>( value >> 24 );
+	dst[1] = static_cast<char>( value >> 16 );
+	dst[2] = static_cast<char>( value >> 8 );
+	dst[3] = static_cast<char>( value );
+	return dst + 4;
+}
+
+char* BatchSender::writeUint64( char *dst, uint64_t value )
+{
+	dst = writeUint32( dst, static_cast<uint32_t>( value >> 32 ) );
+	return writeUint32( dst, static_cast<uint32_t>( value ) );
+}
+
+char* BatchSender::writePadded( char *dst, const void *data, size_t size, size_t paddedSize )
+{
+	memcpy( dst, data, size );
+	memset( dst + size, 0, paddedSize - size );
+	return dst + paddedSize;
+}
+
+} } // namespace cinder::osc
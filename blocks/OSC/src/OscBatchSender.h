@@ -0,0 +1,183 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "cinder/Cinder.h"
+
+#include "OscMessage.h"
+
+#include <cstring>
+#include <string>
+
+class UdpTransmitSocket;
+struct UdpDatagram;
+
+namespace cinder { namespace osc {
+
+typedef std::shared_ptr<class BatchSender>	BatchSenderRef;
+
+//! Thrown by BatchSender::send() when a message doesn't fit in the maximum packet size.
+class OscExcMessageTooLarge : public OscExc {
+};
+
+//! A blob argument for BatchSender::send(). The data is copied into the packet when the message is sent.
+struct BlobArg {
+	BlobArg( const void *data, size_t size ) : mData( data ), mSize( size ) {}
+
+	const void	*mData;
+	size_t		mSize;
+};
+
+//! Sends OSC messages without allocating per message. Arguments are written straight into a set of reusable packet buffers, and the messages
+//! sent before a flush() are coalesced into bundles of up to the maximum packet size. flush() sends every packet at once, with sendmmsg() on
+//! Linux. A packet holding a single message is sent as a bare message. Not thread-safe.
+class BatchSender {
+  public:
+	class Options {
+	  public:
+		Options() : mMaxPacketSize( 1472 ), mNumPackets( 64 ), mBundleMessages( true ), mBroadcast( false ) {}
+
+		//! Sets the size of the largest datagram sent. Default 1472 bytes, which fits a 1500 byte Ethernet MTU after the IPv4 and UDP headers.
+		Options&	maxPacketSize( size_t size )		{ mMaxPacketSize = size; return *this; }
+		//! Sets how many packets are queued before they are sent without waiting for flush(). Default 64.
+		Options&	numPackets( size_t numPackets )		{ mNumPackets = numPackets; return *this; }
+		//! Sets whether messages are coalesced into bundles. When disabled every message is sent as its own datagram, still batched by flush(),
+		//! for receivers that don't support bundles. Default \c true.
+		Options&	bundleMessages( bool bundle = true )	{ mBundleMessages = bundle; return *this; }
+		//! Enables sending to a broadcast address. Default \c false.
+		Options&	broadcast( bool enable = true )		{ mBroadcast = enable; return *this; }
+
+		size_t		getMaxPacketSize() const			{ return mMaxPacketSize; }
+		size_t		getNumPackets() const				{ return mNumPackets; }
+		bool		getBundleMessages() const			{ return mBundleMessages; }
+		bool		getBroadcast() const				{ return mBroadcast; }
+
+	  private:
+		size_t		mMaxPacketSize, mNumPackets;
+		bool		mBundleMessages, mBroadcast;
+	};
+
+	//! Sends to \a hostname on \a port.
+	static BatchSenderRef	create( const std::string &hostname, int port, const Options &options = Options() );
+	//! Sends any queued messages.
+	~BatchSender();
+
+	//! Queues a message to \a address with \a args, which may be int32_t, float, double, bool, const char*, std::string and BlobArg. Throws
+	//! OscExcMessageTooLarge if the message doesn't fit in a single packet.
+	template<typename... Args>
+	void		send( const char *address, const Args&... args );
+	//! Sends every queued message.
+	void		flush();
+
+	//! Returns the number of messages queued since the last flush().
+	size_t		getNumQueuedMessages() const	{ return mNumQueuedMessages; }
+	//! Returns the number of datagrams sent so far.
+	size_t		getNumPacketsSent() const		{ return mNumPacketsSent; }
+
+  private:
+	BatchSender( const std::string &hostname, int port, const Options &options );
+
+	// Returns where a message of \a size bytes is written, after its size prefix in the current packet. Starts a new packet, sending the
+	// queued ones if they're all used, when the current one is full.
+	char*		reserveMessage( size_t size );
+	void		closePacket();
+
+	static size_t	paddedSize( size_t size )	{ return ( size + 3 ) & ~size_t( 3 ); }
+
+	static char*	writeUint32( char *dst, uint32_t value );
+	static char*	writeUint64( char *dst, uint64_t value );
+	static char*	writePadded( char *dst, const void *data, size_t size, size_t paddedSize );
+
+	// per argument type size, type tag and big-endian encoding
+	static size_t	argSize( int32_t )					{ return 4; }
+	static size_t	argSize( float )					{ return 4; }
+	static size_t	argSize( double )					{ return 8; }
+	static size_t	argSize( bool )						{ return 0; }
+	static size_t	argSize( const char *value )		{ return paddedSize( std::strlen( value ) + 1 ); }
+	static size_t	argSize( const std::string &value )	{ return paddedSize( value.size() + 1 ); }
+	static size_t	argSize( const BlobArg &value )		{ return 4 + paddedSize( value.mSize ); }
+
+	static char		argTag( int32_t )					{ return 'i'; }
+	static char		argTag( float )						{ return 'f'; }
+	static char		argTag( double )					{ return 'd'; }
+	static char		argTag( bool value )				{ return value ? 'T' : 'F'; }
+	static char		argTag( const char* )				{ return 's'; }
+	static char		argTag( const std::string& )		{ return 's'; }
+	static char		argTag( const BlobArg& )			{ return 'b'; }
+
+	static char*	writeArg( char *dst, int32_t value )				{ return writeUint32( dst, static_cast<uint32_t>( value ) ); }
+	static char*	writeArg( char *dst, float value )					{ uint32_t bits; std::memcpy( &bits, &value, 4 ); return writeUint32( dst, bits ); }
+	static char*	writeArg( char *dst, double value )					{ uint64_t bits; std::memcpy( &bits, &value, 8 ); return writeUint64( dst, bits ); }
+	static char*	writeArg( char *dst, bool )							{ return dst; }
+	static char*	writeArg( char *dst, const char *value )			{ size_t size = std::strlen( value ) + 1; return writePadded( dst, value, size, paddedSize( size ) ); }
+	static char*	writeArg( char *dst, const std::string &value )		{ return writePadded( dst, value.c_str(), value.size() + 1, paddedSize( value.size() + 1 ) ); }
+	static char*	writeArg( char *dst, const BlobArg &value )
+	{
+		dst = writeUint32( dst, static_cast<uint32_t>( value.mSize ) );
+		return writePadded( dst, value.mData, value.mSize, paddedSize( value.mSize ) );
+	}
+
+	static size_t	argsSize()									{ return 0; }
+	template<typename T, typename... Rest>
+	static size_t	argsSize( const T &arg, const Rest&... rest )			{ return argSize( arg ) + argsSize( rest... ); }
+	static char*	writeTags( char *dst )								{ return dst; }
+	template<typename T, typename... Rest>
+	static char*	writeTags( char *dst, const T &arg, const Rest&... rest )	{ *dst = argTag( arg ); return writeTags( dst + 1, rest... ); }
+	static char*	writeArgs( char *dst )								{ return dst; }
+	template<typename T, typename... Rest>
+	static char*	writeArgs( char *dst, const T &arg, const Rest&... rest )	{ return writeArgs( writeArg( dst, arg ), rest... ); }
+
+	Options								mOptions;
+	std::unique_ptr<UdpTransmitSocket>	mSocket;
+
+	// every packet's data, allocated once up front, and the datagrams queued for the next SendBatch()
+	std::unique_ptr<char[]>				mArena;
+	std::unique_ptr<UdpDatagram[]>		mDatagrams;
+	size_t								mNumQueuedPackets;
+
+	// the packet being filled, which starts with a bundle header
+	char								*mPacket;
+	size_t								mPacketSize, mPacketNumMessages;
+
+	size_t								mNumQueuedMessages, mNumPacketsSent;
+};
+
+template<typename... Args>
+void BatchSender::send( const char *address, const Args&... args )
+{
+	size_t addressSize = std::strlen( address ) + 1;
+	// the type tags start with a comma and end with a null
+	size_t tagsSize = sizeof...( Args ) + 2;
+	char *dst = reserveMessage( paddedSize( addressSize ) + paddedSize( tagsSize ) + argsSize( args... ) );
+
+	dst = writePadded( dst, address, addressSize, paddedSize( addressSize ) );
+	*dst = ',';
+	char *tagsEnd = writeTags( dst + 1, args... );
+	dst += paddedSize( tagsSize );
+	std::memset( tagsEnd, 0, dst - tagsEnd );
+	writeArgs( dst, args... );
+}
+
+} } // namespace cinder::osc
@@ -48,6 +48,16 @@ class TimerListener;
 
 class UdpSocket;
 
+// A datagram for UdpSocket::ReceiveBatch() and SendBatch(). When receiving,
+// size is the capacity of data going in, and the size of the received
+// datagram coming out. A datagram larger than the capacity is truncated and
+// its size left at the capacity. remoteEndpoint is ignored when sending.
+struct UdpDatagram{
+    char *data;
+    std::size_t size;
+    IpEndpointName remoteEndpoint;
+};
+
 class SocketReceiveMultiplexer{
     class Implementation;
     Implementation *impl_;
@@ -126,6 +136,16 @@ public:
 	bool IsBound() const;
 
     std::size_t ReceiveFrom( IpEndpointName& remoteEndpoint, char *data, std::size_t size );
+
+	// Waits up to timeoutMilliseconds for data, then receives up to count
+	// datagrams without blocking and returns how many were received. On
+	// Linux they are drained with a single recvmmsg() call.
+    std::size_t ReceiveBatch( UdpDatagram *datagrams, std::size_t count, int timeoutMilliseconds );
+
+	// Sends count datagrams to the connected endpoint and returns how many
+	// were sent. A datagram that fails is skipped and not counted. On Linux
+	// they are sent with as few sendmmsg() calls as the kernel allows.
+	std::size_t SendBatch( const UdpDatagram *datagrams, std::size_t count );
 };
 
 
@@ -45,6 +45,7 @@
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <netinet/in.h> // for sockaddr_in
+#include <poll.h>
 
 #include <signal.h>
 #include <math.h>
@@ -246,6 +247,103 @@ public:
 		return (std::size_t)result;
 	}
 
+    std::size_t ReceiveBatch( UdpDatagram *datagrams, std::size_t count, int timeoutMilliseconds )
+	{
+		assert( isBound_ );
+
+		struct pollfd pollFd;
+		pollFd.fd = socket_;
+		pollFd.events = POLLIN;
+		pollFd.revents = 0;
+		if( poll( &pollFd, 1, timeoutMilliseconds ) <= 0 )
+			return 0;
+
+#if defined(__linux__)
+		const std::size_t MAX_BATCH_SIZE = 64;
+		struct mmsghdr messages[MAX_BATCH_SIZE];
+		struct iovec buffers[MAX_BATCH_SIZE];
+		struct sockaddr_in fromAddrs[MAX_BATCH_SIZE];
+
+		count = std::min( count, MAX_BATCH_SIZE );
+		std::memset( messages, 0, sizeof(messages[0]) * count );
+		for( std::size_t i = 0; i < count; ++i ){
+			buffers[i].iov_base = datagrams[i].data;
+			buffers[i].iov_len = datagrams[i].size;
+			messages[i].msg_hdr.msg_iov = &buffers[i];
+			messages[i].msg_hdr.msg_iovlen = 1;
+			messages[i].msg_hdr.msg_name = &fromAddrs[i];
+			messages[i].msg_hdr.msg_namelen = sizeof(fromAddrs[i]);
+		}
+
+		int result = recvmmsg( socket_, messages, (unsigned int)count, MSG_DONTWAIT, 0 );
+		if( result < 0 )
+			return 0;
+
+		for( int i = 0; i < result; ++i ){
+			datagrams[i].size = messages[i].msg_len;
+			datagrams[i].remoteEndpoint.address = ntohl(fromAddrs[i].sin_addr.s_addr);
+			datagrams[i].remoteEndpoint.port = ntohs(fromAddrs[i].sin_port);
+		}
+		return (std::size_t)result;
+#else
+		std::size_t received = 0;
+		while( received < count ){
+			struct sockaddr_in fromAddr;
+			socklen_t fromAddrLen = sizeof(fromAddr);
+			ssize_t result = recvfrom(socket_, datagrams[received].data, datagrams[received].size, MSG_DONTWAIT,
+						(struct sockaddr *) &fromAddr, (socklen_t*)&fromAddrLen);
+			if( result < 0 )
+				break;
+
+			datagrams[received].size = (std::size_t)result;
+			datagrams[received].remoteEndpoint.address = ntohl(fromAddr.sin_addr.s_addr);
+			datagrams[received].remoteEndpoint.port = ntohs(fromAddr.sin_port);
+			++received;
+		}
+		return received;
+#endif
+	}
+
+	std::size_t SendBatch( const UdpDatagram *datagrams, std::size_t count )
+	{
+		assert( isConnected_ );
+
+		std::size_t sent = 0;
+#if defined(__linux__)
+		const std::size_t MAX_BATCH_SIZE = 64;
+		struct mmsghdr messages[MAX_BATCH_SIZE];
+		struct iovec buffers[MAX_BATCH_SIZE];
+
+		std::size_t next = 0;
+		while( next < count ){
+			std::size_t batchSize = std::min( count - next, MAX_BATCH_SIZE );
+			std::memset( messages, 0, sizeof(messages[0]) * batchSize );
+			for( std::size_t i = 0; i < batchSize; ++i ){
+				buffers[i].iov_base = datagrams[next + i].data;
+				buffers[i].iov_len = datagrams[next + i].size;
+				messages[i].msg_hdr.msg_iov = &buffers[i];
+				messages[i].msg_hdr.msg_iovlen = 1;
+			}
+
+			// sendmmsg() stops at the first datagram that fails, which like Send() is
+			// skipped rather than retried, and isn't counted as sent
+			int result = sendmmsg( socket_, messages, (unsigned int)batchSize, 0 );
+			if( result > 0 ){
+				next += (std::size_t)result;
+				sent += (std::size_t)result;
+			}
+			else
+				++next;
+		}
+#else
+		for( std::size_t i = 0; i < count; ++i ){
+			if( send( socket_, datagrams[i].data, datagrams[i].size, 0 ) >= 0 )
+				++sent;
+		}
+#endif
+		return sent;
+	}
+
 	int Socket() { return socket_; }
 };
 
@@ -304,6 +402,16 @@ std::size_t UdpSocket::ReceiveFrom( IpEndpointName& remoteEndpoint, char *data,
 	return impl_->ReceiveFrom( remoteEndpoint, data, size );
 }
 
+std::size_t UdpSocket::ReceiveBatch( UdpDatagram *datagrams, std::size_t count, int timeoutMilliseconds )
+{
+	return impl_->ReceiveBatch( datagrams, count, timeoutMilliseconds );
+}
+
+std::size_t UdpSocket::SendBatch( const UdpDatagram *datagrams, std::size_t count )
+{
+	return impl_->SendBatch( datagrams, count );
+}
+
 
 struct AttachedTimerListener{
 	AttachedTimerListener( int id, int p, TimerListener *tl )
@@ -240,6 +240,57 @@ public:
 		return result;
 	}
 
+    std::size_t ReceiveBatch( UdpDatagram *datagrams, std::size_t count, int timeoutMilliseconds )
+	{
+		assert( isBound_ );
+
+		// winsock has no recvmmsg(), so this receives one datagram per call for as long as select() reports more
+		std::size_t received = 0;
+		while( received < count ){
+			fd_set readFds;
+			FD_ZERO( &readFds );
+			FD_SET( socket_, &readFds );
+			struct timeval timeout;
+			int waitMilliseconds = ( received == 0 ) ? timeoutMilliseconds : 0;
+			timeout.tv_sec = waitMilliseconds / 1000;
+			timeout.tv_usec = ( waitMilliseconds % 1000 ) * 1000;
+			if( select( 0, &readFds, 0, 0, &timeout ) <= 0 )
+				break;
+
+			struct sockaddr_in fromAddr;
+			socklen_t fromAddrLen = sizeof(fromAddr);
+			int result = recvfrom(socket_, datagrams[received].data, (int)datagrams[received].size, 0,
+						(struct sockaddr *) &fromAddr, (socklen_t*)&fromAddrLen);
+			// a datagram larger than the buffer fails with WSAEMSGSIZE, but is still consumed and its
+			// truncated data received. Like recvmmsg() it is returned filling the whole buffer, so the
+			// caller sees it as oversized rather than the batch ending early
+			if( result == SOCKET_ERROR ){
+				if( WSAGetLastError() != WSAEMSGSIZE )
+					break;
+				result = (int)datagrams[received].size;
+			}
+
+			datagrams[received].size = result;
+			datagrams[received].remoteEndpoint.address = ntohl(fromAddr.sin_addr.s_addr);
+			datagrams[received].remoteEndpoint.port = ntohs(fromAddr.sin_port);
+			++received;
+		}
+		return received;
+	}
+
+	std::size_t SendBatch( const UdpDatagram *datagrams, std::size_t count )
+	{
+		assert( isConnected_ );
+
+		// winsock has no sendmmsg(), so this sends one datagram per call
+		std::size_t sent = 0;
+		for( std::size_t i = 0; i < count; ++i ){
+			if( send( socket_, datagrams[i].data, (int)datagrams[i].size, 0 ) != SOCKET_ERROR )
+				++sent;
+		}
+		return sent;
+	}
+
 	SOCKET& Socket() { return socket_; }
 };
 
@@ -298,6 +349,16 @@ std::size_t UdpSocket::ReceiveFrom( IpEndpointName& remoteEndpoint, char *data,
 	return impl_->ReceiveFrom( remoteEndpoint, data, size );
 }
 
+std::size_t UdpSocket::ReceiveBatch( UdpDatagram *datagrams, std::size_t count, int timeoutMilliseconds )
+{
+	return impl_->ReceiveBatch( datagrams, count, timeoutMilliseconds );
+}
+
+std::size_t UdpSocket::SendBatch( const UdpDatagram *datagrams, std::size_t count )
+{
+	return impl_->SendBatch( datagrams, count );
+}
+
 
 struct AttachedTimerListener{
 	AttachedTimerListener( int id, int p, TimerListener *tl )
@@ -80,6 +80,7 @@ class Buffer {
 };
 
 Buffer compressBuffer( const Buffer &buffer, int8_t compressionLevel = DEFAULT_COMPRESSION_LEVEL, bool resizeResult = true );
+//! Decompresses zlib or, with \a useGZip, gzip data. Data written by compressBufferBlocks() is recognized and decompressed in parallel.
 Buffer decompressBuffer( const Buffer &buffer, bool resizeResult = true, bool useGZip = false );
 
 } //namespace
\ No newline at end of file
@@ -0,0 +1,150 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Buffer.h"
+#include "cinder/Stream.h"
+
+#include <vector>
+
+namespace cinder {
+
+//! Options for writing data as independently zlib-compressed blocks, which can be compressed and decompressed in parallel and read at random.
+//! Used by compressBufferBlocks() and OStreamCompressed.
+class BlockCompressionOptions {
+  public:
+	BlockCompressionOptions() : mCompressionLevel( DEFAULT_COMPRESSION_LEVEL ), mBlockSize( 1024 * 1024 ), mNumThreads( 0 ) {}
+
+	//! Sets the zlib compression level, from 0 to 9. Default DEFAULT_COMPRESSION_LEVEL.
+	BlockCompressionOptions&	compressionLevel( int8_t level )	{ mCompressionLevel = level; return *this; }
+	//! Sets the number of uncompressed bytes in each block. Smaller blocks make random access cheaper but compress less well. Default 1 MB.
+	BlockCompressionOptions&	blockSize( size_t size )			{ mBlockSize = size; return *this; }
+	//! Sets how many blocks are compressed at once on the shared TaskScheduler, including on the calling thread. 0 uses all of its threads. Default 0.
+	BlockCompressionOptions&	numThreads( int numThreads )		{ mNumThreads = numThreads; return *this; }
+
+	int8_t		getCompressionLevel() const	{ return mCompressionLevel; }
+	size_t		getBlockSize() const		{ return mBlockSize; }
+	int			getNumThreads() const		{ return mNumThreads; }
+
+  private:
+	int8_t		mCompressionLevel;
+	size_t		mBlockSize;
+	int			mNumThreads;
+};
+
+//! Compresses \a buffer in blocks on multiple threads. The result is read by decompressBuffer(), decompressBufferBlocks() and IStreamCompressed.
+Buffer	compressBufferBlocks( const Buffer &buffer, const BlockCompressionOptions &options = BlockCompressionOptions() );
+//! Decompresses all of \a buffer, as written by compressBufferBlocks() or OStreamCompressed, on up to \a numThreads threads of the shared TaskScheduler. 0 uses all of them.
+Buffer	decompressBufferBlocks( const Buffer &buffer, int numThreads = 0 );
+//! Decompresses \a size bytes at uncompressed \a offset of \a buffer into \a dest, only decompressing the blocks the range overlaps. Returns the number of bytes
+//! written, which is less than \a size at the end of the data. Safe to call from multiple threads on the same \a buffer.
+size_t	decompressBufferBlocks( const Buffer &buffer, size_t offset, void *dest, size_t size, int numThreads = 0 );
+//! Returns whether \a buffer starts with the header written by compressBufferBlocks() and OStreamCompressed.
+bool	isBufferBlockCompressed( const Buffer &buffer );
+
+
+typedef std::shared_ptr<class OStreamCompressed>	OStreamCompressedRef;
+
+//! Compresses everything written to it in blocks into another OStream, so the uncompressed data never has to be held in memory at once.
+//! Blocks are queued until there is one per thread and then compressed in parallel. The index used for random access is written by close().
+class OStreamCompressed : public OStream {
+  public:
+	static OStreamCompressedRef	create( const OStreamRef &stream, const BlockCompressionOptions &options = BlockCompressionOptions() );
+	//! Calls close() if it hasn't been called, ignoring any exception.
+	~OStreamCompressed();
+
+	//! Compresses any data still queued and writes the index. Nothing can be written afterwards.
+	void		close();
+
+	//! Returns the number of uncompressed bytes written
+	off_t		tell() const	{ return static_cast<off_t>( mUncompressedSize ); }
+	//! Throws a StreamExc, since compressed output can't be rewritten.
+	void		seekAbsolute( off_t absoluteOffset );
+	//! Throws a StreamExc, since compressed output can't be rewritten.
+	void		seekRelative( off_t relativeOffset );
+
+  protected:
+	OStreamCompressed( const OStreamRef &stream, const BlockCompressionOptions &options );
+
+	virtual void	IOWrite( const void *t, size_t size );
+	void			flushBlocks();
+
+	OStreamRef							mStream;
+	BlockCompressionOptions				mOptions;
+	std::vector<std::vector<uint8_t>>	mPendingBlocks; // uncompressed; the last may be partially filled
+	std::vector<uint64_t>				mBlockOffsets; // offset of every written block in mStream, relative to the header
+	uint64_t							mOutputOffset, mUncompressedSize;
+	bool								mClosed;
+};
+
+
+typedef std::shared_ptr<class IStreamCompressed>	IStreamCompressedRef;
+
+//! Decompresses data written by OStreamCompressed or compressBufferBlocks() from another stream, decompressing as many blocks in parallel as it has threads.
+//! When the source stream can seek and the compressed data runs to its end, the index is read up front, which provides size() and seeking to any block.
+class IStreamCompressed : public IStreamCinder {
+  public:
+	//! Throws a CompressedStreamExc if \a stream doesn't start with a block-compressed header. \a numThreads of 0 uses every thread of the shared TaskScheduler.
+	static IStreamCompressedRef	create( const IStreamRef &stream, int numThreads = 0 );
+
+	size_t		readDataAvailable( void *dest, size_t maxSize );
+
+	void		seekAbsolute( off_t absoluteOffset );
+	void		seekRelative( off_t relativeOffset );
+	off_t		tell() const;
+	//! Returns the uncompressed size, which is only known when the source stream can seek. Returns 0 otherwise.
+	off_t		size() const	{ return static_cast<off_t>( mUncompressedSize ); }
+	bool		isEof() const;
+
+  protected:
+	IStreamCompressed( const IStreamRef &stream, int numThreads );
+
+	virtual void	IORead( void *t, size_t size );
+	size_t			readDataImpl( void *dest, size_t size );
+	// Decompresses the blocks starting at mNextBlock, up to one per thread. Returns false at the end of the data.
+	bool			decompressBlocks();
+	void			readIndex();
+
+	IStreamRef							mStream;
+	off_t								mStreamStart; // offset of the header in mStream
+	int									mNumThreads;
+	size_t								mBlockSize;
+	bool								mIndexed; // whether mStream could seek to read the index
+	std::vector<uint64_t>				mBlockOffsets;
+	uint64_t							mUncompressedSize;
+	std::vector<std::vector<uint8_t>>	mBlocks; // decompressed, starting with block mFirstBlock
+	size_t								mFirstBlock, mCurrentBlock, mNextBlock;
+	size_t								mSkip; // offset into mCurrentBlock to start at once it's decompressed
+	const uint8_t						*mBlockStart; // data of mCurrentBlock, or null before it's decompressed
+	bool								mEnded;
+};
+
+
+class CompressedStreamExc : public StreamExc {
+  public:
+	CompressedStreamExc( const std::string &description )	{ setDescription( description ); }
+};
+
+} // namespace cinder
@@ -0,0 +1,437 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Noncopyable.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace cinder {
+
+namespace detail {
+
+// Wakes threads blocked in wait() without touching the mutex unless a thread is actually waiting, like a futex-based event count.
+class QueueSignal {
+  public:
+	QueueSignal() : mNumWaiters( 0 ) {}
+
+	//! Blocks until \a ready returns true, which must become true only after notify() is called.
+	template<typename ReadyFn>
+	void wait( const ReadyFn &ready )
+	{
+		std::unique_lock<std::mutex> lock( mMutex );
+		mNumWaiters.fetch_add( 1 );
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		while( ! ready() )
+			mCondition.wait( lock );
+		mNumWaiters.fetch_sub( 1 );
+	}
+
+	//! Wakes every waiting thread, which is nearly free when none are.
+	void notify()
+	{
+		// pairs with the fence in wait(): either the waiter sees the change that made it ready, or this sees the waiter
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		if( mNumWaiters.load( std::memory_order_relaxed ) ) {
+			std::lock_guard<std::mutex> lock( mMutex );
+			mCondition.notify_all();
+		}
+	}
+	//! Wakes one waiting thread, for when only one of them can make progress.
+	void notifyOne()
+	{
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		if( mNumWaiters.load( std::memory_order_relaxed ) ) {
+			std::lock_guard<std::mutex> lock( mMutex );
+			mCondition.notify_one();
+		}
+	}
+
+  private:
+	std::atomic<uint32_t>		mNumWaiters;
+	std::mutex					mMutex;
+	std::condition_variable		mCondition;
+};
+
+// Adds blocking push and pop with cancellation to a lock-free queue which implements tryPush(), tryPop() and isFull()
+template<typename T, typename QueueT>
+class BlockingQueue : private Noncopyable {
+  public:
+	//! Pushes \a item, waiting while the queue is full. Returns false without pushing if the queue is canceled.
+	bool push( T &&item )
+	{
+		return waitFor( mNotFull, [&] { return self()->tryPush( std::move( item ) ); } );
+	}
+	//! Pushes a copy of \a item, waiting while the queue is full. Returns false without pushing if the queue is canceled.
+	bool push( const T &item )
+	{
+		return waitFor( mNotFull, [&] { return self()->tryPush( item ); } );
+	}
+	//! Pops the oldest item into \a result, waiting while the queue is empty. Returns false without popping if the queue is canceled.
+	bool pop( T *result )
+	{
+		return waitFor( mNotEmpty, [&] { return self()->tryPop( result ); } );
+	}
+
+	//! Pushes \a count items starting at \a first, waiting for space as needed, and wakes waiting consumers once per batch rather than once per item. Use
+	//! std::make_move_iterator() to move items. Returns the number of items pushed, which is less than \a count if the queue is canceled.
+	template<typename InputIt>
+	size_t pushBatch( InputIt first, size_t count )
+	{
+		size_t result = 0;
+		while( result < count ) {
+			size_t pushed = self()->tryPushBatch( first, count - result );
+			std::advance( first, pushed );
+			result += pushed;
+			if( result < count && ! waitFor( mNotFull, [&] { return ! self()->isFull(); } ) )
+				break;
+		}
+		return result;
+	}
+	//! Pops at least one and up to \a maxCount items to \a dest, waiting while the queue is empty. Returns the number of items popped, which is 0 if the queue is canceled.
+	template<typename OutputIt>
+	size_t popBatch( OutputIt dest, size_t maxCount )
+	{
+		size_t result = 0;
+		waitFor( mNotEmpty, [&] { result = self()->tryPopBatch( dest, maxCount ); return result > 0; } );
+		return result;
+	}
+
+	//! Wakes every thread waiting in push() or pop(), and makes them and all future calls to them return false. Non-blocking calls are unaffected.
+	void cancel()
+	{
+		mCanceled.store( true );
+		mNotFull.notify();
+		mNotEmpty.notify();
+	}
+	//! Returns whether cancel() has been called
+	bool isCanceled() const	{ return mCanceled.load( std::memory_order_relaxed ); }
+
+  protected:
+	BlockingQueue() : mCanceled( false ) {}
+
+	QueueT*		self()	{ return static_cast<QueueT*>( this ); }
+
+	// Tries \a op, spinning briefly and then sleeping on \a signal until it succeeds or the queue is canceled
+	template<typename OpFn>
+	bool waitFor( QueueSignal &signal, const OpFn &op )
+	{
+		for( int spin = 0; spin < 64; ++spin ) {
+			if( mCanceled.load( std::memory_order_relaxed ) )
+				return false;
+			if( op() )
+				return true;
+			if( spin >= 16 )
+				std::this_thread::yield();
+		}
+
+		bool succeeded = false;
+		signal.wait( [&] { return mCanceled.load() || ( succeeded = op() ); } );
+		return succeeded;
+	}
+
+	void notifyPushed()	{ mNotEmpty.notify(); }
+	void notifyPopped()	{ mNotFull.notify(); }
+
+	QueueSignal			mNotEmpty, mNotFull;
+	std::atomic<bool>	mCanceled;
+};
+
+// Raw storage for one element, so that elements need not be default constructible
+template<typename T>
+struct QueueSlot {
+	T*		get()	{ return reinterpret_cast<T*>( &mStorage ); }
+
+	typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type	mStorage;
+};
+
+inline size_t roundUpToPowerOfTwo( size_t value )
+{
+	size_t result = 1;
+	while( result < value )
+		result <<= 1;
+	return result;
+}
+
+} // namespace detail
+
+//! A bounded lock-free queue for exactly one producer thread and one consumer thread. Items are moved in and out, so \a T may be move-only.
+//! The blocking push() and pop() spin briefly before sleeping, and the other side only takes a lock to wake them when a thread is asleep.
+template<typename T>
+class SpscQueue : public detail::BlockingQueue<T, SpscQueue<T>> {
+  public:
+	//! Creates a queue which holds at least \a capacity items, rounded up to a power of two.
+	explicit SpscQueue( size_t capacity )
+		: mCapacity( detail::roundUpToPowerOfTwo( capacity ) ), mSlots( new detail::QueueSlot<T>[mCapacity] ), mHead( 0 ), mCachedTail( 0 ), mTail( 0 ), mCachedHead( 0 )
+	{}
+	~SpscQueue()
+	{
+		for( size_t i = mHead.load(); i != mTail.load(); ++i )
+			mSlots[i & ( mCapacity - 1 )].get()->~T();
+		delete [] mSlots;
+	}
+
+	//! Pushes \a item unless the queue is full. Returns whether it was pushed. Must only be called from the producer thread.
+	bool tryPush( T &&item )		{ return emplace( std::move( item ) ); }
+	//! Pushes a copy of \a item unless the queue is full. Returns whether it was pushed. Must only be called from the producer thread.
+	bool tryPush( const T &item )	{ return emplace( item ); }
+	//! Pops the oldest item into \a result unless the queue is empty. Returns whether an item was popped. Must only be called from the consumer thread.
+	bool tryPop( T *result )
+	{
+		size_t head = mHead.load( std::memory_order_relaxed );
+		if( head == mCachedTail ) {
+			mCachedTail = mTail.load( std::memory_order_acquire );
+			if( head == mCachedTail )
+				return false;
+		}
+
+		T *item = mSlots[head & ( mCapacity - 1 )].get();
+		*result = std::move( *item );
+		item->~T();
+		mHead.store( head + 1, std::memory_order_release );
+		this->notifyPopped();
+		return true;
+	}
+
+	//! Pushes up to \a count items starting at \a first, and returns the number pushed. Must only be called from the producer thread.
+	template<typename InputIt>
+	size_t tryPushBatch( InputIt first, size_t count )
+	{
+		size_t tail = mTail.load( std::memory_order_relaxed );
+		size_t space = mCapacity - ( tail - mCachedHead );
+		if( space < count ) {
+			mCachedHead = mHead.load( std::memory_order_acquire );
+			space = mCapacity - ( tail - mCachedHead );
+		}
+
+		count = std::min( count, space );
+		for( size_t i = 0; i < count; ++i, ++first )
+			new( mSlots[( tail + i ) & ( mCapacity - 1 )].get() ) T( *first );
+		if( count ) {
+			mTail.store( tail + count, std::memory_order_release );
+			this->notifyPushed();
+		}
+		return count;
+	}
+	//! Pops up to \a maxCount items to \a dest, and returns the number popped. Must only be called from the consumer thread.
+	template<typename OutputIt>
+	size_t tryPopBatch( OutputIt dest, size_t maxCount )
+	{
+		size_t head = mHead.load( std::memory_order_relaxed );
+		if( mCachedTail - head < maxCount )
+			mCachedTail = mTail.load( std::memory_order_acquire );
+
+		size_t count = std::min( maxCount, mCachedTail - head );
+		for( size_t i = 0; i < count; ++i, ++dest ) {
+			T *item = mSlots[( head + i ) & ( mCapacity - 1 )].get();
+			*dest = std::move( *item );
+			item->~T();
+		}
+		if( count ) {
+			mHead.store( head + count, std::memory_order_release );
+			this->notifyPopped();
+		}
+		return count;
+	}
+
+	//! Returns the number of items the queue can hold
+	size_t	getCapacity() const	{ return mCapacity; }
+	//! Returns the number of items in the queue, which may already be out of date if called from a thread other than the producer or consumer.
+	size_t	getSize() const
+	{
+		// mHead is read first, so it can't have passed the mTail which is read after it
+		size_t head = mHead.load( std::memory_order_acquire );
+		return mTail.load( std::memory_order_acquire ) - head;
+	}
+	bool	isEmpty() const		{ return getSize() == 0; }
+	bool	isFull() const		{ return getSize() >= mCapacity; }
+
+  private:
+	template<typename U>
+	bool emplace( U &&item )
+	{
+		size_t tail = mTail.load( std::memory_order_relaxed );
+		if( tail - mCachedHead == mCapacity ) {
+			mCachedHead = mHead.load( std::memory_order_acquire );
+			if( tail - mCachedHead == mCapacity )
+				return false;
+		}
+
+		new( mSlots[tail & ( mCapacity - 1 )].get() ) T( std::forward<U>( item ) );
+		mTail.store( tail + 1, std::memory_order_release );
+		this->notifyPushed();
+		return true;
+	}
+
+	// the consumer's and producer's indices are kept on separate cache lines, each with the producer's or consumer's cached copy of the other
+	const size_t			mCapacity;
+	detail::QueueSlot<T>	*mSlots;
+	char					mPad0[64];
+	std::atomic<size_t>		mHead;
+	size_t					mCachedTail; // consumer's copy of mTail
+	char					mPad1[64];
+	std::atomic<size_t>		mTail;
+	size_t					mCachedHead; // producer's copy of mHead
+	char					mPad2[64];
+};
+
+//! A bounded lock-free queue for any number of producer and consumer threads, based on Dmitry Vyukov's bounded MPMC queue. Like SpscQueue, items
+//! are moved in and out and blocking is optional.
+template<typename T>
+class MpmcQueue : public detail::BlockingQueue<T, MpmcQueue<T>> {
+  public:
+	//! Creates a queue which holds at least \a capacity items, rounded up to a power of two.
+	explicit MpmcQueue( size_t capacity )
+		: mCapacity( detail::roundUpToPowerOfTwo( capacity ) ), mCells( new Cell[mCapacity] ), mEnqueuePos( 0 ), mDequeuePos( 0 )
+	{
+		for( size_t i = 0; i < mCapacity; ++i )
+			mCells[i].mSequence.store( i, std::memory_order_relaxed );
+	}
+	~MpmcQueue()
+	{
+		for( size_t i = mDequeuePos.load(); i != mEnqueuePos.load(); ++i )
+			mCells[i & ( mCapacity - 1 )].mSlot.get()->~T();
+		delete [] mCells;
+	}
+
+	//! Pushes \a item unless the queue is full. Returns whether it was pushed.
+	bool tryPush( T &&item )		{ return emplace( std::move( item ), true ); }
+	//! Pushes a copy of \a item unless the queue is full. Returns whether it was pushed.
+	bool tryPush( const T &item )	{ return emplace( item, true ); }
+	//! Pops the oldest item into \a result unless the queue is empty. Returns whether an item was popped.
+	bool tryPop( T *result )		{ return popImpl( result, true ); }
+
+	//! Pushes up to \a count items starting at \a first, and returns the number pushed. Waiting consumers are woken once for the batch.
+	template<typename InputIt>
+	size_t tryPushBatch( InputIt first, size_t count )
+	{
+		size_t result = 0;
+		for( ; result < count && emplace( *first, false ); ++result, ++first )
+			;
+		if( result )
+			this->notifyPushed();
+		return result;
+	}
+	//! Pops up to \a maxCount items to \a dest, and returns the number popped. Waiting producers are woken once for the batch.
+	template<typename OutputIt>
+	size_t tryPopBatch( OutputIt dest, size_t maxCount )
+	{
+		size_t result = 0;
+		for( ; result < maxCount && popImpl( dest, false ); ++result )
+			;
+		if( result )
+			this->notifyPopped();
+		return result;
+	}
+
+	//! Returns the number of items the queue can hold
+	size_t	getCapacity() const	{ return mCapacity; }
+	//! Returns the approximate number of items in the queue, which may be out of date as soon as it returns.
+	size_t	getSize() const
+	{
+		size_t dequeuePos = mDequeuePos.load( std::memory_order_acquire ), enqueuePos = mEnqueuePos.load( std::memory_order_acquire );
+		return enqueuePos > dequeuePos ? std::min( enqueuePos - dequeuePos, mCapacity ) : 0;
+	}
+	bool	isEmpty() const		{ return getSize() == 0; }
+	bool	isFull() const		{ return getSize() >= mCapacity; }
+
+  private:
+	struct Cell {
+		std::atomic<size_t>		mSequence;
+		detail::QueueSlot<T>	mSlot;
+	};
+
+	template<typename U>
+	bool emplace( U &&item, bool notify )
+	{
+		Cell *cell;
+		size_t pos = mEnqueuePos.load( std::memory_order_relaxed );
+		while( true ) {
+			cell = &mCells[pos & ( mCapacity - 1 )];
+			size_t sequence = cell->mSequence.load( std::memory_order_acquire );
+			intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+			if( diff == 0 ) {
+				if( mEnqueuePos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+					break;
+			}
+			else if( diff < 0 )
+				return false;
+			else
+				pos = mEnqueuePos.load( std::memory_order_relaxed );
+		}
+
+		new( cell->mSlot.get() ) T( std::forward<U>( item ) );
+		cell->mSequence.store( pos + 1, std::memory_order_release );
+		if( notify )
+			this->notifyPushed();
+		return true;
+	}
+
+	// Moves the oldest item to *dest and advances dest
+	template<typename OutputIt>
+	bool popImpl( OutputIt &&dest, bool notify )
+	{
+		Cell *cell;
+		size_t pos = mDequeuePos.load( std::memory_order_relaxed );
+		while( true ) {
+			cell = &mCells[pos & ( mCapacity - 1 )];
+			size_t sequence = cell->mSequence.load( std::memory_order_acquire );
+			intptr_t diff = (intptr_t)sequence - (intptr_t)( pos + 1 );
+			if( diff == 0 ) {
+				if( mDequeuePos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+					break;
+			}
+			else if( diff < 0 )
+				return false;
+			else
+				pos = mDequeuePos.load( std::memory_order_relaxed );
+		}
+
+		T *item = cell->mSlot.get();
+		*dest = std::move( *item );
+		++dest;
+		item->~T();
+		cell->mSequence.store( pos + mCapacity, std::memory_order_release );
+		if( notify )
+			this->notifyPopped();
+		return true;
+	}
+
+	const size_t			mCapacity;
+	Cell					*mCells;
+	char					mPad0[64];
+	std::atomic<size_t>		mEnqueuePos;
+	char					mPad1[64];
+	std::atomic<size_t>		mDequeuePos;
+	char					mPad2[64];
+};
+
+} // namespace cinder
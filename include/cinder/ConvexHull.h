@@ -25,15 +25,39 @@
 #include "cinder/Cinder.h"
 #include "cinder/PolyLine.h"
 #include "cinder/Shape2d.h"
+#include "cinder/TriMesh.h"
 
 #include <vector>
 
 namespace cinder {
 
-PolyLine2f	calcConvexHull( const std::vector<vec2> &points );
-PolyLine2f	calcConvexHull( const vec2 *points, size_t numPoints );
+//! Options for calcConvexHull() of large point sets.
+class ConvexHullOptions {
+  public:
+	ConvexHullOptions() : mParallelSort( false ) {}
+
+	//! Sorts the points of a 2D hull in parallel on TaskScheduler::get(). Worthwhile above roughly 100k points that aren't discarded as interior. Default \c false.
+	ConvexHullOptions&	parallelSort( bool enable = true )	{ mParallelSort = enable; return *this; }
+
+	bool				getParallelSort() const				{ return mParallelSort; }
+
+  private:
+	bool		mParallelSort;
+};
+
+//! Returns the convex hull of \a points, starting from the lowest leftmost point and wound clockwise with y up, with its first point repeated at the end. Collinear points are omitted.
+PolyLine2f	calcConvexHull( const std::vector<vec2> &points, const ConvexHullOptions &options = ConvexHullOptions() );
+//! Returns the convex hull of \a numPoints \a points, starting from the lowest leftmost point and wound clockwise with y up, with its first point repeated at the end. Collinear points are omitted.
+PolyLine2f	calcConvexHull( const vec2 *points, size_t numPoints, const ConvexHullOptions &options = ConvexHullOptions() );
 PolyLine2f	calcConvexHull( const Shape2d &shape );
 PolyLine2f	calcConvexHull( const Path2d &path );
 PolyLine2f	calcConvexHull( const PolyLine2f &polyLine );
 
+//! Returns the convex hull of \a points as a TriMesh of its vertices, with triangles wound counter-clockwise seen from outside. Returns an empty TriMesh when the points are all coplanar.
+TriMesh		calcConvexHull( const std::vector<vec3> &points );
+//! Returns the convex hull of \a numPoints \a points as a TriMesh of its vertices, with triangles wound counter-clockwise seen from outside. Returns an empty TriMesh when the points are all coplanar.
+TriMesh		calcConvexHull( const vec3 *points, size_t numPoints );
+//! Returns the convex hull of \a mesh's positions, which must be 3D.
+TriMesh		calcConvexHull( const TriMesh &mesh );
+
 } // namespace cinder
\ No newline at end of file
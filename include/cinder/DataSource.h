@@ -29,6 +29,7 @@
 #include "cinder/Buffer.h"
 #include "cinder/Stream.h"
 #include "cinder/Filesystem.h"
+#include "cinder/MemoryMappedFile.h"
 
 namespace cinder {
 
@@ -67,22 +68,60 @@ typedef std::shared_ptr<class DataSourcePath>	DataSourcePathRef;
 
 class DataSourcePath : public DataSource {
   public:
-	static DataSourcePathRef	create( const fs::path &path );
+	//! Options for how getBuffer() loads the file
+	class Options {
+	  public:
+		Options() : mMapped( false ), mMinMappedSize( 256 * 1024 ), mAccessHint( MemoryMappedFile::ACCESS_SEQUENTIAL ), mPrefetch( false ), mReadAhead( false ) {}
+
+		//! Sets whether getBuffer() returns a copy-on-write mapping of the file rather than reading it into memory. Default false.
+		//! A mapped Buffer is a view of the file rather than a snapshot. On POSIX, truncating the file while the Buffer is referenced raises SIGBUS,
+		//! and later writes to the file may show through pages which haven't been modified. On Windows the file can't be rewritten or deleted while it is mapped.
+		Options&	mapped( bool mapped = true )							{ mMapped = mapped; return *this; }
+		//! Sets the size of the smallest file which is mapped. Smaller files are read, which is cheaper than mapping them. Default 256 KB.
+		Options&	minMappedSize( size_t size )							{ mMinMappedSize = size; return *this; }
+		//! Sets how a mapped file is expected to be read. Default MemoryMappedFile::ACCESS_SEQUENTIAL.
+		Options&	accessHint( MemoryMappedFile::AccessHint hint )		{ mAccessHint = hint; return *this; }
+		//! Sets whether the OS starts reading all of a mapped file in the background as soon as it is mapped. Default false.
+		Options&	prefetch( bool prefetch = true )						{ mPrefetch = prefetch; return *this; }
+		//! Sets whether createStream() returns an IStreamFileBlock which reads files of 1 MB or more a block ahead on a background thread, rather than an IStreamFile. Default false.
+		Options&	readAhead( bool readAhead = true )						{ mReadAhead = readAhead; return *this; }
+
+		bool							isMapped() const			{ return mMapped; }
+		size_t							getMinMappedSize() const	{ return mMinMappedSize; }
+		MemoryMappedFile::AccessHint	getAccessHint() const		{ return mAccessHint; }
+		bool							isPrefetched() const		{ return mPrefetch; }
+		bool							isReadAhead() const			{ return mReadAhead; }
+
+	  private:
+		bool							mMapped;
+		size_t							mMinMappedSize;
+		MemoryMappedFile::AccessHint	mAccessHint;
+		bool							mPrefetch;
+		bool							mReadAhead;
+	};
+
+	//! Creates a DataSource for the file at \a path. If \a options enables mapping, getBuffer() returns a Buffer over a mapping of a file, which is
+	//! only read from disk as it is accessed. See Options::mapped().
+	static DataSourcePathRef	create( const fs::path &path, const Options &options = Options() );
 
 	virtual bool	isFilePath() { return true; }
 	virtual bool	isUrl() { return false; }
 
 	virtual IStreamRef	createStream();
 
+	const Options&		getOptions() const	{ return mOptions; }
+
   protected:
-	explicit DataSourcePath( const fs::path &path );
+	DataSourcePath( const fs::path &path, const Options &options );
 	
 	virtual	void	createBuffer();
 	
 	IStreamFileRef	mStream;	
+	Options			mOptions;
 };
 
-DataSourceRef	loadFile( const fs::path &path );
+//! Returns a DataSourcePath for the file at \a path, loaded according to \a options
+DataSourceRef	loadFile( const fs::path &path, const DataSourcePath::Options &options = DataSourcePath::Options() );
 
 #if !defined( CINDER_WINRT )
 typedef std::shared_ptr<class DataSourceUrl>	DataSourceUrlRef;
@@ -62,7 +62,15 @@ typedef	std::set<Attrib>	AttribSet;
 extern std::string			sAttribNames[(int)Attrib::NUM_ATTRIBS];
 
 enum Primitive { LINES, LINE_STRIP, TRIANGLES, TRIANGLE_STRIP, TRIANGLE_FAN, NUM_PRIMITIVES };
-enum DataType { FLOAT, INTEGER, DOUBLE };
+//! Storage type of a vertex attribute. Beyond FLOAT, INTEGER and DOUBLE are packed types, which are converted from float data when uploaded and expanded back to float by the GPU. Packed attributes always occupy a multiple of 4 bytes.
+enum DataType { FLOAT, INTEGER, DOUBLE,
+	HALF_FLOAT,			//!< 16-bit IEEE half-precision floats
+	SNORM16, UNORM16,	//!< 16-bit normalized integers, mapping [-1,1] or [0,1] respectively
+	SNORM8, UNORM8,		//!< 8-bit normalized integers, mapping [-1,1] or [0,1] respectively
+	SNORM_10_10_10_2,	//!< 10 bits each for xyz and 2 bits for w packed into 32 bits, mapping [-1,1]. Suited to normals and tangents
+	OCTAHEDRAL			//!< Unit-length 3D vectors as 2 SNORM16 octahedral coordinates. The vertex shader receives a vec2 and must decode it, e.g.:
+						//!< vec3 n = vec3( e, 1.0 - abs( e.x ) - abs( e.y ) ); if( n.z < 0.0 ) n.xy = ( 1.0 - abs( n.yx ) ) * sign( n.xy ); n = normalize( n );
+};
 
 
 //! Debug utility which returns the name of \a attrib as a std::string
@@ -73,6 +81,12 @@ std::string primitiveToString( Primitive primitive );
 void copyData( uint8_t srcDimensions, const float *srcData, size_t numElements, uint8_t dstDimensions, size_t dstStrideBytes, float *dstData );
 //! Utility function for copying attribute data. Does the right thing to convert \a srcDimensions to \a dstDimensions. Stride of \c 0 implies tightly packed data.
 void copyData( uint8_t srcDimensions, size_t srcStrideBytes, const float *srcData, size_t numElements, uint8_t dstDimensions, size_t dstStrideBytes, float *dstData );
+//! Utility function for copying float attribute data into the packed DataType \a dstDataType. Converts \a srcDimensions to \a dstDimensions like copyData(). \a dstStrideBytes of \c 0 implies tightly packed data.
+void packData( uint8_t srcDimensions, const float *srcData, size_t numElements, DataType dstDataType, uint8_t dstDimensions, size_t dstStrideBytes, void *dstData );
+//! Utility function for expanding \a srcDimensions attribute data stored as \a srcDataType, as written by packData(), into tightly packed floats. \a srcStrideBytes of \c 0 implies tightly packed data.
+void unpackData( DataType srcDataType, uint8_t srcDimensions, size_t srcStrideBytes, const void *srcData, size_t numElements, float *dstData );
+//! Returns the size in bytes of a single \a dims-dimensional element stored as \a dataType
+uint8_t getDataTypeByteSize( DataType dataType, uint8_t dims );
 //! Utility function for calculating tangents and bitangents from indexed geometry. \a resultBitangents may be NULL if not needed.
 void calculateTangents( size_t numIndices, const uint32_t *indices, size_t numVertices, const vec3 *positions, const vec3 *normals, const vec2 *texCoords, std::vector<vec3> *resultTangents, std::vector<vec3> *resultBitangents );
 //! Utility function for calculating tangents and bitangents from indexed geometry and 3D texture coordinates. \a resultBitangents may be NULL if not needed.
@@ -97,7 +111,7 @@ struct AttribInfo {
 	void		setOffset( size_t offset ) { mOffset = offset; }
 	uint32_t	getInstanceDivisor() const { return mInstanceDivisor; }
 
-	uint8_t		getByteSize() const { if( mDataType == geom::DataType::DOUBLE ) return mDims * 8; else return mDims * 4; }
+	uint8_t		getByteSize() const { return getDataTypeByteSize( mDataType, mDims ); }
 
   protected:
 	Attrib		mAttrib;
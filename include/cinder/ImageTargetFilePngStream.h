@@ -0,0 +1,64 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/ImageIo.h"
+#include "cinder/Stream.h"
+
+typedef struct z_stream_s z_stream;
+
+namespace cinder {
+
+typedef std::shared_ptr<class ImageTargetFilePngStream> ImageTargetFilePngStreamRef;
+
+//! Writes 8-bit PNGs to a DataTarget's stream as rows arrive, holding only two rows and a small deflate buffer rather than the whole image. Rows must be supplied in order, top to bottom.
+//! The quality in ImageTarget::Options selects the zlib compression level, from 0 (stored) to 1 (level 9). Not registered with ImageIoRegistrar; create it directly and pass it to writeImage().
+class ImageTargetFilePngStream : public ImageTarget {
+  public:
+	static ImageTargetFilePngStreamRef	create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options = ImageTarget::Options() );
+	~ImageTargetFilePngStream();
+
+	void*	getRowPointer( int32_t row ) override;
+	void	finalize() override;
+
+	//! Returns the number of rows compressed and written so far
+	int32_t	getNumRowsWritten() const { return mNumRowsWritten; }
+
+  protected:
+	ImageTargetFilePngStream( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options );
+
+	void	writeRow();
+	void	deflateAndWrite( const uint8_t *data, size_t size, int flush );
+	void	writeChunk( const char *type, const uint8_t *data, uint32_t size );
+
+	OStreamRef					mStream;
+	uint8_t						mNumComponents;
+	size_t						mRowBytes;
+	int32_t						mCurrentRow, mNumRowsWritten;
+	std::unique_ptr<uint8_t[]>	mRow, mPrevRow, mFilteredRow, mDeflateBuffer;
+	std::unique_ptr<z_stream>	mZStream;
+	bool						mFinalized;
+};
+
+} // namespace cinder
@@ -38,6 +38,9 @@ namespace Json {
 
 namespace cinder {
 
+class JsonValue;
+typedef std::shared_ptr<class JsonDocument>	JsonDocumentRef;
+
 class JsonTree {
   public:
 	
@@ -102,6 +105,11 @@ class JsonTree {
 	explicit JsonTree( DataSourceRef dataSource, ParseOptions parseOptions = ParseOptions() );
 	//! Parses the JSON contained in the string \a jsonString .
 	explicit JsonTree( const std::string &jsonString, ParseOptions parseOptions = ParseOptions() );
+	/** \brief Creates a JsonTree from \a document without converting it up front. The children of each node are converted when first accessed, and \a document is kept alive until then.
+		Unlike parsing with jsoncpp, object members keep the order and any duplicates of the document. As even const accessors convert children,
+		such a tree must not be read from several threads at once unless each node's children have already been accessed.
+		<br><tt>JsonTree scene( JsonDocument::create( loadFile( "scene.json" ) ) );</tt> **/
+	explicit JsonTree( const JsonDocumentRef &document );
 	//! Creates a JsonTree with key \a key and boolean \a value .
 	explicit JsonTree( const std::string &key, bool value );
 	//! Creates a JsonTree with key \a key and double \a value .
@@ -255,6 +263,7 @@ private:
 	enum ValueType	{ VALUE_BOOL, VALUE_DOUBLE, VALUE_INT, VALUE_STRING, VALUE_UINT	};
 
 	explicit JsonTree( const std::string &key, const Json::Value &value );
+	explicit JsonTree( const std::string &key, const JsonDocumentRef &document, const JsonValue &value );
 
 	Json::Value						createNativeDoc( WriteOptions writeOptions = WriteOptions() ) const;
 	static Json::Value				deserializeNative( const std::string &jsonString, ParseOptions parseOptions );
@@ -265,13 +274,17 @@ private:
 	
 	JsonTree*						getNodePtr( const std::string &relativePath, bool caseSensitive, char separator ) const;
 	static bool						isIndex( const std::string &key );
+	//! Converts the children of a node created from a JsonDocument, if they haven't been yet
+	void							convertChildren() const;
 	
-	Container						mChildren;
+	mutable Container				mChildren;
 	std::string						mKey;
 	JsonTree						*mParent;
 	NodeType						mNodeType;
 	std::string						mValue;
 	ValueType						mValueType;
+	mutable JsonDocumentRef			mDocument;
+	mutable const JsonValue			*mUnconvertedValue;		// the array or object whose children are yet to be converted
 	//! \endcond
 
   public:
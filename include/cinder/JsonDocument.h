@@ -0,0 +1,214 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Json.h"
+#include "cinder/Buffer.h"
+#include "cinder/DataSource.h"
+#include "cinder/Exception.h"
+#include "cinder/MemoryMappedFile.h"
+#include "cinder/Noncopyable.h"
+
+#include <vector>
+#include <memory>
+
+namespace cinder {
+
+typedef std::shared_ptr<class JsonDocument>	JsonDocumentRef;
+
+//! \brief A read-only value within a JsonDocument.
+//!
+//! Numbers are stored parsed, and arrays and objects as contiguous runs of their elements or members. Strings are not null-terminated,
+//! and point either into the document's source or into memory owned by the JsonDocument, so a JsonValue must not outlive its document.
+class JsonValue {
+  public:
+	enum Type { TYPE_NULL, TYPE_BOOL, TYPE_INT, TYPE_UINT, TYPE_DOUBLE, TYPE_STRING, TYPE_ARRAY, TYPE_OBJECT };
+
+	class Member;
+
+	JsonValue() : mUInt( 0 ), mSize( 0 ), mType( TYPE_NULL ) {}
+
+	Type	getType() const		{ return (Type)mType; }
+	bool	isNull() const		{ return mType == TYPE_NULL; }
+	bool	isBool() const		{ return mType == TYPE_BOOL; }
+	//! Returns whether the value is an integer which fits in an int64_t, or a larger one which fits in a uint64_t. Other numbers are TYPE_DOUBLE.
+	bool	isInteger() const	{ return mType == TYPE_INT || mType == TYPE_UINT; }
+	bool	isNumber() const	{ return mType == TYPE_INT || mType == TYPE_UINT || mType == TYPE_DOUBLE; }
+	bool	isString() const	{ return mType == TYPE_STRING; }
+	bool	isArray() const		{ return mType == TYPE_ARRAY; }
+	bool	isObject() const	{ return mType == TYPE_OBJECT; }
+
+	//! Returns the value of a bool. Throws JsonValueExc for other types.
+	bool			getBool() const;
+	//! Returns the value of a number as an int64_t, truncating doubles. Throws JsonValueExc for other types.
+	int64_t			getInt64() const;
+	//! Returns the value of a number as a uint64_t, truncating doubles. Throws JsonValueExc for other types.
+	uint64_t		getUInt64() const;
+	//! Returns the value of a number as a double. Throws JsonValueExc for other types.
+	double			getDouble() const;
+	//! Returns a copy of a string. Throws JsonValueExc for other types.
+	std::string		getString() const;
+	//! Returns the characters of a string, which are not null-terminated, or \c nullptr for other types
+	const char*		getStringData() const		{ return mType == TYPE_STRING ? mString : nullptr; }
+	//! Returns the length of a string in bytes, or \c 0 for other types
+	size_t			getStringLength() const		{ return mType == TYPE_STRING ? mSize : 0; }
+	//! Returns whether this is a string equal to \a str
+	bool			equals( const char *str, size_t length ) const;
+	bool			equals( const std::string &str ) const	{ return equals( str.data(), str.size() ); }
+
+	//! Returns the number of elements in an array or members in an object, or \c 0 for other types
+	size_t			size() const	{ return ( mType == TYPE_ARRAY || mType == TYPE_OBJECT ) ? mSize : 0; }
+
+	//! Returns the first element of an array, or \c nullptr for other types
+	const JsonValue*	begin() const	{ return mType == TYPE_ARRAY ? mElements : nullptr; }
+	const JsonValue*	end() const		{ return mType == TYPE_ARRAY ? mElements + mSize : nullptr; }
+	//! Returns the first member of an object, or \c nullptr for other types
+	const Member*		beginMembers() const;
+	const Member*		endMembers() const;
+
+	//! Returns the element at \a index of an array. Throws JsonValueExc if it is out of range or this isn't an array.
+	const JsonValue&	operator[]( size_t index ) const;
+	//! Returns the member of an object named \a key, searching in order. Throws JsonValueExc if there is none.
+	const JsonValue&	operator[]( const char *key ) const;
+	const JsonValue&	operator[]( const std::string &key ) const;
+	//! Returns the first member of an object named \a key, or \c nullptr if there is none or this isn't an object
+	const JsonValue*	find( const char *key, size_t length ) const;
+	const JsonValue*	find( const char *key ) const;
+	const JsonValue*	find( const std::string &key ) const	{ return find( key.data(), key.size() ); }
+	bool				hasMember( const std::string &key ) const	{ return find( key ) != nullptr; }
+
+  protected:
+	union {
+		double				mDouble;
+		int64_t				mInt;
+		uint64_t			mUInt;
+		bool				mBool;
+		const char			*mString;
+		const JsonValue		*mElements;
+		const JsonValue		*mMembers;	// pairs of key and value
+	};
+	uint32_t	mSize;
+	uint8_t		mType;
+
+	friend class JsonDocument;
+	friend class JsonDocumentBuilder;
+};
+
+//! A member of an object in a JsonDocument
+class JsonValue::Member {
+  public:
+	//! Returns the member's key, which is always a string
+	const JsonValue&	getKey() const		{ return mKey; }
+	const JsonValue&	getValue() const	{ return mValue; }
+
+  private:
+	JsonValue	mKey, mValue;
+};
+
+inline const JsonValue::Member* JsonValue::beginMembers() const
+{
+	return mType == TYPE_OBJECT ? reinterpret_cast<const Member*>( mMembers ) : nullptr;
+}
+
+inline const JsonValue::Member* JsonValue::endMembers() const
+{
+	return mType == TYPE_OBJECT ? reinterpret_cast<const Member*>( mMembers ) + mSize : nullptr;
+}
+
+//! \brief A read-only JSON document, parsed in a single pass without copying strings.
+//!
+//! Files are memory-mapped rather than read into memory, and strings without escapes are referenced where they lie in the source.
+//! Values are 16 bytes each and are allocated together with any decoded strings from blocks owned by the document, so it is
+//! released all at once. Object members keep the order and any duplicates of the source. Use JsonTree( JsonDocumentRef ) for a mutable tree.
+class JsonDocument : private Noncopyable {
+  public:
+	//! Parses \a dataSource, mapping it if it is a file. Throws JsonTree::ExcJsonParserError unless \a options ignores errors, in which case the root is null.
+	static JsonDocumentRef	create( const DataSourceRef &dataSource, const JsonTree::ParseOptions &options = JsonTree::ParseOptions() );
+	//! Parses a copy of \a json. Throws JsonTree::ExcJsonParserError unless \a options ignores errors, in which case the root is null.
+	static JsonDocumentRef	create( const std::string &json, const JsonTree::ParseOptions &options = JsonTree::ParseOptions() );
+
+	//! Returns the top-level value of the document
+	const JsonValue&	getRoot() const			{ return mRoot; }
+	//! Returns the number of bytes allocated for values and decoded strings, which excludes the source
+	size_t				getAllocatedSize() const	{ return mAllocatedSize; }
+	//! Returns the size of the source in bytes
+	size_t				getSourceSize() const	{ return mSourceSize; }
+
+  protected:
+	JsonDocument();
+
+	void	parse( const char *data, size_t size, const JsonTree::ParseOptions &options );
+	//! Returns \a size bytes aligned for a JsonValue, which remain valid for the lifetime of the document
+	char*	allocate( size_t size );
+
+	JsonValue							mRoot;
+	MemoryMappedFileRef					mMappedFile;
+	BufferRef							mBuffer;
+	std::string							mString;
+	size_t								mSourceSize;
+
+	std::vector<std::unique_ptr<char[]>>	mBlocks;
+	char								*mBlockPos;
+	size_t								mBlockRemaining, mNextBlockSize, mAllocatedSize;
+
+	friend class JsonDocumentBuilder;
+};
+
+//! Receives the contents of a JSON document from parseJson() as it is read. Strings are passed as pointers and lengths which are only valid until
+//! the method returns, and are not null-terminated. Each method returns \c false to stop parsing.
+class JsonSaxHandler {
+  public:
+	virtual ~JsonSaxHandler() {}
+
+	virtual bool	onNull()											{ return true; }
+	virtual bool	onBool( bool /*value*/ )							{ return true; }
+	//! Called for integers which fit in an int64_t
+	virtual bool	onInt( int64_t /*value*/ )							{ return true; }
+	//! Called for integers larger than the range of int64_t which fit in a uint64_t
+	virtual bool	onUInt( uint64_t /*value*/ )						{ return true; }
+	//! Called for numbers with a fraction or exponent, and integers which don't fit in 64 bits
+	virtual bool	onDouble( double /*value*/ )						{ return true; }
+	virtual bool	onString( const char * /*str*/, size_t /*length*/ )	{ return true; }
+	virtual bool	onStartObject()										{ return true; }
+	virtual bool	onKey( const char * /*str*/, size_t /*length*/ )	{ return true; }
+	virtual bool	onEndObject( size_t /*numMembers*/ )				{ return true; }
+	virtual bool	onStartArray()										{ return true; }
+	virtual bool	onEndArray( size_t /*numElements*/ )				{ return true; }
+};
+
+//! Parses \a dataSource and passes its contents to \a handler without building a tree, mapping it if it is a file. Returns \c false if the handler
+//! stopped parsing. Throws JsonTree::ExcJsonParserError unless \a options ignores errors, in which case parsing stops at the error and returns \c false.
+bool	parseJson( const DataSourceRef &dataSource, JsonSaxHandler *handler, const JsonTree::ParseOptions &options = JsonTree::ParseOptions() );
+//! Parses the \a size bytes at \a data and passes the contents to \a handler without building a tree. Returns \c false if the handler stopped parsing.
+//! Throws JsonTree::ExcJsonParserError unless \a options ignores errors, in which case parsing stops at the error and returns \c false.
+bool	parseJson( const char *data, size_t size, JsonSaxHandler *handler, const JsonTree::ParseOptions &options = JsonTree::ParseOptions() );
+
+class JsonValueExc : public Exception {
+  public:
+	JsonValueExc( const std::string &description )
+		: Exception( description )
+	{}
+};
+
+} // namespace cinder
@@ -34,6 +34,7 @@
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <atomic>
 
 namespace cinder { namespace log {
 
@@ -46,7 +47,7 @@ typedef enum {
 } Level;
 
 struct Location {
-	Location() {}
+	Location() : mLineNumber( 0 ) {}
 
 	Location( const std::string &functionName, const std::string &fileName, const size_t &lineNumber )
 		: mFunctionName( functionName ), mFileName( fileName ), mLineNumber( lineNumber )
@@ -147,14 +148,23 @@ public:
 
 #endif
 
+//! Determines what CI_LOG_* does when the asynchronous logging queue is full
+typedef enum {
+	//! Waits until the background thread has made room, throttling the logging threads
+	OVERFLOW_BLOCK,
+	//! Discards records below LEVEL_ERROR, which are counted and reported once there is room again. Errors and fatals still wait.
+	OVERFLOW_DROP
+} OverflowPolicy;
+
 class LoggerImplMulti;
+class AsyncLogQueue;
 
 class LogManager {
 public:
 	// Returns a pointer to the shared instance. To enable logging during shutdown, this instance is leaked at shutdown.
 	static LogManager* instance()	{ return sInstance; }
 	//! Destroys the shared instance. Useful to remove false positives with leak detectors like valgrind.
-	static void destroyInstance()	{ delete sInstance; }
+	static void destroyInstance()	{ delete sInstance; sInstance = nullptr; }
 	//! Restores LogManager to its default state.
 	void restoreToDefault();
 
@@ -197,57 +207,136 @@ public:
 	//! Disables any breakpoints set for logging.
 	void disableBreakOnLog();
 
+	//! Sets the lowest Level which is logged. Records below \a level are discarded before anything is formatted. Defaults to \c LEVEL_VERBOSE.
+	void	setLevel( Level level )						{ mLevel.store( level, std::memory_order_relaxed ); }
+	//! Returns the lowest Level which is logged.
+	Level	getLevel() const							{ return (Level)mLevel.load( std::memory_order_relaxed ); }
+
+	//! Hands records to a background thread which writes them to the current Logger, so that CI_LOG_* only formats and enqueues. The queue holds up to \a queueCapacity records, rounded up to a power of two.
+	//! Records logged by a Logger from the background thread itself are written immediately. Like resetLogger(), this should be called while no other threads are logging.
+	//! Loggers may be added, removed or reset while async logging is enabled; records queued beforehand are written to the previous loggers first.
+	void	enableAsyncLogging( size_t queueCapacity = 8192, OverflowPolicy overflowPolicy = OVERFLOW_BLOCK );
+	//! Writes any queued records and returns to writing on the logging thread. Should be called while no other threads are logging.
+	void	disableAsyncLogging();
+	bool	isAsyncLoggingEnabled() const				{ return mAsyncQueue.load( std::memory_order_acquire ) != nullptr; }
+	//! Blocks until every record queued so far has been written. Fatal records are always flushed before CI_LOG_F returns.
+	void	flush();
+	//! Returns the number of records discarded under \c OVERFLOW_DROP since async logging was enabled.
+	size_t	getNumDroppedRecords() const;
+
+	//! Writes \a text to the current Logger, or queues it when async logging is enabled. Called by Entry.
+	void	write( const Metadata &meta, const std::string &text );
+
 protected:
 	LogManager();
+	~LogManager();
 
 	bool initFileLogging();
+	//! Writes queued records and returns a lock which keeps the async background thread from writing until it is released. Held while the Logger stack changes.
+	std::unique_lock<std::mutex>	pauseAsyncWriting();
 
 	std::unique_ptr<Logger>	mLogger;
 	LoggerImplMulti			*mLoggerMulti;
 	mutable std::mutex		mMutex;
 	bool					mConsoleLoggingEnabled, mFileLoggingEnabled, mSystemLoggingEnabled, mBreakOnLogEnabled;
 	Level					mSystemLoggingLevel;
+	std::atomic<int>			mLevel;
+	std::atomic<AsyncLogQueue*>	mAsyncQueue;
 
 	static LogManager *sInstance;
 };
 
 LogManager* manager();
 
+//! Returns whether records at \a level are currently logged. Nothing is logged after LogManager::destroyInstance().
+inline bool isLevelEnabled( Level level )
+{
+	LogManager *logManager = LogManager::instance();
+	return logManager && level >= logManager->getLevel();
+}
+
+namespace detail {
+
+//! Stream which CI_LOG_* formats into. Each thread reuses one, so formatting a record doesn't allocate once its buffer has grown.
+class FormatStream : public std::ostream {
+  public:
+	FormatStream() : std::ostream( &mBuf )	{}
+
+	//! Empties the buffer and restores default formatting state
+	void				reset();
+	const std::string&	getString() const	{ return mBuf.mString; }
+
+  private:
+	struct Buf : public std::streambuf {
+		int_type		overflow( int_type c ) override;
+		std::streamsize	xsputn( const char *s, std::streamsize n ) override;
+
+		std::string		mString;
+	};
+
+	Buf		mBuf;
+};
+
+//! Returns the calling thread's FormatStream, or a new one owned by the caller when the thread's stream is already in use (logging while formatting a record)
+FormatStream*	acquireFormatStream( bool *ownedByCaller );
+void			releaseFormatStream( FormatStream *stream, bool ownedByCaller );
+
+//! Lets CINDER_LOG_STREAM discard an Entry expression in the branch taken when the level is enabled
+struct Voidify {
+	template<typename T>
+	void operator&( const T& ) {}
+};
+
+} // namespace detail
+
 struct Entry {
-	// TODO: move &&location
 	Entry( Level level, const Location &location )
 		: mHasContent( false )
 	{
 		mMetaData.mLevel = level;
 		mMetaData.mLocation = location;
+		mStream = detail::acquireFormatStream( &mOwnsStream );
+	}
+
+	Entry( Level level, Location &&location )
+		: mHasContent( false )
+	{
+		mMetaData.mLevel = level;
+		mMetaData.mLocation = std::move( location );
+		mStream = detail::acquireFormatStream( &mOwnsStream );
 	}
 
 	~Entry()
 	{
 		if( mHasContent )
 			writeToLog();
+		detail::releaseFormatStream( mStream, mOwnsStream );
 	}
 
 	template <typename T>
 	Entry& operator<<( const T &rhs )
 	{
 		mHasContent = true;
-		mStream << rhs;
+		*mStream << rhs;
 		return *this;
 	}
 
 	void writeToLog()
 	{
-		manager()->getLogger()->write( mMetaData, mStream.str() );
+		if( LogManager *logManager = manager() )
+			logManager->write( mMetaData, mStream->getString() );
 	}
 
 	const Metadata&	getMetaData() const	{ return mMetaData; }
 
 private:
+	Entry( const Entry& );
+	Entry& operator=( const Entry& );
 
-	Metadata			mMetaData;
-	bool				mHasContent;
-	std::stringstream	mStream;
+	Metadata				mMetaData;
+	bool					mHasContent;
+	detail::FormatStream	*mStream;
+	bool					mOwnsStream;
 };
 
 
@@ -274,7 +363,8 @@ typedef ThreadSafeT<LoggerFile>			LoggerFileThreadSafe;
 // ----------------------------------------------------------------------------------
 // Logging macros
 
-#define CINDER_LOG_STREAM( level, stream ) ::cinder::log::Entry( level, ::cinder::log::Location( CINDER_CURRENT_FUNCTION, __FILE__, __LINE__ ) ) << stream
+// the level is checked before the Location is built or anything in \a stream is evaluated
+#define CINDER_LOG_STREAM( level, stream ) ( ! ::cinder::log::isLevelEnabled( level ) ) ? (void)0 : ::cinder::log::detail::Voidify() & ( ::cinder::log::Entry( level, ::cinder::log::Location( CINDER_CURRENT_FUNCTION, __FILE__, __LINE__ ) ) << stream )
 
 // CI_MAX_LOG_LEVEL is designed so that if you set it to 0, nothing logs, 1 only fatal, 2 fatal + error, etc...
 
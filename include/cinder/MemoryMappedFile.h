@@ -0,0 +1,86 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Buffer.h"
+#include "cinder/Exception.h"
+#include "cinder/Filesystem.h"
+#include "cinder/Noncopyable.h"
+
+#include <limits>
+
+namespace cinder {
+
+typedef std::shared_ptr<class MemoryMappedFile>	MemoryMappedFileRef;
+
+//! Maps the entirety of a file into the address space of the process, read-only unless it is copy-on-write. Pages are loaded by the OS on first access rather than read up front, and the mapping is released along with the last reference to the MemoryMappedFile.
+class MemoryMappedFile : private Noncopyable {
+  public:
+	//! How the mapping is expected to be read, which determines how far ahead of accesses the OS reads the file
+	enum AccessHint { ACCESS_NORMAL, ACCESS_SEQUENTIAL, ACCESS_RANDOM };
+
+	//! Maps the file at \a path. A \a copyOnWrite mapping is also writable, and writes go to private copies of the pages rather than to the file. Throws MemoryMappedFileExc on failure.
+	static MemoryMappedFileRef	create( const fs::path &path, bool copyOnWrite = false );
+	~MemoryMappedFile();
+
+	//! Returns a Buffer over the mapping of \a mappedFile, which keeps it mapped for as long as the Buffer is referenced. The Buffer's data is only writable for a copy-on-write mapping.
+	static BufferRef	createBuffer( const MemoryMappedFileRef &mappedFile );
+
+	//! Returns a pointer to the first byte of the file, or \c nullptr for an empty file
+	const void*		getData() const { return mData; }
+	//! Returns a writable pointer to the first byte of a copy-on-write mapping, or \c nullptr for a read-only mapping or an empty file
+	void*			getWritableData() const { return mCopyOnWrite ? const_cast<void*>( mData ) : nullptr; }
+	//! Returns whether the mapping is copy-on-write
+	bool			isCopyOnWrite() const { return mCopyOnWrite; }
+	//! Returns the size of the file in bytes
+	size_t			getSize() const { return mSize; }
+	//! Returns the path of the mapped file
+	const fs::path&	getFilePath() const { return mFilePath; }
+
+	//! Advises the OS how the mapping will be read. Ignored on Windows, which has no equivalent.
+	void	setAccessHint( AccessHint hint );
+	//! Asks the OS to start reading \a size bytes at \a offset into memory in the background, so that later accesses don't wait on the disk. Ignored on Windows.
+	void	prefetch( size_t offset = 0, size_t size = std::numeric_limits<size_t>::max() );
+
+  protected:
+	MemoryMappedFile( const fs::path &path, bool copyOnWrite );
+
+	fs::path	mFilePath;
+	const void	*mData;
+	size_t		mSize;
+	bool		mCopyOnWrite;
+#if defined( CINDER_MSW ) || defined( CINDER_WINRT )
+	void		*mFileHandle, *mMappingHandle;
+#endif
+};
+
+class MemoryMappedFileExc : public Exception {
+  public:
+	MemoryMappedFileExc( const fs::path &path, const std::string &description )
+		: Exception( "Failed to map " + path.string() + ": " + description )
+	{}
+};
+
+} // namespace cinder
@@ -0,0 +1,170 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Filesystem.h"
+#include "cinder/Noncopyable.h"
+#include "cinder/Timer.h"
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+//! Defining CI_PROFILING as 0 compiles out every CI_PROFILE() and CI_PROFILE_GPU() marker, including those within Cinder itself. Defaults to 1, in which case a marker costs a single branch while the Profiler is disabled.
+#if ! defined( CI_PROFILING )
+	#define CI_PROFILING 1
+#endif
+
+namespace cinder {
+
+//! Collects hierarchical CPU and GPU timings of scoped markers, grouped into frames. Markers are only recorded on the thread which calls newFrame() (the app's main thread), and only while the Profiler is enabled.
+//! GPU timings require a GpuTimer, such as gl::ProfilerGpuTimer, and are resolved several frames later without ever waiting on the GPU. Marker names must outlive the Profiler, which string literals do.
+class Profiler : private Noncopyable {
+  public:
+	//! Interface for recording GPU timestamps
+	class GpuTimer {
+	  public:
+		virtual ~GpuTimer() {}
+		//! Issues a timestamp which is recorded once the GPU reaches this point in the command stream and returns a handle to it
+		virtual uint32_t	issueTimestamp() = 0;
+		//! Returns \c true and sets \a resultNanoseconds if the timestamp \a handle is available. Never blocks.
+		virtual bool		getTimestamp( uint32_t handle, uint64_t *resultNanoseconds ) = 0;
+		//! Returns the handle \a handle for reuse
+		virtual void		releaseTimestamp( uint32_t handle ) = 0;
+		//! Returns \c true and sets \a resultNanoseconds to the current GPU time, which is used to align GPU timestamps with the CPU clock
+		virtual bool		getCurrentTime( uint64_t *resultNanoseconds ) = 0;
+	};
+
+	//! A single marker within a frame. Times are in seconds, relative to the construction of the Profiler.
+	struct Sample {
+		const char*	mName;
+		int32_t		mParent; // index of the enclosing Sample within the frame, or -1
+		uint32_t	mDepth;
+		double		mCpuStart, mCpuEnd;
+		//! GPU times aligned to the CPU clock. Negative when the marker had no GPU timing or the results never arrived.
+		double		mGpuStart, mGpuEnd;
+		uint32_t	mGpuStartHandle, mGpuEndHandle;
+		bool		mHasGpu;
+	};
+
+	struct Frame {
+		uint64_t			mIndex;
+		double				mCpuStart, mCpuEnd;
+		double				mGpuOffset; // seconds added to GPU timestamps to align them with the CPU clock
+		std::vector<Sample>	mSamples;
+	};
+
+	//! Rolling statistics for a marker over the frames in the history in which it appeared. Times are per-frame totals in milliseconds; GPU times are only meaningful when \a mNumGpuFrames is nonzero.
+	struct Stats {
+		Stats() : mCpuMin( 0 ), mCpuAvg( 0 ), mCpuMax( 0 ), mGpuMin( 0 ), mGpuAvg( 0 ), mGpuMax( 0 ), mCallsPerFrame( 0 ), mNumFrames( 0 ), mNumGpuFrames( 0 ) {}
+
+		double	mCpuMin, mCpuAvg, mCpuMax;
+		double	mGpuMin, mGpuAvg, mGpuMax;
+		double	mCallsPerFrame;
+		size_t	mNumFrames, mNumGpuFrames;
+	};
+
+	//! Returns the global Profiler
+	static Profiler*	get();
+
+	//! Enables or disables recording, which takes effect at the next call to newFrame(). Disabled by default.
+	void	setEnabled( bool enabled = true ) { mEnabled = enabled; }
+	bool	isEnabled() const { return mEnabled; }
+	//! Sets the GpuTimer used by CI_PROFILE_GPU() markers. Without one they record CPU timings only.
+	void	setGpuTimer( const std::shared_ptr<GpuTimer> &gpuTimer );
+	const std::shared_ptr<GpuTimer>&	getGpuTimer() const { return mGpuTimer; }
+	//! Sets the number of resolved frames retained for statistics and export. Defaults to \c 120.
+	void	setHistoryLength( size_t numFrames ) { mHistoryLength = numFrames; }
+	size_t	getHistoryLength() const { return mHistoryLength; }
+	//! Limits the number of markers per frame which issue GPU timestamps; beyond it markers are timed on the CPU only. Defaults to \c 256.
+	void	setMaxGpuMarkersPerFrame( size_t maxMarkers ) { mMaxGpuMarkersPerFrame = maxMarkers; }
+	size_t	getMaxGpuMarkersPerFrame() const { return mMaxGpuMarkersPerFrame; }
+
+	//! Ends the current frame and begins the next one, collecting any GPU timings which have become available. Called by the app at the start of each update.
+	void	newFrame();
+	//! Opens a marker named \a name, which also records GPU timestamps when \a gpu is \c true. Prefer CI_PROFILE() and CI_PROFILE_GPU().
+	void	pushMarker( const char *name, bool gpu )	{ if( mRecording ) pushMarkerImpl( name, gpu ); }
+	//! Closes the innermost marker
+	void	popMarker()									{ if( mRecording ) popMarkerImpl(); }
+
+	//! Returns the resolved frames, oldest first
+	const std::deque<Frame>&	getFrames() const { return mHistory; }
+	//! Returns statistics keyed on each marker's path, such as "App::draw/Batch::draw". The whole frame is reported as "Frame".
+	std::map<std::string, Stats>	getStats() const;
+	//! Writes a hierarchical table of getStats() to \a os
+	void	printStats( std::ostream &os ) const;
+	//! Writes the resolved frames as Chrome tracing JSON (viewable with chrome://tracing), with CPU and GPU markers on separate tracks
+	void	writeChromeTrace( std::ostream &os ) const;
+	//! Writes the resolved frames as Chrome tracing JSON to the file at \a path
+	void	writeChromeTrace( const fs::path &path ) const;
+	//! Discards every recorded frame
+	void	clear();
+
+  protected:
+	Profiler();
+
+	void	pushMarkerImpl( const char *name, bool gpu );
+	void	popMarkerImpl();
+	void	resolvePendingFrames( bool force );
+	void	retire( Frame *frame );
+
+	bool						mEnabled, mRecording;
+	std::thread::id				mThreadId;
+	Timer						mTimer;
+	std::shared_ptr<GpuTimer>	mGpuTimer;
+	size_t						mHistoryLength, mMaxGpuMarkersPerFrame, mNumGpuMarkers;
+	uint64_t					mFrameIndex;
+
+	Frame						mCurrentFrame;
+	std::vector<int32_t>		mStack;
+	std::deque<Frame>			mPending, mHistory;
+	std::vector<std::vector<Sample>>	mSpareSamples;
+};
+
+//! Profiles the lifetime of the object; generally used through CI_PROFILE() and CI_PROFILE_GPU()
+class ScopedProfileMarker : private Noncopyable {
+  public:
+	ScopedProfileMarker( const char *name, bool gpu = false )	{ Profiler::get()->pushMarker( name, gpu ); }
+	~ScopedProfileMarker()										{ Profiler::get()->popMarker(); }
+};
+
+} // namespace cinder
+
+#define CINDER_PROFILE_CONCAT_IMPL( a, b )	a ## b
+#define CINDER_PROFILE_CONCAT( a, b )		CINDER_PROFILE_CONCAT_IMPL( a, b )
+
+#if CI_PROFILING
+	//! Times the CPU cost of the enclosing scope
+	#define CI_PROFILE( name )		::cinder::ScopedProfileMarker CINDER_PROFILE_CONCAT( ciProfileMarker, __LINE__ )( name, false )
+	//! Times the CPU and GPU cost of the enclosing scope
+	#define CI_PROFILE_GPU( name )	::cinder::ScopedProfileMarker CINDER_PROFILE_CONCAT( ciProfileMarker, __LINE__ )( name, true )
+#else
+	#define CI_PROFILE( name )		((void)0)
+	#define CI_PROFILE_GPU( name )	((void)0)
+#endif
@@ -29,72 +29,27 @@
 #include "cinder/CinderAssert.h"
 #include "cinder/Noncopyable.h"
 
+#include <algorithm>
 #include <functional>
 #include <memory>
-#include <map>
+#include <mutex>
 #include <vector>
+#include <cstdint>
 
 namespace cinder { namespace signals {
 
 namespace detail {
 
-//! Base class for signal links, which manages reference counting and provides a concrete type to be passed to Connection
-struct SignalLinkBase {
-  public:
-	SignalLinkBase()
-		: mRefCount( 1 ), mEnabled( true )
-	{}
-	virtual ~SignalLinkBase()
-	{
-		CI_ASSERT( mRefCount == 0 );
-	}
-
-	virtual bool removeSibling( SignalLinkBase *link ) = 0;
-
-	void incrRef()
-	{
-		mRefCount++;
-		CI_ASSERT( mRefCount > 0 );
-	}
-
-	void decrRef()
-	{
-		mRefCount--;
-		if( ! mRefCount )
-			delete this;
-		else
-			CI_ASSERT( mRefCount > 0 );
-	}
-
-	int getRefCount() const
-	{
-		return mRefCount;
-	}
-
-	void enable()
-	{
-		mEnabled = true;
-	}
-
-	void disable()
-	{
-		mEnabled = false;
-	}
-
-	bool isEnabled() const
-	{
-		return mEnabled;
-	}
-
-  private:
-	int		mRefCount;
-	bool	mEnabled;
-};
-
 //! Base Signal class, which provides a concrete type that can be stored by the Disconnector
 struct SignalBase : private Noncopyable {
-	//! abstract method to disconnect \a link from the callback chain, which resides in the priority group \a priority.
-	virtual bool disconnect( SignalLinkBase *link, int priority ) = 0;
+	//! abstract method to disconnect the slot \a id from the callback chain, which resides in the priority group \a priority.
+	virtual bool disconnect( uint64_t id, int priority ) = 0;
+	//! abstract method returning whether the slot \a id in priority group \a priority is still connected.
+	virtual bool isConnected( uint64_t id, int priority ) const = 0;
+	//! abstract method enabling or disabling the slot \a id in priority group \a priority.
+	virtual void setEnabled( uint64_t id, int priority, bool enable ) = 0;
+	//! abstract method returning whether the slot \a id in priority group \a priority is enabled.
+	virtual bool isEnabled( uint64_t id, int priority ) const = 0;
 
 	friend struct Disconnector;
 };
@@ -103,13 +58,35 @@ struct SignalBase : private Noncopyable {
 struct Disconnector : private Noncopyable {
 	//! Constructs a new Disconnector, which is owned by \a signal.
 	Disconnector( SignalBase *signal );
-	//! Instructs the owning signal to disconnect \a link, which resides within priority group \a priority.
-	bool disconnect( SignalLinkBase *link, int priority );
+	//! Instructs the owning signal to disconnect slot \a id, which resides within priority group \a priority.
+	bool disconnect( uint64_t id, int priority );
+	bool isConnected( uint64_t id, int priority ) const;
+	void setEnabled( uint64_t id, int priority, bool enable );
+	bool isEnabled( uint64_t id, int priority ) const;
 
   private:
 	SignalBase*	mSignal;
 };
 
+//! Locks \a mutex for the current scope unless it is null, which is the case for signals that aren't thread safe.
+struct ScopedOptionalLock : private Noncopyable {
+	ScopedOptionalLock( std::recursive_mutex *mutex )
+		: mMutex( mutex )
+	{
+		if( mMutex )
+			mMutex->lock();
+	}
+
+	~ScopedOptionalLock()
+	{
+		if( mMutex )
+			mMutex->unlock();
+	}
+
+  private:
+	std::recursive_mutex *mMutex;
+};
+
 } // namespace detail
 
 // ----------------------------------------------------------------------------------------------------
@@ -120,7 +97,7 @@ struct Disconnector : private Noncopyable {
 class Connection {
   public:
 	Connection();
-	Connection( const std::shared_ptr<detail::Disconnector> &disconnector, detail::SignalLinkBase *link, int priority );
+	Connection( const std::shared_ptr<detail::Disconnector> &disconnector, uint64_t id, int priority );
 
 	//! Disconnects this Connection from the callback chain. \a return true if a disconnection was made, false otherwise.
 	bool disconnect();
@@ -136,7 +113,7 @@ class Connection {
 
   private:
 	std::weak_ptr<detail::Disconnector>		mDisconnector;
-	detail::SignalLinkBase*					mLink;
+	uint64_t								mId;
 	int										mPriority;
 };
 
@@ -154,6 +131,119 @@ class ScopedConnection : public Connection, private Noncopyable {
 
 namespace detail {
 
+//! Type-erased callable which stores small callables, such as lambdas capturing a few pointers or a std::function, inline instead of on the heap.
+template<typename> class SlotFunction;   // undefined
+
+template<class R, class... Args>
+class SlotFunction<R ( Args... )> {
+  public:
+	SlotFunction()
+		: mInvoke( nullptr ), mManage( nullptr )
+	{}
+
+	//! An empty std::function or null function pointer results in an empty SlotFunction.
+	template<typename F>
+	explicit SlotFunction( F &&fn )
+		: mInvoke( nullptr ), mManage( nullptr )
+	{
+		if( ! isEmpty( fn ) )
+			init<typename std::decay<F>::type>( std::forward<F>( fn ), FitsInline<typename std::decay<F>::type>() );
+	}
+
+	SlotFunction( SlotFunction &&other )
+		: mInvoke( other.mInvoke ), mManage( other.mManage )
+	{
+		if( mManage )
+			mManage( MOVE, &other.mStorage, &mStorage );
+		other.mInvoke = nullptr;
+		other.mManage = nullptr;
+	}
+
+	SlotFunction& operator=( SlotFunction &&rhs )
+	{
+		if( this != &rhs ) {
+			reset();
+			mInvoke = rhs.mInvoke;
+			mManage = rhs.mManage;
+			if( mManage )
+				mManage( MOVE, &rhs.mStorage, &mStorage );
+			rhs.mInvoke = nullptr;
+			rhs.mManage = nullptr;
+		}
+		return *this;
+	}
+
+	~SlotFunction()
+	{
+		reset();
+	}
+
+	R operator()( const Args&... args ) const	{ return mInvoke( &mStorage, args... ); }
+
+	explicit operator bool() const	{ return mInvoke != nullptr; }
+
+  private:
+	SlotFunction( const SlotFunction& );
+	SlotFunction& operator=( const SlotFunction& );
+
+	enum Op { MOVE, DESTROY };
+	typedef typename std::aligned_storage<4 * sizeof( void* ), std::alignment_of<void*>::value>::type Storage;
+
+	template<typename F>
+	struct FitsInline : std::integral_constant<bool, sizeof( F ) <= sizeof( Storage ) && std::alignment_of<F>::value <= std::alignment_of<Storage>::value
+													&& std::is_nothrow_move_constructible<F>::value> {};
+
+	template<typename F>
+	static bool isEmpty( const F & )						{ return false; }
+	template<typename Sig>
+	static bool isEmpty( const std::function<Sig> &fn )		{ return ! fn; }
+	template<typename T>
+	static bool isEmpty( T *fn )							{ return fn == nullptr; }
+
+	//! Calls \a fn, discarding its result when the signal returns void, as std::function does.
+	template<typename F>
+	static R call( F &fn, std::false_type /*void*/, const Args&... args )	{ return fn( args... ); }
+	template<typename F>
+	static void call( F &fn, std::true_type /*void*/, const Args&... args )	{ fn( args... ); }
+
+	template<typename F, typename Fn>
+	void init( Fn &&fn, std::true_type /*inline*/ )
+	{
+		new( &mStorage ) F( std::forward<Fn>( fn ) );
+		mInvoke = []( void *storage, const Args&... args ) -> R { return call( *static_cast<F*>( storage ), std::is_void<R>(), args... ); };
+		mManage = []( Op op, void *src, void *dst ) {
+			if( op == MOVE )
+				new( dst ) F( std::move( *static_cast<F*>( src ) ) );
+			static_cast<F*>( src )->~F();
+		};
+	}
+
+	template<typename F, typename Fn>
+	void init( Fn &&fn, std::false_type /*inline*/ )
+	{
+		*reinterpret_cast<F**>( &mStorage ) = new F( std::forward<Fn>( fn ) );
+		mInvoke = []( void *storage, const Args&... args ) -> R { return call( **static_cast<F**>( storage ), std::is_void<R>(), args... ); };
+		mManage = []( Op op, void *src, void *dst ) {
+			if( op == MOVE )
+				*static_cast<F**>( dst ) = *static_cast<F**>( src );
+			else
+				delete *static_cast<F**>( src );
+		};
+	}
+
+	void reset()
+	{
+		if( mManage )
+			mManage( DESTROY, &mStorage, nullptr );
+		mInvoke = nullptr;
+		mManage = nullptr;
+	}
+
+	mutable Storage		mStorage;
+	R					(*mInvoke)( void *storage, const Args&... args );
+	void				(*mManage)( Op op, void *src, void *dst );
+};
+
 //! The template implementation for callback list.
 template<typename, typename> class	SignalProto;   // undefined
 
@@ -192,7 +282,7 @@ struct CollectorDefault<void> {
 template<class Collector, class R, class... Args>
 struct CollectorInvocation<Collector, R ( Args... )> : public SignalBase {
 
-	bool invoke( Collector &collector, const std::function<R ( Args... )> &callback, Args... args )
+	bool invoke( Collector &collector, const SlotFunction<R ( Args... )> &callback, const Args&... args )
 	{
 		return collector( callback( args... ) );
 	}
@@ -202,7 +292,7 @@ struct CollectorInvocation<Collector, R ( Args... )> : public SignalBase {
 template<class Collector, class... Args>
 struct CollectorInvocation<Collector, void( Args... )> : public SignalBase {
 
-	bool invoke( Collector &collector, const std::function<void( Args... )> &callback, Args... args )
+	bool invoke( Collector &collector, const SlotFunction<void( Args... )> &callback, const Args&... args )
 	{
 		callback( args... );
 		return collector();
@@ -210,200 +300,260 @@ struct CollectorInvocation<Collector, void( Args... )> : public SignalBase {
 };
 
 //! SignalProto template, the parent class of Signal, specialised for the callback signature and collector.
+//! Slots are stored in a contiguous array per priority group. Slots disconnected during an emission are only marked, and slots connected
+//! during an emission are queued, so the arrays never move while a callback runs. Both are applied when the outermost emission returns.
 template<class Collector, class R, class... Args>
 class SignalProto<R ( Args... ), Collector> : private CollectorInvocation<Collector, R ( Args... )> {
   protected:
 	typedef std::function<R ( Args... )>		CallbackFn;
 	typedef typename CallbackFn::result_type	Result;
 	typedef typename Collector::CollectorResult	CollectorResult;
+	typedef SlotFunction<R ( Args... )>			SlotFn;
 
   public:
 	//! Constructs an empty SignalProto
 	SignalProto()
-		: mDisconnector( new Disconnector( this ) )
+		: mDisconnector( new Disconnector( this ) ), mNextId( 1 ), mEmitDepth( 0 ), mNeedsUpdate( false )
 	{}
 
-	//! Destructor releases all resources associated with this signal.
-	~SignalProto()
-	{
-		for( auto &lp : mLinks ) {
-			SignalLink *link = lp.second;
-			if( link ) {
-				while( link->mNext != link )
-					link->mNext->unlink();
-
-				CI_ASSERT( link->getRefCount() >= 2 );
-
-				link->decrRef();
-				link->decrRef();
-			}
-		}
-	}
-
 	//! Connects \a callback to the signal, assigned to the default priority group (priority = 0). \return a Connection, which can be used to disconnect this callback slot.
-	Connection connect( const CallbackFn &callback )
+	template<typename F>
+	Connection connect( F &&callback )
 	{
-		return connect( 0, callback );
+		return connect( 0, std::forward<F>( callback ) );
 	}
 
 	//! Connects \a callback to the signal, assigned to the priority group \a priority. \return a Connection, which can be used to disconnect this callback slot.
-	Connection connect( int priority, const CallbackFn &callback )
+	//! \a callback may be a std::function, a function pointer or any other callable, which is stored without allocating if it is no larger than four pointers.
+	template<typename F>
+	Connection connect( int priority, F &&callback )
 	{
-		auto head = ensureLinkGroup( priority );
-		auto link = head->addBefore( callback );
-		return Connection( mDisconnector, link, priority );
+		ScopedOptionalLock lock( mMutex.get() );
+
+		uint64_t id = mNextId++;
+		if( mEmitDepth > 0 ) {
+			mPending.push_back( PendingSlot( priority, Slot( SlotFn( std::forward<F>( callback ) ), id ) ) );
+			mNeedsUpdate = true;
+		}
+		else
+			ensureGroup( priority ).push_back( Slot( SlotFn( std::forward<F>( callback ) ), id ) );
+
+		return Connection( mDisconnector, id, priority );
 	}
 
 	//! Emit a signal, i.e. invoke all its callbacks and collect return types with Collector. \return the CollectorResult from the collector.
-	CollectorResult	emit( Args... args )
+	CollectorResult	emit( const Args&... args )
 	{
 		Collector collector;
 		emit( collector, args... );
 		return collector.getResult();
 	}
 
-	//! Emit a signal, i.e. invoke all its callbacks and collect return types with \a collector.
-	void emit( Collector &collector, Args... args )
+	//! Emit a signal, i.e. invoke all its callbacks and collect return types with \a collector. Arguments are passed to every callback by reference.
+	void emit( Collector &collector, const Args&... args )
 	{
-		bool continueEmission = true;
-		for( auto &lp : mLinks ) {
-			SignalLink *link = lp.second;
-			link->incrRef();
-			do {
-				if( link->mCallbackFn && link->isEnabled() ) {
-					continueEmission = this->invoke( collector, link->mCallbackFn, args... );
-					if( ! continueEmission ) {
-						break;
-					}
+		ScopedOptionalLock lock( mMutex.get() );
+		EmitScope emitScope( this );
+
+		for( size_t g = 0; g < mGroups.size(); ++g ) {
+			const std::vector<Slot> &slots = mGroups[g].mSlots;
+			for( size_t i = 0, numSlots = slots.size(); i < numSlots; ++i ) {
+				const Slot &slot = slots[i];
+				if( slot.mConnected && slot.mEnabled && slot.mFn ) {
+					if( ! this->invoke( collector, slot.mFn, args... ) )
+						return;
 				}
-
-				SignalLink *old = link;
-				link = old->mNext;
-
-				link->incrRef();
-				old->decrRef();
 			}
-			while( link != lp.second );
-			
-			link->decrRef();
-
-			if( ! continueEmission )
-				break;
 		}
 	}
 
 	//! Returns the number of connected slots.
 	size_t getNumSlots() const
 	{
-		size_t count = 0;
+		ScopedOptionalLock lock( mMutex.get() );
 
-		for( auto &lp : mLinks ) {
-			SignalLink *link = lp.second;
-			do {
-				if( link->mCallbackFn )
+		size_t count = 0;
+		for( const auto &pending : mPending ) {
+			if( pending.mSlot.mConnected )
+				count++;
+		}
+		for( const auto &group : mGroups ) {
+			for( const auto &slot : group.mSlots ) {
+				if( slot.mConnected )
 					count++;
-
-				SignalLink *old = link;
-				link = old->mNext;
 			}
-			while( link != lp.second );
 		}
 
 		return count;
 	}
 
+	//! Makes connect(), disconnect() and emit() safe to call from multiple threads by serializing them with a recursive mutex, so callbacks
+	//! can still connect, disconnect and emit on the emitting thread. Should be called before the signal is shared between threads. Default is disabled.
+	void setThreadSafe( bool threadSafe = true )
+	{
+		if( threadSafe && ! mMutex )
+			mMutex.reset( new std::recursive_mutex );
+		else if( ! threadSafe )
+			mMutex.reset();
+	}
+	//! Returns whether connect(), disconnect() and emit() may be called from multiple threads.
+	bool isThreadSafe() const	{ return mMutex != nullptr; }
+
   private:
+	struct Slot {
+		Slot( SlotFn &&fn, uint64_t id )
+			: mFn( std::move( fn ) ), mId( id ), mEnabled( true ), mConnected( true )
+		{}
 
-	//! implements a doubly-linked ring with ref-counted nodes containing the signal handlers.
-	struct SignalLink : public SignalLinkBase {
-		explicit SignalLink( const CallbackFn &callback )
-			: mNext( nullptr ), mPrev( nullptr ), mCallbackFn( callback )
+		Slot( Slot &&other )
+			: mFn( std::move( other.mFn ) ), mId( other.mId ), mEnabled( other.mEnabled ), mConnected( other.mConnected )
 		{}
 
-		void unlink()
+		Slot& operator=( Slot &&rhs )
 		{
-			mCallbackFn = nullptr;
-			if( mNext )
-				mNext->mPrev = mPrev;
-			if( mPrev )
-				mPrev->mNext = mNext;
-
-			decrRef();
-			// leave intact ->mNext, ->mPrev for stale iterators
+			mFn = std::move( rhs.mFn );
+			mId = rhs.mId;
+			mEnabled = rhs.mEnabled;
+			mConnected = rhs.mConnected;
+			return *this;
 		}
 
-		SignalLink* addBefore( const CallbackFn &callback )
+		SlotFn		mFn;
+		uint64_t	mId;
+		bool		mEnabled, mConnected;
+	};
+
+	struct Group {
+		int					mPriority;
+		std::vector<Slot>	mSlots;		// ordered by id, which is the order they were connected in
+	};
+
+	struct PendingSlot {
+		PendingSlot( int priority, Slot &&slot )
+			: mPriority( priority ), mSlot( std::move( slot ) )
+		{}
+
+		int		mPriority;
+		Slot	mSlot;
+	};
+
+	//! Tracks emission depth, and applies deferred disconnections and connections when the outermost emission returns.
+	struct EmitScope {
+		EmitScope( SignalProto *signal ) : mSignal( signal )	{ mSignal->mEmitDepth++; }
+		~EmitScope()
 		{
-			SignalLink *link = new SignalLink( callback );
+			if( --mSignal->mEmitDepth == 0 && mSignal->mNeedsUpdate )
+				mSignal->applyDeferred();
+		}
+
+		SignalProto	*mSignal;
+	};
 
-			link->mPrev = mPrev; // link to last
-			link->mNext = this;
-			mPrev->mNext = link; // link from last
-			mPrev = link;
+	void applyDeferred()
+	{
+		mNeedsUpdate = false;
 
-			return link;
+		for( auto &group : mGroups ) {
+			auto &slots = group.mSlots;
+			slots.erase( std::remove_if( slots.begin(), slots.end(), []( const Slot &slot ) { return ! slot.mConnected; } ), slots.end() );
 		}
+		mGroups.erase( std::remove_if( mGroups.begin(), mGroups.end(), []( const Group &group ) { return group.mSlots.empty(); } ), mGroups.end() );
 
-		bool deactivate( const CallbackFn &callback )
-		{
-			if( callback == mCallbackFn ) {
-				mCallbackFn = nullptr;	// deactivate static head
-				return true;
-			}
+		for( auto &pending : mPending ) {
+			if( pending.mSlot.mConnected )
+				ensureGroup( pending.mPriority ).push_back( std::move( pending.mSlot ) );
+		}
+		mPending.clear();
+	}
 
-			for( SignalLink *link = this->mNext ? this->mNext : this; link != this; link = link->mNext ) {
-				if( callback == link->function ) {
-					link->unlink();		// deactivate and unlink sibling
-					return true;
-				}
-			}
-			return false;
+	//! returns the slots for this priority group, creating the group if necessary. Groups are sorted so that greater priorities fire first.
+	std::vector<Slot>& ensureGroup( int priority )
+	{
+		auto it = mGroups.begin();
+		while( it != mGroups.end() && it->mPriority > priority )
+			++it;
+
+		if( it == mGroups.end() || it->mPriority != priority ) {
+			Group group;
+			group.mPriority = priority;
+			it = mGroups.insert( it, std::move( group ) );
 		}
 
-		bool removeSibling( SignalLinkBase *sibling ) override
-		{
-			for( SignalLink *link = this->mNext ? this->mNext : this; link != this; link = link->mNext ) {
-				if( sibling == link ) {
-					link->unlink();		// deactivate and unlink sibling
-					return true;
-				}
+		return it->mSlots;
+	}
+
+	Slot* findSlot( uint64_t id, int priority ) const
+	{
+		for( auto &group : mGroups ) {
+			if( group.mPriority == priority ) {
+				auto &slots = group.mSlots;
+				auto it = std::lower_bound( slots.begin(), slots.end(), id, []( const Slot &slot, uint64_t id ) { return slot.mId < id; } );
+				if( it != slots.end() && it->mId == id && it->mConnected )
+					return const_cast<Slot*>( &*it );
+				break;
 			}
-			return false;
 		}
 
-		SignalLink*		mNext;
-		SignalLink*		mPrev;
-		CallbackFn		mCallbackFn;
-	};
+		for( auto &pending : mPending ) {
+			if( pending.mSlot.mId == id && pending.mSlot.mConnected )
+				return const_cast<Slot*>( &pending.mSlot );
+		}
+
+		return nullptr;
+	}
 
-	bool disconnect( SignalLinkBase *link, int priority ) override
+	bool disconnect( uint64_t id, int priority ) override
 	{
-		auto it = mLinks.find( priority );
-		if( it == mLinks.end() )
+		ScopedOptionalLock lock( mMutex.get() );
+
+		Slot *slot = findSlot( id, priority );
+		if( ! slot )
 			return false;
 
-		return it->second->removeSibling( link );
+		if( mEmitDepth > 0 ) {
+			// the callback may be running, so it is destroyed once the emission returns
+			slot->mConnected = false;
+			mNeedsUpdate = true;
+		}
+		else {
+			auto &slots = ensureGroup( priority );
+			slots.erase( slots.begin() + ( slot - slots.data() ) );
+			// drops the group if it is now empty
+			if( slots.empty() )
+				applyDeferred();
+		}
+
+		return true;
 	}
 
-	//! returns the head link for this priority group
-	SignalLink* ensureLinkGroup( int priority )
+	bool isConnected( uint64_t id, int priority ) const override
 	{
-		auto it = mLinks.find( priority );
-		if( it != mLinks.end() )
-			return it->second;
-		else {
-			auto head = new SignalLink( CallbackFn() ); // ref count = 1
-			head->incrRef(); // ref count = 2, head of ring, can be deactivated but not removed
-			head->mNext = head; // ring head initialization
-			head->mPrev = head; // ring tail initialization
+		ScopedOptionalLock lock( mMutex.get() );
+		return findSlot( id, priority ) != nullptr;
+	}
 
-			mLinks.insert( { priority, head } );
-			return head;
-		}
+	void setEnabled( uint64_t id, int priority, bool enable ) override
+	{
+		ScopedOptionalLock lock( mMutex.get() );
+		Slot *slot = findSlot( id, priority );
+		if( slot )
+			slot->mEnabled = enable;
 	}
 
-	std::map<int, SignalLink*, std::greater<int> >	mLinks;			// groups of callback nodes, which are stored in a reference counted linked list. Each group represents priority, greater int means fires first.
-	std::shared_ptr<Disconnector>					mDisconnector;	// Connection holds a weak_ptr to this to make disconnections.
+	bool isEnabled( uint64_t id, int priority ) const override
+	{
+		ScopedOptionalLock lock( mMutex.get() );
+		Slot *slot = findSlot( id, priority );
+		return slot && slot->mEnabled;
+	}
+
+	std::vector<Group>						mGroups;		// sorted by descending priority, so greater int means fires first.
+	std::vector<PendingSlot>				mPending;		// slots connected during an emission
+	std::shared_ptr<Disconnector>			mDisconnector;	// Connection holds a weak_ptr to this to make disconnections.
+	std::unique_ptr<std::recursive_mutex>	mMutex;			// only allocated when thread safe
+	uint64_t								mNextId;
+	int										mEmitDepth;
+	bool									mNeedsUpdate;
 };
 
 } // cinder::detail
@@ -436,7 +586,11 @@ class SignalProto<R ( Args... ), Collector> : private CollectorInvocation<Collec
 //! of scope.
 //!
 //! The signal implementation is safe against recursion, so callbacks may be connected and disconnected
-//! during a signal emission. Recursive emit() calls are also safe.
+//! during a signal emission. Recursive emit() calls are also safe. Callbacks connected during an emission
+//! are first called by the next emission.
+//!
+//! Signals aren't thread safe by default. Call setThreadSafe() to serialize connect(), disconnect() and
+//! emit() from multiple threads.
 //!
 //! \note Signals are non-copyable.
 template <typename Signature, class Collector = detail::CollectorDefault<typename std::function<Signature>::result_type> >
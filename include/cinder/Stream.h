@@ -28,6 +28,7 @@
 #include "cinder/Filesystem.h"
 #include "cinder/Noncopyable.h"
 
+#include <cstring>
 #include <string>
 
 namespace cinder {
@@ -106,7 +107,7 @@ class IStreamCinder : public virtual StreamBase {
 	virtual ~IStreamCinder() {};
 
 	template<typename T>
-	void		read( T *t ) { IORead( t, sizeof(T) ); }
+	void		read( T *t );
 	template<typename T>
 	void		readEndian( T *t, uint8_t endian ) { if ( endian == STREAM_BIG_ENDIAN ) readBig( t ); else readLittle( t ); }
 	template<typename T>
@@ -128,12 +129,36 @@ class IStreamCinder : public virtual StreamBase {
 	virtual bool		isEof() const = 0;
 
  protected:
-	IStreamCinder() : StreamBase() {}
+	IStreamCinder() : StreamBase(), mReadPos( nullptr ), mReadEnd( nullptr ) {}
 
 	virtual void		IORead( void *t, size_t size ) = 0;
 		
 	static const int	MINIMUM_BUFFER_SIZE = 8; // minimum bytes of random access a stream must offer relative to the file start
+
+	// Bytes a stream has already buffered at its current position, which read() and readData() copy without a virtual call.
+	// A stream which sets these must account for them in all of its other methods.
+	const uint8_t		*mReadPos, *mReadEnd;
 };
+
+template<typename T>
+inline void IStreamCinder::read( T *t )
+{
+	if( mReadEnd - mReadPos >= (ptrdiff_t)sizeof(T) ) {
+		std::memcpy( t, mReadPos, sizeof(T) );
+		mReadPos += sizeof(T);
+	}
+	else
+		IORead( t, sizeof(T) );
+}
+
+#if defined( CINDER_LITTLE_ENDIAN )
+template<typename T>
+inline void IStreamCinder::readLittle( T *t )
+{
+	read( t );
+}
+#endif
+
 typedef std::shared_ptr<IStreamCinder>		IStreamRef;
 
 
@@ -181,6 +206,70 @@ class IStreamFile : public IStreamCinder {
 };
 
 
+typedef std::shared_ptr<class IStreamFileBlock>	IStreamFileBlockRef;
+
+//! Reads a file in large page-aligned blocks with positional reads, bypassing the block for reads at least as large as it. Optionally reads the next block on a background thread.
+class IStreamFileBlock : public IStreamCinder {
+ public:
+	class Options {
+	  public:
+		Options() : mBlockSize( 256 * 1024 ), mReadAhead( false ) {}
+
+		//! Sets the size of each read from the file, which is rounded up to a multiple of 4 KB. Default 256 KB.
+		Options&	blockSize( size_t size )			{ mBlockSize = size; return *this; }
+		//! Sets whether the block following the current one is read on a background thread while the current one is consumed. Default false.
+		Options&	readAhead( bool readAhead = true )	{ mReadAhead = readAhead; return *this; }
+
+		size_t		getBlockSize() const	{ return mBlockSize; }
+		bool		isReadAhead() const		{ return mReadAhead; }
+
+	  private:
+		size_t		mBlockSize;
+		bool		mReadAhead;
+	};
+
+	//! Opens the file at \a path for reading. Returns a null IStreamFileBlockRef if the file cannot be opened.
+	static IStreamFileBlockRef	create( const fs::path &path, const Options &options = Options() );
+	~IStreamFileBlock();
+
+	size_t		readDataAvailable( void *dest, size_t maxSize );
+	//! Reads up to \a size bytes at \a offset into \a dest without moving the stream or using its blocks, and returns the number of bytes read. Safe to call from multiple threads.
+	size_t		readAt( off_t offset, void *dest, size_t size ) const;
+
+	void		seekAbsolute( off_t absoluteOffset );
+	void		seekRelative( off_t relativeOffset );
+	off_t		tell() const;
+	off_t		size() const	{ return mSize; }
+
+	bool		isEof() const	{ return tell() >= mSize; }
+
+	const Options&	getOptions() const	{ return mOptions; }
+
+ protected:
+	IStreamFileBlock( const fs::path &path, const Options &options );
+
+	virtual void		IORead( void *t, size_t size );
+	// Makes the block containing \a offset current, and points the read window at \a offset within it. Returns false at the end of the file.
+	bool				loadBlock( off_t offset );
+	void				requestReadAhead( off_t offset );
+	size_t				readDataImpl( void *dest, size_t size );
+
+	struct ReadAhead;
+
+	Options							mOptions;
+#if defined( CINDER_MSW ) || defined( CINDER_WINRT )
+	void							*mHandle;
+#else
+	int								mFd;
+#endif
+	off_t							mSize;
+	uint8_t							*mBlock, *mNextBlock;
+	off_t							mBlockFileOffset; // offset of mBlock in the file
+	size_t							mBlockDataSize; // bytes of the file in mBlock
+	std::unique_ptr<ReadAhead>		mReadAhead;
+};
+
+
 typedef std::shared_ptr<class OStreamFile>	OStreamFileRef;
 
 class OStreamFile : public OStream {
@@ -255,7 +344,7 @@ class IStreamMem : public IStreamCinder {
 	void		seekAbsolute( off_t absoluteOffset );
 	void		seekRelative( off_t relativeOffset );
 	//! Returns the current offset into the stream in bytes
-	off_t		tell() const;
+	off_t		tell() const { return static_cast<off_t>( mReadPos - mData ); }
 	//! Returns the total length of stream in bytes
 	off_t		size() const { return static_cast<off_t>( mDataSize ); }
 
@@ -272,7 +361,6 @@ class IStreamMem : public IStreamCinder {
  
 	const uint8_t	*mData;
 	size_t			mDataSize;
-	size_t			mOffset;
 };
 
 
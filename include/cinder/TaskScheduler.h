@@ -0,0 +1,190 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Noncopyable.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace cinder {
+
+typedef std::shared_ptr<class Task>				TaskRef;
+typedef std::shared_ptr<class TaskScheduler>	TaskSchedulerRef;
+
+//! A unit of work run by a TaskScheduler once every task it depends on has completed. Create with TaskScheduler::createTask().
+class Task : public std::enable_shared_from_this<Task>, private Noncopyable {
+  public:
+	//! Delays this task until \a other completes. Must be called before the task is submitted.
+	void		dependsOn( const TaskRef &other );
+	//! Submits and returns a task which runs \a fn on the scheduler once this task completes.
+	TaskRef		then( const std::function<void()> &fn );
+	//! Submits and returns a task which runs \a fn on the App's main thread, through AppBase::dispatchAsync(), once this task completes. On Linux, whose
+	//! headless App has no event loop, and without an App, \a fn runs on the thread that completed this task instead. Calling wait() on the result from
+	//! the main thread deadlocks, as \a fn can't run until the main thread returns to its event loop.
+	TaskRef		thenOnMainThread( const std::function<void()> &fn );
+
+	//! Returns whether the task has run.
+	bool		isDone() const { return mDone.load( std::memory_order_acquire ); }
+	//! Blocks until the task has run, running other queued tasks in the meantime. Rethrows any exception the task threw.
+	void		wait();
+
+  private:
+	Task( TaskScheduler *scheduler, const std::function<void()> &fn, bool mainThread );
+
+	void		run();
+	// Called once per completed dependency, and once on submit(). Returns true when the task is ready to run.
+	bool		release()	{ return mNumPending.fetch_sub( 1, std::memory_order_acq_rel ) == 1; }
+
+	TaskScheduler				*mScheduler;
+	std::function<void()>		mFn;
+	bool						mMainThread;
+	// unfinished dependencies, plus one until the task is submitted
+	std::atomic<int>			mNumPending;
+	std::atomic<bool>			mDone;
+	std::exception_ptr			mException;
+	// guards mDependents against a concurrent completion
+	std::mutex					mMutex;
+	std::vector<TaskRef>		mDependents;
+
+	friend class TaskScheduler;
+};
+
+//! Runs Tasks on a pool of worker threads, one per core by default. Each worker has its own deque of tasks which it runs newest first, and idle
+//! workers steal the oldest tasks from the others. Threads that wait on a task run queued tasks rather than blocking, so tasks may wait on other tasks.
+class TaskScheduler : private Noncopyable {
+  public:
+	class Options {
+	  public:
+		Options() : mNumThreads( 0 ) {}
+
+		//! Sets the number of worker threads. The default of 0 uses one fewer than the number of cores, since waiting threads run tasks too.
+		Options&	numThreads( size_t numThreads )		{ mNumThreads = numThreads; return *this; }
+		size_t		getNumThreads() const				{ return mNumThreads; }
+
+	  private:
+		size_t		mNumThreads;
+	};
+
+	static TaskSchedulerRef		create( const Options &options = Options() );
+	//! Returns the scheduler shared by Cinder and the app, created on first use with the default Options.
+	static TaskSchedulerRef		get();
+
+	//! Joins the worker threads. Tasks which are still queued are discarded without running, so anything waiting on them never returns.
+	~TaskScheduler();
+
+	//! Returns a task that runs \a fn once submitted and once its dependencies have completed.
+	TaskRef		createTask( const std::function<void()> &fn );
+	//! Queues \a task, which runs as soon as its dependencies have completed.
+	void		submit( const TaskRef &task );
+	//! Creates and submits a task running \a fn.
+	TaskRef		async( const std::function<void()> &fn );
+
+	//! Calls \a fn( chunkBegin, chunkEnd ) over [\a begin, \a end) in chunks of \a grainSize, on the workers and the calling thread, and returns once every chunk has run.
+	template<typename Fn>
+	void		parallelFor( size_t begin, size_t end, size_t grainSize, const Fn &fn );
+	//! Maps each chunk of [\a begin, \a end) with \a map( chunkBegin, chunkEnd ) in parallel, and combines the results in order with \a reduce( T, T ), starting from \a identity.
+	template<typename T, typename MapFn, typename ReduceFn>
+	T			parallelReduce( size_t begin, size_t end, size_t grainSize, const T &identity, const MapFn &map, const ReduceFn &reduce );
+
+	//! Returns the number of worker threads.
+	size_t		getNumWorkers() const	{ return mWorkers.size(); }
+	//! Returns whether the calling thread is one of this scheduler's workers.
+	bool		isWorkerThread() const;
+
+  private:
+	struct Worker;
+
+	TaskScheduler( const Options &options );
+
+	void		schedule( const TaskRef &task );
+	// Schedules whichever of a completed task's \a dependents are now ready.
+	void		complete( std::vector<TaskRef> &dependents );
+	// Runs one queued task, preferring the calling worker's own, and returns false if there were none.
+	bool		runQueuedTask();
+	void		waitFor( const std::function<bool()> &done );
+	void		workerLoop( size_t index );
+	void		parallelForChunks( size_t numChunks, const std::function<void( size_t )> &runChunk );
+
+	std::vector<std::unique_ptr<Worker>>	mWorkers;
+	std::mutex								mInjectedMutex;
+	std::deque<TaskRef>						mInjected;			// tasks submitted from threads other than the workers, run oldest first
+	std::atomic<int>						mNumQueued;
+	std::atomic<bool>						mQuit;
+
+	// opaque here to keep ConcurrentQueue.h out of this header
+	struct Signals;
+	std::unique_ptr<Signals>				mSignals;
+
+	friend class Task;
+};
+
+template<typename Fn>
+void TaskScheduler::parallelFor( size_t begin, size_t end, size_t grainSize, const Fn &fn )
+{
+	if( end <= begin )
+		return;
+	grainSize = std::max<size_t>( grainSize, 1 );
+	const size_t numChunks = ( end - begin - 1 ) / grainSize + 1;
+	if( numChunks == 1 || mWorkers.empty() ) {
+		fn( begin, end );
+		return;
+	}
+
+	parallelForChunks( numChunks, [&]( size_t chunk ) {
+		size_t chunkBegin = begin + chunk * grainSize;
+		fn( chunkBegin, std::min( end - chunkBegin, grainSize ) + chunkBegin );
+	} );
+}
+
+template<typename T, typename MapFn, typename ReduceFn>
+T TaskScheduler::parallelReduce( size_t begin, size_t end, size_t grainSize, const T &identity, const MapFn &map, const ReduceFn &reduce )
+{
+	if( end <= begin )
+		return identity;
+	grainSize = std::max<size_t>( grainSize, 1 );
+	const size_t numChunks = ( end - begin - 1 ) / grainSize + 1;
+
+	std::vector<T> partials( numChunks, identity );
+	parallelFor( 0, numChunks, 1, [&]( size_t chunkBegin, size_t chunkEnd ) {
+		for( size_t chunk = chunkBegin; chunk < chunkEnd; ++chunk ) {
+			size_t rangeBegin = begin + chunk * grainSize;
+			partials[chunk] = map( rangeBegin, std::min( end - rangeBegin, grainSize ) + rangeBegin );
+		}
+	} );
+
+	T result = identity;
+	for( const auto &partial : partials )
+		result = reduce( result, partial );
+	return result;
+}
+
+} // namespace cinder
@@ -50,7 +50,7 @@ class Timer {
 	
   private:
 	bool	mIsStopped;
-#if defined( CINDER_COCOA )
+#if defined( CINDER_COCOA ) || defined( CINDER_LINUX )
 	double	mStartTime, mEndTime;
 #elif (defined( CINDER_MSW ) || defined( CINDER_WINRT ))
 	double				mStartTime, mEndTime, mInvNativeFreq;
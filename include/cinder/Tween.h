@@ -36,6 +36,8 @@ namespace cinder {
 
 class Timeline;
 typedef std::shared_ptr<Timeline>		TimelineRef;
+class TweenEngine;
+typedef std::shared_ptr<TweenEngine>	TweenEngineRef;
 
 template<typename T>
 class Tween;
@@ -298,7 +300,7 @@ class FnTweenRef : public TweenRef<T> {
 
 class AnimBase {
   public:
-  	//! removes self from Timeline
+  	//! removes self from Timeline or TweenEngine
 	void 	stop();
 
 	//! returns false if any tweens are active on 'this', otherwise true
@@ -306,6 +308,8 @@ class AnimBase {
 	
 	//! returns the parent timeline for the Anim<> or NULL if there is none
 	TimelineRef	getParent() const { return mParentTimeline; }
+	//! returns the parent TweenEngine for the Anim<> or NULL if there is none
+	TweenEngineRef	getParentEngine() const { return mParentEngine; }
 
   protected:
 	AnimBase( void *voidPtr ) : mVoidPtr( voidPtr ) {}
@@ -316,9 +320,13 @@ class AnimBase {
 	void 	setReplace( const AnimBase &rhs );
 	
 	void		setParentTimeline( TimelineRef parentTimeline );
+	void		setParentEngine( TweenEngineRef parentEngine );
 
 	void			*mVoidPtr;	
 	TimelineRef		mParentTimeline;
+	TweenEngineRef	mParentEngine;
+
+	friend class TweenEngine;
 };
 
 template<typename T>
@@ -351,12 +359,14 @@ class Anim : public AnimBase {
 	{
 		setReplace( rhs );
 		rhs.mParentTimeline.reset(); // blow away rhs's tweens due to move semantics
+		rhs.mParentEngine.reset();
 		mValue = rhs.mValue;
 	}
 	Anim<T>& operator=( Anim &&rhs ) { // move assignment
 		if( this != &rhs ) {
 			setReplace( rhs );
 			rhs.mParentTimeline.reset(); // blow away rhs's tweens due to move semantics
+			rhs.mParentEngine.reset();
 			mValue = rhs.mValue;
 		}
 		return *this;
@@ -373,6 +383,7 @@ class Anim : public AnimBase {
   protected:
 
 	friend class Timeline;
+	friend class TweenEngine;
 
 	T				mValue;
 };
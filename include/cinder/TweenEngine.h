@@ -0,0 +1,240 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Tween.h"
+#include "cinder/Color.h"
+#include "cinder/Vector.h"
+
+#include <vector>
+#include <unordered_map>
+#include <functional>
+
+namespace cinder {
+
+typedef std::shared_ptr<class TweenEngine>	TweenEngineRef;
+
+//! Easing equations which TweenEngine evaluates in batches. Each matches the function of the same name in Easing.h, using its default parameters.
+typedef enum {
+	EASE_NONE,
+	EASE_IN_QUAD, EASE_OUT_QUAD, EASE_IN_OUT_QUAD,
+	EASE_IN_CUBIC, EASE_OUT_CUBIC, EASE_IN_OUT_CUBIC,
+	EASE_IN_QUART, EASE_OUT_QUART, EASE_IN_OUT_QUART,
+	EASE_IN_QUINT, EASE_OUT_QUINT, EASE_IN_OUT_QUINT,
+	EASE_IN_SINE, EASE_OUT_SINE, EASE_IN_OUT_SINE,
+	EASE_IN_EXPO, EASE_OUT_EXPO, EASE_IN_OUT_EXPO,
+	EASE_IN_CIRC, EASE_OUT_CIRC, EASE_IN_OUT_CIRC,
+	EASE_IN_BACK, EASE_OUT_BACK, EASE_IN_OUT_BACK,
+	NUM_EASE_TYPES
+} EaseType;
+
+//! Evaluates \a ease for the \a count times in \a t, writing the results to \a result. Uses SSE2 where available.
+void	easeBatch( EaseType ease, const float *t, float *result, size_t count );
+
+//! Number of float components TweenEngine animates for each supported type
+template<typename T> struct TweenEngineComponents;
+template<> struct TweenEngineComponents<float>		{ static const int VALUE = 1; };
+template<> struct TweenEngineComponents<vec2>		{ static const int VALUE = 2; };
+template<> struct TweenEngineComponents<vec3>		{ static const int VALUE = 3; };
+template<> struct TweenEngineComponents<vec4>		{ static const int VALUE = 4; };
+template<> struct TweenEngineComponents<Colorf>		{ static const int VALUE = 3; };
+template<> struct TweenEngineComponents<ColorAf>	{ static const int VALUE = 4; };
+
+//! \brief Animates large numbers of float, vec and Color values, as an alternative to Timeline.
+//!
+//! Running tweens are stored as structures of arrays, one per combination of component count and EaseType, so every step evaluates
+//! each easing equation over a contiguous batch. Tweens which haven't started yet wait in a queue ordered by start time and aren't
+//! touched until they start, and completed tweens are removed by swapping with the last one. Easing is limited to the EaseType
+//! equations and interpolation is linear, in exchange for not calling std::functions or virtual methods per tween.
+//!
+//! Anim<T> targets are supported like Timeline's, so copying, moving or destroying an Anim updates its tweens. Time is expected to advance.
+class TweenEngine : public std::enable_shared_from_this<TweenEngine> {
+  public:
+	//! Identifies a tween. Ids are never reused, so one remains safe to pass to remove() after its tween completes.
+	typedef uint64_t Id;
+
+	struct Options {
+		Options() : mEase( EASE_NONE ), mDelay( 0 ), mLoop( false ) {}
+
+		//! Sets the easing equation. Defaults to \c EASE_NONE.
+		Options&	ease( EaseType ease )						{ mEase = ease; return *this; }
+		//! Delays the start of the tween by \a delay seconds
+		Options&	delay( float delay )						{ mDelay = delay; return *this; }
+		//! Restarts the tween whenever it completes, instead of removing it
+		Options&	loop( bool loop = true )					{ mLoop = loop; return *this; }
+		//! Sets a function to call after the step in which the tween completes
+		Options&	finishFn( const std::function<void ()> &fn )	{ mFinishFn = fn; return *this; }
+
+		EaseType				mEase;
+		float					mDelay;
+		bool					mLoop;
+		std::function<void ()>	mFinishFn;
+	};
+
+	static TweenEngineRef	create()	{ return TweenEngineRef( new TweenEngine ); }
+
+	//! Advances time by \a timestep and evaluates running tweens
+	void	step( float timestep )		{ stepTo( mCurrentTime + timestep ); }
+	//! Goes to \a absoluteTime, which should not be earlier than the current time, and evaluates running tweens
+	void	stepTo( float absoluteTime );
+	//! Returns the most recent time passed to stepTo()
+	float	getCurrentTime() const		{ return mCurrentTime; }
+
+	//! Replaces any existing tweens on \a target with a tween from its current value to \a endValue, starting at the current time
+	template<typename T>
+	Id	apply( Anim<T> *target, const T &endValue, float duration, const Options &options = Options() )
+	{
+		setParentOf( target );
+		return applyPtr( target->ptr(), endValue, duration, options );
+	}
+	//! Replaces any existing tweens on \a target with a tween from \a startValue to \a endValue, starting at the current time
+	template<typename T>
+	Id	apply( Anim<T> *target, const T &startValue, const T &endValue, float duration, const Options &options = Options() )
+	{
+		setParentOf( target );
+		return applyPtr( target->ptr(), startValue, endValue, duration, options );
+	}
+	//! Adds a tween to \a endValue which starts when the last tween on \a target ends, or at the current time if it has none
+	template<typename T>
+	Id	appendTo( Anim<T> *target, const T &endValue, float duration, const Options &options = Options() )
+	{
+		setParentOf( target );
+		return appendToPtr( target->ptr(), endValue, duration, options );
+	}
+
+	//! Replaces any existing tweens on \a target with a tween to \a endValue. Consider the Anim<T> variant, which removes the tweens when the Anim is destroyed.
+	template<typename T>
+	Id	applyPtr( T *target, const T &endValue, float duration, const Options &options = Options() )
+	{
+		static_assert( sizeof( T ) == TweenEngineComponents<T>::VALUE * sizeof( float ), "TweenEngine requires tightly packed float components" );
+		removeTarget( target );
+		return add( reinterpret_cast<float*>( target ), TweenEngineComponents<T>::VALUE, nullptr, reinterpret_cast<const float*>( &endValue ), mCurrentTime, duration, options );
+	}
+	template<typename T>
+	Id	applyPtr( T *target, const T &startValue, const T &endValue, float duration, const Options &options = Options() )
+	{
+		static_assert( sizeof( T ) == TweenEngineComponents<T>::VALUE * sizeof( float ), "TweenEngine requires tightly packed float components" );
+		removeTarget( target );
+		return add( reinterpret_cast<float*>( target ), TweenEngineComponents<T>::VALUE, reinterpret_cast<const float*>( &startValue ), reinterpret_cast<const float*>( &endValue ), mCurrentTime, duration, options );
+	}
+	template<typename T>
+	Id	appendToPtr( T *target, const T &endValue, float duration, const Options &options = Options() )
+	{
+		static_assert( sizeof( T ) == TweenEngineComponents<T>::VALUE * sizeof( float ), "TweenEngine requires tightly packed float components" );
+		return addAfter( reinterpret_cast<float*>( target ), TweenEngineComponents<T>::VALUE, reinterpret_cast<const float*>( &endValue ), duration, options );
+	}
+
+	//! Removes the tween \a id, leaving its target at its current value. Returns \c false if it had already completed or been removed.
+	bool	remove( Id id );
+	//! Removes every tween on \a target
+	void	removeTarget( void *target );
+	//! Returns whether \a id is waiting to start or running
+	bool	contains( Id id ) const;
+	//! Returns whether any tweens on \a target are waiting to start or running
+	bool	hasTarget( void *target ) const		{ return mTargets.find( target ) != mTargets.end(); }
+	//! Returns the time at which the last tween on \a target ends, or the current time if it has none
+	float	findEndTimeOf( void *target ) const;
+	//! Adds a copy of every tween on \a target, animating \a replacementTarget instead
+	void	cloneAndReplaceTarget( void *target, void *replacementTarget );
+	//! Moves every tween on \a target to \a replacementTarget
+	void	replaceTarget( void *target, void *replacementTarget );
+	//! Removes all tweens
+	void	clear();
+
+	//! Returns the number of tweens which are waiting to start or running
+	size_t	getNumTweens() const		{ return mNumPending + getNumRunning(); }
+	//! Returns the number of tweens which have started and not yet completed
+	size_t	getNumRunning() const;
+
+  protected:
+	TweenEngine();
+
+	//! Struct of arrays for the running tweens with one component count and EaseType
+	struct Track {
+		std::vector<float*>		mTargets;
+		std::vector<float>		mStart[4], mEnd[4];
+		std::vector<float>		mStartTime, mEndTime, mInvDuration;
+		std::vector<uint8_t>	mLoop;
+		std::vector<uint32_t>	mSlots;		// index into TweenEngine::mSlots of each tween
+	};
+
+	//! A tween which hasn't started, or a copy of one which has
+	struct TweenDesc {
+		float		*mTarget;
+		float		mStart[4], mEnd[4];
+		float		mStartTime, mDuration;
+		uint8_t		mNumComponents, mEase;
+		bool		mLoop, mCopyStartValue;
+	};
+
+	enum SlotState { SLOT_FREE, SLOT_PENDING, SLOT_RUNNING };
+
+	//! Where a tween lives. Indexed by the low 32 bits of its Id, while the high 32 bits must match mGeneration.
+	struct Slot {
+		uint32_t	mGeneration;
+		SlotState	mState;
+		uint32_t	mTrack;		// index into mTracks when running
+		uint32_t	mIndex;		// index within the Track when running
+		TweenDesc	mDesc;		// when pending
+	};
+
+	template<typename T>
+	void	setParentOf( Anim<T> *target )	{ target->setParentEngine( shared_from_this() ); }
+
+	Id		add( float *target, int numComponents, const float *startValue, const float *endValue, float startTime, float duration, const Options &options );
+	//! Adds a tween which starts from the end time and value of the last tween on \a target
+	Id		addAfter( float *target, int numComponents, const float *endValue, float duration, const Options &options );
+	Id		add( const TweenDesc &desc, const std::function<void ()> &finishFn );
+	void	start( uint32_t slotIndex );
+	//! Writes the end values of completed tweens and removes them, and rewinds looping ones
+	void	completeTrack( uint32_t trackIndex );
+	//! Evaluates every tween in a track and writes the results to their targets
+	void	evaluateTrack( uint32_t trackIndex );
+	//! Removes the running tween at \a index of track \a trackIndex by moving the last one into its place
+	void	removeRunning( uint32_t trackIndex, uint32_t index );
+	void	freeSlot( uint32_t slotIndex );
+	void	getDesc( uint32_t slotIndex, TweenDesc *result ) const;
+	//! Returns the slot of the tween on \a target which ends last, or -1 if there are none
+	int64_t	findLast( void *target ) const;
+	const Slot*	findSlot( Id id ) const;
+	Id		makeId( uint32_t slotIndex ) const	{ return ( uint64_t( mSlots[slotIndex].mGeneration ) << 32 ) | slotIndex; }
+
+	float								mCurrentTime;
+	std::vector<Track>					mTracks;		// NUM_EASE_TYPES * 4, indexed by ease * 4 + numComponents - 1
+	std::vector<Slot>					mSlots;
+	std::vector<uint32_t>				mFreeSlots;
+	//! min-heap of pending tweens by start time, with their Ids to skip removed ones
+	std::vector<std::pair<float, Id>>	mPending;
+	size_t								mNumPending;
+	std::unordered_multimap<void*, uint32_t>				mTargets;		// slots of the tweens on each target
+	std::unordered_map<uint32_t, std::function<void ()>>	mFinishFns;		// by slot
+
+	// scratch space for stepping
+	std::vector<float>					mTimes, mEased;
+	std::vector<uint32_t>				mCompleted;
+	std::vector<std::function<void ()>>	mFinishedFns;
+};
+
+} // namespace cinder
@@ -43,6 +43,8 @@ namespace rapidxml {
 
 namespace cinder {
 
+class XmlNodeView;
+
 class XmlTree {
   public:
 
@@ -229,6 +231,9 @@ class XmlTree {
 	//! Parses the XML contained in the string \a xmlString using the options \a parseOptions.
 	explicit XmlTree( const std::string &xmlString, ParseOptions parseOptions = ParseOptions() );
 
+	//! Copies \a node of an XmlDocument and its descendants, using the document's ParseOptions. A document node becomes a NODE_DOCUMENT with its DOCTYPE.
+	explicit XmlTree( const XmlNodeView &node );
+
 	//! Constructs an XML node with the tag \a tag, the value \a value. Optionally sets the pointer to the node's parent and sets the node type.
 	explicit XmlTree( const std::string &tag, const std::string &value, XmlTree *parent = 0, NodeType type = NODE_ELEMENT )
 		: mTag( tag ), mValue( value ), mParent( parent ), mNodeType( type )
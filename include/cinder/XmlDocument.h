@@ -0,0 +1,312 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Xml.h"
+#include "cinder/Noncopyable.h"
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+//! \cond
+namespace rapidxml {
+	template<class Ch> class xml_attribute;
+};
+//! \endcond
+
+namespace cinder {
+
+typedef std::shared_ptr<class XmlDocument>	XmlDocumentRef;
+
+//! A read-only string within an XmlDocument, which is null-terminated and points into the document's buffer. Must not outlive its document.
+class XmlStringView {
+  public:
+	XmlStringView() : mData( "" ), mSize( 0 ) {}
+	XmlStringView( const char *data, size_t size ) : mData( data ), mSize( size ) {}
+
+	const char*		data() const	{ return mData; }
+	const char*		c_str() const	{ return mData; }
+	size_t			size() const	{ return mSize; }
+	bool			empty() const	{ return mSize == 0; }
+	//! Returns a copy of the string
+	std::string		str() const		{ return std::string( mData, mSize ); }
+
+	//! Returns the string parsed as a T using ci::fromString()
+	template<typename T>
+	T				as() const		{ return fromString<T>( str() ); }
+
+	bool	equals( const char *str, size_t length ) const	{ return mSize == length && std::memcmp( mData, str, length ) == 0; }
+	//! Returns whether the string equals \a str, comparing ASCII characters without regard to case like XmlTree's path lookups
+	bool	equalsIgnoreCase( const char *str, size_t length ) const;
+
+	bool	operator==( const char *rhs ) const				{ return equals( rhs, std::strlen( rhs ) ); }
+	bool	operator==( const std::string &rhs ) const		{ return equals( rhs.data(), rhs.size() ); }
+	bool	operator!=( const char *rhs ) const				{ return ! ( *this == rhs ); }
+	bool	operator!=( const std::string &rhs ) const		{ return ! ( *this == rhs ); }
+
+  private:
+	const char	*mData;
+	size_t		mSize;
+};
+
+//! A read-only attribute of a node in an XmlDocument. Default-constructed and missing attributes are invalid.
+class XmlAttrView {
+  public:
+	XmlAttrView() : mAttr( nullptr ) {}
+
+	//! Returns whether the view refers to an attribute
+	explicit operator bool() const	{ return mAttr != nullptr; }
+
+	XmlStringView	getName() const;
+	XmlStringView	getValue() const;
+	//! Returns the node's next attribute, which is invalid after the last one
+	XmlAttrView		getNext() const;
+
+  private:
+	explicit XmlAttrView( rapidxml::xml_attribute<char> *attr ) : mAttr( attr ) {}
+
+	rapidxml::xml_attribute<char>	*mAttr;
+
+	friend class XmlNodeView;
+};
+
+class XmlPath;
+
+//! \brief A read-only node of an XmlDocument, which is the size of two pointers and is passed by value.
+//!
+//! Views only see the children an XmlTree parsed with the document's ParseOptions would have, and never copy tags, values or attributes.
+//! A default-constructed view, or the result of a query which doesn't match, is invalid. Must not outlive its document.
+class XmlNodeView {
+  public:
+	class Iter;
+
+	XmlNodeView() : mDocument( nullptr ), mNode( nullptr ) {}
+
+	//! Returns whether the view refers to a node
+	explicit operator bool() const		{ return mNode != nullptr; }
+
+	XmlTree::NodeType	getNodeType() const;
+	bool				isDocument() const	{ return getNodeType() == XmlTree::NODE_DOCUMENT; }
+	bool				isElement() const	{ return getNodeType() == XmlTree::NODE_ELEMENT; }
+
+	//! Returns the tag or name of the node
+	XmlStringView		getTag() const;
+	//! Returns the value of the node. Unlike XmlTree, CDATA is not appended to the value when the document collapses it.
+	XmlStringView		getValue() const;
+	//! Returns the value of the node parsed as a T using ci::fromString()
+	template<typename T>
+	T					getValue() const	{ return getValue().as<T>(); }
+
+	//! Returns the parent of the node, which is invalid for the document node
+	XmlNodeView			getParent() const;
+	//! Returns the first child of the node, or an invalid view if it has none
+	XmlNodeView			getFirstChild() const;
+	//! Returns the next sibling of the node, or an invalid view after the last child
+	XmlNodeView			getNextSibling() const;
+	//! Returns an iterator over the node's children
+	Iter				begin() const;
+	Iter				end() const;
+
+	//! Returns the node's first attribute, or an invalid view if it has none
+	XmlAttrView			getFirstAttribute() const;
+	//! Returns the attribute named \a attrName, or an invalid view if there is none. Names are compared case-sensitively, like XmlTree::getAttribute().
+	XmlAttrView			findAttribute( const std::string &attrName ) const;
+	bool				hasAttribute( const std::string &attrName ) const	{ return bool( findAttribute( attrName ) ); }
+	//! Returns the value of the attribute named \a attrName, which is empty if there is none
+	XmlStringView		getAttributeValue( const std::string &attrName ) const;
+	//! Returns the value of the attribute named \a attrName parsed as a T, or \a defaultValue if there is none or it fails to parse
+	template<typename T>
+	T					getAttributeValue( const std::string &attrName, const T &defaultValue ) const;
+
+	//! Returns the first child matching \a path, taking the first match at each level like XmlTree::getChild(), or an invalid view if none matches.
+	//! Throws XmlPathExc if \a path was compiled against another document.
+	XmlNodeView			findChild( const XmlPath &path ) const;
+	//! Compiles \a relativePath and returns the first child matching it. Use an XmlPath to repeat a query.
+	XmlNodeView			findChild( const std::string &relativePath, bool caseSensitive = false, char separator = '/' ) const;
+	//! Appends every descendant matching \a path to \a result in document order, the nodes an XmlTree::Iter with the same filter path visits
+	void				findAll( const XmlPath &path, std::vector<XmlNodeView> *result ) const;
+	std::vector<XmlNodeView>	findAll( const XmlPath &path ) const	{ std::vector<XmlNodeView> result; findAll( path, &result ); return result; }
+
+	//! Returns the document which owns the node
+	const XmlDocument*					getDocument() const		{ return mDocument; }
+	//! Returns the underlying RapidXML node
+	const rapidxml::xml_node<char>*		getRapidXmlNode() const	{ return mNode; }
+
+  private:
+	XmlNodeView( const XmlDocument *document, rapidxml::xml_node<char> *node ) : mDocument( node ? document : nullptr ), mNode( node ) {}
+
+	void	findAllFrom( const XmlPath &path, size_t component, std::vector<XmlNodeView> *result ) const;
+	//! Calls \a visit with each child of \a parent matching \a component of \a path in document order, until it returns \c false
+	template<typename VisitT>
+	static void	visitChildren( const XmlDocument *document, rapidxml::xml_node<char> *parent, const XmlPath &path, size_t component, VisitT visit );
+
+	const XmlDocument			*mDocument;
+	rapidxml::xml_node<char>	*mNode;
+
+	friend class XmlDocument;
+};
+
+//! A forward iterator over the children of an XmlNodeView
+class XmlNodeView::Iter {
+  public:
+	Iter() {}
+	explicit Iter( const XmlNodeView &node ) : mNode( node ) {}
+
+	const XmlNodeView&	operator*() const	{ return mNode; }
+	const XmlNodeView*	operator->() const	{ return &mNode; }
+	Iter&				operator++()		{ mNode = mNode.getNextSibling(); return *this; }
+	Iter				operator++( int )	{ Iter prev( *this ); ++(*this); return prev; }
+
+	bool	operator==( const Iter &rhs ) const	{ return mNode.mNode == rhs.mNode.mNode; }
+	bool	operator!=( const Iter &rhs ) const	{ return mNode.mNode != rhs.mNode.mNode; }
+
+  private:
+	XmlNodeView		mNode;
+};
+
+inline XmlNodeView::Iter XmlNodeView::begin() const
+{
+	return Iter( getFirstChild() );
+}
+
+inline XmlNodeView::Iter XmlNodeView::end() const
+{
+	return Iter();
+}
+
+//! \brief A relative path of tags compiled against an XmlDocument, which can be used to query any of its nodes.
+//!
+//! Tags are resolved to the document's interned names once, so children of indexed elements are looked up rather than compared with each tag.
+//! Follows XmlTree's conventions: a leading separator and empty components are ignored, and an empty path matches the node itself in
+//! XmlNodeView::findChild() and nothing in findAll().
+class XmlPath {
+  public:
+	XmlPath() : mDocument( nullptr ), mCaseSensitive( false ) {}
+
+	//! Returns the number of tags in the path
+	size_t			size() const		{ return mNameIds.size(); }
+	bool			empty() const		{ return mNameIds.empty(); }
+	bool			isCaseSensitive() const	{ return mCaseSensitive; }
+
+  private:
+	const XmlDocument			*mDocument;
+	std::vector<uint32_t>		mNameIds;
+	std::vector<std::string>	mTags;
+	bool						mCaseSensitive;
+
+	friend class XmlDocument;
+	friend class XmlNodeView;
+};
+
+//! \brief A read-only XML document which keeps RapidXML's in-situ parse rather than copying it into XmlTree nodes.
+//!
+//! The source is copied once into a buffer owned by the document and parsed in place, so tags, values and attributes are views into it.
+//! Path queries use an index by tag of the children of elements with many children, built the first time a path is compiled. Create an XmlTree from
+//! getRoot() or any other node when a mutable tree is needed. Parsing errors throw rapidxml::parse_error, as they do for XmlTree.
+class XmlDocument : private Noncopyable {
+  public:
+	//! Parses \a dataSource with \a parseOptions
+	static XmlDocumentRef	create( const DataSourceRef &dataSource, const XmlTree::ParseOptions &parseOptions = XmlTree::ParseOptions() );
+	//! Parses the XML in \a xmlString with \a parseOptions
+	static XmlDocumentRef	create( const std::string &xmlString, const XmlTree::ParseOptions &parseOptions = XmlTree::ParseOptions() );
+	~XmlDocument();
+
+	//! Returns the document node, whose children are the top-level nodes of the document
+	XmlNodeView		getRoot() const;
+	//! Returns the DOCTYPE of the document, which is empty if it has none
+	XmlStringView	getDocType() const;
+	const XmlTree::ParseOptions&	getParseOptions() const		{ return mParseOptions; }
+
+	//! Compiles \a relativePath for querying this document with XmlNodeView::findChild() and findAll(), building the document's index if necessary
+	XmlPath			compilePath( const std::string &relativePath, bool caseSensitive = false, char separator = '/' ) const;
+
+	//! Returns the underlying RapidXML document
+	const rapidxml::xml_document<char>*		getRapidXmlDoc() const	{ return mDoc.get(); }
+
+  protected:
+	XmlDocument( const XmlTree::ParseOptions &parseOptions );
+
+	void	parse( const char *data, size_t size );
+	void	buildIndex() const;
+	//! Sets \a result to the children of \a parent tagged with the interned name \a nameId, in document order. Returns \c false if \a parent isn't indexed.
+	bool	findIndexedChildren( const rapidxml::xml_node<char> *parent, uint32_t nameId, std::pair<rapidxml::xml_node<char>* const*, rapidxml::xml_node<char>* const*> *result ) const;
+
+	struct NameHash {
+		size_t operator()( const XmlStringView &name ) const;
+	};
+	struct NameEqual {
+		bool operator()( const XmlStringView &lhs, const XmlStringView &rhs ) const	{ return lhs.equalsIgnoreCase( rhs.data(), rhs.size() ); }
+	};
+	struct ChildKey {
+		const rapidxml::xml_node<char>	*mParent;
+		uint32_t						mNameId;
+
+		bool operator==( const ChildKey &rhs ) const	{ return mParent == rhs.mParent && mNameId == rhs.mNameId; }
+	};
+	struct ChildKeyHash {
+		size_t operator()( const ChildKey &key ) const	{ return std::hash<const void*>()( key.mParent ) ^ ( key.mNameId * 0x9E3779B9u ); }
+	};
+
+	XmlTree::ParseOptions						mParseOptions;
+	std::unique_ptr<char[]>						mBuffer;
+	std::unique_ptr<rapidxml::xml_document<char>>	mDoc;
+
+	// index of element children by case-folded tag, built on the first query. Elements with few children aren't indexed, since scanning them is as fast.
+	mutable std::once_flag												mIndexBuilt;
+	mutable std::unordered_map<XmlStringView, uint32_t, NameHash, NameEqual>	mNameIds;
+	mutable std::unordered_map<ChildKey, std::pair<uint32_t, uint32_t>, ChildKeyHash>	mChildRanges;
+	mutable std::vector<rapidxml::xml_node<char>*>						mIndexedChildren;
+	mutable std::unordered_set<const rapidxml::xml_node<char>*>				mIndexedParents;
+
+	friend class XmlNodeView;
+};
+
+//! Exception thrown when querying a node with an XmlPath compiled against a different XmlDocument
+class XmlPathExc : public Exception {
+  public:
+	XmlPathExc( const std::string &description )
+		: Exception( description )
+	{}
+};
+
+template<typename T>
+T XmlNodeView::getAttributeValue( const std::string &attrName, const T &defaultValue ) const
+{
+	XmlAttrView attr = findAttribute( attrName );
+	if( ! attr )
+		return defaultValue;
+	try {
+		return attr.getValue().as<T>();
+	}
+	catch( ... ) {
+		return defaultValue;
+	}
+}
+
+} // namespace cinder
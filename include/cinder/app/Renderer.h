@@ -99,6 +99,11 @@ class Renderer {
 	virtual HDC					getDc() { return NULL; }
 #elif defined( CINDER_WINRT )
 	virtual void setup( ::Platform::Agile<Windows::UI::Core::CoreWindow> wnd, RendererRef sharedRenderer ) = 0;
+#elif defined( CINDER_LINUX )
+	//! Headless setup; \a size is the size of the offscreen framebuffer which stands in for a window
+	virtual void setup( const ivec2 &size, RendererRef sharedRenderer ) = 0;
+	virtual void setFrameSize( int width, int height ) {}
+	virtual void kill() {}
 #endif
 
 	virtual Surface8u		copyWindowSurface( const Area &area, int32_t windowHeightPixels ) = 0;
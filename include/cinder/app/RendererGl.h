@@ -52,6 +52,7 @@ namespace cinder { namespace gl {
 
 class Context;
 typedef std::shared_ptr<Context>		ContextRef;
+typedef std::shared_ptr<class Fbo>		FboRef;
 
 } } // cinder::gl
 
@@ -181,6 +182,12 @@ class RendererGl : public Renderer {
 	void	setup( ::Platform::Agile<Windows::UI::Core::CoreWindow> wnd, RendererRef sharedRenderer ) override;
 	void	prepareToggleFullScreen();
 	void	finishToggleFullScreen();
+#elif defined( CINDER_LINUX )
+	void	setup( const ivec2 &size, RendererRef sharedRenderer ) override;
+	void	setFrameSize( int width, int height ) override;
+	void	kill() override;
+	//! Returns the offscreen Fbo which takes the place of the window's framebuffer
+	const gl::FboRef&	getFbo() const;
 #endif
 
 	const Options&	getOptions() const { return mOptions; }
@@ -218,6 +225,9 @@ protected:
 	class RendererImplGlAngle	*mImpl;
 	friend class				RendererImplGlAngle;
 	::Platform::Agile<Windows::UI::Core::CoreWindow>	mWnd;
+#elif defined( CINDER_LINUX )
+	class RendererImplGlHeadless	*mImpl;
+	friend class					RendererImplGlHeadless;
 #endif
 
 	std::function<void( Renderer* )> mStartDrawFn;
@@ -0,0 +1,154 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/app/RendererGl.h"
+#include "cinder/Timer.h"
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace cinder { namespace app {
+
+typedef std::shared_ptr<class AppHeadless>	AppHeadlessRef;
+
+//! Minimal runner for displayless Linux machines. Renders into the RendererGl's offscreen Fbo a fixed number of frames, as fast as possible, then exits. The frame count can be overridden with \c --frames \c N on the command line, and the framebuffer size with \c --size \c W \c H.
+class AppHeadless {
+  public:
+	class Settings {
+	  public:
+		Settings() : mFrameSize( 1920, 1080 ), mNumFrames( 1 ), mFixedTimestep( 0 ) {}
+
+		//! Sets the size of the offscreen framebuffer measured in pixels. Defaults to 1920x1080.
+		void	setWindowSize( int width, int height )		{ mFrameSize = ivec2( width, height ); }
+		//! Sets the size of the offscreen framebuffer measured in pixels. Defaults to 1920x1080.
+		void	setWindowSize( const ivec2 &size )			{ mFrameSize = size; }
+		ivec2	getWindowSize() const						{ return mFrameSize; }
+		//! Sets the number of frames to render before quitting. \c 0 renders until quit() is called. Defaults to \c 1.
+		void	setNumFrames( uint32_t numFrames )			{ mNumFrames = numFrames; }
+		uint32_t	getNumFrames() const					{ return mNumFrames; }
+		//! When non-zero, getElapsedSeconds() advances by \a seconds per frame rather than following the wall clock, which keeps offline renders deterministic. Defaults to \c 0.
+		void	setFixedTimestep( double seconds )			{ mFixedTimestep = seconds; }
+		double	getFixedTimestep() const					{ return mFixedTimestep; }
+
+		const std::vector<std::string>&	getCommandLineArgs() const	{ return mCommandLineArgs; }
+
+	  protected:
+		ivec2						mFrameSize;
+		uint32_t					mNumFrames;
+		double						mFixedTimestep;
+		std::vector<std::string>	mCommandLineArgs;
+
+		friend class AppHeadless;
+	};
+
+	typedef std::function<void( Settings *settings )>	SettingsFn;
+
+	AppHeadless();
+	virtual ~AppHeadless();
+
+	//! Override to perform any application setup after the GL context has been created
+	virtual void	setup() {}
+	//! Override to perform any once-per-frame updating
+	virtual void	update() {}
+	//! Override to perform any rendering once per frame, into the offscreen Fbo
+	virtual void	draw() {}
+	//! Override to cleanup any resources before the GL context is destroyed
+	virtual void	cleanup() {}
+
+	//! Stops the frame loop after the current frame
+	void			quit() { mShouldQuit = true; }
+
+	//! Returns the number of frames which have been rendered
+	uint32_t		getElapsedFrames() const { return mFrameCount; }
+	//! Returns the seconds since rendering began, or the frame count times the fixed timestep if one was set
+	double			getElapsedSeconds() const;
+	//! Returns the average frames per second since rendering began, measured against the wall clock
+	float			getAverageFps() const;
+	//! Returns the size of the offscreen framebuffer
+	ivec2			getWindowSize() const { return mSettings.getWindowSize(); }
+	int				getWindowWidth() const { return getWindowSize().x; }
+	int				getWindowHeight() const { return getWindowSize().y; }
+	Area			getWindowBounds() const { return Area( ivec2( 0 ), getWindowSize() ); }
+	//! Returns the renderer, whose getFbo() holds the current frame
+	RendererGlRef	getRenderer() const { return mRenderer; }
+	//! Returns a copy of the current frame, top-down
+	Surface8u		copyWindowSurface() { return mRenderer->copyWindowSurface( getWindowBounds(), getWindowHeight() ); }
+	const Settings&	getSettings() const { return mSettings; }
+	//! Returns the stream used for console output, which is \c std::cout
+	std::ostream&	console() { return std::cout; }
+
+	//! Returns the running AppHeadless instance
+	static AppHeadless*	get() { return sInstance; }
+
+	template<typename AppT>
+	static int		main( const RendererRef &defaultRenderer, const char *title, int argc, char * const argv[], const SettingsFn &settingsFn = SettingsFn() );
+
+  protected:
+	//! Applies command line overrides to \a settings and stashes them for the constructor of the app instance
+	static void		prepareLaunch( Settings *settings, const RendererRef &defaultRenderer, const char *title, int argc, char * const argv[] );
+	int				run();
+
+	static AppHeadless*	sInstance;
+	static Settings		sSettingsFromMain;
+	static RendererRef	sRendererFromMain;
+
+	Settings		mSettings;
+	RendererGlRef	mRenderer;
+	uint32_t		mFrameCount;
+	bool			mShouldQuit;
+	Timer			mTimer;
+};
+
+template<typename AppT>
+int AppHeadless::main( const RendererRef &defaultRenderer, const char *title, int argc, char * const argv[], const SettingsFn &settingsFn )
+{
+	Settings settings;
+	for( int arg = 0; arg < argc; ++arg )
+		settings.mCommandLineArgs.push_back( argv[arg] );
+	if( settingsFn )
+		settingsFn( &settings );
+
+	AppHeadless::prepareLaunch( &settings, defaultRenderer, title, argc, argv );
+	AppT app;
+	return app.run();
+}
+
+#define CINDER_APP_HEADLESS( APP, RENDERER, ... )										\
+int main( int argc, char* argv[] )														\
+{																						\
+	cinder::app::RendererRef renderer( new RENDERER );									\
+	return cinder::app::AppHeadless::main<APP>( renderer, #APP, argc, argv, ##__VA_ARGS__ );	\
+}
+
+//! Returns the size of the running AppHeadless's offscreen framebuffer
+inline ivec2	getWindowSize()			{ return AppHeadless::get()->getWindowSize(); }
+//! Returns the elapsed seconds of the running AppHeadless
+inline double	getElapsedSeconds()		{ return AppHeadless::get()->getElapsedSeconds(); }
+//! Returns the number of frames rendered by the running AppHeadless
+inline uint32_t	getElapsedFrames()		{ return AppHeadless::get()->getElapsedFrames(); }
+
+} } // namespace cinder::app
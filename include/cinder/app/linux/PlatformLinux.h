@@ -0,0 +1,64 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/app/Platform.h"
+#include "cinder/Display.h"
+
+namespace cinder { namespace app {
+
+//! Platform for displayless Linux machines, used by AppHeadless. There are no file dialogs, browsers or Displays; resources are loaded from a \c resources directory next to the executable.
+class PlatformLinux : public Platform {
+  public:
+	PlatformLinux();
+	static PlatformLinux*	get() { return reinterpret_cast<PlatformLinux*>( Platform::get() ); }
+
+	DataSourceRef	loadResource( const fs::path &resourcePath ) override;
+
+	fs::path getResourceDirectory() const override;
+	fs::path getResourcePath( const fs::path &rsrcRelativePath ) const override;
+
+	fs::path getOpenFilePath( const fs::path &/*initialPath*/, const std::vector<std::string> &/*extensions*/ ) override	{ return fs::path(); }
+	fs::path getFolderPath( const fs::path &/*initialPath*/ ) override													{ return fs::path(); }
+	fs::path getSaveFilePath( const fs::path &/*initialPath*/, const std::vector<std::string> &/*extensions*/ ) override	{ return fs::path(); }
+
+	std::map<std::string,std::string>	getEnvironmentVariables() override;
+
+	fs::path	expandPath( const fs::path &path ) override;
+	fs::path	getHomeDirectory() override;
+	fs::path	getDocumentsDirectory()	override;
+
+	void launchWebBrowser( const Url &/*url*/ ) override {}
+
+	void sleep( float milliseconds ) override;
+
+	std::vector<std::string>	stackTrace() override;
+
+	const std::vector<DisplayRef>&	getDisplays() override	{ return mDisplays; }
+
+  private:
+	std::vector<DisplayRef>		mDisplays;
+};
+
+} } // namespace cinder::app
@@ -0,0 +1,60 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/app/Renderer.h"
+#include "cinder/Vector.h"
+
+namespace cinder { namespace gl {
+	class Context;
+	typedef std::shared_ptr<Context>	ContextRef;
+	typedef std::shared_ptr<class Fbo>	FboRef;
+} }
+
+namespace cinder { namespace app {
+
+//! Renders into an offscreen Fbo through a surfaceless EGL (or OSMesa) context. The Fbo stands in for the window's default framebuffer.
+class RendererImplGlHeadless {
+ public:
+	RendererImplGlHeadless( class RendererGl *aRenderer );
+
+	bool	initialize( const ivec2 &size, RendererRef sharedRenderer );
+	void	kill();
+	void	setFrameSize( const ivec2 &size );
+	void	defaultResize() const;
+	void	swapBuffers() const;
+	void	makeCurrentContext( bool force = false );
+	void	bindDefaultFramebuffer();
+
+	ivec2				getSize() const { return mSize; }
+	const gl::FboRef&	getFbo() const { return mFbo; }
+
+ protected:
+	class RendererGl	*mRenderer;
+	gl::ContextRef		mCinderContext;
+	gl::FboRef			mFbo;
+	ivec2				mSize;
+};
+
+} } // namespace cinder::app
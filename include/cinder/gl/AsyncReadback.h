@@ -0,0 +1,147 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/gl/platform.h"
+
+#if ! defined( CINDER_GL_ES )
+
+#include "cinder/gl/Pbo.h"
+#include "cinder/gl/Sync.h"
+#include "cinder/gl/Fbo.h"
+#include "cinder/Surface.h"
+#include "cinder/ConcurrentCircularBuffer.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace cinder { namespace gl {
+
+typedef std::shared_ptr<class AsyncReadback>	AsyncReadbackRef;
+
+//! Reads back the contents of Fbos without stalling the GL pipeline. Each read is packed into one of a ring of PBOs guarded by a fence, and is delivered as a pooled Surface several frames later, once the GPU has finished with it.
+class AsyncReadback {
+  public:
+	struct Format {
+		//! Defaults to 3 PBOs, RGBA pixels flipped top-down on the GPU, delivered on a worker thread
+		Format() : mNumBuffers( 3 ), mBgra( false ), mFlipVertical( true ), mThreaded( true ), mMaxPooledSurfaces( 6 ) {}
+
+		//! Sets the number of PBOs in the ring, which is the latency in reads before a result is delivered. Defaults to \c 3.
+		Format&	numBuffers( size_t numBuffers ) { mNumBuffers = numBuffers; return *this; }
+		//! Packs pixels as BGRA rather than RGBA, which is the native ordering for most desktop drivers and image writers. Defaults to \c false.
+		Format&	bgra( bool bgra = true ) { mBgra = bgra; return *this; }
+		//! Flips rows on the GPU with a framebuffer blit so that results are top-down and the CPU never has to flip them. When disabled results are bottom-up as returned by glReadPixels(). Defaults to \c true.
+		Format&	flipVertical( bool flip = true ) { mFlipVertical = flip; return *this; }
+		//! Copies mapped PBOs into Surfaces and invokes the completion callback on a dedicated worker thread. Otherwise this happens inside update(). Defaults to \c true.
+		Format&	threaded( bool threaded = true ) { mThreaded = threaded; return *this; }
+		//! Sets the maximum number of released Surfaces whose memory is retained for reuse. Defaults to \c 6.
+		Format&	maxPooledSurfaces( size_t maxPooled ) { mMaxPooledSurfaces = maxPooled; return *this; }
+
+		size_t	getNumBuffers() const { return mNumBuffers; }
+		bool	isBgra() const { return mBgra; }
+		bool	isFlipVertical() const { return mFlipVertical; }
+		bool	isThreaded() const { return mThreaded; }
+		size_t	getMaxPooledSurfaces() const { return mMaxPooledSurfaces; }
+
+	  protected:
+		size_t		mNumBuffers;
+		bool		mBgra, mFlipVertical, mThreaded;
+		size_t		mMaxPooledSurfaces;
+	};
+
+	//! Signature of the completion callback, which receives the Surface and the id returned by the corresponding readPixels() call
+	typedef std::function<void( const Surface8uRef &surface, uint64_t readId )>	CompletionFn;
+
+	static AsyncReadbackRef	create( const Format &format = Format() );
+	~AsyncReadback();
+
+	//! Issues an asynchronous read of \a area (in Fbo coordinates, cropped to its bounds) from \a attachment of \a fbo. Returns an id which identifies the result. Blocks only if every PBO in the ring is still in flight.
+	uint64_t	readPixels( const FboRef &fbo, const Area &area, GLenum attachment = GL_COLOR_ATTACHMENT0 );
+	//! Issues an asynchronous read of the entirety of \a attachment of \a fbo. Returns an id which identifies the result.
+	uint64_t	readPixels( const FboRef &fbo, GLenum attachment = GL_COLOR_ATTACHMENT0 ) { return readPixels( fbo, fbo->getBounds(), attachment ); }
+
+	//! Polls the fences of reads in flight and dispatches any which have completed. Never blocks; must be called regularly (generally once per frame) on the thread which owns the GL context.
+	void		update();
+	//! Blocks until every read issued so far has been delivered. Must be called on the thread which owns the GL context.
+	void		flush();
+
+	//! Sets the callback which receives completed reads. Invoked on the worker thread when the Format is threaded, otherwise inside update(). When no callback is set results are queued for getNextSurface().
+	void		setCompletionFn( const CompletionFn &completionFn ) { mCompletionFn = completionFn; }
+	//! Pops the oldest completed read when no completion callback is set. Returns \c false if none is available.
+	bool		getNextSurface( Surface8uRef *result, uint64_t *readId = nullptr );
+
+	//! Returns the number of reads issued but not yet delivered
+	size_t		getNumPending() const;
+	//! Returns the Format of this AsyncReadback
+	const Format&	getFormat() const { return mFormat; }
+
+  protected:
+	AsyncReadback( const Format &format );
+
+	struct Slot {
+		enum State { EMPTY, PENDING, MAPPED };
+
+		Slot() : mState( EMPTY ), mMapped( nullptr ), mWidth( 0 ), mHeight( 0 ), mReadId( 0 ), mCopied( false ) {}
+
+		PboRef				mPbo;
+		SyncRef				mFence;
+		State				mState;
+		const uint8_t		*mMapped;
+		int32_t				mWidth, mHeight;
+		uint64_t			mReadId;
+		std::atomic<bool>	mCopied;
+	};
+
+	void			mapAndDispatch( Slot *slot );
+	void			retire( Slot *slot, bool block );
+	void			deliver( Slot *slot );
+	void			workerThreadFn();
+	Surface8uRef	acquireSurface( int32_t width, int32_t height );
+
+	struct SurfacePool;
+
+	Format							mFormat;
+	std::vector<std::unique_ptr<Slot>>	mSlots;
+	size_t							mWriteIndex, mReadIndex;
+	uint64_t						mNextReadId;
+	FboRef							mFlipFbo;
+
+	std::shared_ptr<SurfacePool>	mSurfacePool;
+	CompletionFn					mCompletionFn;
+
+	std::mutex						mCompletedMutex;
+	std::deque<std::pair<Surface8uRef, uint64_t>>	mCompleted;
+
+	std::unique_ptr<std::thread>	mWorkerThread;
+	ConcurrentCircularBuffer<Slot*>	mWorkQueue;
+	std::mutex						mCopiedMutex;
+	std::condition_variable			mCopiedCond;
+	std::atomic<bool>				mShouldQuit;
+};
+
+} } // namespace cinder::gl
+
+#endif // ! defined( CINDER_GL_ES )
@@ -65,6 +65,8 @@ class Batch {
 	const GlslProgRef&	getGlslProg() const	{ return mGlsl; }
 	//! Replaces the shader associated with the Batch. Issues a warning if not all attributes were able to match.
 	void			replaceGlslProg( const GlslProgRef& glsl );
+	//! Returns the mapping between geom::Attribs and GlslProg attribute names the Batch was created with
+	const AttributeMapping&	getAttributeMapping() const { return mAttribMapping; }
 	//! Returns the VAO mapping the Batch's geometry to its shader
 	const VaoRef	getVao() const { return mVao; }
 	//! Returns the VboMesh associated with the Batch
@@ -91,6 +93,8 @@ class Batch {
 };
 
 //! Cannot be shared across contexts
+//! When it owns its buffers, a VertBatch is retained: vertices are uploaded interleaved, only the range modified since the last draw is re-uploaded,
+//! and the VAO is rebuilt only when the attributes present or the bound GlslProg change, so drawing an unchanged VertBatch costs a single draw call.
 class VertBatch {
   public:
 	//! If \a useContextDefaultBuffers is \c true, uses default buffers for the context, saving allocations; suitable for single draw.
@@ -120,17 +124,37 @@ class VertBatch {
 	void	texCoord( const vec3 &t ) { texCoord( vec4( t.x, t.y, t.z, 1 ) ); }
 	void	texCoord( const vec4 &t );
 	
+	//! Replaces the position of vertex \a index, so that only the modified range is uploaded by the next draw()
+	void	setVertex( size_t index, const vec4 &v );
+	//! Replaces the normal of vertex \a index, which requires normals to have been specified
+	void	setNormal( size_t index, const vec3 &n );
+	//! Replaces the color of vertex \a index, which requires colors to have been specified
+	void	setColor( size_t index, const ColorAf &c );
+	//! Replaces the texture coordinate of vertex \a index, which requires texture coordinates to have been specified
+	void	setTexCoord( size_t index, const vec4 &t );
+
 	void	begin( GLenum type );
 	void	end();
+	//! Removes every vertex. A VertBatch which owns its buffers keeps its Vbo and VAO for reuse.
 	void	clear();
 
 	bool	empty() const { return mVertices.empty(); }
+	size_t	getNumVertices() const { return mVertices.size(); }
 	
 	void	draw();
 	
   protected:
+	//! Bits returned by getLayout() for the attributes present in addition to positions
+	enum { LAYOUT_NORMALS = 1, LAYOUT_COLORS = 2, LAYOUT_TEX_COORDS = 4 };
+
 	void	addVertex( const vec4 &v );
 	void	setupBuffers();
+	void	markDirty( size_t begin, size_t end );
+	int		getLayout() const;
+	//! Interleaves vertices \a begin through \a end into mInterleaved according to \a layout
+	void	interleave( int layout, size_t begin, size_t end );
+	//! Points the attributes of the current GlslProg at mVbo, interleaved according to \a layout
+	void	setupVertexAttribs( int layout );
 
 	GLenum					mPrimType;
 
@@ -144,6 +168,14 @@ class VertBatch {
 	Vao*					mVao;
 	VaoRef					mVaoStorage;
 	VboRef					mVbo;
+
+	// retained state, when mOwnsBuffers
+	std::vector<float>		mInterleaved;
+	size_t					mDirtyBegin, mDirtyEnd;
+	int						mUploadedLayout;
+	size_t					mUploadedCapacity;
+	const GlslProg*			mVaoGlsl;
+	GLuint					mVaoGlslHandle;
 };
 
 } } // namespace cinder::gl
\ No newline at end of file
@@ -44,6 +44,11 @@
 	#include "cinder/msw/CinderWindowsFwd.h"
 	struct HGLRC__;
 	typedef HGLRC__* HGLRC;
+#elif defined( CINDER_LINUX )
+	typedef void*		EGLContext;
+	typedef void*		EGLDisplay;
+	typedef void*		EGLConfig;
+	typedef struct osmesa_context	*OSMesaContext;
 #endif
 
 namespace cinder { namespace gl {
@@ -126,6 +131,30 @@ struct PlatformDataMsw : public Context::PlatformData {
 	HGLRC	mGlrc;
 	HDC		mDc;
 };
+
+#elif defined( CINDER_LINUX ) // headless surfaceless EGL, or OSMesa as a fallback
+struct PlatformDataLinux : public Context::PlatformData {
+	enum Backend { EGL, OSMESA };
+
+	PlatformDataLinux( EGLContext context, EGLDisplay display, EGLConfig eglConfig )
+		: mBackend( EGL ), mContext( context ), mDisplay( display ), mConfig( eglConfig ), mOsMesaContext( nullptr ), mMajorVersion( 0 ), mMinorVersion( 0 ), mCoreProfile( true )
+	{}
+	PlatformDataLinux( OSMesaContext osMesaContext )
+		: mBackend( OSMESA ), mContext( nullptr ), mDisplay( nullptr ), mConfig( nullptr ), mOsMesaContext( osMesaContext ), mMajorVersion( 0 ), mMinorVersion( 0 ), mCoreProfile( true )
+	{}
+
+	//! Creates a headless context of at least version \a majorVersion.\a minorVersion, preferring surfaceless EGL and falling back to OSMesa. Shares resources with \a sharedPlatformData when it is non-null. Throws ExcContextAllocation on failure.
+	static std::shared_ptr<PlatformDataLinux>	create( int majorVersion, int minorVersion, bool coreProfile, bool debug, const PlatformDataLinux *sharedPlatformData = nullptr );
+
+	Backend			mBackend;
+	EGLContext		mContext;
+	EGLDisplay		mDisplay;
+	EGLConfig		mConfig;
+	OSMesaContext	mOsMesaContext;
+	uint32_t		mOsMesaBuffer[1]; // OSMesa requires a color buffer to make a context current; all rendering goes to Fbos
+	int				mMajorVersion, mMinorVersion;
+	bool			mCoreProfile;
+};
 #endif
 
 } } // namespace cinder::gl
\ No newline at end of file
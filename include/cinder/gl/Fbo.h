@@ -268,6 +268,7 @@ class Fbo : public std::enable_shared_from_this<Fbo> {
 		std::map<GLenum,TextureBaseRef>		mAttachmentsTexture;
 
 		friend class Fbo;
+		friend class RenderTargetPool;
 	};
 
  protected:
@@ -0,0 +1,160 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/gl/platform.h"
+
+#if ! defined( CINDER_GL_ES_2 )
+
+#include "cinder/gl/Batch.h"
+#include "cinder/gl/Sync.h"
+#include "cinder/gl/Vbo.h"
+#include "cinder/CinderAssert.h"
+
+#include <functional>
+#include <map>
+
+namespace cinder { namespace gl {
+
+typedef std::shared_ptr<class InstanceBuffer>	InstanceBufferRef;
+
+//! Streams per-instance attributes, such as transforms and colors, to Batch::drawInstanced() without building and re-uploading a Vbo by hand.
+//! The attributes are interleaved in one Vbo divided into several buffers which are used in turn. map() waits on a fence until the GPU is done with the next buffer and maps it unsynchronized,
+//! so the driver never has to stall or copy, and the mapped memory can be filled from any number of threads. drawInstanced() binds the most recently unmapped buffer to a Batch with an instance divisor of \c 1.
+//! \code
+//! auto instances = gl::InstanceBuffer::create( 100000, gl::InstanceBuffer::Format().attrib( geom::CUSTOM_0, 16 ).attrib( geom::COLOR, 4, geom::UNORM8 ) );
+//! auto batch = gl::Batch::create( geom::Cube(), glsl, { { geom::CUSTOM_0, "iModelMatrix" } } );
+//! ...
+//! instances->fill( numInstances, [&]( uint32_t begin, uint32_t end ) {
+//!		auto matrices = instances->getMappedAttrib<mat4>( geom::CUSTOM_0 );
+//!		for( uint32_t i = begin; i < end; ++i )
+//!			matrices[i] = ...;
+//! } );
+//! instances->drawInstanced( batch );
+//! \endcode
+class InstanceBuffer {
+  public:
+	struct Format {
+		Format() : mNumBuffers( 2 ) {}
+
+		//! Adds a per-instance attribute of \a dims components stored as \a dataType. A \c mat4 has 16 dims.
+		Format&	attrib( geom::Attrib attrib, uint8_t dims, geom::DataType dataType = geom::FLOAT ) { mAttribs.push_back( geom::AttribInfo( attrib, dataType, dims, 0, 0, 1 ) ); return *this; }
+		//! Sets the number of buffers cycled through, each holding every instance. Defaults to \c 2.
+		Format&	numBuffers( int numBuffers ) { mNumBuffers = numBuffers; return *this; }
+		//! Sets the debugging label of the Vbo
+		Format&	label( const std::string &label ) { mLabel = label; return *this; }
+
+		const std::vector<geom::AttribInfo>&	getAttribs() const { return mAttribs; }
+		int										getNumBuffers() const { return mNumBuffers; }
+		const std::string&						getLabel() const { return mLabel; }
+
+	  private:
+		std::vector<geom::AttribInfo>	mAttribs;
+		int								mNumBuffers;
+		std::string						mLabel;
+	};
+
+	//! Strided access to one attribute of the mapped instances
+	template<typename T>
+	class MappedAttrib {
+	  public:
+		MappedAttrib( uint8_t *ptr, size_t stride ) : mPtr( ptr ), mStride( stride ) {}
+
+		T&	operator[]( size_t instance ) const { return *reinterpret_cast<T*>( mPtr + instance * mStride ); }
+
+	  private:
+		uint8_t		*mPtr;
+		size_t		mStride;
+	};
+
+	static InstanceBufferRef	create( uint32_t maxInstances, const Format &format );
+	~InstanceBuffer();
+
+	//! Waits until the GPU has finished drawing from the next buffer, then maps its first \a numInstances instances, at most getMaxInstances(), for writing. Their previous contents are undefined.
+	void	map( uint32_t numInstances );
+	//! Unmaps the buffer mapped by map(), making it the buffer used by drawInstanced()
+	void	unmap();
+	//! Returns whether map() has been called without a matching unmap()
+	bool	isMapped() const { return mMappedPtr != nullptr; }
+	//! Returns strided access to \a attrib of the mapped instances. \a T must be as large as the attribute, such as \c mat4 for 16 floats or \c uint32_t for 4 \c UNORM8s. Safe to call and write through from any thread while mapped.
+	template<typename T>
+	MappedAttrib<T>	getMappedAttrib( geom::Attrib attrib ) const;
+
+	//! Maps \a numInstances instances, calls \a fn with up to \a numThreads contiguous ranges of them on the shared TaskScheduler and the calling thread, and unmaps.
+	//! A \a numThreads of \c 0 uses one range per worker plus one. If \a fn throws, the buffer is unmapped without replacing the current instances and the exception is rethrown.
+	void	fill( uint32_t numInstances, const std::function<void( uint32_t begin, uint32_t end )> &fn, size_t numThreads = 0 );
+
+	//! Draws \a batch once for each instance written to the most recently unmapped buffer, with the per-instance attributes bound according to \a batch's attribute mapping.
+	//! A Batch is built internally for each buffer, sharing \a batch's VboMesh and GlslProg, and rebuilt if either is replaced.
+	void	drawInstanced( const BatchRef &batch );
+
+	//! Returns the number of instances in the most recently unmapped buffer
+	uint32_t	getNumInstances() const { return mNumInstances; }
+	uint32_t	getMaxInstances() const { return mMaxInstances; }
+	int			getNumBuffers() const { return mNumBuffers; }
+	//! Returns the number of bytes between consecutive instances
+	size_t		getStride() const { return mStride; }
+	//! Returns the Vbo holding every buffer, one after another
+	const VboRef&	getVbo() const { return mVbo; }
+	//! Returns the geom::BufferLayout of buffer \a bufferIndex within getVbo(), with an instance divisor of \c 1
+	geom::BufferLayout	getBufferLayout( int bufferIndex ) const;
+
+  protected:
+	InstanceBuffer( uint32_t maxInstances, const Format &format );
+
+	const geom::AttribInfo&	findAttrib( geom::Attrib attrib ) const;
+
+	struct InstancedBatch {
+		std::weak_ptr<Batch>	mSource;
+		VboMeshRef				mVboMesh;
+		GlslProgRef				mGlsl;
+		std::vector<BatchRef>	mBatches;
+	};
+
+	uint32_t						mMaxInstances;
+	int								mNumBuffers;
+	std::vector<geom::AttribInfo>	mAttribs;
+	size_t							mStride;
+
+	VboRef							mVbo;
+	std::vector<SyncRef>			mFences;
+	int								mCurrentBuffer, mMappedBuffer;
+	uint8_t							*mMappedPtr;
+	uint32_t						mNumInstances, mNumMappedInstances;
+
+	std::map<const Batch*,InstancedBatch>	mInstancedBatches;
+};
+
+template<typename T>
+InstanceBuffer::MappedAttrib<T> InstanceBuffer::getMappedAttrib( geom::Attrib attrib ) const
+{
+	CI_ASSERT_MSG( mMappedPtr, "getMappedAttrib() requires the InstanceBuffer to be mapped" );
+	const geom::AttribInfo &info = findAttrib( attrib );
+	CI_ASSERT( sizeof( T ) == info.getByteSize() );
+	return MappedAttrib<T>( mMappedPtr + info.getOffset(), mStride );
+}
+
+} } // namespace cinder::gl
+
+#endif // ! defined( CINDER_GL_ES_2 )
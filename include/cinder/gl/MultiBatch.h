@@ -0,0 +1,146 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "cinder/gl/platform.h"
+
+#if ! defined( CINDER_GL_ES )
+
+#include "cinder/gl/Batch.h"
+#include "cinder/gl/BufferTexture.h"
+#include "cinder/gl/wrapper.h"
+
+#include <string>
+#include <vector>
+
+namespace cinder { namespace gl {
+
+typedef std::shared_ptr<class MultiBatch>	MultiBatchRef;
+
+//! Draws many VboMeshes which share a vertex layout with a single VAO, shader bind and (when available) a single glMultiDrawElementsIndirect() call.
+//! Vertex and index data are packed on the GPU into shared buffers. Each draw has a transform and material id, stored in a buffer texture and addressed by the vertex shader through the \c ciDrawId attribute; see getGlslDeclarations().
+//! Falls back to a loop of glDrawElementsBaseVertex() when multi-draw-indirect is unavailable, such as on OS X.
+class MultiBatch {
+  public:
+	typedef Batch::AttributeMapping	AttributeMapping;
+
+	struct Format {
+		Format() : mDrawDataTextureUnit( 8 ), mForceFallback( false ) {}
+
+		//! Sets the texture unit the per-draw data buffer texture is bound to while drawing. Defaults to \c 8, to stay out of the way of material textures.
+		Format&	drawDataTextureUnit( uint8_t unit ) { mDrawDataTextureUnit = unit; return *this; }
+		//! Forces the glDrawElementsBaseVertex() loop even when multi-draw-indirect is supported. Primarily useful for testing. Defaults to \c false.
+		Format&	forceFallback( bool force = true ) { mForceFallback = force; return *this; }
+
+		uint8_t	getDrawDataTextureUnit() const { return mDrawDataTextureUnit; }
+		bool	getForceFallback() const { return mForceFallback; }
+
+	  protected:
+		uint8_t		mDrawDataTextureUnit;
+		bool		mForceFallback;
+	};
+
+	//! Packs \a meshes into shared buffers, one draw per mesh in order. Every mesh must have the same primitive and the same vertex buffer layouts. Throws MultiBatchExc otherwise.
+	static MultiBatchRef	create( const std::vector<VboMeshRef> &meshes, const GlslProgRef &glsl, const Format &format = Format(), const AttributeMapping &attributeMapping = AttributeMapping() );
+
+	//! Issues every visible draw.
+	void			draw();
+
+	//! Returns the number of draws, which is the number of meshes the MultiBatch was created with
+	size_t			getNumDraws() const { return mDraws.size(); }
+	//! Sets the model transform of draw \a drawIndex, returned by \c ciDrawTransform() in the vertex shader
+	void			setTransform( size_t drawIndex, const mat4 &transform );
+	//! Returns the model transform of draw \a drawIndex
+	const mat4&		getTransform( size_t drawIndex ) const { return mDrawData[drawIndex].mTransform; }
+	//! Sets the material id of draw \a drawIndex, returned by \c ciDrawMaterialId() in the vertex shader
+	void			setMaterialId( size_t drawIndex, uint32_t materialId );
+	//! Returns the material id of draw \a drawIndex
+	uint32_t		getMaterialId( size_t drawIndex ) const { return (uint32_t)mDrawData[drawIndex].mData.x; }
+	//! Hides or shows draw \a drawIndex without repacking any geometry
+	void			setVisible( size_t drawIndex, bool visible );
+	//! Returns whether draw \a drawIndex is visible
+	bool			isVisible( size_t drawIndex ) const { return mDraws[drawIndex].mVisible; }
+
+	//! Returns whether draws are submitted with glMultiDrawElementsIndirect() rather than the glDrawElementsBaseVertex() fallback
+	bool			isMultiDrawIndirect() const { return mMultiDrawIndirect; }
+	//! Returns the VboMesh holding the packed geometry of all draws
+	const VboMeshRef&	getVboMesh() const { return mVboMesh; }
+	//! Returns the VAO mapping the packed geometry to the shader
+	const VaoRef&	getVao() const { return mVao; }
+	//! Returns the shader associated with the MultiBatch
+	const GlslProgRef&	getGlslProg() const { return mGlsl; }
+	//! Returns the buffer texture holding the per-draw transforms and material ids
+	const BufferTextureRef&	getDrawDataTexture() const { return mDrawDataTexture; }
+
+	//! Returns GLSL declarations for the vertex shader: the \c ciDrawId attribute, the \c ciDrawData sampler and the \c ciDrawTransform() and \c ciDrawMaterialId() functions. Requires GLSL 1.50 or later.
+	static std::string	getGlslDeclarations();
+
+  protected:
+	MultiBatch( const std::vector<VboMeshRef> &meshes, const GlslProgRef &glsl, const Format &format, const AttributeMapping &attributeMapping );
+
+	void	packMeshes( const std::vector<VboMeshRef> &meshes );
+	void	initVao( const AttributeMapping &attributeMapping );
+	void	updateBuffers();
+
+	// layout matches DrawElementsIndirectCommand
+	struct Draw {
+		GLuint		mCount;
+		GLuint		mFirstIndex;
+		GLint		mBaseVertex;
+		bool		mVisible;
+	};
+
+	// five texels per draw; the layout is mirrored by getGlslDeclarations()
+	struct DrawData {
+		mat4		mTransform;
+		vec4		mData; // x is the material id
+	};
+
+	Format					mFormat;
+	GlslProgRef				mGlsl;
+	VboMeshRef				mVboMesh;
+	VaoRef					mVao;
+	bool					mMultiDrawIndirect;
+
+	std::vector<Draw>		mDraws;
+	std::vector<DrawData>	mDrawData;
+	size_t					mDirtyDrawDataBegin, mDirtyDrawDataEnd;
+	bool					mCommandsDirty;
+	GLsizei					mNumVisibleCommands;
+
+	VboRef					mDrawIdVbo;
+	VboRef					mIndirectBuffer;
+	BufferTextureRef		mDrawDataTexture;
+	GLint					mDrawIdLocation, mDrawDataLocation;
+};
+
+class MultiBatchExc : public Exception {
+  public:
+	MultiBatchExc( const std::string &description ) : Exception( description ) {}
+};
+
+} } // namespace cinder::gl
+
+#endif // ! defined( CINDER_GL_ES )
@@ -0,0 +1,198 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/gl/platform.h"
+
+#if ! defined( CINDER_GL_ES_2 )
+
+#include "cinder/gl/Batch.h"
+#include "cinder/gl/GlslProg.h"
+#include "cinder/gl/Vao.h"
+#include "cinder/gl/Vbo.h"
+#include "cinder/Color.h"
+
+namespace cinder { namespace gl {
+
+typedef std::shared_ptr<class ParticleSystem>	ParticleSystemRef;
+
+//! Simulates particles entirely on the GPU by running an update shader over one of a pair of Vbos and capturing the result into the other with transform feedback.
+//! Particles are emitted by advancing a write cursor around the buffers as a ring, are integrated under built-in gravity, drag, noise and attractor forces plus an optional GLSL snippet,
+//! and die when their age reaches their lifetime. The CPU only ever sets uniforms; per-particle data is never read back or uploaded.
+//!
+//! Particles are exposed to draw shaders as the attributes <tt>vec4 ciParticlePosition</tt> (xyz, age in \c w), <tt>vec4 ciParticleVelocity</tt> (xyz, lifetime in \c w),
+//! <tt>vec4 ciParticleColor</tt> and, with Format::customData(), <tt>vec4 ciParticleData</tt>. A particle is alive while <tt>ciParticlePosition.w < ciParticleVelocity.w</tt>.
+class ParticleSystem {
+  public:
+	static const int MAX_ATTRACTORS = 4;
+
+	//! Describes how newly emitted particles are initialized
+	struct Emitter {
+		Emitter() : mPosition( 0 ), mRadius( 0 ), mVelocity( 0 ), mVelocitySpread( 0 ), mLifetimeMin( 1 ), mLifetimeMax( 1 ), mColor( 1, 1, 1, 1 ) {}
+
+		//! Sets the center of the emission volume. Defaults to the origin.
+		Emitter&	position( const vec3 &position ) { mPosition = position; return *this; }
+		//! Sets the radius of the sphere particles are emitted within. Defaults to \c 0.
+		Emitter&	radius( float radius ) { mRadius = radius; return *this; }
+		//! Sets the initial velocity of particles. Defaults to zero.
+		Emitter&	velocity( const vec3 &velocity ) { mVelocity = velocity; return *this; }
+		//! Sets the radius of the sphere a random offset to the initial velocity is chosen within. Defaults to \c 0.
+		Emitter&	velocitySpread( float spread ) { mVelocitySpread = spread; return *this; }
+		//! Sets the range lifetimes in seconds are chosen from. Defaults to \c 1.
+		Emitter&	lifetime( float minSeconds, float maxSeconds ) { mLifetimeMin = minSeconds; mLifetimeMax = maxSeconds; return *this; }
+		//! Sets the initial color of particles. Defaults to white.
+		Emitter&	color( const ColorA &color ) { mColor = color; return *this; }
+
+		const vec3&		getPosition() const { return mPosition; }
+		float			getRadius() const { return mRadius; }
+		const vec3&		getVelocity() const { return mVelocity; }
+		float			getVelocitySpread() const { return mVelocitySpread; }
+		float			getLifetimeMin() const { return mLifetimeMin; }
+		float			getLifetimeMax() const { return mLifetimeMax; }
+		const ColorA&	getColor() const { return mColor; }
+
+	  private:
+		vec3	mPosition;
+		float	mRadius;
+		vec3	mVelocity;
+		float	mVelocitySpread;
+		float	mLifetimeMin, mLifetimeMax;
+		ColorA	mColor;
+	};
+
+	struct Format {
+		Format() : mMaxParticles( 1024 * 1024 ), mCustomData( false ), mOverwriteLive( false ) {}
+
+		//! Sets the capacity of the system, which is allocated twice on the GPU. Defaults to \c 1M.
+		Format&	maxParticles( uint32_t maxParticles ) { mMaxParticles = maxParticles; return *this; }
+		//! Adds a <tt>vec4 data</tt> member to each particle, initialized to zero and available to the snippets and to draw shaders as \c ciParticleData. Defaults to \c false.
+		Format&	customData( bool enable = true ) { mCustomData = enable; return *this; }
+		//! Sets whether emission may reuse slots whose particles are still alive, stealing the oldest particles once the system is full. Otherwise only dead particles are recycled and emission is dropped while the system is full. Defaults to \c false.
+		Format&	overwriteLive( bool enable = true ) { mOverwriteLive = enable; return *this; }
+		//! Sets GLSL declarations, such as uniforms and functions, which are visible to the update and emit snippets
+		Format&	declarations( const std::string &glsl ) { mDeclarations = glsl; return *this; }
+		//! Sets GLSL run for each live particle after the built-in forces are applied to its velocity and before it is integrated. The snippet can modify <tt>Particle p</tt>, whose members are
+		//! \c position, \c age, \c velocity, \c lifetime, \c color and \c data, read the time step \c dt and draw random numbers with <tt>ciRandom( seed )</tt>. Setting \c p.age to \c p.lifetime kills the particle.
+		Format&	updateSnippet( const std::string &glsl ) { mUpdateSnippet = glsl; return *this; }
+		//! Sets GLSL run for each newly emitted particle after the Emitter has initialized <tt>Particle p</tt>, with the same variables as the update snippet
+		Format&	emitSnippet( const std::string &glsl ) { mEmitSnippet = glsl; return *this; }
+		//! Sets the debugging label of the Vbos and update GlslProg
+		Format&	label( const std::string &label ) { mLabel = label; return *this; }
+
+		uint32_t			getMaxParticles() const { return mMaxParticles; }
+		bool				isCustomDataEnabled() const { return mCustomData; }
+		bool				isOverwriteLiveEnabled() const { return mOverwriteLive; }
+		const std::string&	getDeclarations() const { return mDeclarations; }
+		const std::string&	getUpdateSnippet() const { return mUpdateSnippet; }
+		const std::string&	getEmitSnippet() const { return mEmitSnippet; }
+		const std::string&	getLabel() const { return mLabel; }
+
+	  private:
+		uint32_t		mMaxParticles;
+		bool			mCustomData, mOverwriteLive;
+		std::string		mDeclarations, mUpdateSnippet, mEmitSnippet;
+		std::string		mLabel;
+	};
+
+	//! Creates a system whose particles are all dead. Throws GlslProgCompileExc if the snippets fail to compile.
+	static ParticleSystemRef	create( const Format &format = Format() );
+
+	//! Queues \a count particles to be emitted by the next update()
+	void	emit( uint32_t count ) { mNumPendingEmission += count; }
+	//! Sets a continuous emission rate in particles per second, which is accumulated by update(). Defaults to \c 0.
+	void	setEmissionRate( float particlesPerSecond ) { mEmissionRate = particlesPerSecond; }
+	float	getEmissionRate() const { return mEmissionRate; }
+	//! Sets how the particles emitted by subsequent calls to update() are initialized
+	void			setEmitter( const Emitter &emitter ) { mEmitter = emitter; }
+	const Emitter&	getEmitter() const { return mEmitter; }
+
+	//! Sets a constant acceleration applied to every particle. Defaults to zero.
+	void	setGravity( const vec3 &gravity ) { mGravity = gravity; }
+	//! Sets the rate at which velocity decays, so that it is scaled by <tt>exp( -drag * dt )</tt> each update. Defaults to \c 0.
+	void	setDrag( float drag ) { mDrag = drag; }
+	//! Sets an acceleration drawn from 3D simplex noise of the particle's position scaled by \a frequency, scrolling through the noise at \a speed per second. Disabled when \a amplitude is \c 0, which is the default.
+	void	setNoise( float amplitude, float frequency = 1, float speed = 0 ) { mNoise = vec3( amplitude, frequency, speed ); }
+	//! Sets attractor \a index, less than \c MAX_ATTRACTORS, to pull particles towards \a position with an inverse-square falloff. A negative \a strength repels. A \a strength of \c 0 disables it, which is the default.
+	void	setAttractor( int index, const vec3 &position, float strength );
+
+	//! Runs the update shader over every particle, emitting any queued particles, and swaps the buffers
+	void	update( float deltaTime );
+	//! Kills every particle and clears any queued emission
+	void	clear();
+
+	//! Draws the particles as points with \a glsl, which receives the particle attributes described above, or with a built-in shader that draws live particles in their color when \a glsl is null
+	void	draw( const GlslProgRef &glsl = GlslProgRef() );
+	//! Sets the mesh drawn for each particle by drawInstanced(). \a glsl receives the mesh's attributes and, per instance, the particle attributes described above, and should collapse dead particles, for example by scaling them to zero.
+	void	setInstanceMesh( const VboMeshRef &mesh, const GlslProgRef &glsl );
+	//! Draws the mesh set by setInstanceMesh() once for every particle slot with Batch::drawInstanced()
+	void	drawInstanced();
+
+	uint32_t	getMaxParticles() const { return mMaxParticles; }
+	//! Returns the seconds accumulated by update(), which is available to the snippets as \c ciParticleTime
+	float		getTime() const { return mTime; }
+	//! Returns the GlslProg which runs the update, for setting uniforms declared with Format::declarations()
+	const GlslProgRef&	getUpdateGlsl() const { return mUpdateGlsl; }
+	//! Returns the Vbo holding the particles as of the last update(), interleaved as position, velocity, color and optionally data, each a \c vec4
+	const VboRef&		getVbo() const { return mVbos[mSourceIndex]; }
+	//! Returns the geom::BufferLayout of getVbo(), mapping the particle attributes to geom::CUSTOM_0 through geom::CUSTOM_3 with \a instanceDivisor
+	geom::BufferLayout	getBufferLayout( uint32_t instanceDivisor = 0 ) const;
+	//! Returns the Batch::AttributeMapping from geom::CUSTOM_0 through geom::CUSTOM_3 to the particle attribute names
+	static Batch::AttributeMapping	getAttributeMapping();
+
+  protected:
+	ParticleSystem( const Format &format );
+
+	//! Runs the update shader with \a emitCount particles emitted from the cursor, or kills every particle when \a reset is \c true
+	void	runUpdate( float deltaTime, uint32_t emitCount, bool reset );
+
+	uint32_t		mMaxParticles;
+	bool			mCustomData, mOverwriteLive;
+	size_t			mStride;
+
+	VboRef			mVbos[2];
+	VaoRef			mUpdateVaos[2];
+	GlslProgRef		mUpdateGlsl;
+	int				mSourceIndex;
+
+	BatchRef		mPointBatches[2];
+	GlslProgRef		mPointGlsl;
+	BatchRef		mInstanceBatches[2];
+
+	Emitter			mEmitter;
+	uint32_t		mEmitCursor;
+	uint32_t		mNumPendingEmission;
+	float			mEmissionRate, mEmissionRemainder;
+
+	vec3			mGravity;
+	float			mDrag;
+	vec3			mNoise;
+	vec4			mAttractors[MAX_ATTRACTORS];
+
+	float			mTime;
+	uint32_t		mFrame;
+};
+
+} } // namespace cinder::gl
+
+#endif // ! defined( CINDER_GL_ES_2 )
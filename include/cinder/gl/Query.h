@@ -26,8 +26,10 @@
 
 #include "cinder/gl/platform.h"
 #include "cinder/Exception.h"
+#include "cinder/Profiler.h"
 
 #include <array>
+#include <vector>
 
 namespace cinder { namespace gl {
 
@@ -107,6 +109,29 @@ class QueryTimeSwapped {
 	bool					mIsStopped;
 	size_t					mSwapIndex;
 };
+
+typedef std::shared_ptr<class ProfilerGpuTimer> ProfilerGpuTimerRef;
+
+//! Implements Profiler::GpuTimer with a pool of GL_TIMESTAMP queries, which unlike GL_TIME_ELAPSED queries can nest. Must be created and used with the same context current.
+class ProfilerGpuTimer : public Profiler::GpuTimer {
+  public:
+	static ProfilerGpuTimerRef create();
+	~ProfilerGpuTimer();
+
+	uint32_t	issueTimestamp() override;
+	bool		getTimestamp( uint32_t handle, uint64_t *resultNanoseconds ) override;
+	void		releaseTimestamp( uint32_t handle ) override;
+	bool		getCurrentTime( uint64_t *resultNanoseconds ) override;
+
+	//! Returns the number of query objects allocated, which levels off at the number of timestamps in flight
+	size_t		getNumQueries() const { return mQueries.size(); }
+
+  private:
+	ProfilerGpuTimer() {}
+
+	std::vector<GLuint>		mQueries;
+	std::vector<uint32_t>	mFreeHandles;
+};
 	
 class QueryException : public Exception {
   public:
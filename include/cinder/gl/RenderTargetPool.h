@@ -0,0 +1,130 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/gl/Fbo.h"
+#include "cinder/gl/Texture.h"
+#include "cinder/gl/wrapper.h"
+
+#include <memory>
+#include <vector>
+
+namespace cinder { namespace gl {
+
+typedef std::shared_ptr<class RenderTargetPool>	RenderTargetPoolRef;
+
+//! Recycles transient Fbos and Texture2ds, such as the intermediate targets of a post-processing chain. Targets are handed out from a free list when their size and format match a previous request,
+//! return to the pool automatically when the last reference to them is released, and are destroyed once they've gone unused for a number of frames. Pooled targets retain their previous contents.
+class RenderTargetPool : public std::enable_shared_from_this<RenderTargetPool> {
+  public:
+	struct Format {
+		//! Defaults to destroying free targets after 3 unused frames
+		Format() : mMaxUnusedFrames( 3 ) {}
+
+		//! Sets the number of calls to endFrame() a free target survives without being acquired before it's destroyed. Defaults to \c 3.
+		Format&		maxUnusedFrames( uint32_t frames ) { mMaxUnusedFrames = frames; return *this; }
+		uint32_t	getMaxUnusedFrames() const { return mMaxUnusedFrames; }
+
+	  protected:
+		uint32_t	mMaxUnusedFrames;
+	};
+
+	static RenderTargetPoolRef	create( const Format &format = Format() );
+
+	//! Returns an Fbo of \a size created with \a format, reusing a free one when possible. The Fbo returns to the pool when the result and every copy of it are released. Fbo::Formats with explicit attachments are not supported.
+	FboRef			acquireFbo( const ivec2 &size, const Fbo::Format &format = Fbo::Format() );
+	//! Returns a Texture2d of \a size created with \a format, reusing a free one when possible. The Texture2d returns to the pool when the result and every copy of it are released.
+	Texture2dRef	acquireTexture( const ivec2 &size, const Texture2d::Format &format = Texture2d::Format() );
+
+	//! Ages the free targets and destroys those which have been unused for longer than Format::maxUnusedFrames(). Should be called once per frame.
+	void		endFrame();
+	//! Destroys every free target immediately. Targets in use are unaffected.
+	void		clear();
+
+	//! Returns the number of targets owned by the pool, both free and in use
+	size_t		getNumTargets() const { return mEntries.size(); }
+	//! Returns the number of targets currently handed out
+	size_t		getNumTargetsInUse() const;
+	//! Returns the estimated GPU memory in bytes of every target owned by the pool, both free and in use
+	size_t		getNumBytes() const;
+	//! Returns the estimated GPU memory in bytes of the targets currently handed out
+	size_t		getNumBytesInUse() const;
+	//! Returns the number of Fbos and Texture2ds the pool has created since it was constructed. Constant in steady state.
+	size_t		getNumAllocations() const { return mNumAllocations; }
+
+	const Format&	getFormat() const { return mFormat; }
+
+  protected:
+	RenderTargetPool( const Format &format );
+
+	// the subset of a Texture::Format which affects whether a texture can be reused
+	struct TextureKey {
+		TextureKey() : mTarget( 0 ), mInternalFormat( 0 ), mMipmapping( false ), mMinFilter( 0 ), mMagFilter( 0 ), mWrapS( 0 ), mWrapT( 0 ), mCompareMode( 0 ) {}
+		TextureKey( const TextureBase::Format &format );
+
+		bool operator==( const TextureKey &rhs ) const;
+
+		GLenum	mTarget;
+		GLint	mInternalFormat;
+		bool	mMipmapping;
+		GLenum	mMinFilter, mMagFilter, mWrapS, mWrapT, mCompareMode;
+	};
+
+	struct Key {
+		Key() : mIsFbo( false ), mColorTexture( false ), mDepthTexture( false ), mDepthBuffer( false ), mStencilBuffer( false ), mDepthBufferInternalFormat( 0 ), mSamples( 0 ), mCoverageSamples( 0 ) {}
+
+		bool operator==( const Key &rhs ) const;
+
+		ivec2		mSize;
+		bool		mIsFbo;
+		TextureKey	mColorTextureKey, mDepthTextureKey;
+		bool		mColorTexture, mDepthTexture, mDepthBuffer, mStencilBuffer;
+		GLint		mDepthBufferInternalFormat;
+		int			mSamples, mCoverageSamples;
+	};
+
+	struct Entry {
+		Key				mKey;
+		FboRef			mFbo;
+		Texture2dRef	mTexture;
+		size_t			mNumBytes;
+		bool			mInUse;
+		uint32_t		mLastUsedFrame;
+	};
+
+	Entry*		findFree( const Key &key );
+	void		markFree( Entry *entry );
+
+	Format			mFormat;
+	std::vector<std::unique_ptr<Entry>>	mEntries;
+	uint32_t		mFrameCount;
+	size_t			mNumAllocations;
+};
+
+class RenderTargetPoolExc : public Exception {
+  public:
+	RenderTargetPoolExc( const std::string &description ) : Exception( description ) {}
+};
+
+} } // namespace cinder::gl
@@ -366,6 +366,11 @@ class TextureData {
 	void	mapDataStore();
 	void	unmapDataStore();
 
+	//! Points the data store at \a size bytes of memory the caller keeps alive, such as a memory-mapped file. The parsers then record each Level's \c offset into that memory rather than copying pixel data.
+	void	setExternalDataStore( const void *data, size_t size );
+	//! Returns whether the data store refers to external memory set with setExternalDataStore()
+	bool	hasExternalDataStore() const { return mExternalDataStore != nullptr; }
+
   private:
 	void		init();
 	
@@ -382,6 +387,7 @@ class TextureData {
 	void*						mPboMappedPtr;
   #endif
 	std::unique_ptr<uint8_t[]>	mDataStoreMem;
+	const uint8_t*				mExternalDataStore;
 	size_t						mDataStoreSize;
 };
 
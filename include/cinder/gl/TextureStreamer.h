@@ -0,0 +1,103 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/gl/platform.h"
+
+#if ! defined( CINDER_GL_ES_2 )
+
+#include "cinder/gl/Texture.h"
+#include "cinder/MemoryMappedFile.h"
+
+namespace cinder { namespace gl {
+
+typedef std::shared_ptr<class TextureStreamer>	TextureStreamerRef;
+
+//! Streams the mip levels of a KTX or DDS file into a Texture2d straight from a memory-mapped copy of the file, without reading it into an intermediate buffer.
+//! The coarsest levels are uploaded at creation so that the texture is usable immediately, and each call to update() uploads finer levels under a byte budget, lowering the texture's base level as each one completes.
+class TextureStreamer {
+  public:
+	struct Format {
+		//! Defaults to a 4MB budget per update() and 256KB at creation
+		Format() : mUploadBudget( 4 * 1024 * 1024 ), mInitialBudget( 256 * 1024 ) {}
+
+		//! Sets the maximum number of bytes uploaded by each call to update(). At least one row of blocks is always uploaded so that streaming makes progress. Defaults to \c 4MB.
+		Format&	uploadBudget( size_t bytes ) { mUploadBudget = bytes; return *this; }
+		//! Sets the number of bytes of the coarsest levels uploaded at creation. The smallest level is always uploaded. Defaults to \c 256KB.
+		Format&	initialBudget( size_t bytes ) { mInitialBudget = bytes; return *this; }
+		//! Sets the wrap, filtering, anisotropy, swizzle and label of the Texture. Mipmapped min filtering is enabled when the file has more than one level unless a mipmapped min filter is specified.
+		Format&	textureFormat( const Texture2d::Format &format ) { mTextureFormat = format; return *this; }
+
+		size_t						getUploadBudget() const { return mUploadBudget; }
+		size_t						getInitialBudget() const { return mInitialBudget; }
+		const Texture2d::Format&	getTextureFormat() const { return mTextureFormat; }
+
+	  private:
+		size_t				mUploadBudget, mInitialBudget;
+		Texture2d::Format	mTextureFormat;
+	};
+
+	//! Maps the KTX file at \a path and uploads its coarsest levels. Throws KtxParseExc or MemoryMappedFileExc on failure.
+	static TextureStreamerRef	createFromKtx( const fs::path &path, const Format &format = Format() );
+#if ! defined( CINDER_GL_ES ) || defined( CINDER_GL_ANGLE )
+	//! Maps the DDS file at \a path and uploads its coarsest levels. Throws DdsParseExc or MemoryMappedFileExc on failure.
+	static TextureStreamerRef	createFromDds( const fs::path &path, const Format &format = Format() );
+#endif
+
+	//! Uploads up to the upload budget of the remaining levels. Returns \c true once every level is resident, at which point the file is unmapped.
+	bool	update();
+	//! Uploads every remaining level regardless of the budget
+	void	finish();
+
+	//! Returns the Texture, which is valid and samples the finest resident level from the moment the TextureStreamer is created
+	const Texture2dRef&	getTexture() const { return mTexture; }
+	//! Returns whether every level has been uploaded
+	bool	isComplete() const { return mResidentLevel == 0; }
+	//! Returns the finest mip level that has been fully uploaded, which is the Texture's \c GL_TEXTURE_BASE_LEVEL
+	int		getResidentLevel() const { return mResidentLevel; }
+	//! Returns the number of mip levels in the file
+	int		getNumLevels() const { return (int)mTextureData.getNumLevels(); }
+	//! Returns the number of bytes of level data uploaded so far
+	size_t	getNumBytesUploaded() const { return mNumBytesUploaded; }
+	//! Returns the number of bytes of level data in the file
+	size_t	getNumBytesTotal() const { return mNumBytesTotal; }
+
+  protected:
+	TextureStreamer( const fs::path &path, bool dds, const Format &format );
+
+	//! Uploads up to \a budget bytes of rows of the level above mResidentLevel, starting at mNextRow. Uploads a single row regardless of the budget when \a atLeastOneRow is \c true. Returns the number of bytes uploaded.
+	size_t	uploadRows( size_t budget, bool atLeastOneRow );
+
+	MemoryMappedFileRef	mFile;
+	TextureData			mTextureData;
+	Texture2dRef		mTexture;
+	int					mResidentLevel;
+	int					mNextRow;
+	size_t				mUploadBudget;
+	size_t				mNumBytesUploaded, mNumBytesTotal;
+};
+
+} } // namespace cinder::gl
+
+#endif // ! defined( CINDER_GL_ES_2 )
@@ -0,0 +1,126 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/gl/Fbo.h"
+#include "cinder/Camera.h"
+#include "cinder/ImageIo.h"
+#include "cinder/Surface.h"
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+namespace cinder { namespace gl {
+
+#if ! defined( CINDER_GL_ES )
+typedef std::shared_ptr<class AsyncReadback>	AsyncReadbackRef;
+#endif
+
+//! Renders images larger than the GL's maximum framebuffer size by drawing the scene once per tile into an Fbo with a frustum narrowed to that tile.
+//! Each tile is read back asynchronously while the next one renders, and rows are either assembled into a Surface or, after setOutput(), streamed to an image file a row of tiles at a time so that the whole image never needs to be in memory.
+//! \code
+//! gl::TileRender tr( 20000, 12000 );
+//! tr.setOutput( getHomeDirectory() / "poster.png" );
+//! tr.setMatrices( cam );
+//! while( tr.nextTile() )
+//!		drawScene();
+//! \endcode
+class TileRender {
+  public:
+	TileRender( int32_t imageWidth, int32_t imageHeight, int32_t tileWidth = 512, int32_t tileHeight = 512, const Fbo::Format &fboFormat = Fbo::Format() );
+	~TileRender();
+
+	//! Streams the image to \a path as rows of tiles complete instead of assembling it into a Surface. PNGs are written incrementally by ImageTargetFilePngStream; other extensions go through the registered ImageTarget, which may buffer the image. Must be called before the first nextTile().
+	void	setOutput( const fs::path &path, ImageTarget::Options options = ImageTarget::Options(), bool alpha = false );
+	//! Streams the image to \a imageTarget, which must accept rows in order, top to bottom. Must be called before the first nextTile().
+	void	setOutput( const ImageTargetRef &imageTarget );
+	//! Returns an ImageSource describing the output, for creating an ImageTarget to pass to setOutput()
+	ImageSourceRef	getImageSource( bool alpha = false ) const;
+
+	//! Binds the Fbo and matrices for the next tile and returns \c true, or finishes the image and returns \c false once every tile has been rendered. The scene should be drawn once after every call which returns \c true.
+	bool	nextTile();
+
+	int32_t	getImageWidth() const { return mImageWidth; }
+	int32_t	getImageHeight() const { return mImageHeight; }
+	ivec2	getImageSize() const { return ivec2( mImageWidth, mImageHeight ); }
+	int32_t	getNumTiles() const { return mNumTilesX * mNumTilesY; }
+	//! Returns the index of the tile being rendered, or \c -1 outside of the nextTile() loop
+	int32_t	getCurrentTile() const { return mCurrentTile; }
+	//! Returns the bounds of the tile being rendered in image coordinates, with the origin in the upper-left
+	Area	getCurrentTileArea() const;
+
+	//! Uses the view and frustum of \a camera
+	void	setMatrices( const CameraPersp &camera );
+	//! Uses the view and frustum of \a camera
+	void	setMatrices( const CameraOrtho &camera );
+	//! Uses window coordinates of \a windowWidth x \a windowHeight stretched over the image, as gl::setMatricesWindow() does
+	void	setMatricesWindow( int32_t windowWidth, int32_t windowHeight, bool originUpperLeft = true );
+	//! Uses perspective window coordinates of \a windowWidth x \a windowHeight stretched over the image, as gl::setMatricesWindowPersp() does
+	void	setMatricesWindowPersp( int32_t windowWidth, int32_t windowHeight, float fovDegrees = 60.0f, float nearPlane = 1.0f, float farPlane = 1000.0f, bool originUpperLeft = true );
+	//! Uses a perspective frustum and an identity view matrix
+	void	frustum( float left, float right, float bottom, float top, float nearPlane, float farPlane );
+	//! Uses an orthographic frustum and an identity view matrix
+	void	ortho( float left, float right, float bottom, float top, float nearPlane, float farPlane );
+
+	//! Returns the assembled image once nextTile() has returned \c false. Empty when setOutput() was used.
+	Surface8u	getSurface() const { return mSurface; }
+
+  protected:
+	class OutputSource;
+
+	void	beginTile();
+	void	endTile();
+	void	finish();
+	void	setFrustum( float left, float right, float bottom, float top, float nearPlane, float farPlane, bool perspective );
+	void	updateMatrices();
+	void	tileReceived( const Surface8u &tile );
+
+	int32_t			mImageWidth, mImageHeight;
+	int32_t			mTileWidth, mTileHeight;
+	int32_t			mNumTilesX, mNumTilesY;
+	int32_t			mCurrentTile;
+
+	FboRef			mFbo;
+#if ! defined( CINDER_GL_ES )
+	AsyncReadbackRef	mReadback;
+#endif
+
+	float			mFrustumLeft, mFrustumRight, mFrustumTop, mFrustumBottom, mNearClip, mFarClip;
+	bool			mPerspective;
+	mat4			mViewMatrix;
+
+	Surface8u						mSurface;
+	Surface8u						mBand;
+	ImageTargetRef					mImageTarget;
+	std::shared_ptr<OutputSource>	mOutputSource;
+
+	// tiles are received on the AsyncReadback's worker thread
+	std::mutex						mReceivedMutex;
+	std::condition_variable			mReceivedCond;
+	int32_t							mNumTilesReceived;
+	std::exception_ptr				mError;
+};
+
+} } // namespace cinder::gl
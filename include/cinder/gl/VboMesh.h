@@ -56,6 +56,8 @@ class VboMesh {
 		GLenum		getUsage() const { return mUsage; }
 		//! Appends an attribute of semantic \a attrib which is \a dims-dimensional. Replaces AttribInfo if it exists for \a attrib
 		Layout&		attrib( geom::Attrib attrib, uint8_t dims );
+		//! Appends an attribute of semantic \a attrib which is \a dims-dimensional, stored as \a dataType. Packed types such as geom::HALF_FLOAT or geom::SNORM_10_10_10_2 reduce memory and bandwidth. Replaces AttribInfo if it exists for \a attrib
+		Layout&		attrib( geom::Attrib attrib, uint8_t dims, geom::DataType dataType );
 		//! Appends an attribute using a geom::AttribInfo. Replaces AttribInfo if it exists for \a attribInfo.getAttrib()
 		Layout&		attrib( const geom::AttribInfo &attribInfo );
 
@@ -24,7 +24,9 @@
 #include "cinder/Buffer.h"
 #include "cinder/DataSource.h"
 #include "cinder/DataTarget.h"
+#include "cinder/CompressedStream.h"
 #include <zlib.h>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -106,7 +108,7 @@ void Buffer::resize( size_t newSize )
 		mData = realloc( mData, newSize );
 	else {
 		void *newData = malloc( newSize );
-		memcpy( newData, mData, mDataSize );
+		memcpy( newData, mData, std::min( mDataSize, newSize ) );
 		mData = newData;
 		mOwnsData = true;
 	}
@@ -147,6 +149,9 @@ Buffer compressBuffer( const Buffer &buffer, int8_t compressionLevel, bool resiz
 
 Buffer decompressBuffer( const Buffer &buffer, bool resizeResult, bool useGZip )
 {
+	if( isBufferBlockCompressed( buffer ) )
+		return decompressBufferBlocks( buffer );
+
 	int err;
 	z_stream strm;
 
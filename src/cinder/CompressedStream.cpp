@@ -0,0 +1,554 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/CompressedStream.h"
+#include "cinder/TaskScheduler.h"
+
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+using namespace std;
+
+namespace cinder {
+
+// Layout, with every integer little-endian and every offset relative to the start of the header:
+//	header:	"CIZB", uint32 version, uint32 block size
+//	blocks:	uint32 uncompressed size, uint32 compressed size, zlib stream; every block but the last holds exactly the block size
+//	end:	two zero uint32s
+//	index:	uint64 offset of each block
+//	footer:	uint64 uncompressed size, uint64 offset of the index, uint32 number of blocks, "CIZE"
+namespace {
+
+const char		HEADER_MAGIC[4] = { 'C', 'I', 'Z', 'B' };
+const char		FOOTER_MAGIC[4] = { 'C', 'I', 'Z', 'E' };
+const uint32_t	VERSION = 1;
+const size_t	HEADER_SIZE = 12;
+const size_t	BLOCK_HEADER_SIZE = 8;
+const size_t	FOOTER_SIZE = 24;
+const size_t	MAX_BLOCK_SIZE = 256 * 1024 * 1024;
+
+template<typename T>
+T load( const uint8_t *data )
+{
+	T result;
+	memcpy( &result, data, sizeof(T) );
+	return result;
+}
+
+template<typename T>
+void store( uint8_t *data, T value )
+{
+	memcpy( data, &value, sizeof(T) );
+}
+
+size_t clampBlockSize( size_t blockSize )
+{
+	return std::min( std::max<size_t>( blockSize, 1 ), MAX_BLOCK_SIZE );
+}
+
+int resolveNumThreads( int numThreads )
+{
+	if( numThreads > 0 )
+		return numThreads;
+	return static_cast<int>( TaskScheduler::get()->getNumWorkers() + 1 );
+}
+
+// Calls fn( i ) for every i below count on the shared TaskScheduler, with at most numThreads running at once. The first exception thrown is rethrown here.
+void parallelFor( size_t count, int numThreads, const function<void( size_t )> &fn )
+{
+	// fewer chunks than the scheduler has threads caps how many run at once
+	size_t grainSize = numThreads > 0 ? ( count + numThreads - 1 ) / numThreads : 1;
+	TaskScheduler::get()->parallelFor( 0, count, grainSize, [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i )
+			fn( i );
+	} );
+}
+
+void compressBlock( const uint8_t *data, size_t size, int8_t compressionLevel, vector<uint8_t> *result )
+{
+	uLongf compressedSize = compressBound( static_cast<uLong>( size ) );
+	result->resize( BLOCK_HEADER_SIZE + compressedSize );
+	if( compress2( result->data() + BLOCK_HEADER_SIZE, &compressedSize, data, static_cast<uLong>( size ), compressionLevel ) != Z_OK )
+		throw CompressedStreamExc( "zlib failed to compress a block" );
+
+	result->resize( BLOCK_HEADER_SIZE + compressedSize );
+	store<uint32_t>( result->data(), static_cast<uint32_t>( size ) );
+	store<uint32_t>( result->data() + 4, static_cast<uint32_t>( compressedSize ) );
+}
+
+void decompressBlock( const uint8_t *compressed, size_t compressedSize, uint8_t *dest, size_t size )
+{
+	uLongf destSize = static_cast<uLongf>( size );
+	if( uncompress( dest, &destSize, compressed, static_cast<uLong>( compressedSize ) ) != Z_OK || destSize != size )
+		throw CompressedStreamExc( "corrupt compressed block" );
+}
+
+void writeHeader( uint8_t *data, size_t blockSize )
+{
+	memcpy( data, HEADER_MAGIC, 4 );
+	store<uint32_t>( data + 4, VERSION );
+	store<uint32_t>( data + 8, static_cast<uint32_t>( blockSize ) );
+}
+
+// Returns the block size
+size_t readHeader( const uint8_t *data )
+{
+	if( memcmp( data, HEADER_MAGIC, 4 ) != 0 )
+		throw CompressedStreamExc( "not block-compressed data" );
+	if( load<uint32_t>( data + 4 ) != VERSION )
+		throw CompressedStreamExc( "unsupported block-compressed version" );
+	size_t blockSize = load<uint32_t>( data + 8 );
+	if( blockSize == 0 || blockSize > MAX_BLOCK_SIZE )
+		throw CompressedStreamExc( "invalid block size" );
+	return blockSize;
+}
+
+void writeFooter( uint8_t *data, uint64_t uncompressedSize, uint64_t indexOffset, uint32_t numBlocks )
+{
+	store<uint64_t>( data, uncompressedSize );
+	store<uint64_t>( data + 8, indexOffset );
+	store<uint32_t>( data + 16, numBlocks );
+	memcpy( data + 20, FOOTER_MAGIC, 4 );
+}
+
+void readFooter( const uint8_t *data, uint64_t *uncompressedSize, uint64_t *indexOffset, uint32_t *numBlocks )
+{
+	if( memcmp( data + 20, FOOTER_MAGIC, 4 ) != 0 )
+		throw CompressedStreamExc( "missing block index" );
+	*uncompressedSize = load<uint64_t>( data );
+	*indexOffset = load<uint64_t>( data + 8 );
+	*numBlocks = load<uint32_t>( data + 16 );
+}
+
+// Whether numBlocks blocks of blockSize bytes hold exactly uncompressedSize bytes. The products can't overflow, as blockSize is at most MAX_BLOCK_SIZE.
+bool isBlockCountValid( uint64_t uncompressedSize, size_t blockSize, uint32_t numBlocks )
+{
+	if( numBlocks == 0 )
+		return uncompressedSize == 0;
+	return uncompressedSize <= (uint64_t)numBlocks * blockSize && uncompressedSize > (uint64_t)( numBlocks - 1 ) * blockSize;
+}
+
+// A view of a whole block-compressed Buffer, validated against its size
+struct BlockView {
+	BlockView( const Buffer &buffer )
+	{
+		mData = static_cast<const uint8_t*>( buffer.getData() );
+		mSize = buffer.getSize();
+		if( mSize < HEADER_SIZE + BLOCK_HEADER_SIZE + FOOTER_SIZE )
+			throw CompressedStreamExc( "not block-compressed data" );
+		mBlockSize = readHeader( mData );
+
+		uint64_t indexOffset;
+		uint32_t numBlocks;
+		readFooter( mData + mSize - FOOTER_SIZE, &mUncompressedSize, &indexOffset, &numBlocks );
+		// compared by subtraction, so that a corrupt footer can't wrap around
+		if( numBlocks > ( mSize - FOOTER_SIZE ) / sizeof(uint64_t) || indexOffset != mSize - FOOTER_SIZE - numBlocks * sizeof(uint64_t)
+			|| ! isBlockCountValid( mUncompressedSize, mBlockSize, numBlocks ) )
+			throw CompressedStreamExc( "corrupt block index" );
+		mIndex = mData + indexOffset;
+		mNumBlocks = numBlocks;
+	}
+
+	// Decompresses all of block \a i into \a dest, which must hold getBlockSize( i ) bytes
+	void decompress( size_t i, uint8_t *dest ) const
+	{
+		uint64_t offset = load<uint64_t>( mIndex + i * sizeof(uint64_t) );
+		if( offset > mSize - BLOCK_HEADER_SIZE )
+			throw CompressedStreamExc( "corrupt block index" );
+		size_t size = load<uint32_t>( mData + offset ), compressedSize = load<uint32_t>( mData + offset + 4 );
+		if( size != getBlockSize( i ) || compressedSize > mSize - BLOCK_HEADER_SIZE - offset )
+			throw CompressedStreamExc( "corrupt block index" );
+		decompressBlock( mData + offset + BLOCK_HEADER_SIZE, compressedSize, dest, size );
+	}
+
+	size_t getBlockSize( size_t i ) const	{ return static_cast<size_t>( std::min<uint64_t>( mBlockSize, mUncompressedSize - i * mBlockSize ) ); }
+
+	const uint8_t	*mData, *mIndex;
+	size_t			mSize, mBlockSize, mNumBlocks;
+	uint64_t		mUncompressedSize;
+};
+
+} // anonymous namespace
+
+Buffer compressBufferBlocks( const Buffer &buffer, const BlockCompressionOptions &options )
+{
+	const uint8_t *data = static_cast<const uint8_t*>( buffer.getData() );
+	const size_t blockSize = clampBlockSize( options.getBlockSize() );
+	const size_t numBlocks = ( buffer.getSize() + blockSize - 1 ) / blockSize;
+	if( numBlocks > numeric_limits<uint32_t>::max() )
+		throw CompressedStreamExc( "too many blocks" );
+
+	vector<vector<uint8_t>> blocks( numBlocks );
+	parallelFor( numBlocks, options.getNumThreads(), [&]( size_t i ) {
+		size_t offset = i * blockSize;
+		compressBlock( data + offset, std::min( blockSize, buffer.getSize() - offset ), options.getCompressionLevel(), &blocks[i] );
+	} );
+
+	size_t resultSize = HEADER_SIZE + BLOCK_HEADER_SIZE + numBlocks * sizeof(uint64_t) + FOOTER_SIZE;
+	for( const auto &block : blocks )
+		resultSize += block.size();
+
+	Buffer result( resultSize );
+	uint8_t *out = static_cast<uint8_t*>( result.getData() );
+	writeHeader( out, blockSize );
+	size_t offset = HEADER_SIZE;
+	vector<uint64_t> blockOffsets( numBlocks );
+	for( size_t i = 0; i < numBlocks; ++i ) {
+		blockOffsets[i] = offset;
+		memcpy( out + offset, blocks[i].data(), blocks[i].size() );
+		offset += blocks[i].size();
+	}
+	memset( out + offset, 0, BLOCK_HEADER_SIZE );
+	offset += BLOCK_HEADER_SIZE;
+	uint64_t indexOffset = offset;
+	if( numBlocks )
+		memcpy( out + offset, blockOffsets.data(), numBlocks * sizeof(uint64_t) );
+	offset += numBlocks * sizeof(uint64_t);
+	writeFooter( out + offset, buffer.getSize(), indexOffset, static_cast<uint32_t>( numBlocks ) );
+
+	return result;
+}
+
+Buffer decompressBufferBlocks( const Buffer &buffer, int numThreads )
+{
+	BlockView view( buffer );
+	Buffer result( static_cast<size_t>( view.mUncompressedSize ) );
+	uint8_t *out = static_cast<uint8_t*>( result.getData() );
+	parallelFor( view.mNumBlocks, numThreads, [&]( size_t i ) {
+		view.decompress( i, out + i * view.mBlockSize );
+	} );
+
+	return result;
+}
+
+size_t decompressBufferBlocks( const Buffer &buffer, size_t offset, void *dest, size_t size, int numThreads )
+{
+	BlockView view( buffer );
+	if( offset >= view.mUncompressedSize )
+		return 0;
+	size = static_cast<size_t>( std::min<uint64_t>( size, view.mUncompressedSize - offset ) );
+	if( size == 0 )
+		return 0;
+
+	uint8_t *out = static_cast<uint8_t*>( dest );
+	const size_t firstBlock = offset / view.mBlockSize, lastBlock = ( offset + size - 1 ) / view.mBlockSize;
+	parallelFor( lastBlock - firstBlock + 1, numThreads, [&]( size_t i ) {
+		size_t block = firstBlock + i, blockStart = block * view.mBlockSize, blockSize = view.getBlockSize( block );
+		size_t begin = std::max( offset, blockStart ), end = std::min( offset + size, blockStart + blockSize );
+		// blocks wholly inside the range decompress straight into dest
+		if( begin == blockStart && end == blockStart + blockSize )
+			view.decompress( block, out + ( blockStart - offset ) );
+		else {
+			vector<uint8_t> temp( blockSize );
+			view.decompress( block, temp.data() );
+			memcpy( out + ( begin - offset ), temp.data() + ( begin - blockStart ), end - begin );
+		}
+	} );
+
+	return size;
+}
+
+bool isBufferBlockCompressed( const Buffer &buffer )
+{
+	return buffer.getSize() >= HEADER_SIZE && memcmp( buffer.getData(), HEADER_MAGIC, 4 ) == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// OStreamCompressed
+OStreamCompressedRef OStreamCompressed::create( const OStreamRef &stream, const BlockCompressionOptions &options )
+{
+	return OStreamCompressedRef( new OStreamCompressed( stream, options ) );
+}
+
+OStreamCompressed::OStreamCompressed( const OStreamRef &stream, const BlockCompressionOptions &options )
+	: OStream(), mStream( stream ), mOptions( options ), mOutputOffset( HEADER_SIZE ), mUncompressedSize( 0 ), mClosed( false )
+{
+	mOptions.blockSize( clampBlockSize( mOptions.getBlockSize() ) );
+	mOptions.numThreads( resolveNumThreads( mOptions.getNumThreads() ) );
+
+	uint8_t header[HEADER_SIZE];
+	writeHeader( header, mOptions.getBlockSize() );
+	mStream->writeData( header, HEADER_SIZE );
+}
+
+OStreamCompressed::~OStreamCompressed()
+{
+	try {
+		close();
+	}
+	catch( std::exception & ) {
+	}
+}
+
+void OStreamCompressed::IOWrite( const void *t, size_t size )
+{
+	if( mClosed )
+		throw CompressedStreamExc( "write after close()" );
+
+	const uint8_t *data = static_cast<const uint8_t*>( t );
+	const size_t blockSize = mOptions.getBlockSize();
+	while( size ) {
+		if( mPendingBlocks.empty() || mPendingBlocks.back().size() == blockSize ) {
+			// every pending block is full, so compress them once there's one for each thread
+			if( mPendingBlocks.size() == static_cast<size_t>( mOptions.getNumThreads() ) )
+				flushBlocks();
+			mPendingBlocks.push_back( vector<uint8_t>() );
+			mPendingBlocks.back().reserve( blockSize );
+		}
+
+		auto &block = mPendingBlocks.back();
+		size_t amount = std::min( size, blockSize - block.size() );
+		block.insert( block.end(), data, data + amount );
+		data += amount;
+		size -= amount;
+		mUncompressedSize += amount;
+	}
+}
+
+void OStreamCompressed::flushBlocks()
+{
+	vector<vector<uint8_t>> compressed( mPendingBlocks.size() );
+	parallelFor( mPendingBlocks.size(), mOptions.getNumThreads(), [&]( size_t i ) {
+		compressBlock( mPendingBlocks[i].data(), mPendingBlocks[i].size(), mOptions.getCompressionLevel(), &compressed[i] );
+	} );
+
+	for( const auto &block : compressed ) {
+		mBlockOffsets.push_back( mOutputOffset );
+		mStream->writeData( block.data(), block.size() );
+		mOutputOffset += block.size();
+	}
+	mPendingBlocks.clear();
+}
+
+void OStreamCompressed::close()
+{
+	if( mClosed )
+		return;
+	mClosed = true;
+
+	flushBlocks();
+	if( mBlockOffsets.size() > numeric_limits<uint32_t>::max() )
+		throw CompressedStreamExc( "too many blocks" );
+
+	uint8_t end[BLOCK_HEADER_SIZE] = {};
+	mStream->writeData( end, BLOCK_HEADER_SIZE );
+	uint64_t indexOffset = mOutputOffset + BLOCK_HEADER_SIZE;
+	if( ! mBlockOffsets.empty() )
+		mStream->writeData( mBlockOffsets.data(), mBlockOffsets.size() * sizeof(uint64_t) );
+
+	uint8_t footer[FOOTER_SIZE];
+	writeFooter( footer, mUncompressedSize, indexOffset, static_cast<uint32_t>( mBlockOffsets.size() ) );
+	mStream->writeData( footer, FOOTER_SIZE );
+}
+
+void OStreamCompressed::seekAbsolute( off_t /*absoluteOffset*/ )
+{
+	throw StreamExc();
+}
+
+void OStreamCompressed::seekRelative( off_t /*relativeOffset*/ )
+{
+	throw StreamExc();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// IStreamCompressed
+IStreamCompressedRef IStreamCompressed::create( const IStreamRef &stream, int numThreads )
+{
+	return IStreamCompressedRef( new IStreamCompressed( stream, numThreads ) );
+}
+
+IStreamCompressed::IStreamCompressed( const IStreamRef &stream, int numThreads )
+	: IStreamCinder(), mStream( stream ), mNumThreads( resolveNumThreads( numThreads ) ), mIndexed( false ), mUncompressedSize( 0 ),
+		mFirstBlock( 0 ), mCurrentBlock( 0 ), mNextBlock( 0 ), mSkip( 0 ), mBlockStart( nullptr ), mEnded( false )
+{
+	mStreamStart = mStream->tell();
+	uint8_t header[HEADER_SIZE];
+	mStream->readData( header, HEADER_SIZE );
+	mBlockSize = readHeader( header );
+
+	// the index is only readable when the stream can seek to its end
+	if( mStream->size() >= mStreamStart + static_cast<off_t>( HEADER_SIZE + BLOCK_HEADER_SIZE + FOOTER_SIZE ) ) {
+		readIndex();
+		mStream->seekAbsolute( mStreamStart + HEADER_SIZE );
+	}
+}
+
+void IStreamCompressed::readIndex()
+{
+	mStream->seekAbsolute( mStream->size() - FOOTER_SIZE );
+	uint8_t footer[FOOTER_SIZE];
+	mStream->readData( footer, FOOTER_SIZE );
+	uint64_t indexOffset;
+	uint32_t numBlocks;
+	readFooter( footer, &mUncompressedSize, &indexOffset, &numBlocks );
+	const uint64_t streamSize = mStream->size() - mStreamStart;
+	if( numBlocks > ( streamSize - FOOTER_SIZE ) / sizeof(uint64_t) || indexOffset != streamSize - FOOTER_SIZE - numBlocks * sizeof(uint64_t)
+		|| ! isBlockCountValid( mUncompressedSize, mBlockSize, numBlocks ) )
+		throw CompressedStreamExc( "corrupt block index" );
+
+	mBlockOffsets.resize( numBlocks );
+	mStream->seekAbsolute( mStreamStart + static_cast<off_t>( indexOffset ) );
+	if( numBlocks )
+		mStream->readData( mBlockOffsets.data(), numBlocks * sizeof(uint64_t) );
+	mIndexed = true;
+}
+
+bool IStreamCompressed::decompressBlocks()
+{
+	if( mIndexed ) {
+		if( mNextBlock >= mBlockOffsets.size() )
+			mEnded = true;
+		else if( mStream->tell() != mStreamStart + static_cast<off_t>( mBlockOffsets[mNextBlock] ) )
+			mStream->seekAbsolute( mStreamStart + static_cast<off_t>( mBlockOffsets[mNextBlock] ) );
+	}
+
+	// reading is sequential, then the blocks are decompressed in parallel
+	vector<vector<uint8_t>> compressed;
+	vector<size_t> sizes;
+	while( ! mEnded && compressed.size() < static_cast<size_t>( mNumThreads ) && ( ! mIndexed || mNextBlock + compressed.size() < mBlockOffsets.size() ) ) {
+		uint32_t size, compressedSize;
+		mStream->readLittle( &size );
+		mStream->readLittle( &compressedSize );
+		if( size == 0 ) {
+			mEnded = true;
+			break;
+		}
+		// checked before allocating, as the sizes come from the stream
+		if( size > mBlockSize || compressedSize > compressBound( static_cast<uLong>( mBlockSize ) ) )
+			throw CompressedStreamExc( "corrupt compressed block" );
+		compressed.push_back( vector<uint8_t>( compressedSize ) );
+		mStream->readData( compressed.back().data(), compressedSize );
+		sizes.push_back( size );
+	}
+	if( compressed.empty() )
+		return false;
+
+	mBlocks.resize( compressed.size() );
+	parallelFor( compressed.size(), mNumThreads, [&]( size_t i ) {
+		mBlocks[i].resize( sizes[i] );
+		decompressBlock( compressed[i].data(), compressed[i].size(), mBlocks[i].data(), sizes[i] );
+	} );
+
+	mFirstBlock = mCurrentBlock = mNextBlock;
+	mNextBlock += compressed.size();
+	mEnded = mEnded || ( mIndexed && mNextBlock >= mBlockOffsets.size() );
+
+	const auto &block = mBlocks.front();
+	mBlockStart = block.data();
+	mReadPos = mBlockStart + std::min( mSkip, block.size() );
+	mReadEnd = mBlockStart + block.size();
+	mSkip = 0;
+	return true;
+}
+
+size_t IStreamCompressed::readDataImpl( void *dest, size_t size )
+{
+	uint8_t *destBytes = static_cast<uint8_t*>( dest );
+	size_t result = 0;
+	while( result < size ) {
+		size_t available = mReadEnd - mReadPos;
+		if( available ) {
+			size_t amount = std::min( available, size - result );
+			memcpy( destBytes + result, mReadPos, amount );
+			mReadPos += amount;
+			result += amount;
+		}
+		else if( mBlockStart && mCurrentBlock + 1 < mFirstBlock + mBlocks.size() ) {
+			const auto &block = mBlocks[++mCurrentBlock - mFirstBlock];
+			mBlockStart = mReadPos = block.data();
+			mReadEnd = mBlockStart + block.size();
+		}
+		else if( ! decompressBlocks() )
+			break;
+	}
+
+	return result;
+}
+
+size_t IStreamCompressed::readDataAvailable( void *dest, size_t maxSize )
+{
+	return readDataImpl( dest, maxSize );
+}
+
+void IStreamCompressed::IORead( void *t, size_t size )
+{
+	if( readDataImpl( t, size ) != size )
+		throw StreamExc();
+}
+
+void IStreamCompressed::seekAbsolute( off_t absoluteOffset )
+{
+	if( ! mIndexed )
+		throw StreamExc(); // the source can't seek
+	if( absoluteOffset < 0 )
+		absoluteOffset += static_cast<off_t>( mUncompressedSize );
+	if( absoluteOffset < 0 || absoluteOffset > static_cast<off_t>( mUncompressedSize ) )
+		throw StreamExc();
+
+	size_t block = static_cast<size_t>( absoluteOffset / mBlockSize ), offsetInBlock = static_cast<size_t>( absoluteOffset % mBlockSize );
+	// blocks which are already decompressed are reused
+	if( mBlockStart && block >= mFirstBlock && block < mFirstBlock + mBlocks.size() ) {
+		const auto &data = mBlocks[block - mFirstBlock];
+		mCurrentBlock = block;
+		mBlockStart = data.data();
+		mReadPos = mBlockStart + offsetInBlock;
+		mReadEnd = mBlockStart + data.size();
+	}
+	else {
+		mBlocks.clear();
+		mFirstBlock = mCurrentBlock = mNextBlock = block;
+		mSkip = offsetInBlock;
+		mBlockStart = mReadPos = mReadEnd = nullptr;
+		mEnded = false;
+	}
+}
+
+void IStreamCompressed::seekRelative( off_t relativeOffset )
+{
+	// range-checked here, as seekAbsolute() would treat a negative result as relative to the end
+	off_t absoluteOffset = tell() + relativeOffset;
+	if( absoluteOffset < 0 || absoluteOffset > static_cast<off_t>( mUncompressedSize ) )
+		throw StreamExc();
+	seekAbsolute( absoluteOffset );
+}
+
+off_t IStreamCompressed::tell() const
+{
+	size_t offsetInBlock = mBlockStart ? static_cast<size_t>( mReadPos - mBlockStart ) : mSkip;
+	return static_cast<off_t>( mCurrentBlock * mBlockSize + offsetInBlock );
+}
+
+bool IStreamCompressed::isEof() const
+{
+	if( mReadPos < mReadEnd )
+		return false;
+	if( mIndexed )
+		return tell() >= static_cast<off_t>( mUncompressedSize );
+	return mEnded && ( ! mBlockStart || mCurrentBlock + 1 >= mFirstBlock + mBlocks.size() );
+}
+
+} // namespace cinder
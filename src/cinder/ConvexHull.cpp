@@ -20,36 +20,136 @@
  POSSIBILITY OF SUCH DAMAGE.
 */
 
+
 #include "cinder/ConvexHull.h"
+#include "cinder/TaskScheduler.h"
 
-#include <boost/geometry.hpp>
-#include <boost/geometry/geometries/point_xy.hpp>
-#include <boost/geometry/geometries/polygon.hpp>
+#include <algorithm>
+#include <limits>
 
+using namespace std;
 
 namespace cinder {
 
-typedef boost::geometry::model::polygon<boost::geometry::model::d2::point_xy<double> > polygon;
-
 namespace {
 
-PolyLine2f toPolyLine( const polygon &p )
+// below this many points a parallel sort isn't worth scheduling
+const size_t PARALLEL_SORT_MIN_POINTS = 32768;
+// marks a missing face, point or vertex index in QuickHull3d
+const uint32_t NO_INDEX = 0xFFFFFFFF;
+
+// positive when o, a, b turn counter-clockwise with y up. Computed in double so collinear points are found reliably.
+inline double cross( const vec2 &o, const vec2 &a, const vec2 &b )
 {
-	PolyLine2f result;
+	return ( (double)a.x - o.x ) * ( (double)b.y - o.y ) - ( (double)a.y - o.y ) * ( (double)b.x - o.x );
+}
 
-	for( auto pt = p.outer().begin(); pt != p.outer().end(); ++pt )
-		result.push_back( vec2( boost::geometry::get<0>(*pt), boost::geometry::get<1>(*pt) ) );
+inline bool lessXY( const vec2 &a, const vec2 &b )
+{
+	return a.x < b.x || ( a.x == b.x && a.y < b.y );
+}
 
-	
-	return result;
+// Copies the points that aren't strictly inside the octagon of the extreme points along the axes and diagonals, as those can't be on the hull
+void discardInterior( const vec2 *points, size_t numPoints, vector<vec2> *result )
+{
+	// counter-clockwise from the leftmost point, so interior points are to the left of every edge
+	const vec2 directions[8] = { vec2( -1, 0 ), vec2( -1, -1 ), vec2( 0, -1 ), vec2( 1, -1 ), vec2( 1, 0 ), vec2( 1, 1 ), vec2( 0, 1 ), vec2( -1, 1 ) };
+	size_t extremes[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+	float extents[8];
+	for( int d = 0; d < 8; ++d )
+		extents[d] = dot( points[0], directions[d] );
+	for( size_t p = 1; p < numPoints; ++p ) {
+		for( int d = 0; d < 8; ++d ) {
+			float extent = dot( points[p], directions[d] );
+			if( extent > extents[d] ) {
+				extents[d] = extent;
+				extremes[d] = p;
+			}
+		}
+	}
+
+	// the same point can be extreme in several directions
+	vec2 octagon[8];
+	int numVertices = 0;
+	for( int d = 0; d < 8; ++d ) {
+		if( numVertices == 0 || points[extremes[d]] != octagon[numVertices - 1] )
+			octagon[numVertices++] = points[extremes[d]];
+	}
+	while( numVertices > 1 && octagon[numVertices - 1] == octagon[0] )
+		--numVertices;
+
+	result->reserve( numPoints );
+	for( size_t p = 0; p < numPoints; ++p ) {
+		bool inside = numVertices >= 3;
+		for( int v = 0; v < numVertices && inside; ++v )
+			inside = cross( octagon[v], octagon[( v + 1 ) % numVertices], points[p] ) > 0;
+		if( ! inside )
+			result->push_back( points[p] );
+	}
 }
 
-boost::geometry::model::d2::point_xy<double> makePoint( const vec2 &p )
+// Sorts a run per thread, then merges neighbouring runs in parallel, doubling their length each round
+void parallelSort( vector<vec2> *points )
 {
-	return boost::geometry::make<boost::geometry::model::d2::point_xy<double> >( p.x, p.y );
+	TaskSchedulerRef scheduler = TaskScheduler::get();
+	const size_t numPoints = points->size(), numRuns = scheduler->getNumWorkers() + 1;
+	if( numRuns == 1 ) {
+		sort( points->begin(), points->end(), lessXY );
+		return;
+	}
+
+	const size_t runLength = ( numPoints + numRuns - 1 ) / numRuns;
+	vec2 *data = points->data();
+	scheduler->parallelFor( 0, numPoints, runLength, [=]( size_t begin, size_t end ) {
+		sort( data + begin, data + end, lessXY );
+	} );
+
+	vector<vec2> buffer( numPoints );
+	vec2 *src = data, *dst = buffer.data();
+	for( size_t length = runLength; length < numPoints; length *= 2 ) {
+		size_t numPairs = ( numPoints + 2 * length - 1 ) / ( 2 * length );
+		scheduler->parallelFor( 0, numPairs, 1, [=]( size_t pairBegin, size_t pairEnd ) {
+			for( size_t pair = pairBegin; pair < pairEnd; ++pair ) {
+				size_t begin = pair * 2 * length, mid = std::min( begin + length, numPoints ), end = std::min( begin + 2 * length, numPoints );
+				merge( src + begin, src + mid, src + mid, src + end, dst + begin, lessXY );
+			}
+		} );
+		swap( src, dst );
+	}
+
+	if( src != data )
+		points->swap( buffer );
+}
+
+// Andrew's monotone chain over points sorted by x then y, without duplicates. The upper chain is built first, so the hull is clockwise with y up.
+PolyLine2f calcMonotoneChain( const vector<vec2> &sorted )
+{
+	PolyLine2f result;
+	if( sorted.empty() )
+		return result;
+
+	vector<vec2> &hull = result.getPoints();
+	hull.reserve( sorted.size() + 1 );
+	for( size_t p = 0; p < sorted.size(); ++p ) {
+		while( hull.size() >= 2 && cross( hull[hull.size() - 2], hull.back(), sorted[p] ) >= 0 )
+			hull.pop_back();
+		hull.push_back( sorted[p] );
+	}
+
+	// the lower chain ends with the first point again
+	const size_t upperSize = hull.size();
+	for( size_t p = sorted.size() - 1; p-- > 0; ) {
+		while( hull.size() > upperSize && cross( hull[hull.size() - 2], hull.back(), sorted[p] ) >= 0 )
+			hull.pop_back();
+		hull.push_back( sorted[p] );
+	}
+	if( sorted.size() == 1 )
+		hull.push_back( sorted[0] );
+
+	return result;
 }
 
-void includePathExtremeties( const Path2d &p, polygon *output )
+void includePathExtremeties( const Path2d &p, vector<vec2> *output )
 {
 	size_t firstPoint = 0;
 	for( size_t s = 0; s < p.getSegments().size(); ++s ) {
@@ -58,27 +158,27 @@ void includePathExtremeties( const Path2d &p, polygon *output )
 				float monotoneT[4];
 				int monotoneCnt = Path2d::calcCubicBezierMonotoneRegions( &(p.getPoints()[firstPoint]), monotoneT );
 				for( int monotoneIdx = 0; monotoneIdx < monotoneCnt; ++monotoneIdx )
-					output->outer().push_back( makePoint( Path2d::calcCubicBezierPos( &(p.getPoints()[firstPoint]), monotoneT[monotoneIdx] ) ) );
+					output->push_back( Path2d::calcCubicBezierPos( &(p.getPoints()[firstPoint]), monotoneT[monotoneIdx] ) );
 
-				output->outer().push_back( makePoint( p.getPoints()[firstPoint+0] ) );
-				output->outer().push_back( makePoint( p.getPoints()[firstPoint+1] ) );
-				output->outer().push_back( makePoint( p.getPoints()[firstPoint+2] ) );
+				output->push_back( p.getPoints()[firstPoint+0] );
+				output->push_back( p.getPoints()[firstPoint+1] );
+				output->push_back( p.getPoints()[firstPoint+2] );
 			}
 			break;
 			case Path2d::QUADTO: {
 				float monotoneT[2];
-				int monotoneCnt = Path2d::calcCubicBezierMonotoneRegions( &(p.getPoints()[firstPoint]), monotoneT );
+				int monotoneCnt = Path2d::calcQuadraticBezierMonotoneRegions( &(p.getPoints()[firstPoint]), monotoneT );
 				for( int monotoneIdx = 0; monotoneIdx < monotoneCnt; ++monotoneIdx )
-					output->outer().push_back( makePoint( Path2d::calcQuadraticBezierPos( &(p.getPoints()[firstPoint]), monotoneT[monotoneIdx] ) ) );
-				output->outer().push_back( makePoint( p.getPoints()[firstPoint+0] ) );
-				output->outer().push_back( makePoint( p.getPoints()[firstPoint+1] ) );
+					output->push_back( Path2d::calcQuadraticBezierPos( &(p.getPoints()[firstPoint]), monotoneT[monotoneIdx] ) );
+				output->push_back( p.getPoints()[firstPoint+0] );
+				output->push_back( p.getPoints()[firstPoint+1] );
 			}
 			break;
 			case Path2d::LINETO:
-				output->outer().push_back( makePoint( p.getPoints()[firstPoint+0] ) );
+				output->push_back( p.getPoints()[firstPoint+0] );
 			break;
 			case Path2d::CLOSE:
-				output->outer().push_back( makePoint( p.getPoints()[firstPoint+0] ) );
+				output->push_back( p.getPoints()[firstPoint+0] );
 			break;
 			default:
 				throw Path2dExc();
@@ -88,61 +188,389 @@ void includePathExtremeties( const Path2d &p, polygon *output )
 	}
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////
+// QuickHull3d
+// Quickhull over triangular faces. Every point outside the hull so far is assigned to one face it is in front of, and the farthest point of a face
+// is added by replacing the faces it can see with a fan from their horizon to the point. Planes are computed in double. A point is only assigned
+// to a face when it is farther in front than a tolerance scaled to the points' extent, so nearly coplanar points are treated as inside, but the
+// faces replaced are all those the point is in front of at all, as keeping one would leave a reflex edge that later faces can fold over.
+class QuickHull3d {
+  public:
+	QuickHull3d( const vec3 *points, size_t numPoints );
+
+	TriMesh		calcMesh();
+
+  private:
+	struct Face {
+		uint32_t	mVertices[3];
+		// the face across the edge from mVertices[i] to mVertices[(i + 1) % 3]
+		uint32_t	mNeighbors[3];
+		dvec3		mNormal;
+		double		mOffset;
+		// the points in front of this face, linked through mNextOutside
+		uint32_t	mOutsideHead, mFarthest;
+		double		mFarthestDistance;
+		uint32_t	mVisitStamp;
+		bool		mVisible, mDeleted;
+	};
+
+	struct HorizonEdge {
+		uint32_t	mStart, mEnd, mNeighbor, mNewFace;
+		bool operator<( const HorizonEdge &rhs ) const { return mStart < rhs.mStart; }
+	};
+
+	bool		createSimplex();
+	uint32_t	addFace( uint32_t v0, uint32_t v1, uint32_t v2 );
+	double		distance( const Face &face, uint32_t point ) const	{ return dot( face.mNormal, dvec3( mPoints[point] ) ) - face.mOffset; }
+	void		addOutside( uint32_t face, uint32_t point, double dist );
+	// assigns \a point to the first of \a faces it is in front of, or discards it
+	void		assignPoint( uint32_t point, const uint32_t *faces, size_t numFaces );
+	void		addPoint( uint32_t face );
+	void		removeFarthest( uint32_t face );
+
+	const vec3			*mPoints;
+	size_t				mNumPoints;
+	double				mTolerance;
+	vector<Face>		mFaces;
+	vector<uint32_t>	mNextOutside;
+	uint32_t			mVisitStamp;
+
+	// reused by every addPoint()
+	vector<uint32_t>	mVisibleFaces, mStack, mNewFaces;
+	vector<HorizonEdge>	mHorizon;
+};
+
+QuickHull3d::QuickHull3d( const vec3 *points, size_t numPoints )
+	: mPoints( points ), mNumPoints( numPoints ), mVisitStamp( 0 )
+{
+}
+
+uint32_t QuickHull3d::addFace( uint32_t v0, uint32_t v1, uint32_t v2 )
+{
+	Face face;
+	face.mVertices[0] = v0;
+	face.mVertices[1] = v1;
+	face.mVertices[2] = v2;
+	face.mNeighbors[0] = face.mNeighbors[1] = face.mNeighbors[2] = NO_INDEX;
+	dvec3 p0( mPoints[v0] ), p1( mPoints[v1] ), p2( mPoints[v2] );
+	face.mNormal = cross( p1 - p0, p2 - p0 );
+	double len = length( face.mNormal );
+	face.mNormal = ( len > 0 ) ? face.mNormal / len : dvec3( 0 );
+	face.mOffset = dot( face.mNormal, p0 );
+	face.mOutsideHead = face.mFarthest = NO_INDEX;
+	face.mFarthestDistance = 0;
+	face.mVisitStamp = 0;
+	face.mVisible = face.mDeleted = false;
+	mFaces.push_back( face );
+	return static_cast<uint32_t>( mFaces.size() - 1 );
+}
+
+void QuickHull3d::addOutside( uint32_t face, uint32_t point, double dist )
+{
+	Face &f = mFaces[face];
+	mNextOutside[point] = f.mOutsideHead;
+	f.mOutsideHead = point;
+	if( dist > f.mFarthestDistance ) {
+		f.mFarthestDistance = dist;
+		f.mFarthest = point;
+	}
+}
+
+void QuickHull3d::assignPoint( uint32_t point, const uint32_t *faces, size_t numFaces )
+{
+	for( size_t f = 0; f < numFaces; ++f ) {
+		double dist = distance( mFaces[faces[f]], point );
+		if( dist > mTolerance ) {
+			addOutside( faces[f], point, dist );
+			return;
+		}
+	}
+}
+
+bool QuickHull3d::createSimplex()
+{
+	// the tolerance follows the magnitude of the coordinates, as float inputs carry a relative error
+	uint32_t extremes[6] = { 0, 0, 0, 0, 0, 0 };
+	vec3 maxAbs( 0 );
+	for( uint32_t p = 0; p < mNumPoints; ++p ) {
+		for( int axis = 0; axis < 3; ++axis ) {
+			if( mPoints[p][axis] < mPoints[extremes[axis * 2]][axis] ) extremes[axis * 2] = p;
+			if( mPoints[p][axis] > mPoints[extremes[axis * 2 + 1]][axis] ) extremes[axis * 2 + 1] = p;
+		}
+		maxAbs = glm::max( maxAbs, glm::abs( mPoints[p] ) );
+	}
+	mTolerance = 3 * ( (double)maxAbs.x + maxAbs.y + maxAbs.z ) * numeric_limits<float>::epsilon();
+
+	// the most distant pair of extreme points, the point farthest from their line, and the point farthest from the plane through all three
+	uint32_t v[4] = { 0, 0, 0, 0 };
+	double best = 0;
+	for( int axis = 0; axis < 3; ++axis ) {
+		double dist = length( dvec3( mPoints[extremes[axis * 2 + 1]] ) - dvec3( mPoints[extremes[axis * 2]] ) );
+		if( dist > best ) {
+			best = dist;
+			v[0] = extremes[axis * 2];
+			v[1] = extremes[axis * 2 + 1];
+		}
+	}
+	if( best <= mTolerance )
+		return false;
+
+	dvec3 p0( mPoints[v[0]] ), lineDir = normalize( dvec3( mPoints[v[1]] ) - p0 );
+	best = 0;
+	for( uint32_t p = 0; p < mNumPoints; ++p ) {
+		double dist = length( cross( dvec3( mPoints[p] ) - p0, lineDir ) );
+		if( dist > best ) {
+			best = dist;
+			v[2] = p;
+		}
+	}
+	if( best <= mTolerance )
+		return false;
+
+	dvec3 planeNormal = normalize( cross( dvec3( mPoints[v[1]] ) - p0, dvec3( mPoints[v[2]] ) - p0 ) );
+	double signedBest = 0;
+	best = 0;
+	for( uint32_t p = 0; p < mNumPoints; ++p ) {
+		double dist = dot( dvec3( mPoints[p] ) - p0, planeNormal );
+		if( std::abs( dist ) > best ) {
+			best = std::abs( dist );
+			signedBest = dist;
+			v[3] = p;
+		}
+	}
+	if( best <= mTolerance )
+		return false;
+
+	// wound so that every face's normal points away from the remaining vertex
+	if( signedBest > 0 )
+		swap( v[1], v[2] );
+	addFace( v[0], v[1], v[2] );
+	addFace( v[0], v[3], v[1] );
+	addFace( v[1], v[3], v[2] );
+	addFace( v[2], v[3], v[0] );
+
+	// each edge's neighbor is the face with the same edge reversed
+	for( uint32_t f = 0; f < 4; ++f ) {
+		for( int e = 0; e < 3; ++e ) {
+			uint32_t a = mFaces[f].mVertices[e], b = mFaces[f].mVertices[( e + 1 ) % 3];
+			for( uint32_t g = 0; g < 4; ++g ) {
+				for( int ge = 0; ge < 3; ++ge ) {
+					if( mFaces[g].mVertices[ge] == b && mFaces[g].mVertices[( ge + 1 ) % 3] == a )
+						mFaces[f].mNeighbors[e] = g;
+				}
+			}
+		}
+	}
+
+	mNextOutside.assign( mNumPoints, NO_INDEX );
+	const uint32_t faces[4] = { 0, 1, 2, 3 };
+	for( uint32_t p = 0; p < mNumPoints; ++p ) {
+		if( p != v[0] && p != v[1] && p != v[2] && p != v[3] )
+			assignPoint( p, faces, 4 );
+	}
+
+	return true;
+}
+
+// Removes the farthest point from \a face's outside set, when adding it would leave the hull inconsistent, and finds the next farthest
+void QuickHull3d::removeFarthest( uint32_t face )
+{
+	Face &f = mFaces[face];
+	uint32_t farthest = f.mFarthest, point = f.mOutsideHead;
+	f.mOutsideHead = f.mFarthest = NO_INDEX;
+	f.mFarthestDistance = 0;
+	while( point != NO_INDEX ) {
+		uint32_t next = mNextOutside[point];
+		if( point != farthest )
+			addOutside( face, point, distance( f, point ) );
+		point = next;
+	}
+}
+
+void QuickHull3d::addPoint( uint32_t face )
+{
+	const uint32_t eye = mFaces[face].mFarthest;
+	const dvec3 eyePos( mPoints[eye] );
+	++mVisitStamp;
+
+	// every face the eye is in front of, found from the face it was assigned to
+	mVisibleFaces.clear();
+	mStack.assign( 1, face );
+	mFaces[face].mVisitStamp = mVisitStamp;
+	mFaces[face].mVisible = true;
+	while( ! mStack.empty() ) {
+		uint32_t f = mStack.back();
+		mStack.pop_back();
+		mVisibleFaces.push_back( f );
+		for( int e = 0; e < 3; ++e ) {
+			Face &neighbor = mFaces[mFaces[f].mNeighbors[e]];
+			if( neighbor.mVisitStamp != mVisitStamp ) {
+				neighbor.mVisitStamp = mVisitStamp;
+				neighbor.mVisible = dot( neighbor.mNormal, eyePos ) - neighbor.mOffset > 0;
+				if( neighbor.mVisible )
+					mStack.push_back( mFaces[f].mNeighbors[e] );
+			}
+		}
+	}
+
+	// the edges between visible and hidden faces, which must form a single loop
+	mHorizon.clear();
+	for( uint32_t f : mVisibleFaces ) {
+		for( int e = 0; e < 3; ++e ) {
+			uint32_t neighbor = mFaces[f].mNeighbors[e];
+			if( ! mFaces[neighbor].mVisible ) {
+				HorizonEdge edge = { mFaces[f].mVertices[e], mFaces[f].mVertices[( e + 1 ) % 3], neighbor, NO_INDEX };
+				mHorizon.push_back( edge );
+			}
+		}
+	}
+	sort( mHorizon.begin(), mHorizon.end() );
+	bool isLoop = true;
+	for( size_t h = 1; h < mHorizon.size(); ++h )
+		isLoop = isLoop && mHorizon[h].mStart != mHorizon[h - 1].mStart;
+	uint32_t vertex = mHorizon[0].mStart;
+	for( size_t h = 0; h < mHorizon.size() && isLoop; ++h ) {
+		HorizonEdge key = { vertex, 0, 0, 0 };
+		auto edge = lower_bound( mHorizon.begin(), mHorizon.end(), key );
+		isLoop = edge != mHorizon.end() && edge->mStart == vertex;
+		vertex = isLoop ? edge->mEnd : NO_INDEX;
+		// returning to the start early means there is more than one loop
+		isLoop = isLoop && ( vertex != mHorizon[0].mStart || h + 1 == mHorizon.size() );
+	}
+	if( ! isLoop || vertex != mHorizon[0].mStart ) {
+		// numerically inconsistent visibility; the point is dropped, which can only make the hull slightly smaller than exact
+		for( uint32_t f : mVisibleFaces )
+			mFaces[f].mVisible = false;
+		removeFarthest( face );
+		return;
+	}
+
+	// a fan of new faces from the horizon to the eye
+	mNewFaces.clear();
+	for( HorizonEdge &edge : mHorizon ) {
+		edge.mNewFace = addFace( edge.mStart, edge.mEnd, eye );
+		mNewFaces.push_back( edge.mNewFace );
+		Face &newFace = mFaces[edge.mNewFace];
+		newFace.mNeighbors[0] = edge.mNeighbor;
+		Face &neighbor = mFaces[edge.mNeighbor];
+		for( int e = 0; e < 3; ++e ) {
+			if( neighbor.mVertices[e] == edge.mEnd && neighbor.mVertices[( e + 1 ) % 3] == edge.mStart )
+				neighbor.mNeighbors[e] = edge.mNewFace;
+		}
+	}
+	for( const HorizonEdge &edge : mHorizon ) {
+		HorizonEdge key = { edge.mEnd, 0, 0, 0 };
+		uint32_t next = lower_bound( mHorizon.begin(), mHorizon.end(), key )->mNewFace;
+		mFaces[edge.mNewFace].mNeighbors[1] = next;
+		mFaces[next].mNeighbors[2] = edge.mNewFace;
+	}
+
+	// the visible faces' other outside points move to the new faces, or are now inside
+	for( uint32_t f : mVisibleFaces ) {
+		uint32_t point = mFaces[f].mOutsideHead;
+		while( point != NO_INDEX ) {
+			uint32_t next = mNextOutside[point];
+			if( point != eye )
+				assignPoint( point, mNewFaces.data(), mNewFaces.size() );
+			point = next;
+		}
+		mFaces[f].mDeleted = true;
+		mFaces[f].mOutsideHead = NO_INDEX;
+	}
+}
+
+TriMesh QuickHull3d::calcMesh()
+{
+	TriMesh result( TriMesh::Format().positions( 3 ) );
+	if( mNumPoints < 4 || ! createSimplex() )
+		return result;
+
+	// new faces are appended, so one pass reaches every face
+	for( size_t f = 0; f < mFaces.size(); ++f ) {
+		while( ! mFaces[f].mDeleted && mFaces[f].mOutsideHead != NO_INDEX )
+			addPoint( static_cast<uint32_t>( f ) );
+	}
+
+	// only the points used by the remaining faces become vertices
+	vector<uint32_t> &vertexIndices = mNextOutside;
+	vertexIndices.assign( mNumPoints, NO_INDEX );
+	uint32_t numVertices = 0;
+	for( const Face &face : mFaces ) {
+		if( face.mDeleted )
+			continue;
+		uint32_t indices[3];
+		for( int v = 0; v < 3; ++v ) {
+			uint32_t &index = vertexIndices[face.mVertices[v]];
+			if( index == NO_INDEX ) {
+				index = numVertices++;
+				result.appendPosition( mPoints[face.mVertices[v]] );
+			}
+			indices[v] = index;
+		}
+		result.appendTriangle( indices[0], indices[1], indices[2] );
+	}
+
+	return result;
+}
+
 } // anonymous namespace
 
-PolyLine2f calcConvexHull( const std::vector<vec2> &points )
+PolyLine2f calcConvexHull( const std::vector<vec2> &points, const ConvexHullOptions &options )
 {
-	if( points.empty() )
-		return PolyLine2f();
-	else
-		return calcConvexHull( points.data(), points.size() );
+	return calcConvexHull( points.data(), points.size(), options );
 }
 
-PolyLine2f calcConvexHull( const vec2 *points, size_t numPoints )
+PolyLine2f calcConvexHull( const vec2 *points, size_t numPoints, const ConvexHullOptions &options )
 {
-	polygon poly;
-	for( size_t p = 0; p < numPoints; ++p )
-		poly.outer().push_back( boost::geometry::make<boost::geometry::model::d2::point_xy<double> >( points[p].x, points[p].y ) );
+	if( numPoints == 0 )
+		return PolyLine2f();
 
-	polygon result;
-	boost::geometry::convex_hull( poly, result );
-	
-	return toPolyLine( result );
+	vector<vec2> sorted;
+	discardInterior( points, numPoints, &sorted );
+	if( options.getParallelSort() && sorted.size() >= PARALLEL_SORT_MIN_POINTS )
+		parallelSort( &sorted );
+	else
+		sort( sorted.begin(), sorted.end(), lessXY );
+	sorted.erase( unique( sorted.begin(), sorted.end() ), sorted.end() );
+
+	return calcMonotoneChain( sorted );
 }
 
 PolyLine2f calcConvexHull( const Shape2d &shape )
 {
-	polygon poly;
+	vector<vec2> points;
 	for( auto contourIt = shape.getContours().begin(); contourIt != shape.getContours().end(); ++contourIt )
-		includePathExtremeties( *contourIt, &poly );
+		includePathExtremeties( *contourIt, &points );
 
-	polygon result;
-	boost::geometry::convex_hull( poly, result );
-
-	return toPolyLine( result );
+	return calcConvexHull( points );
 }
 
 PolyLine2f calcConvexHull( const Path2d &path )
 {
-	polygon poly;
-	includePathExtremeties( path, &poly );
+	vector<vec2> points;
+	includePathExtremeties( path, &points );
 
-	polygon result;
-	boost::geometry::convex_hull( poly, result );
-	
-	return toPolyLine( result );
+	return calcConvexHull( points );
 }
 
 PolyLine2f calcConvexHull( const PolyLine2f &polyLine )
 {
-	polygon poly;
-	for( auto ptIt = polyLine.begin(); ptIt != polyLine.end(); ++ptIt )
-		poly.outer().push_back( boost::geometry::make<boost::geometry::model::d2::point_xy<double> >( ptIt->x, ptIt->y ) );
+	return calcConvexHull( polyLine.getPoints() );
+}
 
-	polygon result;
-	boost::geometry::convex_hull( poly, result );
-	
-	return toPolyLine( result );
+TriMesh calcConvexHull( const std::vector<vec3> &points )
+{
+	return calcConvexHull( points.data(), points.size() );
+}
+
+TriMesh calcConvexHull( const vec3 *points, size_t numPoints )
+{
+	return QuickHull3d( points, numPoints ).calcMesh();
+}
+
+TriMesh calcConvexHull( const TriMesh &mesh )
+{
+	return calcConvexHull( mesh.getPositions<3>(), mesh.getNumVertices() );
 }
 
-} // namespace cinder
\ No newline at end of file
+} // namespace cinder
@@ -58,20 +58,35 @@ BufferRef DataSource::getBuffer()
 
 /////////////////////////////////////////////////////////////////////////////
 // DataSourcePath
-DataSourcePathRef DataSourcePath::create( const fs::path &path )
+DataSourcePathRef DataSourcePath::create( const fs::path &path, const Options &options )
 {
-	return DataSourcePathRef( new DataSourcePath( path ) );
+	return DataSourcePathRef( new DataSourcePath( path, options ) );
 }
 
-DataSourcePath::DataSourcePath( const fs::path &path )
-	: DataSource( path, Url() )
+DataSourcePath::DataSourcePath( const fs::path &path, const Options &options )
+	: DataSource( path, Url() ), mOptions( options )
 {
 	setFilePathHint( path );
 }
 
 void DataSourcePath::createBuffer()
 {
-	// no-op - we already supplied the buffer in the constructor
+	if( mOptions.isMapped() ) {
+		// anything which can't be mapped, such as a pipe, is read instead
+		try {
+			if( fs::is_regular_file( mFilePath ) && fs::file_size( mFilePath ) >= mOptions.getMinMappedSize() ) {
+				MemoryMappedFileRef mappedFile = MemoryMappedFile::create( mFilePath, true );
+				mappedFile->setAccessHint( mOptions.getAccessHint() );
+				if( mOptions.isPrefetched() )
+					mappedFile->prefetch();
+				mBuffer = MemoryMappedFile::createBuffer( mappedFile );
+				return;
+			}
+		}
+		catch( std::exception & ) {
+		}
+	}
+
 	IStreamFileRef stream = loadFileStream( mFilePath );
 	if( ! stream )
 		throw StreamExc();
@@ -81,12 +96,20 @@ void DataSourcePath::createBuffer()
 
 IStreamRef DataSourcePath::createStream()
 {
-	return loadFileStream( mFilePath );
+	if( ! mOptions.isReadAhead() )
+		return loadFileStream( mFilePath );
+
+	// large files are read on a background thread a block ahead of the consumer
+	IStreamFileBlock::Options options;
+	if( fs::is_regular_file( mFilePath ) && fs::file_size( mFilePath ) >= 4 * options.getBlockSize() )
+		options.readAhead();
+
+	return IStreamFileBlock::create( mFilePath, options );
 }
 
-DataSourceRef loadFile( const fs::path &path )
+DataSourceRef loadFile( const fs::path &path, const DataSourcePath::Options &options )
 {
-	return DataSourcePath::create( path );
+	return DataSourcePath::create( path, options );
 }
 
 #if !defined( CINDER_WINRT )
@@ -33,6 +33,11 @@
 #include "cinder/Sphere.h"
 #include <algorithm>
 
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_GEOM_SSE2
+	#include <emmintrin.h>
+#endif
+
 using namespace std;
 
 namespace cinder { namespace geom {
@@ -302,6 +307,355 @@ void copyData( uint8_t srcDimensions, const float *srcData, size_t numElements,
 	}
 }
 
+uint8_t getDataTypeByteSize( DataType dataType, uint8_t dims )
+{
+	switch( dataType ) {
+		case DataType::DOUBLE:
+			return dims * 8;
+		case DataType::HALF_FLOAT:
+		case DataType::SNORM16:
+		case DataType::UNORM16:
+			return ( dims * 2 + 3 ) & ~3;
+		case DataType::SNORM8:
+		case DataType::UNORM8:
+			return ( dims + 3 ) & ~3;
+		case DataType::SNORM_10_10_10_2:
+		case DataType::OCTAHEDRAL:
+			return 4;
+		default:
+			return dims * 4;
+	}
+}
+
+namespace {
+// packing converts in chunks of this many elements via stack buffers, so that copyData() can handle the dimension conversion
+const size_t PACK_CHUNK_SIZE = 256;
+
+inline float clampSnorm( float v ) { return ( v < -1.0f ) ? -1.0f : ( ( v > 1.0f ) ? 1.0f : v ); }
+inline float clampUnorm( float v ) { return ( v < 0.0f ) ? 0.0f : ( ( v > 1.0f ) ? 1.0f : v ); }
+inline int32_t roundToInt( float v ) { return (int32_t)( ( v >= 0 ) ? ( v + 0.5f ) : ( v - 0.5f ) ); }
+
+// round-to-nearest-even float to half conversion, handling denormals, infinities and NaNs
+inline uint16_t floatToHalf( float f )
+{
+	const uint32_t F32_INFINITY = 255 << 23;
+	const uint32_t F16_MAX = ( 127 + 16 ) << 23;
+	const uint32_t DENORM_MAGIC = ( ( 127 - 15 ) + ( 23 - 10 ) + 1 ) << 23;
+
+	uint32_t bits;
+	memcpy( &bits, &f, 4 );
+	uint32_t sign = bits & 0x80000000u;
+	bits ^= sign;
+
+	uint16_t result;
+	if( bits >= F16_MAX ) // overflow to infinity, or NaN
+		result = ( bits > F32_INFINITY ) ? 0x7e00 : 0x7c00;
+	else if( bits < ( 113 << 23 ) ) { // denormal or zero; let the FPU do the rounding
+		float magic, denorm;
+		memcpy( &magic, &DENORM_MAGIC, 4 );
+		memcpy( &denorm, &bits, 4 );
+		denorm += magic;
+		memcpy( &bits, &denorm, 4 );
+		result = (uint16_t)( bits - DENORM_MAGIC );
+	}
+	else {
+		uint32_t mantissaOdd = ( bits >> 13 ) & 1;
+		bits += ( (uint32_t)( 15 - 127 ) << 23 ) + 0xfff + mantissaOdd;
+		result = (uint16_t)( bits >> 13 );
+	}
+
+	return result | (uint16_t)( sign >> 16 );
+}
+
+#if defined( CINDER_GEOM_SSE2 )
+// SSE2 version of floatToHalf(), converting 4 floats at once into the low 16 bits of each lane
+inline __m128i floatToHalfSse2( __m128 f )
+{
+	const __m128i F16_MAX = _mm_set1_epi32( ( 127 + 16 ) << 23 );
+	const __m128i NAN_BIT = _mm_set1_epi32( 0x200 );
+	const __m128i INFINITY_AS_F16 = _mm_set1_epi32( 0x7c00 );
+	const __m128i MIN_NORMAL = _mm_set1_epi32( ( 127 - 14 ) << 23 );
+	const __m128i DENORM_MAGIC = _mm_set1_epi32( ( ( 127 - 15 ) + ( 23 - 10 ) + 1 ) << 23 );
+	const __m128i NORMAL_BIAS = _mm_set1_epi32( 0xfff - ( ( 127 - 15 ) << 23 ) );
+
+	__m128 sign = _mm_and_ps( _mm_castsi128_ps( _mm_set1_epi32( 0x80000000 ) ), f );
+	__m128 absF = _mm_xor_ps( f, sign );
+	__m128i absBits = _mm_castps_si128( absF );
+
+	__m128i isRegular = _mm_cmpgt_epi32( F16_MAX, absBits );
+	__m128i infOrNan = _mm_or_si128( _mm_and_si128( _mm_castps_si128( _mm_cmpunord_ps( absF, absF ) ), NAN_BIT ), INFINITY_AS_F16 );
+	__m128i isDenormal = _mm_cmpgt_epi32( MIN_NORMAL, absBits );
+
+	__m128i denormal = _mm_sub_epi32( _mm_castps_si128( _mm_add_ps( absF, _mm_castsi128_ps( DENORM_MAGIC ) ) ), DENORM_MAGIC );
+	__m128i mantissaOdd = _mm_srai_epi32( _mm_slli_epi32( absBits, 31 - 13 ), 31 );
+	__m128i normal = _mm_srli_epi32( _mm_sub_epi32( _mm_add_epi32( absBits, NORMAL_BIAS ), mantissaOdd ), 13 );
+
+	__m128i finite = _mm_or_si128( _mm_and_si128( isDenormal, denormal ), _mm_andnot_si128( isDenormal, normal ) );
+	__m128i result = _mm_or_si128( _mm_and_si128( isRegular, finite ), _mm_andnot_si128( isRegular, infOrNan ) );
+	// the arithmetic shift sign-extends negative results, which keeps them in range for _mm_packs_epi32()
+	return _mm_or_si128( result, _mm_srai_epi32( _mm_castps_si128( sign ), 16 ) );
+}
+
+inline __m128i floatToSnormSse2( __m128 f, float scale )
+{
+	f = _mm_min_ps( _mm_max_ps( f, _mm_set1_ps( -1.0f ) ), _mm_set1_ps( 1.0f ) );
+	return _mm_cvtps_epi32( _mm_mul_ps( f, _mm_set1_ps( scale ) ) );
+}
+
+inline __m128i floatToUnormSse2( __m128 f, float scale )
+{
+	f = _mm_min_ps( _mm_max_ps( f, _mm_setzero_ps() ), _mm_set1_ps( 1.0f ) );
+	return _mm_cvtps_epi32( _mm_mul_ps( f, _mm_set1_ps( scale ) ) );
+}
+#endif // defined( CINDER_GEOM_SSE2 )
+
+// converts 'count' floats into 16-bit components; the SSE2 paths handle 8 at a time and the scalar loop handles the remainder
+void packComponents16( DataType dataType, const float *src, size_t count, uint16_t *dst )
+{
+	size_t i = 0;
+#if defined( CINDER_GEOM_SSE2 )
+	for( ; i + 8 <= count; i += 8 ) {
+		__m128 lo = _mm_loadu_ps( src + i ), hi = _mm_loadu_ps( src + i + 4 );
+		__m128i packed;
+		if( dataType == DataType::HALF_FLOAT )
+			packed = _mm_packs_epi32( floatToHalfSse2( lo ), floatToHalfSse2( hi ) );
+		else if( dataType == DataType::SNORM16 )
+			packed = _mm_packs_epi32( floatToSnormSse2( lo, 32767.0f ), floatToSnormSse2( hi, 32767.0f ) );
+		else { // UNORM16; SSE2 lacks an unsigned saturating 32->16 pack so bias into signed range and back
+			const __m128i BIAS32 = _mm_set1_epi32( 32768 );
+			packed = _mm_packs_epi32( _mm_sub_epi32( floatToUnormSse2( lo, 65535.0f ), BIAS32 ), _mm_sub_epi32( floatToUnormSse2( hi, 65535.0f ), BIAS32 ) );
+			packed = _mm_xor_si128( packed, _mm_set1_epi16( (short)0x8000 ) );
+		}
+		_mm_storeu_si128( (__m128i*)( dst + i ), packed );
+	}
+#endif
+	for( ; i < count; ++i ) {
+		if( dataType == DataType::HALF_FLOAT )
+			dst[i] = floatToHalf( src[i] );
+		else if( dataType == DataType::SNORM16 )
+			dst[i] = (uint16_t)(int16_t)roundToInt( clampSnorm( src[i] ) * 32767.0f );
+		else
+			dst[i] = (uint16_t)roundToInt( clampUnorm( src[i] ) * 65535.0f );
+	}
+}
+
+// converts 'count' floats into 8-bit components, 16 at a time with SSE2
+void packComponents8( DataType dataType, const float *src, size_t count, uint8_t *dst )
+{
+	size_t i = 0;
+#if defined( CINDER_GEOM_SSE2 )
+	for( ; i + 16 <= count; i += 16 ) {
+		__m128 f0 = _mm_loadu_ps( src + i ), f1 = _mm_loadu_ps( src + i + 4 ), f2 = _mm_loadu_ps( src + i + 8 ), f3 = _mm_loadu_ps( src + i + 12 );
+		__m128i packed;
+		if( dataType == DataType::SNORM8 ) {
+			__m128i lo = _mm_packs_epi32( floatToSnormSse2( f0, 127.0f ), floatToSnormSse2( f1, 127.0f ) );
+			__m128i hi = _mm_packs_epi32( floatToSnormSse2( f2, 127.0f ), floatToSnormSse2( f3, 127.0f ) );
+			packed = _mm_packs_epi16( lo, hi );
+		}
+		else {
+			__m128i lo = _mm_packs_epi32( floatToUnormSse2( f0, 255.0f ), floatToUnormSse2( f1, 255.0f ) );
+			__m128i hi = _mm_packs_epi32( floatToUnormSse2( f2, 255.0f ), floatToUnormSse2( f3, 255.0f ) );
+			packed = _mm_packus_epi16( lo, hi );
+		}
+		_mm_storeu_si128( (__m128i*)( dst + i ), packed );
+	}
+#endif
+	for( ; i < count; ++i ) {
+		if( dataType == DataType::SNORM8 )
+			dst[i] = (uint8_t)(int8_t)roundToInt( clampSnorm( src[i] ) * 127.0f );
+		else
+			dst[i] = (uint8_t)roundToInt( clampUnorm( src[i] ) * 255.0f );
+	}
+}
+
+// packs a 4D float vector as GL_INT_2_10_10_10_REV, x occupying the low bits
+inline uint32_t packSnorm10_10_10_2( const float *v )
+{
+	uint32_t x = (uint32_t)roundToInt( clampSnorm( v[0] ) * 511.0f ) & 0x3ff;
+	uint32_t y = (uint32_t)roundToInt( clampSnorm( v[1] ) * 511.0f ) & 0x3ff;
+	uint32_t z = (uint32_t)roundToInt( clampSnorm( v[2] ) * 511.0f ) & 0x3ff;
+	uint32_t w = (uint32_t)roundToInt( clampSnorm( v[3] ) ) & 0x3;
+	return x | ( y << 10 ) | ( z << 20 ) | ( w << 30 );
+}
+
+// encodes a 3D unit vector as a pair of SNORM16 octahedral coordinates
+inline void packOctahedral( const float *v, int16_t *dst )
+{
+	float l1 = fabs( v[0] ) + fabs( v[1] ) + fabs( v[2] );
+	float x = 0, y = 0;
+	if( l1 > 0 ) {
+		x = v[0] / l1;
+		y = v[1] / l1;
+		if( v[2] < 0 ) {
+			float foldedX = ( 1.0f - fabs( y ) ) * ( ( x >= 0 ) ? 1.0f : -1.0f );
+			y = ( 1.0f - fabs( x ) ) * ( ( y >= 0 ) ? 1.0f : -1.0f );
+			x = foldedX;
+		}
+	}
+	dst[0] = (int16_t)roundToInt( clampSnorm( x ) * 32767.0f );
+	dst[1] = (int16_t)roundToInt( clampSnorm( y ) * 32767.0f );
+}
+
+// exact half to float conversion, handling denormals, infinities and NaNs
+inline float halfToFloat( uint16_t h )
+{
+	const uint32_t SHIFTED_EXPONENT = 0x7c00 << 13;
+	const uint32_t EXPONENT_ADJUST = ( 127 - 15 ) << 23;
+	const uint32_t DENORM_MAGIC = 113 << 23;
+
+	uint32_t bits = ( h & 0x7fff ) << 13;
+	uint32_t exponent = bits & SHIFTED_EXPONENT;
+	bits += EXPONENT_ADJUST;
+	if( exponent == SHIFTED_EXPONENT ) // infinity or NaN
+		bits += EXPONENT_ADJUST;
+	else if( exponent == 0 ) { // zero or denormal; let the FPU renormalize
+		float magic, denorm;
+		bits += 1 << 23;
+		memcpy( &magic, &DENORM_MAGIC, 4 );
+		memcpy( &denorm, &bits, 4 );
+		denorm -= magic;
+		memcpy( &bits, &denorm, 4 );
+	}
+	bits |= (uint32_t)( h & 0x8000 ) << 16;
+
+	float result;
+	memcpy( &result, &bits, 4 );
+	return result;
+}
+
+// SNORM decoding maps both the most negative value and the one above it to -1, as GL does
+inline float snormToFloat( int32_t v, float scale ) { return std::max( v / scale, -1.0f ); }
+
+inline void unpackSnorm10_10_10_2( uint32_t value, float *dst )
+{
+	// shifting the field to the top and back sign-extends it
+	for( int c = 0; c < 3; ++c )
+		dst[c] = snormToFloat( (int32_t)( value << ( 22 - c * 10 ) ) >> 22, 511.0f );
+	dst[3] = snormToFloat( (int32_t)value >> 30, 1.0f );
+}
+
+inline void unpackOctahedral( const int16_t *src, float *dst )
+{
+	float x = snormToFloat( src[0], 32767.0f ), y = snormToFloat( src[1], 32767.0f );
+	float z = 1.0f - fabs( x ) - fabs( y );
+	if( z < 0 ) {
+		float unfoldedX = ( 1.0f - fabs( y ) ) * ( ( x >= 0 ) ? 1.0f : -1.0f );
+		y = ( 1.0f - fabs( x ) ) * ( ( y >= 0 ) ? 1.0f : -1.0f );
+		x = unfoldedX;
+	}
+	float len = sqrt( x * x + y * y + z * z );
+	dst[0] = x / len;
+	dst[1] = y / len;
+	dst[2] = z / len;
+}
+} // anonymous namespace
+
+void packData( uint8_t srcDimensions, const float *srcData, size_t numElements, DataType dstDataType, uint8_t dstDimensions, size_t dstStrideBytes, void *dstData )
+{
+	if( dstDataType == DataType::FLOAT ) {
+		copyData( srcDimensions, srcData, numElements, dstDimensions, dstStrideBytes, reinterpret_cast<float*>( dstData ) );
+		return;
+	}
+	else if( dstDataType == DataType::INTEGER || dstDataType == DataType::DOUBLE || dstDimensions < 1 || dstDimensions > 4 )
+		throw ExcIllegalDestDimensions();
+
+	const size_t elementBytes = getDataTypeByteSize( dstDataType, dstDimensions );
+	if( dstStrideBytes == 0 )
+		dstStrideBytes = elementBytes;
+
+	// 10_10_10_2 and octahedral always pack the full 4D or 3D vector
+	uint8_t unpackedDims = dstDimensions;
+	if( dstDataType == DataType::SNORM_10_10_10_2 )
+		unpackedDims = 4;
+	else if( dstDataType == DataType::OCTAHEDRAL )
+		unpackedDims = 3;
+
+	float unpacked[PACK_CHUNK_SIZE * 4];
+	uint8_t packed[PACK_CHUNK_SIZE * 16];
+	uint8_t *dst = reinterpret_cast<uint8_t*>( dstData );
+	for( size_t chunkStart = 0; chunkStart < numElements; chunkStart += PACK_CHUNK_SIZE ) {
+		const size_t chunkSize = std::min( PACK_CHUNK_SIZE, numElements - chunkStart );
+		copyData( srcDimensions, srcData + chunkStart * srcDimensions, chunkSize, unpackedDims, 0, unpacked );
+
+		// convert the chunk to a tightly packed run of elements, each padded to 'elementBytes'
+		memset( packed, 0, chunkSize * elementBytes );
+		switch( dstDataType ) {
+			case DataType::HALF_FLOAT:
+			case DataType::SNORM16:
+			case DataType::UNORM16: {
+				uint16_t components[PACK_CHUNK_SIZE * 4];
+				packComponents16( dstDataType, unpacked, chunkSize * unpackedDims, components );
+				for( size_t e = 0; e < chunkSize; ++e )
+					memcpy( packed + e * elementBytes, components + e * unpackedDims, unpackedDims * 2 );
+			}
+			break;
+			case DataType::SNORM8:
+			case DataType::UNORM8: {
+				uint8_t components[PACK_CHUNK_SIZE * 4];
+				packComponents8( dstDataType, unpacked, chunkSize * unpackedDims, components );
+				for( size_t e = 0; e < chunkSize; ++e )
+					memcpy( packed + e * elementBytes, components + e * unpackedDims, unpackedDims );
+			}
+			break;
+			case DataType::SNORM_10_10_10_2:
+				for( size_t e = 0; e < chunkSize; ++e ) {
+					uint32_t value = packSnorm10_10_10_2( unpacked + e * 4 );
+					memcpy( packed + e * 4, &value, 4 );
+				}
+			break;
+			case DataType::OCTAHEDRAL:
+				for( size_t e = 0; e < chunkSize; ++e )
+					packOctahedral( unpacked + e * 3, reinterpret_cast<int16_t*>( packed + e * 4 ) );
+			break;
+			default:
+			break;
+		}
+
+		if( dstStrideBytes == elementBytes )
+			memcpy( dst + chunkStart * elementBytes, packed, chunkSize * elementBytes );
+		else {
+			for( size_t e = 0; e < chunkSize; ++e )
+				memcpy( dst + ( chunkStart + e ) * dstStrideBytes, packed + e * elementBytes, elementBytes );
+		}
+	}
+}
+
+void unpackData( DataType srcDataType, uint8_t srcDimensions, size_t srcStrideBytes, const void *srcData, size_t numElements, float *dstData )
+{
+	if( srcDataType == DataType::INTEGER || srcDataType == DataType::DOUBLE || srcDimensions < 1 || srcDimensions > 4 )
+		throw ExcIllegalSourceDimensions();
+	if( srcStrideBytes == 0 )
+		srcStrideBytes = getDataTypeByteSize( srcDataType, srcDimensions );
+
+	const uint8_t *src = reinterpret_cast<const uint8_t*>( srcData );
+	for( size_t e = 0; e < numElements; ++e, src += srcStrideBytes ) {
+		// 10_10_10_2 and octahedral always hold the full 4D or 3D vector
+		float unpacked[4] = { 0, 0, 0, 0 };
+		for( uint8_t c = 0; c < srcDimensions; ++c ) {
+			switch( srcDataType ) {
+				case DataType::FLOAT: { float v; memcpy( &v, src + c * 4, 4 ); unpacked[c] = v; } break;
+				case DataType::HALF_FLOAT: { uint16_t v; memcpy( &v, src + c * 2, 2 ); unpacked[c] = halfToFloat( v ); } break;
+				case DataType::SNORM16: { int16_t v; memcpy( &v, src + c * 2, 2 ); unpacked[c] = snormToFloat( v, 32767.0f ); } break;
+				case DataType::UNORM16: { uint16_t v; memcpy( &v, src + c * 2, 2 ); unpacked[c] = v / 65535.0f; } break;
+				case DataType::SNORM8: unpacked[c] = snormToFloat( (int8_t)src[c], 127.0f ); break;
+				case DataType::UNORM8: unpacked[c] = src[c] / 255.0f; break;
+				default: break;
+			}
+		}
+		if( srcDataType == DataType::SNORM_10_10_10_2 ) {
+			uint32_t value;
+			memcpy( &value, src, 4 );
+			unpackSnorm10_10_10_2( value, unpacked );
+		}
+		else if( srcDataType == DataType::OCTAHEDRAL ) {
+			int16_t values[2];
+			memcpy( values, src, 4 );
+			unpackOctahedral( values, unpacked );
+		}
+
+		memcpy( dstData + e * srcDimensions, unpacked, srcDimensions * sizeof(float) );
+	}
+}
 
 namespace { 
 template<typename T>
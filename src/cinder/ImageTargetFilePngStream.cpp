@@ -0,0 +1,197 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ImageTargetFilePngStream.h"
+#include "cinder/DataTarget.h"
+#include "cinder/CinderMath.h"
+
+#include <zlib.h>
+#include <cstring>
+
+namespace cinder {
+
+namespace {
+
+const size_t DEFLATE_BUFFER_SIZE = 256 * 1024;
+
+void writeBigEndian( uint8_t *dst, uint32_t value )
+{
+	dst[0] = (uint8_t)( value >> 24 );
+	dst[1] = (uint8_t)( value >> 16 );
+	dst[2] = (uint8_t)( value >> 8 );
+	dst[3] = (uint8_t)value;
+}
+
+} // anonymous namespace
+
+ImageTargetFilePngStreamRef ImageTargetFilePngStream::create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options )
+{
+	return ImageTargetFilePngStreamRef( new ImageTargetFilePngStream( dataTarget, imageSource, options ) );
+}
+
+ImageTargetFilePngStream::ImageTargetFilePngStream( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options )
+	: mCurrentRow( -1 ), mNumRowsWritten( 0 ), mFinalized( false )
+{
+	mStream = dataTarget->getStream();
+	if( ! mStream )
+		throw ImageIoExceptionFailedWrite( "Could not open stream for PNG" );
+
+	setSize( imageSource->getWidth(), imageSource->getHeight() );
+	setDataType( ImageIo::UINT8 );
+	uint8_t pngColorType;
+	ImageIo::ColorModel cm = options.isColorModelDefault() ? imageSource->getColorModel() : options.getColorModel();
+	switch( cm ) {
+		case ImageIo::CM_RGB:
+			mNumComponents = imageSource->hasAlpha() ? 4 : 3;
+			setColorModel( ImageIo::CM_RGB );
+			setChannelOrder( ( mNumComponents == 4 ) ? ImageIo::RGBA : ImageIo::RGB );
+			pngColorType = ( mNumComponents == 4 ) ? 6 : 2;
+		break;
+		case ImageIo::CM_GRAY:
+			mNumComponents = imageSource->hasAlpha() ? 2 : 1;
+			setColorModel( ImageIo::CM_GRAY );
+			setChannelOrder( ( mNumComponents == 2 ) ? ImageIo::YA : ImageIo::Y );
+			pngColorType = ( mNumComponents == 2 ) ? 4 : 0;
+		break;
+		default:
+			throw ImageIoExceptionIllegalColorModel();
+	}
+
+	// each row is preceded by its filter type
+	mRowBytes = mWidth * mNumComponents;
+	mRow = std::unique_ptr<uint8_t[]>( new uint8_t[mRowBytes] );
+	mPrevRow = std::unique_ptr<uint8_t[]>( new uint8_t[mRowBytes] );
+	mFilteredRow = std::unique_ptr<uint8_t[]>( new uint8_t[mRowBytes + 1] );
+	mDeflateBuffer = std::unique_ptr<uint8_t[]>( new uint8_t[DEFLATE_BUFFER_SIZE] );
+	memset( mPrevRow.get(), 0, mRowBytes );
+
+	mZStream = std::unique_ptr<z_stream>( new z_stream );
+	memset( mZStream.get(), 0, sizeof( z_stream ) );
+	int level = constrain<int>( (int)( options.getQuality() * 9 + 0.5f ), 0, 9 );
+	if( deflateInit( mZStream.get(), level ) != Z_OK )
+		throw ImageIoExceptionFailedWrite( "Failed to initialize zlib" );
+	mZStream->next_out = mDeflateBuffer.get();
+	mZStream->avail_out = DEFLATE_BUFFER_SIZE;
+
+	static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	mStream->writeData( signature, sizeof( signature ) );
+
+	uint8_t header[13];
+	writeBigEndian( header, mWidth );
+	writeBigEndian( header + 4, mHeight );
+	header[8] = 8; // bit depth
+	header[9] = pngColorType;
+	header[10] = header[11] = header[12] = 0; // deflate, adaptive filtering, no interlace
+	writeChunk( "IHDR", header, sizeof( header ) );
+}
+
+ImageTargetFilePngStream::~ImageTargetFilePngStream()
+{
+	deflateEnd( mZStream.get() );
+}
+
+void* ImageTargetFilePngStream::getRowPointer( int32_t row )
+{
+	if( row != mCurrentRow ) {
+		// a request for the next row means the current one is complete
+		if( mCurrentRow >= 0 )
+			writeRow();
+		if( row != mNumRowsWritten )
+			throw ImageIoExceptionFailedWrite( "ImageTargetFilePngStream requires rows in order" );
+		mCurrentRow = row;
+	}
+
+	return mRow.get();
+}
+
+void ImageTargetFilePngStream::finalize()
+{
+	if( mFinalized )
+		return;
+
+	if( mCurrentRow >= 0 )
+		writeRow();
+	if( mNumRowsWritten != mHeight )
+		throw ImageIoExceptionFailedWrite( "ImageTargetFilePngStream finalized before every row was written" );
+
+	deflateAndWrite( nullptr, 0, Z_FINISH );
+	writeChunk( "IEND", nullptr, 0 );
+	mFinalized = true;
+}
+
+// uses the Up filter, which is cheap and suits rendered images with large smooth areas
+void ImageTargetFilePngStream::writeRow()
+{
+	uint8_t *filtered = mFilteredRow.get();
+	const uint8_t *row = mRow.get();
+	const uint8_t *prevRow = mPrevRow.get();
+	filtered[0] = 2;
+	for( size_t i = 0; i < mRowBytes; ++i )
+		filtered[i + 1] = row[i] - prevRow[i];
+
+	deflateAndWrite( filtered, mRowBytes + 1, Z_NO_FLUSH );
+
+	std::swap( mRow, mPrevRow );
+	mCurrentRow = -1;
+	++mNumRowsWritten;
+}
+
+void ImageTargetFilePngStream::deflateAndWrite( const uint8_t *data, size_t size, int flush )
+{
+	mZStream->next_in = const_cast<Bytef*>( data );
+	mZStream->avail_in = (uInt)size;
+	while( true ) {
+		int result = deflate( mZStream.get(), flush );
+		if( result == Z_STREAM_ERROR )
+			throw ImageIoExceptionFailedWrite( "zlib deflate failed" );
+
+		// flush the output whenever it fills, and at the end of the stream
+		if( mZStream->avail_out == 0 || result == Z_STREAM_END ) {
+			writeChunk( "IDAT", mDeflateBuffer.get(), (uint32_t)( DEFLATE_BUFFER_SIZE - mZStream->avail_out ) );
+			mZStream->next_out = mDeflateBuffer.get();
+			mZStream->avail_out = DEFLATE_BUFFER_SIZE;
+		}
+
+		if( result == Z_STREAM_END || ( flush == Z_NO_FLUSH && mZStream->avail_in == 0 && mZStream->avail_out != 0 ) )
+			break;
+	}
+}
+
+void ImageTargetFilePngStream::writeChunk( const char *type, const uint8_t *data, uint32_t size )
+{
+	uint8_t header[8];
+	writeBigEndian( header, size );
+	memcpy( header + 4, type, 4 );
+	mStream->writeData( header, sizeof( header ) );
+	if( size )
+		mStream->writeData( data, size );
+
+	uLong crc = crc32( 0, reinterpret_cast<const Bytef*>( type ), 4 );
+	if( size )
+		crc = crc32( crc, data, size );
+	uint8_t crcBytes[4];
+	writeBigEndian( crcBytes, (uint32_t)crc );
+	mStream->writeData( crcBytes, sizeof( crcBytes ) );
+}
+
+} // namespace cinder
@@ -29,6 +29,7 @@
 #include "jsoncpp/json.h"
 
 #include "cinder/Json.h"
+#include "cinder/JsonDocument.h"
 #include "cinder/Stream.h"
 #include "cinder/Utilities.h"
 
@@ -106,8 +107,11 @@ JsonTree::JsonTree( const JsonTree &jsonTree )
 	mNodeType = jsonTree.mNodeType;
 	mValue = jsonTree.mValue;
 	mValueType = jsonTree.mValueType;
+	// an unconverted node is copied by sharing its document
+	mDocument = jsonTree.mDocument;
+	mUnconvertedValue = jsonTree.mUnconvertedValue;
 
-	for( ConstIter childIt = jsonTree.begin(); childIt != jsonTree.end(); ++childIt ) {
+	for( ConstIter childIt = jsonTree.mChildren.begin(); childIt != jsonTree.mChildren.end(); ++childIt ) {
 		pushBack( *childIt );
     }
 }
@@ -119,10 +123,13 @@ JsonTree& JsonTree::operator=( const JsonTree &jsonTree )
 	mNodeType = jsonTree.mNodeType;
 	mValue = jsonTree.mValue;
 	mValueType = jsonTree.mValueType;
+	// an unconverted node is copied by sharing its document
+	mDocument = jsonTree.mDocument;
+	mUnconvertedValue = jsonTree.mUnconvertedValue;
 
 	mChildren.clear();
 
-	for( ConstIter childIt = jsonTree.begin(); childIt != jsonTree.end(); ++childIt ) {
+	for( ConstIter childIt = jsonTree.mChildren.begin(); childIt != jsonTree.mChildren.end(); ++childIt ) {
 		pushBack( *childIt );
     }
 
@@ -152,6 +159,70 @@ JsonTree::JsonTree( const std::string &key, const Json::Value &value )
 {
 	init( key, value, true, NODE_VALUE );
 }
+
+JsonTree::JsonTree( const JsonDocumentRef &document )
+	: JsonTree( "", document, document->getRoot() )
+{
+	// matches the parsing constructors, which make any other root a null node
+	if( mNodeType != NODE_ARRAY && mNodeType != NODE_OBJECT )
+		mNodeType = NODE_NULL;
+}
+
+JsonTree::JsonTree( const std::string &key, const JsonDocumentRef &document, const JsonValue &value )
+	: mKey( key ), mParent( NULL ), mNodeType( NODE_VALUE ), mValueType( VALUE_STRING ), mUnconvertedValue( NULL )
+{
+	// values are formatted the same way as init() formats jsoncpp's, where every number is a double
+	switch( value.getType() ) {
+		case JsonValue::TYPE_ARRAY:
+		case JsonValue::TYPE_OBJECT:
+			mNodeType = value.isArray() ? NODE_ARRAY : NODE_OBJECT;
+			if( value.size() > 0 ) {
+				mDocument = document;
+				mUnconvertedValue = &value;
+			}
+		break;
+		case JsonValue::TYPE_BOOL:
+			mValue = toString( value.getBool() );
+			mValueType = VALUE_BOOL;
+		break;
+		case JsonValue::TYPE_INT:
+		case JsonValue::TYPE_UINT:
+		case JsonValue::TYPE_DOUBLE:
+			mValue = toString( value.getDouble() );
+			mValueType = VALUE_DOUBLE;
+		break;
+		case JsonValue::TYPE_STRING:
+			mValue.assign( value.getStringData(), value.getStringLength() );
+		break;
+		default:
+		break;
+	}
+}
+
+void JsonTree::convertChildren() const
+{
+	if( ! mUnconvertedValue )
+		return;
+
+	const JsonValue *value = mUnconvertedValue;
+	JsonDocumentRef document = mDocument;
+	mUnconvertedValue = NULL;
+	mDocument.reset();
+
+	JsonTree *self = const_cast<JsonTree*>( this );
+	if( value->isArray() ) {
+		for( const JsonValue &element : *value ) {
+			mChildren.push_back( JsonTree( "", document, element ) );
+			mChildren.back().mParent = self;
+		}
+	}
+	else {
+		for( const JsonValue::Member *member = value->beginMembers(); member != value->endMembers(); ++member ) {
+			mChildren.push_back( JsonTree( member->getKey().getString(), document, member->getValue() ) );
+			mChildren.back().mParent = self;
+		}
+	}
+}
     
 JsonTree::JsonTree( const string &key, bool value )
 {
@@ -221,6 +292,7 @@ void JsonTree::init( const string &key, const Json::Value &value, bool setType,
     mKey = key;
 	mNodeType = nodeType;
 	mParent = 0;
+	mUnconvertedValue = NULL;
 	mValue = "";
 	mValueType = valueType;
 
@@ -299,6 +371,8 @@ Json::Value JsonTree::deserializeNative( const string &jsonString, ParseOptions
 	
 void JsonTree::clear()
 {
+	mDocument.reset();
+	mUnconvertedValue = NULL;
 	mChildren.clear();
 }
 
@@ -316,6 +390,7 @@ void JsonTree::pushBack( const JsonTree &newChild )
 		mNodeType = NODE_OBJECT;
 	}
 
+	convertChildren();
 	mChildren.push_back( newChild );
 	mChildren.back().mParent = this;
     mValue = "";
@@ -323,6 +398,7 @@ void JsonTree::pushBack( const JsonTree &newChild )
 
 void JsonTree::removeChild( size_t index )
 {
+	convertChildren();
 	if( index < mChildren.size() ) {
 		JsonTree::Iter pos = mChildren.begin();
 		for( uint32_t i = 0; i < index; i++, ++pos ) {
@@ -344,6 +420,7 @@ JsonTree::Iter JsonTree::removeChild( JsonTree::Iter pos )
 
 void JsonTree::replaceChild( size_t index, const JsonTree &newChild )
 {
+	convertChildren();
 	if ( index < mChildren.size() ) {
 		JsonTree::Iter oldChild = mChildren.begin();
 		for( uint32_t i = 0; i < index; i++, ++oldChild ) {
@@ -389,21 +466,25 @@ const JsonTree&	JsonTree::operator[]( size_t index ) const
 
 JsonTree::Iter JsonTree::begin() 
 { 
+	convertChildren();
 	return mChildren.begin(); 
 }
 
 JsonTree::ConstIter JsonTree::begin() const 
 { 
+	convertChildren();
 	return mChildren.begin();
 }
 
 JsonTree::Iter JsonTree::end() 
 { 
+	convertChildren();
 	return mChildren.end();
 }
 
 JsonTree::ConstIter JsonTree::end() const 
 { 
+	convertChildren();
 	return mChildren.end(); 
 }
 
@@ -449,6 +530,7 @@ const JsonTree& JsonTree::getChild( size_t index ) const
 
 const JsonTree::Container& JsonTree::getChildren() const
 { 
+	convertChildren();
 	return mChildren; 
 }
 
@@ -459,6 +541,7 @@ bool JsonTree::hasChild( const string &relativePath, bool caseSensitive, char se
 
 bool JsonTree::hasChildren() const
 {
+	convertChildren();
 	return mChildren.size() > 0;
 }
 
@@ -599,6 +682,7 @@ Json::Value JsonTree::createNativeDoc( WriteOptions writeOptions ) const
 {
 	// Create JsonCpp value
 	Json::Value value( Json::nullValue );
+	convertChildren();
 
 	// Key on node type
     switch( mNodeType ) {
@@ -0,0 +1,766 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/JsonDocument.h"
+
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_JSON_SSE2
+	#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace cinder {
+
+namespace {
+
+const int MAX_DEPTH = 1024;
+
+struct JsonParseError {
+	JsonParseError( const char *pos, const char *message ) : mPos( pos ), mMessage( message ) {}
+
+	const char	*mPos;
+	const char	*mMessage;
+};
+
+// Recursive descent parser which reports to a HandlerT without virtual calls. HandlerT's string() and key() receive whether the
+// characters lie in the source, which holds until parsing ends, or in scratch space which is reused by the next string.
+template<typename HandlerT>
+class JsonParser {
+  public:
+	JsonParser( const char *data, size_t size, HandlerT *handler, bool allowComments )
+		: mPos( data ), mEnd( data + size ), mHandler( handler ), mAllowComments( allowComments )
+	{
+		mDecimalPoint = localeconv()->decimal_point[0];
+	}
+
+	//! Returns \c false if the handler stopped parsing. Throws JsonParseError.
+	bool parse()
+	{
+		// skip a UTF-8 byte order mark
+		if( mEnd - mPos >= 3 && (unsigned char)mPos[0] == 0xEF && (unsigned char)mPos[1] == 0xBB && (unsigned char)mPos[2] == 0xBF )
+			mPos += 3;
+
+		skipWhitespace();
+		if( mPos == mEnd )
+			throw JsonParseError( mPos, "the document is empty" );
+		if( ! parseValue( 0 ) )
+			return false;
+		skipWhitespace();
+		if( mPos != mEnd )
+			throw JsonParseError( mPos, "unexpected characters after the document" );
+		return true;
+	}
+
+  private:
+	void skipWhitespace()
+	{
+		while( mPos < mEnd ) {
+			char c = *mPos;
+			if( c == ' ' || c == '\n' || c == '\r' || c == '\t' )
+				++mPos;
+			else if( c == '/' && mAllowComments )
+				skipComment();
+			else
+				break;
+		}
+	}
+
+	void skipComment()
+	{
+		if( mPos + 1 < mEnd && mPos[1] == '/' ) {
+			mPos += 2;
+			while( mPos < mEnd && *mPos != '\n' )
+				++mPos;
+		}
+		else if( mPos + 1 < mEnd && mPos[1] == '*' ) {
+			const char *start = mPos;
+			mPos += 2;
+			while( mPos + 1 < mEnd && ! ( mPos[0] == '*' && mPos[1] == '/' ) )
+				++mPos;
+			if( mPos + 1 >= mEnd )
+				throw JsonParseError( start, "unterminated comment" );
+			mPos += 2;
+		}
+		else
+			throw JsonParseError( mPos, "unexpected '/'" );
+	}
+
+	bool parseValue( int depth )
+	{
+		switch( *mPos ) {
+			case '{':	return parseObject( depth );
+			case '[':	return parseArray( depth );
+			case '"':	return parseString( false );
+			case 't':	expectLiteral( "true", 4 ); return mHandler->boolean( true );
+			case 'f':	expectLiteral( "false", 5 ); return mHandler->boolean( false );
+			case 'n':	expectLiteral( "null", 4 ); return mHandler->null();
+			default:
+				if( *mPos == '-' || ( *mPos >= '0' && *mPos <= '9' ) )
+					return parseNumber();
+				throw JsonParseError( mPos, "expected a value" );
+		}
+	}
+
+	void expectLiteral( const char *literal, size_t length )
+	{
+		if( size_t( mEnd - mPos ) < length || memcmp( mPos, literal, length ) != 0 )
+			throw JsonParseError( mPos, "expected a value" );
+		mPos += length;
+	}
+
+	bool parseObject( int depth )
+	{
+		if( depth >= MAX_DEPTH )
+			throw JsonParseError( mPos, "nesting is too deep" );
+		++mPos;
+		if( ! mHandler->startObject() )
+			return false;
+
+		size_t numMembers = 0;
+		skipWhitespace();
+		if( mPos < mEnd && *mPos == '}' ) {
+			++mPos;
+			return mHandler->endObject( 0 );
+		}
+
+		while( true ) {
+			if( mPos == mEnd || *mPos != '"' )
+				throw JsonParseError( mPos, "expected a key" );
+			if( ! parseString( true ) )
+				return false;
+			skipWhitespace();
+			if( mPos == mEnd || *mPos != ':' )
+				throw JsonParseError( mPos, "expected ':'" );
+			++mPos;
+			skipWhitespace();
+			if( mPos == mEnd )
+				throw JsonParseError( mPos, "expected a value" );
+			if( ! parseValue( depth + 1 ) )
+				return false;
+			++numMembers;
+
+			skipWhitespace();
+			if( mPos == mEnd )
+				throw JsonParseError( mPos, "expected ',' or '}'" );
+			if( *mPos == ',' ) {
+				++mPos;
+				skipWhitespace();
+			}
+			else if( *mPos == '}' ) {
+				++mPos;
+				return mHandler->endObject( numMembers );
+			}
+			else
+				throw JsonParseError( mPos, "expected ',' or '}'" );
+		}
+	}
+
+	bool parseArray( int depth )
+	{
+		if( depth >= MAX_DEPTH )
+			throw JsonParseError( mPos, "nesting is too deep" );
+		++mPos;
+		if( ! mHandler->startArray() )
+			return false;
+
+		size_t numElements = 0;
+		skipWhitespace();
+		if( mPos < mEnd && *mPos == ']' ) {
+			++mPos;
+			return mHandler->endArray( 0 );
+		}
+
+		while( true ) {
+			if( mPos == mEnd )
+				throw JsonParseError( mPos, "expected a value" );
+			if( ! parseValue( depth + 1 ) )
+				return false;
+			++numElements;
+
+			skipWhitespace();
+			if( mPos == mEnd )
+				throw JsonParseError( mPos, "expected ',' or ']'" );
+			if( *mPos == ',' ) {
+				++mPos;
+				skipWhitespace();
+			}
+			else if( *mPos == ']' ) {
+				++mPos;
+				return mHandler->endArray( numElements );
+			}
+			else
+				throw JsonParseError( mPos, "expected ',' or ']'" );
+		}
+	}
+
+	//! Returns the first quote or backslash at or after \a p, or mEnd
+	const char* findSpecial( const char *p ) const
+	{
+#if defined( CINDER_JSON_SSE2 )
+		const __m128i quote = _mm_set1_epi8( '"' ), backslash = _mm_set1_epi8( '\\' );
+		for( ; mEnd - p >= 16; p += 16 ) {
+			__m128i chars = _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) );
+			int mask = _mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( chars, quote ), _mm_cmpeq_epi8( chars, backslash ) ) );
+			if( mask ) {
+				int offset = 0;
+				while( ! ( mask & 1 ) ) {
+					mask >>= 1;
+					++offset;
+				}
+				return p + offset;
+			}
+		}
+#endif
+		while( p < mEnd && *p != '"' && *p != '\\' )
+			++p;
+		return p;
+	}
+
+	bool parseString( bool isKey )
+	{
+		const char *start = ++mPos;
+		const char *p = findSpecial( start );
+		if( p == mEnd )
+			throw JsonParseError( start - 1, "unterminated string" );
+
+		// strings without escapes are passed where they lie
+		if( *p == '"' ) {
+			mPos = p + 1;
+			return isKey ? mHandler->key( start, p - start, true ) : mHandler->string( start, p - start, true );
+		}
+
+		mScratch.assign( start, p );
+		while( true ) {
+			if( *p == '"' )
+				break;
+			// *p is a backslash
+			if( ++p == mEnd )
+				throw JsonParseError( start - 1, "unterminated string" );
+			switch( *p ) {
+				case '"':	mScratch += '"'; break;
+				case '\\':	mScratch += '\\'; break;
+				case '/':	mScratch += '/'; break;
+				case 'b':	mScratch += '\b'; break;
+				case 'f':	mScratch += '\f'; break;
+				case 'n':	mScratch += '\n'; break;
+				case 'r':	mScratch += '\r'; break;
+				case 't':	mScratch += '\t'; break;
+				case 'u':	p = parseUnicodeEscape( p + 1 ) - 1; break;
+				default:	throw JsonParseError( p - 1, "invalid escape sequence" );
+			}
+			const char *next = findSpecial( ++p );
+			if( next == mEnd )
+				throw JsonParseError( start - 1, "unterminated string" );
+			mScratch.append( p, next );
+			p = next;
+		}
+
+		mPos = p + 1;
+		return isKey ? mHandler->key( mScratch.data(), mScratch.size(), false ) : mHandler->string( mScratch.data(), mScratch.size(), false );
+	}
+
+	uint32_t parseHex4( const char *p ) const
+	{
+		if( mEnd - p < 4 )
+			throw JsonParseError( p, "invalid unicode escape" );
+		uint32_t result = 0;
+		for( int i = 0; i < 4; ++i ) {
+			char c = p[i];
+			result <<= 4;
+			if( c >= '0' && c <= '9' )
+				result |= c - '0';
+			else if( c >= 'a' && c <= 'f' )
+				result |= c - 'a' + 10;
+			else if( c >= 'A' && c <= 'F' )
+				result |= c - 'A' + 10;
+			else
+				throw JsonParseError( p, "invalid unicode escape" );
+		}
+		return result;
+	}
+
+	//! Decodes the \\u escape whose digits start at \a p into UTF-8, and returns the position after it
+	const char* parseUnicodeEscape( const char *p )
+	{
+		uint32_t codePoint = parseHex4( p );
+		p += 4;
+		// a high surrogate must be followed by an escaped low surrogate
+		if( codePoint >= 0xD800 && codePoint <= 0xDBFF ) {
+			if( mEnd - p < 6 || p[0] != '\\' || p[1] != 'u' )
+				throw JsonParseError( p, "unpaired surrogate in unicode escape" );
+			uint32_t low = parseHex4( p + 2 );
+			if( low < 0xDC00 || low > 0xDFFF )
+				throw JsonParseError( p, "unpaired surrogate in unicode escape" );
+			codePoint = 0x10000 + ( ( codePoint - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+			p += 6;
+		}
+
+		if( codePoint < 0x80 )
+			mScratch += (char)codePoint;
+		else if( codePoint < 0x800 ) {
+			mScratch += (char)( 0xC0 | ( codePoint >> 6 ) );
+			mScratch += (char)( 0x80 | ( codePoint & 0x3F ) );
+		}
+		else if( codePoint < 0x10000 ) {
+			mScratch += (char)( 0xE0 | ( codePoint >> 12 ) );
+			mScratch += (char)( 0x80 | ( ( codePoint >> 6 ) & 0x3F ) );
+			mScratch += (char)( 0x80 | ( codePoint & 0x3F ) );
+		}
+		else {
+			mScratch += (char)( 0xF0 | ( codePoint >> 18 ) );
+			mScratch += (char)( 0x80 | ( ( codePoint >> 12 ) & 0x3F ) );
+			mScratch += (char)( 0x80 | ( ( codePoint >> 6 ) & 0x3F ) );
+			mScratch += (char)( 0x80 | ( codePoint & 0x3F ) );
+		}
+
+		return p;
+	}
+
+	bool parseNumber()
+	{
+		const char *start = mPos;
+		const char *p = mPos;
+		bool negative = false;
+		if( *p == '-' ) {
+			negative = true;
+			++p;
+		}
+
+		// digits accumulate while they fit in a uint64_t, and beyond that only scale the exponent
+		const uint64_t maxBeforeDigit = numeric_limits<uint64_t>::max() / 10;
+		const int maxLastDigit = int( numeric_limits<uint64_t>::max() % 10 );
+		uint64_t mantissa = 0;
+		int exponent = 0;
+		bool overflow = false;
+		if( p == mEnd || *p < '0' || *p > '9' )
+			throw JsonParseError( start, "invalid number" );
+		if( *p == '0' ) {
+			++p;
+			if( p < mEnd && *p >= '0' && *p <= '9' )
+				throw JsonParseError( start, "invalid number" );
+		}
+		else {
+			for( ; p < mEnd && *p >= '0' && *p <= '9'; ++p ) {
+				int digit = *p - '0';
+				if( mantissa < maxBeforeDigit || ( mantissa == maxBeforeDigit && digit <= maxLastDigit ) )
+					mantissa = mantissa * 10 + digit;
+				else {
+					overflow = true;
+					++exponent;
+				}
+			}
+		}
+
+		bool isInteger = true;
+		if( p < mEnd && *p == '.' ) {
+			isInteger = false;
+			const char *fractionStart = ++p;
+			for( ; p < mEnd && *p >= '0' && *p <= '9'; ++p ) {
+				int digit = *p - '0';
+				if( mantissa < maxBeforeDigit || ( mantissa == maxBeforeDigit && digit <= maxLastDigit ) ) {
+					mantissa = mantissa * 10 + digit;
+					--exponent;
+				}
+				else
+					overflow = true;
+			}
+			if( p == fractionStart )
+				throw JsonParseError( start, "invalid number" );
+		}
+		if( p < mEnd && ( *p == 'e' || *p == 'E' ) ) {
+			isInteger = false;
+			++p;
+			bool negativeExponent = false;
+			if( p < mEnd && ( *p == '+' || *p == '-' ) )
+				negativeExponent = *p++ == '-';
+			const char *exponentStart = p;
+			int explicitExponent = 0;
+			for( ; p < mEnd && *p >= '0' && *p <= '9'; ++p ) {
+				if( explicitExponent < 100000 )
+					explicitExponent = explicitExponent * 10 + ( *p - '0' );
+			}
+			if( p == exponentStart )
+				throw JsonParseError( start, "invalid number" );
+			exponent += negativeExponent ? -explicitExponent : explicitExponent;
+		}
+		mPos = p;
+
+		if( isInteger && ! overflow ) {
+			if( negative ) {
+				if( mantissa <= uint64_t( numeric_limits<int64_t>::max() ) + 1 )
+					return mHandler->integer( mantissa == uint64_t( numeric_limits<int64_t>::max() ) + 1 ? numeric_limits<int64_t>::min() : -int64_t( mantissa ) );
+			}
+			else if( mantissa <= uint64_t( numeric_limits<int64_t>::max() ) )
+				return mHandler->integer( int64_t( mantissa ) );
+			else
+				return mHandler->uinteger( mantissa );
+		}
+
+		// exact when both the mantissa and the power of ten are exactly representable as doubles
+		static const double powersOf10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16,
+			1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+		if( ! overflow && mantissa <= ( uint64_t( 1 ) << 53 ) && exponent >= -22 && exponent <= 22 ) {
+			double value = (double)mantissa;
+			value = exponent < 0 ? value / powersOf10[-exponent] : value * powersOf10[exponent];
+			return mHandler->dbl( negative ? -value : value );
+		}
+
+		return mHandler->dbl( parseDoubleSlow( start, p ) );
+	}
+
+	//! Converts with strtod(), which needs a null-terminated copy using the C locale's decimal point
+	double parseDoubleSlow( const char *start, const char *end )
+	{
+		mNumberScratch.assign( start, end );
+		if( mDecimalPoint != '.' ) {
+			size_t point = mNumberScratch.find( '.' );
+			if( point != string::npos )
+				mNumberScratch[point] = mDecimalPoint;
+		}
+		return strtod( mNumberScratch.c_str(), nullptr );
+	}
+
+	const char		*mPos, *mEnd;
+	HandlerT		*mHandler;
+	bool			mAllowComments;
+	char			mDecimalPoint;
+	string			mScratch, mNumberScratch;
+};
+
+string formatParseError( const char *begin, const JsonParseError &error )
+{
+	size_t line = 1, column = 1;
+	for( const char *p = begin; p < error.mPos; ++p ) {
+		if( *p == '\n' ) {
+			++line;
+			column = 1;
+		}
+		else
+			++column;
+	}
+
+	return "Line " + to_string( line ) + ", column " + to_string( column ) + ": " + error.mMessage;
+}
+
+// Runs \a parser, translating errors according to \a options. Returns false if the handler stopped parsing or an error was ignored.
+template<typename HandlerT>
+bool runParser( const char *data, size_t size, HandlerT *handler, const JsonTree::ParseOptions &options )
+{
+	JsonParser<HandlerT> parser( data, size, handler, options.getAllowComments() );
+	try {
+		return parser.parse();
+	}
+	catch( const JsonParseError &error ) {
+		if( options.getIgnoreErrors() )
+			return false;
+		throw JsonTree::ExcJsonParserError( formatParseError( data, error ) );
+	}
+}
+
+// Forwards to a JsonSaxHandler
+class SaxAdapter {
+  public:
+	SaxAdapter( JsonSaxHandler *handler ) : mHandler( handler ) {}
+
+	bool null()										{ return mHandler->onNull(); }
+	bool boolean( bool value )						{ return mHandler->onBool( value ); }
+	bool integer( int64_t value )					{ return mHandler->onInt( value ); }
+	bool uinteger( uint64_t value )					{ return mHandler->onUInt( value ); }
+	bool dbl( double value )						{ return mHandler->onDouble( value ); }
+	bool string( const char *str, size_t length, bool )	{ return mHandler->onString( str, length ); }
+	bool key( const char *str, size_t length, bool )	{ return mHandler->onKey( str, length ); }
+	bool startObject()								{ return mHandler->onStartObject(); }
+	bool endObject( size_t numMembers )				{ return mHandler->onEndObject( numMembers ); }
+	bool startArray()								{ return mHandler->onStartArray(); }
+	bool endArray( size_t numElements )				{ return mHandler->onEndArray( numElements ); }
+
+  private:
+	JsonSaxHandler	*mHandler;
+};
+
+} // anonymous namespace
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// JsonDocumentBuilder
+// Builds values on a stack, and moves the elements or members of each array or object into the document's blocks when it ends
+class JsonDocumentBuilder {
+  public:
+	JsonDocumentBuilder( JsonDocument *document )
+		: mDocument( document )
+	{}
+
+	bool null()					{ push( JsonValue::TYPE_NULL ); return true; }
+	bool boolean( bool value )	{ push( JsonValue::TYPE_BOOL ).mBool = value; return true; }
+	bool integer( int64_t value )	{ push( JsonValue::TYPE_INT ).mInt = value; return true; }
+	bool uinteger( uint64_t value )	{ push( JsonValue::TYPE_UINT ).mUInt = value; return true; }
+	bool dbl( double value )	{ push( JsonValue::TYPE_DOUBLE ).mDouble = value; return true; }
+	bool string( const char *str, size_t length, bool inSource )	{ pushString( str, length, inSource ); return true; }
+	bool key( const char *str, size_t length, bool inSource )		{ pushString( str, length, inSource ); return true; }
+	bool startObject()			{ return true; }
+	bool startArray()			{ return true; }
+	bool endObject( size_t numMembers )		{ pushContainer( JsonValue::TYPE_OBJECT, numMembers, numMembers * 2 ); return true; }
+	bool endArray( size_t numElements )		{ pushContainer( JsonValue::TYPE_ARRAY, numElements, numElements ); return true; }
+
+	JsonValue	getRoot() const		{ return mStack.empty() ? JsonValue() : mStack.back(); }
+
+  private:
+	JsonValue& push( JsonValue::Type type )
+	{
+		mStack.push_back( JsonValue() );
+		mStack.back().mType = (uint8_t)type;
+		return mStack.back();
+	}
+
+	void pushString( const char *str, size_t length, bool inSource )
+	{
+		if( length > numeric_limits<uint32_t>::max() )
+			throw JsonTree::ExcJsonParserError( "string is longer than 4GB" );
+
+		// escaped strings were decoded into scratch space, so they need a permanent copy
+		if( ! inSource ) {
+			char *copy = mDocument->allocate( length );
+			memcpy( copy, str, length );
+			str = copy;
+		}
+		JsonValue &value = push( JsonValue::TYPE_STRING );
+		value.mString = str;
+		value.mSize = (uint32_t)length;
+	}
+
+	void pushContainer( JsonValue::Type type, size_t size, size_t numValues )
+	{
+		if( size > numeric_limits<uint32_t>::max() )
+			throw JsonTree::ExcJsonParserError( "array or object has more than 2^32 entries" );
+
+		JsonValue *values = nullptr;
+		if( numValues ) {
+			values = reinterpret_cast<JsonValue*>( mDocument->allocate( numValues * sizeof( JsonValue ) ) );
+			memcpy( values, &mStack[mStack.size() - numValues], numValues * sizeof( JsonValue ) );
+			mStack.resize( mStack.size() - numValues );
+		}
+		JsonValue &value = push( type );
+		value.mElements = values;
+		value.mSize = (uint32_t)size;
+	}
+
+	JsonDocument		*mDocument;
+	vector<JsonValue>	mStack;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// JsonDocument
+JsonDocument::JsonDocument()
+	: mSourceSize( 0 ), mBlockPos( nullptr ), mBlockRemaining( 0 ), mNextBlockSize( 64 * 1024 ), mAllocatedSize( 0 )
+{
+}
+
+JsonDocumentRef JsonDocument::create( const DataSourceRef &dataSource, const JsonTree::ParseOptions &options )
+{
+	JsonDocumentRef result( new JsonDocument );
+	if( dataSource->isFilePath() ) {
+		result->mMappedFile = MemoryMappedFile::create( dataSource->getFilePath() );
+		result->mMappedFile->setAccessHint( MemoryMappedFile::ACCESS_SEQUENTIAL );
+		result->parse( static_cast<const char*>( result->mMappedFile->getData() ), result->mMappedFile->getSize(), options );
+	}
+	else {
+		result->mBuffer = dataSource->getBuffer();
+		result->parse( static_cast<const char*>( result->mBuffer->getData() ), result->mBuffer->getSize(), options );
+	}
+
+	return result;
+}
+
+JsonDocumentRef JsonDocument::create( const std::string &json, const JsonTree::ParseOptions &options )
+{
+	JsonDocumentRef result( new JsonDocument );
+	result->mString = json;
+	result->parse( result->mString.data(), result->mString.size(), options );
+	return result;
+}
+
+void JsonDocument::parse( const char *data, size_t size, const JsonTree::ParseOptions &options )
+{
+	mSourceSize = size;
+	JsonDocumentBuilder builder( this );
+	if( runParser( data, size, &builder, options ) )
+		mRoot = builder.getRoot();
+}
+
+char* JsonDocument::allocate( size_t size )
+{
+	const size_t alignment = std::alignment_of<JsonValue>::value;
+	size = ( size + alignment - 1 ) & ~( alignment - 1 );
+	if( size > mBlockRemaining ) {
+		// blocks grow with the document, while an oversized request gets a block of its own
+		size_t blockSize = std::max( size, mNextBlockSize );
+		mNextBlockSize = std::min<size_t>( mNextBlockSize * 2, 16 * 1024 * 1024 );
+		mBlocks.push_back( unique_ptr<char[]>( new char[blockSize] ) );
+		mBlockPos = mBlocks.back().get();
+		mBlockRemaining = blockSize;
+		mAllocatedSize += blockSize;
+	}
+
+	char *result = mBlockPos;
+	mBlockPos += size;
+	mBlockRemaining -= size;
+	return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// JsonValue
+namespace {
+
+const char* typeName( JsonValue::Type type )
+{
+	switch( type ) {
+		case JsonValue::TYPE_NULL:		return "null";
+		case JsonValue::TYPE_BOOL:		return "bool";
+		case JsonValue::TYPE_INT:
+		case JsonValue::TYPE_UINT:
+		case JsonValue::TYPE_DOUBLE:	return "number";
+		case JsonValue::TYPE_STRING:	return "string";
+		case JsonValue::TYPE_ARRAY:		return "array";
+		case JsonValue::TYPE_OBJECT:	return "object";
+		default:						return "unknown";
+	}
+}
+
+} // anonymous namespace
+
+bool JsonValue::getBool() const
+{
+	if( mType != TYPE_BOOL )
+		throw JsonValueExc( string( "Expected a bool, not a " ) + typeName( getType() ) );
+	return mBool;
+}
+
+int64_t JsonValue::getInt64() const
+{
+	switch( mType ) {
+		case TYPE_INT:		return mInt;
+		case TYPE_UINT:		return (int64_t)mUInt;
+		case TYPE_DOUBLE:	return (int64_t)mDouble;
+		default:			throw JsonValueExc( string( "Expected a number, not a " ) + typeName( getType() ) );
+	}
+}
+
+uint64_t JsonValue::getUInt64() const
+{
+	switch( mType ) {
+		case TYPE_INT:		return (uint64_t)mInt;
+		case TYPE_UINT:		return mUInt;
+		case TYPE_DOUBLE:	return (uint64_t)mDouble;
+		default:			throw JsonValueExc( string( "Expected a number, not a " ) + typeName( getType() ) );
+	}
+}
+
+double JsonValue::getDouble() const
+{
+	switch( mType ) {
+		case TYPE_INT:		return (double)mInt;
+		case TYPE_UINT:		return (double)mUInt;
+		case TYPE_DOUBLE:	return mDouble;
+		default:			throw JsonValueExc( string( "Expected a number, not a " ) + typeName( getType() ) );
+	}
+}
+
+std::string JsonValue::getString() const
+{
+	if( mType != TYPE_STRING )
+		throw JsonValueExc( string( "Expected a string, not a " ) + typeName( getType() ) );
+	return std::string( mString, mSize );
+}
+
+bool JsonValue::equals( const char *str, size_t length ) const
+{
+	return mType == TYPE_STRING && mSize == length && memcmp( mString, str, length ) == 0;
+}
+
+const JsonValue& JsonValue::operator[]( size_t index ) const
+{
+	if( mType != TYPE_ARRAY )
+		throw JsonValueExc( string( "Expected an array, not a " ) + typeName( getType() ) );
+	if( index >= mSize )
+		throw JsonValueExc( "Index " + to_string( index ) + " is out of range for an array of " + to_string( mSize ) );
+	return mElements[index];
+}
+
+const JsonValue* JsonValue::find( const char *key, size_t length ) const
+{
+	if( mType != TYPE_OBJECT )
+		return nullptr;
+	for( const Member *member = beginMembers(); member != endMembers(); ++member ) {
+		if( member->getKey().equals( key, length ) )
+			return &member->getValue();
+	}
+	return nullptr;
+}
+
+const JsonValue* JsonValue::find( const char *key ) const
+{
+	return find( key, strlen( key ) );
+}
+
+const JsonValue& JsonValue::operator[]( const char *key ) const
+{
+	if( mType != TYPE_OBJECT )
+		throw JsonValueExc( string( "Expected an object, not a " ) + typeName( getType() ) );
+	const JsonValue *result = find( key );
+	if( ! result )
+		throw JsonValueExc( string( "No member named " ) + key );
+	return *result;
+}
+
+const JsonValue& JsonValue::operator[]( const std::string &key ) const
+{
+	return (*this)[key.c_str()];
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// SAX
+bool parseJson( const DataSourceRef &dataSource, JsonSaxHandler *handler, const JsonTree::ParseOptions &options )
+{
+	if( dataSource->isFilePath() ) {
+		MemoryMappedFileRef file = MemoryMappedFile::create( dataSource->getFilePath() );
+		file->setAccessHint( MemoryMappedFile::ACCESS_SEQUENTIAL );
+		return parseJson( static_cast<const char*>( file->getData() ), file->getSize(), handler, options );
+	}
+	else {
+		BufferRef buffer = dataSource->getBuffer();
+		return parseJson( static_cast<const char*>( buffer->getData() ), buffer->getSize(), handler, options );
+	}
+}
+
+bool parseJson( const char *data, size_t size, JsonSaxHandler *handler, const JsonTree::ParseOptions &options )
+{
+	SaxAdapter adapter( handler );
+	return runParser( data, size, &adapter, options );
+}
+
+} // namespace cinder
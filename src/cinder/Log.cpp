@@ -26,11 +26,13 @@
 #include "cinder/Utilities.h"
 #include "cinder/Breakpoint.h"
 #include "cinder/app/Platform.h"
+#include "cinder/ConcurrentQueue.h"
 
 #if defined( CINDER_COCOA )
 	#include "cinder/app/cocoa/PlatformCocoa.h"
 	#import <Foundation/Foundation.h>
 	#include <syslog.h>
+	#include <pthread.h>
 #endif
 
 #if defined( CINDER_COCOA ) && ( ! defined( __OBJC__ ) )
@@ -38,6 +40,8 @@
 #endif
 
 #include <mutex>
+#include <thread>
+#include <condition_variable>
 #include <time.h>
 
 // TODO: consider storing Logger's as shared_ptr instead
@@ -117,6 +121,265 @@ int cinderLogLevelToSysLogLevel( Level cinderLogLevel )
 
 } // anonymous namespace
 
+// ----------------------------------------------------------------------------------------------------
+// MARK: - AsyncLogQueue
+// ----------------------------------------------------------------------------------------------------
+
+// Records are kept in a fixed pool of Slots, which circulate between a queue of free Slots and a queue of pending records drained by a single
+// background thread. Each Slot keeps its Metadata and text strings, so once they have grown large enough, enqueueing a record copies characters without allocating.
+class AsyncLogQueue {
+  public:
+	AsyncLogQueue( LogManager *manager, size_t capacity, OverflowPolicy overflowPolicy );
+	~AsyncLogQueue();
+
+	void	push( const Metadata &meta, const std::string &text );
+	void	flush();
+	// flushes, then returns a lock on mWriteMutex so the Logger can be changed. Returns an empty lock on the background thread, which already holds it.
+	unique_lock<mutex>	pauseWriting();
+	size_t	getNumDropped() const	{ return mNumDropped.load(); }
+
+  private:
+	struct Slot {
+		Metadata	mMeta;
+		std::string	mText;
+	};
+
+	void	threadFn();
+	void	writeSlots( Slot **slots, size_t count );
+	void	reportDropped();
+	bool	isConsumerThread() const	{ return this_thread::get_id() == mThread.get_id(); }
+
+	LogManager				*mManager;
+	OverflowPolicy			mOverflowPolicy;
+	std::unique_ptr<Slot[]>	mSlots;
+	MpmcQueue<Slot*>		mFree, mPending;
+
+	std::atomic<size_t>		mNumPushed, mNumDropped;
+	size_t					mNumWritten; // guarded by mMutex
+	size_t					mNumDroppedReported;
+	std::mutex				mMutex;
+	std::mutex				mWriteMutex; // held by the background thread while it writes to the Logger
+	std::condition_variable	mWrittenCond;
+	std::thread				mThread;
+};
+
+AsyncLogQueue::AsyncLogQueue( LogManager *manager, size_t capacity, OverflowPolicy overflowPolicy )
+	: mManager( manager ), mOverflowPolicy( overflowPolicy ), mFree( std::max<size_t>( capacity, 2 ) ), mPending( mFree.getCapacity() ),
+		mNumPushed( 0 ), mNumDropped( 0 ), mNumWritten( 0 ), mNumDroppedReported( 0 )
+{
+	mSlots.reset( new Slot[mFree.getCapacity()] );
+	for( size_t i = 0; i < mFree.getCapacity(); ++i )
+		mFree.tryPush( &mSlots[i] );
+
+	mThread = thread( &AsyncLogQueue::threadFn, this );
+}
+
+AsyncLogQueue::~AsyncLogQueue()
+{
+	// producers blocked on a full queue give up, and the background thread writes what remains before exiting
+	mFree.cancel();
+	mPending.cancel();
+	mThread.join();
+}
+
+void AsyncLogQueue::push( const Metadata &meta, const std::string &text )
+{
+	// a Logger which logs from the background thread could otherwise wait on itself for a free Slot
+	if( isConsumerThread() ) {
+		mManager->getLogger()->write( meta, text );
+		return;
+	}
+
+	Slot *slot;
+	if( ! mFree.tryPop( &slot ) ) {
+		bool drop = mOverflowPolicy == OVERFLOW_DROP && meta.mLevel < LEVEL_ERROR;
+		if( drop || ! mFree.pop( &slot ) ) {
+			++mNumDropped;
+			return;
+		}
+	}
+
+	slot->mMeta.mLevel = meta.mLevel;
+	slot->mMeta.mLocation = meta.mLocation;
+	slot->mText.assign( text );
+	++mNumPushed;
+	// there are only as many Slots as mPending holds, so this never waits
+	mPending.push( slot );
+}
+
+void AsyncLogQueue::flush()
+{
+	if( isConsumerThread() )
+		return;
+
+	size_t target = mNumPushed.load();
+	unique_lock<mutex> lock( mMutex );
+	mWrittenCond.wait( lock, [&] { return mNumWritten >= target; } );
+}
+
+unique_lock<mutex> AsyncLogQueue::pauseWriting()
+{
+	if( isConsumerThread() )
+		return unique_lock<mutex>();
+
+	flush();
+	return unique_lock<mutex>( mWriteMutex );
+}
+
+void AsyncLogQueue::writeSlots( Slot **slots, size_t count )
+{
+	{
+		lock_guard<mutex> writeLock( mWriteMutex );
+		Logger *logger = mManager->getLogger();
+		for( size_t i = 0; i < count; ++i )
+			logger->write( slots[i]->mMeta, slots[i]->mText );
+	}
+	mFree.pushBatch( slots, count );
+
+	lock_guard<mutex> lock( mMutex );
+	mNumWritten += count;
+	mWrittenCond.notify_all();
+}
+
+void AsyncLogQueue::reportDropped()
+{
+	size_t numDropped = mNumDropped.load();
+	if( numDropped != mNumDroppedReported ) {
+		Metadata meta;
+		meta.mLevel = LEVEL_WARNING;
+		meta.mLocation = Location( CINDER_CURRENT_FUNCTION, __FILE__, __LINE__ );
+		lock_guard<mutex> writeLock( mWriteMutex );
+		mManager->getLogger()->write( meta, to_string( numDropped - mNumDroppedReported ) + " log records dropped because the async queue was full" );
+		mNumDroppedReported = numDropped;
+	}
+}
+
+void AsyncLogQueue::threadFn()
+{
+	Slot *slots[64];
+	while( size_t count = mPending.popBatch( slots, 64 ) ) {
+		writeSlots( slots, count );
+		// records are only dropped while the queue is full, so this reports them once it has drained
+		if( mPending.isEmpty() )
+			reportDropped();
+	}
+
+	// popBatch() returns nothing once canceled, even if records remain
+	while( size_t count = mPending.tryPopBatch( slots, 64 ) )
+		writeSlots( slots, count );
+	reportDropped();
+}
+
+// ----------------------------------------------------------------------------------------------------
+// MARK: - FormatStream
+// ----------------------------------------------------------------------------------------------------
+
+namespace detail {
+
+void FormatStream::reset()
+{
+	mBuf.mString.clear();
+	clear();
+	flags( ios_base::skipws | ios_base::dec );
+	precision( 6 );
+	width( 0 );
+	fill( ' ' );
+}
+
+FormatStream::Buf::int_type FormatStream::Buf::overflow( int_type c )
+{
+	if( ! traits_type::eq_int_type( c, traits_type::eof() ) )
+		mString.push_back( traits_type::to_char_type( c ) );
+	return traits_type::not_eof( c );
+}
+
+streamsize FormatStream::Buf::xsputn( const char *s, streamsize n )
+{
+	mString.append( s, (size_t)n );
+	return n;
+}
+
+namespace {
+
+struct ThreadFormatStream {
+	ThreadFormatStream() : mInUse( false ) {}
+
+	FormatStream	mStream;
+	bool			mInUse;
+};
+
+#if defined( CINDER_COCOA )
+pthread_key_t	sThreadFormatStreamKey;
+pthread_once_t	sThreadFormatStreamKeyOnce = PTHREAD_ONCE_INIT;
+
+void destroyThreadFormatStream( void *stream )
+{
+	delete static_cast<ThreadFormatStream*>( stream );
+}
+
+void createThreadFormatStreamKey()
+{
+	pthread_key_create( &sThreadFormatStreamKey, destroyThreadFormatStream );
+}
+
+ThreadFormatStream* getThreadFormatStream()
+{
+	pthread_once( &sThreadFormatStreamKeyOnce, createThreadFormatStreamKey );
+	auto result = static_cast<ThreadFormatStream*>( pthread_getspecific( sThreadFormatStreamKey ) );
+	if( ! result ) {
+		result = new ThreadFormatStream;
+		pthread_setspecific( sThreadFormatStreamKey, result );
+	}
+	return result;
+}
+#elif defined( _MSC_VER ) && ( _MSC_VER < 1900 )
+// __declspec(thread) only holds PODs, so each thread which logs leaks its stream at exit
+__declspec(thread) ThreadFormatStream *sThreadFormatStream = nullptr;
+
+ThreadFormatStream* getThreadFormatStream()
+{
+	if( ! sThreadFormatStream )
+		sThreadFormatStream = new ThreadFormatStream;
+	return sThreadFormatStream;
+}
+#else
+ThreadFormatStream* getThreadFormatStream()
+{
+	thread_local ThreadFormatStream sThreadFormatStream;
+	return &sThreadFormatStream;
+}
+#endif
+
+} // anonymous namespace
+
+FormatStream* acquireFormatStream( bool *ownedByCaller )
+{
+	ThreadFormatStream *threadStream = getThreadFormatStream();
+	FormatStream *result;
+	if( threadStream->mInUse ) {
+		result = new FormatStream;
+		*ownedByCaller = true;
+	}
+	else {
+		threadStream->mInUse = true;
+		result = &threadStream->mStream;
+		result->reset();
+		*ownedByCaller = false;
+	}
+
+	return result;
+}
+
+void releaseFormatStream( FormatStream *stream, bool ownedByCaller )
+{
+	if( ownedByCaller )
+		delete stream;
+	else
+		getThreadFormatStream()->mInUse = false;
+}
+
+} // namespace detail
+
 // ----------------------------------------------------------------------------------------------------
 // MARK: - LogManager
 // ----------------------------------------------------------------------------------------------------
@@ -129,12 +392,67 @@ LogManager* manager()
 }
 
 LogManager::LogManager()
+	: mLevel( LEVEL_VERBOSE ), mAsyncQueue( nullptr )
 {
 	restoreToDefault();
 }
 
+void LogManager::write( const Metadata &meta, const std::string &text )
+{
+	AsyncLogQueue *asyncQueue = mAsyncQueue.load( memory_order_acquire );
+	if( asyncQueue ) {
+		asyncQueue->push( meta, text );
+		if( meta.mLevel == LEVEL_FATAL )
+			asyncQueue->flush();
+	}
+	else
+		mLogger->write( meta, text );
+}
+
+LogManager::~LogManager()
+{
+	disableAsyncLogging();
+}
+
+void LogManager::enableAsyncLogging( size_t queueCapacity, OverflowPolicy overflowPolicy )
+{
+	// the shared instance is leaked, so records still queued at exit are written from an atexit handler
+	static once_flag sFlushAtExitFlag;
+	call_once( sFlushAtExitFlag, [] { atexit( [] { if( LogManager::instance() ) LogManager::instance()->flush(); } ); } );
+
+	disableAsyncLogging();
+	mAsyncQueue.store( new AsyncLogQueue( this, queueCapacity, overflowPolicy ), memory_order_release );
+}
+
+void LogManager::disableAsyncLogging()
+{
+	AsyncLogQueue *asyncQueue = mAsyncQueue.exchange( nullptr );
+	// the destructor writes what remains before joining the background thread
+	delete asyncQueue;
+}
+
+void LogManager::flush()
+{
+	AsyncLogQueue *asyncQueue = mAsyncQueue.load( memory_order_acquire );
+	if( asyncQueue )
+		asyncQueue->flush();
+}
+
+unique_lock<mutex> LogManager::pauseAsyncWriting()
+{
+	AsyncLogQueue *asyncQueue = mAsyncQueue.load( memory_order_acquire );
+	return asyncQueue ? asyncQueue->pauseWriting() : unique_lock<mutex>();
+}
+
+size_t LogManager::getNumDroppedRecords() const
+{
+	AsyncLogQueue *asyncQueue = mAsyncQueue.load( memory_order_acquire );
+	return asyncQueue ? asyncQueue->getNumDropped() : 0;
+}
+
 void LogManager::resetLogger( Logger *logger )
 {
+	auto writeLock = pauseAsyncWriting();
 	lock_guard<mutex> lock( mMutex );
 
 	mLogger.reset( logger );
@@ -147,6 +465,7 @@ void LogManager::resetLogger( Logger *logger )
 
 void LogManager::addLogger( Logger *logger )
 {
+	auto writeLock = pauseAsyncWriting();
 	lock_guard<mutex> lock( mMutex );
 
 	if( ! mLoggerMulti ) {
@@ -159,16 +478,18 @@ void LogManager::addLogger( Logger *logger )
 	mLoggerMulti->add( logger );
 }
 
-
 void LogManager::removeLogger( Logger *logger )
 {
 	CI_ASSERT( mLoggerMulti );
 
+	auto writeLock = pauseAsyncWriting();
+	lock_guard<mutex> lock( mMutex );
 	mLoggerMulti->remove( logger );
 }
 
 void LogManager::restoreToDefault()
 {
+	auto writeLock = pauseAsyncWriting();
 	lock_guard<mutex> lock( mMutex );
 
 	mLogger.reset( new LoggerConsoleThreadSafe );
@@ -289,7 +610,7 @@ void LogManager::disableConsoleLogging()
 		return;
 
 	auto logger = mLoggerMulti->findType<LoggerConsole>();
-	mLoggerMulti->remove( logger );
+	removeLogger( logger );
 
 	mConsoleLoggingEnabled = false;
 }
@@ -300,7 +621,7 @@ void LogManager::disableFileLogging()
 		return;
 
 	auto logger = mLoggerMulti->findType<LoggerFile>();
-	mLoggerMulti->remove( logger );
+	removeLogger( logger );
 
 	mFileLoggingEnabled = false;
 }
@@ -312,7 +633,7 @@ void LogManager::disableSystemLogging()
 
 #if defined( CINDER_COCOA )
 	auto logger = mLoggerMulti->findType<LoggerSysLog>();
-	mLoggerMulti->remove( logger );
+	removeLogger( logger );
 	mSystemLoggingEnabled = false;
 #endif
 }
@@ -320,6 +641,7 @@ void LogManager::disableSystemLogging()
 void LogManager::enableBreakOnLevel( Level triggerLevel )
 {
 	if( mBreakOnLogEnabled ) {
+		auto writeLock = pauseAsyncWriting();
 		auto logger = mLoggerMulti->findType<LoggerBreakpoint>();
 		logger->setTriggerLevel( triggerLevel );
 	}
@@ -336,7 +658,7 @@ void LogManager::disableBreakOnLog()
 	
 	auto logger = mLoggerMulti->findType<LoggerBreakpoint>();
 	if( logger )
-		mLoggerMulti->remove( logger );
+		removeLogger( logger );
 
 	mBreakOnLogEnabled = false;
 }
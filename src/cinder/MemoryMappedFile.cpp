@@ -0,0 +1,168 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/MemoryMappedFile.h"
+
+#if defined( CINDER_MSW ) || defined( CINDER_WINRT )
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <cerrno>
+	#include <cstring>
+#endif
+
+namespace cinder {
+
+MemoryMappedFileRef MemoryMappedFile::create( const fs::path &path, bool copyOnWrite )
+{
+	return MemoryMappedFileRef( new MemoryMappedFile( path, copyOnWrite ) );
+}
+
+BufferRef MemoryMappedFile::createBuffer( const MemoryMappedFileRef &mappedFile )
+{
+	// the deleter holds a reference to the mapping, which outlives the Buffer's view of it
+	return BufferRef( new Buffer( const_cast<void*>( mappedFile->getData() ), mappedFile->getSize() ), [mappedFile]( Buffer *buffer ) { delete buffer; } );
+}
+
+#if defined( CINDER_MSW ) || defined( CINDER_WINRT )
+MemoryMappedFile::MemoryMappedFile( const fs::path &path, bool copyOnWrite )
+	: mFilePath( path ), mData( nullptr ), mSize( 0 ), mCopyOnWrite( copyOnWrite ), mFileHandle( INVALID_HANDLE_VALUE ), mMappingHandle( nullptr )
+{
+#if defined( CINDER_WINRT )
+	mFileHandle = ::CreateFile2( path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr );
+#else
+	mFileHandle = ::CreateFileW( path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+#endif
+	if( mFileHandle == INVALID_HANDLE_VALUE )
+		throw MemoryMappedFileExc( path, "could not open file" );
+
+	LARGE_INTEGER fileSize;
+	if( ! ::GetFileSizeEx( mFileHandle, &fileSize ) ) {
+		::CloseHandle( mFileHandle );
+		throw MemoryMappedFileExc( path, "could not determine file size" );
+	}
+	mSize = (size_t)fileSize.QuadPart;
+
+	// a zero-length file can't be mapped, but is still a valid empty mapping
+	if( mSize > 0 ) {
+#if defined( CINDER_WINRT )
+		mMappingHandle = ::CreateFileMappingFromApp( mFileHandle, nullptr, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, nullptr );
+		if( mMappingHandle )
+			mData = ::MapViewOfFileFromApp( mMappingHandle, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0 );
+#else
+		mMappingHandle = ::CreateFileMappingW( mFileHandle, nullptr, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr );
+		if( mMappingHandle )
+			mData = ::MapViewOfFile( mMappingHandle, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0 );
+#endif
+		if( ! mData ) {
+			if( mMappingHandle )
+				::CloseHandle( mMappingHandle );
+			::CloseHandle( mFileHandle );
+			throw MemoryMappedFileExc( path, "could not map file" );
+		}
+	}
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	if( mData )
+		::UnmapViewOfFile( mData );
+	if( mMappingHandle )
+		::CloseHandle( mMappingHandle );
+	if( mFileHandle != INVALID_HANDLE_VALUE )
+		::CloseHandle( mFileHandle );
+}
+
+void MemoryMappedFile::setAccessHint( AccessHint /*hint*/ )
+{
+}
+
+void MemoryMappedFile::prefetch( size_t /*offset*/, size_t /*size*/ )
+{
+}
+
+#else
+MemoryMappedFile::MemoryMappedFile( const fs::path &path, bool copyOnWrite )
+	: mFilePath( path ), mData( nullptr ), mSize( 0 ), mCopyOnWrite( copyOnWrite )
+{
+	int fd = ::open( path.c_str(), O_RDONLY );
+	if( fd == -1 )
+		throw MemoryMappedFileExc( path, std::strerror( errno ) );
+
+	struct stat fileStat;
+	if( ::fstat( fd, &fileStat ) == -1 ) {
+		::close( fd );
+		throw MemoryMappedFileExc( path, std::strerror( errno ) );
+	}
+	mSize = (size_t)fileStat.st_size;
+
+	// a zero-length file can't be mapped, but is still a valid empty mapping
+	if( mSize > 0 ) {
+		void *data = ::mmap( nullptr, mSize, copyOnWrite ? ( PROT_READ | PROT_WRITE ) : PROT_READ, MAP_PRIVATE, fd, 0 );
+		if( data == MAP_FAILED ) {
+			::close( fd );
+			throw MemoryMappedFileExc( path, std::strerror( errno ) );
+		}
+		mData = data;
+	}
+
+	// the mapping keeps its own reference to the file
+	::close( fd );
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	if( mData )
+		::munmap( const_cast<void*>( mData ), mSize );
+}
+
+void MemoryMappedFile::setAccessHint( AccessHint hint )
+{
+	if( ! mData )
+		return;
+
+	int advice = MADV_NORMAL;
+	if( hint == ACCESS_SEQUENTIAL )
+		advice = MADV_SEQUENTIAL;
+	else if( hint == ACCESS_RANDOM )
+		advice = MADV_RANDOM;
+	::madvise( const_cast<void*>( mData ), mSize, advice );
+}
+
+void MemoryMappedFile::prefetch( size_t offset, size_t size )
+{
+	if( ! mData || offset >= mSize )
+		return;
+
+	// madvise() requires a page-aligned address
+	size_t pageSize = (size_t)::sysconf( _SC_PAGESIZE );
+	size_t begin = offset - offset % pageSize;
+	size_t end = ( size > mSize - offset ) ? mSize : offset + size;
+	::madvise( static_cast<char*>( const_cast<void*>( mData ) ) + begin, end - begin, MADV_WILLNEED );
+}
+#endif
+
+} // namespace cinder
@@ -0,0 +1,305 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/Profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+using namespace std;
+
+namespace cinder {
+
+namespace {
+
+// frames whose GPU timings haven't arrived after this many frames are retired without them rather than waiting on the GPU
+const size_t MAX_PENDING_FRAMES = 8;
+
+void writeJsonString( ostream &os, const char *str )
+{
+	os << '"';
+	for( const char *c = str; *c; ++c ) {
+		if( *c == '"' || *c == '\\' )
+			os << '\\';
+		os << *c;
+	}
+	os << '"';
+}
+
+string getSamplePath( const Profiler::Frame &frame, int32_t index )
+{
+	string result = frame.mSamples[index].mName;
+	for( int32_t parent = frame.mSamples[index].mParent; parent >= 0; parent = frame.mSamples[parent].mParent )
+		result = string( frame.mSamples[parent].mName ) + "/" + result;
+
+	return result;
+}
+
+} // anonymous namespace
+
+Profiler* Profiler::get()
+{
+	static Profiler sInstance;
+	return &sInstance;
+}
+
+Profiler::Profiler()
+	: mEnabled( false ), mRecording( false ), mTimer( true ), mHistoryLength( 120 ), mMaxGpuMarkersPerFrame( 256 ), mNumGpuMarkers( 0 ), mFrameIndex( 0 )
+{
+}
+
+void Profiler::setGpuTimer( const shared_ptr<GpuTimer> &gpuTimer )
+{
+	// timestamps issued by the previous timer have to be resolved by it
+	resolvePendingFrames( true );
+	mGpuTimer = gpuTimer;
+}
+
+void Profiler::newFrame()
+{
+	if( mRecording ) {
+		// close anything left open; their scopes' pops are ignored later since the stack is empty by then
+		while( ! mStack.empty() )
+			popMarkerImpl();
+
+		mCurrentFrame.mCpuEnd = mTimer.getSeconds();
+		mPending.push_back( std::move( mCurrentFrame ) );
+	}
+
+	resolvePendingFrames( false );
+
+	mRecording = mEnabled;
+	if( mRecording ) {
+		mThreadId = this_thread::get_id();
+		mCurrentFrame.mIndex = mFrameIndex;
+		mCurrentFrame.mCpuStart = mTimer.getSeconds();
+		mCurrentFrame.mGpuOffset = 0;
+		if( mSpareSamples.empty() )
+			mCurrentFrame.mSamples = vector<Sample>();
+		else {
+			mCurrentFrame.mSamples = std::move( mSpareSamples.back() );
+			mSpareSamples.pop_back();
+		}
+
+		uint64_t gpuNow;
+		if( mGpuTimer && mGpuTimer->getCurrentTime( &gpuNow ) )
+			mCurrentFrame.mGpuOffset = mTimer.getSeconds() - gpuNow * 1e-9;
+		mNumGpuMarkers = 0;
+	}
+
+	++mFrameIndex;
+}
+
+void Profiler::pushMarkerImpl( const char *name, bool gpu )
+{
+	if( this_thread::get_id() != mThreadId )
+		return;
+
+	Sample sample;
+	sample.mName = name;
+	sample.mParent = mStack.empty() ? -1 : mStack.back();
+	sample.mDepth = (uint32_t)mStack.size();
+	sample.mCpuEnd = sample.mGpuStart = sample.mGpuEnd = -1;
+	sample.mGpuStartHandle = sample.mGpuEndHandle = 0;
+	sample.mHasGpu = gpu && mGpuTimer && mNumGpuMarkers < mMaxGpuMarkersPerFrame;
+	if( sample.mHasGpu ) {
+		sample.mGpuStartHandle = mGpuTimer->issueTimestamp();
+		++mNumGpuMarkers;
+	}
+
+	mStack.push_back( (int32_t)mCurrentFrame.mSamples.size() );
+	// read the clock last so that the bookkeeping above isn't attributed to the marker
+	sample.mCpuStart = mTimer.getSeconds();
+	mCurrentFrame.mSamples.push_back( sample );
+}
+
+void Profiler::popMarkerImpl()
+{
+	if( mStack.empty() || this_thread::get_id() != mThreadId )
+		return;
+
+	Sample &sample = mCurrentFrame.mSamples[mStack.back()];
+	sample.mCpuEnd = mTimer.getSeconds();
+	if( sample.mHasGpu )
+		sample.mGpuEndHandle = mGpuTimer->issueTimestamp();
+	mStack.pop_back();
+}
+
+void Profiler::resolvePendingFrames( bool force )
+{
+	// frames retire in order, as soon as every one of their timestamps is available
+	while( ! mPending.empty() ) {
+		Frame &frame = mPending.front();
+		bool giveUp = force || mPending.size() > MAX_PENDING_FRAMES;
+		bool ready = true;
+		for( auto &sample : frame.mSamples ) {
+			if( ! sample.mHasGpu || sample.mGpuEnd >= 0 )
+				continue;
+
+			uint64_t start, end;
+			if( mGpuTimer && mGpuTimer->getTimestamp( sample.mGpuStartHandle, &start ) && mGpuTimer->getTimestamp( sample.mGpuEndHandle, &end ) ) {
+				sample.mGpuStart = start * 1e-9 + frame.mGpuOffset;
+				sample.mGpuEnd = end * 1e-9 + frame.mGpuOffset;
+			}
+			else if( ! giveUp ) {
+				ready = false;
+				break;
+			}
+		}
+
+		if( ! ready )
+			break;
+
+		retire( &frame );
+		mPending.pop_front();
+	}
+}
+
+void Profiler::retire( Frame *frame )
+{
+	for( auto &sample : frame->mSamples ) {
+		if( sample.mHasGpu && mGpuTimer ) {
+			mGpuTimer->releaseTimestamp( sample.mGpuStartHandle );
+			mGpuTimer->releaseTimestamp( sample.mGpuEndHandle );
+		}
+	}
+
+	mHistory.push_back( std::move( *frame ) );
+	while( mHistory.size() > mHistoryLength ) {
+		// keep the sample storage around so that steady-state profiling doesn't allocate
+		mHistory.front().mSamples.clear();
+		mSpareSamples.push_back( std::move( mHistory.front().mSamples ) );
+		mHistory.pop_front();
+	}
+}
+
+void Profiler::clear()
+{
+	resolvePendingFrames( true );
+	mHistory.clear();
+}
+
+map<string, Profiler::Stats> Profiler::getStats() const
+{
+	struct Totals {
+		Totals() : mCpu( 0 ), mGpu( 0 ), mCalls( 0 ), mHasGpu( false ) {}
+		double	mCpu, mGpu;
+		size_t	mCalls;
+		bool	mHasGpu;
+	};
+
+	map<string, Stats> result;
+	for( const auto &frame : mHistory ) {
+		map<string, Totals> frameTotals;
+		Totals &frameTotal = frameTotals["Frame"];
+		frameTotal.mCpu = frame.mCpuEnd - frame.mCpuStart;
+		frameTotal.mCalls = 1;
+
+		for( size_t i = 0; i < frame.mSamples.size(); ++i ) {
+			const Sample &sample = frame.mSamples[i];
+			Totals &totals = frameTotals[getSamplePath( frame, (int32_t)i )];
+			totals.mCpu += sample.mCpuEnd - sample.mCpuStart;
+			totals.mCalls++;
+			if( sample.mGpuEnd >= 0 ) {
+				totals.mGpu += sample.mGpuEnd - sample.mGpuStart;
+				totals.mHasGpu = true;
+			}
+		}
+
+		for( const auto &totals : frameTotals ) {
+			Stats &stats = result[totals.first];
+			double cpu = totals.second.mCpu * 1000, gpu = totals.second.mGpu * 1000;
+			stats.mCpuMin = stats.mNumFrames ? std::min( stats.mCpuMin, cpu ) : cpu;
+			stats.mCpuMax = std::max( stats.mCpuMax, cpu );
+			stats.mCpuAvg += cpu;
+			stats.mCallsPerFrame += totals.second.mCalls;
+			stats.mNumFrames++;
+			if( totals.second.mHasGpu ) {
+				stats.mGpuMin = stats.mNumGpuFrames ? std::min( stats.mGpuMin, gpu ) : gpu;
+				stats.mGpuMax = std::max( stats.mGpuMax, gpu );
+				stats.mGpuAvg += gpu;
+				stats.mNumGpuFrames++;
+			}
+		}
+	}
+
+	for( auto &stats : result ) {
+		stats.second.mCpuAvg /= stats.second.mNumFrames;
+		stats.second.mCallsPerFrame /= stats.second.mNumFrames;
+		if( stats.second.mNumGpuFrames )
+			stats.second.mGpuAvg /= stats.second.mNumGpuFrames;
+	}
+
+	return result;
+}
+
+void Profiler::printStats( ostream &os ) const
+{
+	auto stats = getStats();
+	os << "marker                                 calls     cpu min/avg/max (ms)         gpu min/avg/max (ms)" << endl;
+	for( const auto &entry : stats ) {
+		size_t depth = std::count( entry.first.begin(), entry.first.end(), '/' );
+		string name = string( depth * 2, ' ' ) + entry.first.substr( entry.first.rfind( '/' ) + 1 );
+		const Stats &s = entry.second;
+		os << left << setw( 36 ) << name << right << fixed << setprecision( 1 ) << setw( 8 ) << s.mCallsPerFrame
+			<< setprecision( 3 ) << setw( 10 ) << s.mCpuMin << setw( 10 ) << s.mCpuAvg << setw( 10 ) << s.mCpuMax;
+		if( s.mNumGpuFrames )
+			os << setw( 10 ) << s.mGpuMin << setw( 10 ) << s.mGpuAvg << setw( 10 ) << s.mGpuMax;
+		os << endl;
+	}
+	os.unsetf( ios_base::floatfield | ios_base::adjustfield );
+}
+
+void Profiler::writeChromeTrace( ostream &os ) const
+{
+	// timestamps are in microseconds; the CPU and GPU get separate tracks of the same process
+	os << "{\"traceEvents\":[" << endl;
+	os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}}," << endl;
+	os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+	os << fixed << setprecision( 3 );
+	for( const auto &frame : mHistory ) {
+		os << "," << endl << "{\"name\":\"Frame " << frame.mIndex << "\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << frame.mCpuStart * 1e6
+			<< ",\"dur\":" << ( frame.mCpuEnd - frame.mCpuStart ) * 1e6 << "}";
+		for( const auto &sample : frame.mSamples ) {
+			os << "," << endl << "{\"name\":";
+			writeJsonString( os, sample.mName );
+			os << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << sample.mCpuStart * 1e6 << ",\"dur\":" << ( sample.mCpuEnd - sample.mCpuStart ) * 1e6 << "}";
+			if( sample.mGpuEnd >= 0 ) {
+				os << "," << endl << "{\"name\":";
+				writeJsonString( os, sample.mName );
+				os << ",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":" << sample.mGpuStart * 1e6 << ",\"dur\":" << ( sample.mGpuEnd - sample.mGpuStart ) * 1e6 << "}";
+			}
+		}
+	}
+	os << endl << "]}" << endl;
+	os.unsetf( ios_base::floatfield );
+}
+
+void Profiler::writeChromeTrace( const fs::path &path ) const
+{
+	ofstream os( path.string().c_str() );
+	writeChromeTrace( os );
+}
+
+} // namespace cinder
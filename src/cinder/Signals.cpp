@@ -26,12 +26,12 @@
 namespace cinder { namespace signals {
 
 Connection::Connection()
-	: mLink( nullptr ), mPriority( 0 )
+	: mId( 0 ), mPriority( 0 )
 {
 }
 
-Connection::Connection( const std::shared_ptr<detail::Disconnector> &disconnector, detail::SignalLinkBase *link, int priority )
-	: mDisconnector( disconnector ), mLink( link ), mPriority( priority )
+Connection::Connection( const std::shared_ptr<detail::Disconnector> &disconnector, uint64_t id, int priority )
+	: mDisconnector( disconnector ), mId( id ), mPriority( priority )
 {
 }
 
@@ -39,9 +39,9 @@ bool Connection::disconnect()
 {
 	auto disconnector = mDisconnector.lock();
 	if( disconnector ) {
-		auto link = mLink;
-		mLink = nullptr;
-		return disconnector->disconnect( link, mPriority );
+		auto id = mId;
+		mId = 0;
+		return disconnector->disconnect( id, mPriority );
 	}
 
 	return false;
@@ -49,27 +49,31 @@ bool Connection::disconnect()
 
 bool Connection::isConnected() const
 {
-	return ! mDisconnector.expired() && mLink;
+	auto disconnector = mDisconnector.lock();
+	return disconnector && mId && disconnector->isConnected( mId, mPriority );
 }
 
 void Connection::disable()
 {
-	if( mLink ) {
-		mLink->disable();
+	auto disconnector = mDisconnector.lock();
+	if( disconnector ) {
+		disconnector->setEnabled( mId, mPriority, false );
 	}
 }
 
 void Connection::enable()
 {
-	if( mLink ) {
-		mLink->enable();
+	auto disconnector = mDisconnector.lock();
+	if( disconnector ) {
+		disconnector->setEnabled( mId, mPriority, true );
 	}
 }
 
 bool Connection::isEnabled() const
 {
-	if( mLink ) {
-		return mLink->isEnabled();
+	auto disconnector = mDisconnector.lock();
+	if( disconnector ) {
+		return disconnector->isEnabled( mId, mPriority );
 	}
 	return false;
 }
@@ -118,9 +122,24 @@ Disconnector::Disconnector( SignalBase *signal )
 {
 }
 
-bool Disconnector::disconnect( SignalLinkBase *link, int priority )
+bool Disconnector::disconnect( uint64_t id, int priority )
+{
+	return mSignal->disconnect( id, priority );
+}
+
+bool Disconnector::isConnected( uint64_t id, int priority ) const
+{
+	return mSignal->isConnected( id, priority );
+}
+
+void Disconnector::setEnabled( uint64_t id, int priority, bool enable )
+{
+	mSignal->setEnabled( id, priority, enable );
+}
+
+bool Disconnector::isEnabled( uint64_t id, int priority ) const
 {
-	return mSignal->disconnect( link, priority );
+	return mSignal->isEnabled( id, priority );
 }
 
 } } } // namespace cinder::signals::detail
@@ -31,6 +31,23 @@
 #include <boost/scoped_array.hpp>
 #include <iostream>
 #include <boost/preprocessor/seq/for_each.hpp>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#if defined( CINDER_MSW ) || defined( CINDER_WINRT )
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+	#include <malloc.h>
+#else
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <cerrno>
+	#include <cstdlib>
+#endif
 using std::string;
 
 namespace cinder {
@@ -92,16 +109,14 @@ void IStreamCinder::readBig( T *t )
 #endif
 }
 
+#if ! defined( CINDER_LITTLE_ENDIAN )
 template<typename T>
 void IStreamCinder::readLittle( T *t )
 {
-#ifdef CINDER_LITTLE_ENDIAN
-	read( t );
-#else
 	IORead( t, sizeof(T) );
 	*t = swapEndian( *t );
-#endif
 }
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
@@ -144,7 +159,12 @@ std::string IStreamCinder::readLine()
 
 void IStreamCinder::readData( void *t, size_t size )
 {
-	IORead( t, size );
+	if( mReadEnd - mReadPos >= (ptrdiff_t)size ) {
+		memcpy( t, mReadPos, size );
+		mReadPos += size;
+	}
+	else
+		IORead( t, size );
 }
 
 void OStream::write( const Buffer &buffer )
@@ -261,6 +281,296 @@ void IStreamFile::IORead( void *t, size_t size )
 		throw StreamExc();
 }
 
+////////////////////////////////////////////////////////////////////////////////////////
+// IStreamFileBlock
+
+// The reader thread fills mNextBlock while the stream consumes mBlock. A read is only ever outstanding for the block following
+// the current one, and the stream waits for it to finish before touching mNextBlock.
+struct IStreamFileBlock::ReadAhead {
+	enum State { IDLE, PENDING, DONE };
+
+	ReadAhead() : mState( IDLE ), mQuit( false ), mOffset( 0 ), mBytesRead( 0 ) {}
+
+	std::thread					mThread;
+	std::mutex					mMutex;
+	std::condition_variable		mCondition;
+	State						mState;
+	bool						mQuit;
+	off_t						mOffset;
+	size_t						mBytesRead;
+};
+
+namespace {
+
+const size_t BLOCK_ALIGNMENT = 4096;
+
+uint8_t* allocateBlock( size_t size )
+{
+#if defined( CINDER_MSW ) || defined( CINDER_WINRT )
+	void *result = _aligned_malloc( size, BLOCK_ALIGNMENT );
+#else
+	void *result = nullptr;
+	if( posix_memalign( &result, BLOCK_ALIGNMENT, size ) )
+		result = nullptr;
+#endif
+	if( ! result )
+		throw StreamExcOutOfMemory();
+	return reinterpret_cast<uint8_t*>( result );
+}
+
+void freeBlock( uint8_t *block )
+{
+#if defined( CINDER_MSW ) || defined( CINDER_WINRT )
+	_aligned_free( block );
+#else
+	free( block );
+#endif
+}
+
+} // anonymous namespace
+
+IStreamFileBlockRef IStreamFileBlock::create( const fs::path &path, const Options &options )
+{
+	IStreamFileBlockRef result( new IStreamFileBlock( path, options ) );
+#if defined( CINDER_MSW ) || defined( CINDER_WINRT )
+	if( result->mHandle == INVALID_HANDLE_VALUE )
+#else
+	if( result->mFd < 0 )
+#endif
+		return IStreamFileBlockRef();
+
+	result->setFileName( path );
+	return result;
+}
+
+IStreamFileBlock::IStreamFileBlock( const fs::path &path, const Options &options )
+	: IStreamCinder(), mOptions( options ), mSize( 0 ), mBlock( nullptr ), mNextBlock( nullptr ), mBlockFileOffset( 0 ), mBlockDataSize( 0 )
+{
+	mOptions.blockSize( std::max<size_t>( ( mOptions.getBlockSize() + BLOCK_ALIGNMENT - 1 ) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT, BLOCK_ALIGNMENT ) );
+	mBlock = allocateBlock( mOptions.getBlockSize() );
+	if( mOptions.isReadAhead() )
+		mNextBlock = allocateBlock( mOptions.getBlockSize() );
+	mReadPos = mReadEnd = mBlock;
+
+#if defined( CINDER_MSW ) || defined( CINDER_WINRT )
+  #if defined( CINDER_WINRT )
+	mHandle = ::CreateFile2( path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr );
+  #else
+	mHandle = ::CreateFileW( path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+  #endif
+	if( mHandle == INVALID_HANDLE_VALUE )
+		return;
+	LARGE_INTEGER fileSize;
+	if( ::GetFileSizeEx( mHandle, &fileSize ) )
+		mSize = static_cast<off_t>( fileSize.QuadPart );
+#else
+	mFd = ::open( path.string().c_str(), O_RDONLY );
+	if( mFd < 0 )
+		return;
+	struct stat fileStat;
+	if( ::fstat( mFd, &fileStat ) == 0 )
+		mSize = static_cast<off_t>( fileStat.st_size );
+  #if defined( POSIX_FADV_SEQUENTIAL )
+	::posix_fadvise( mFd, 0, 0, POSIX_FADV_SEQUENTIAL );
+  #endif
+#endif
+
+	if( mOptions.isReadAhead() ) {
+		mReadAhead.reset( new ReadAhead );
+		ReadAhead *readAhead = mReadAhead.get();
+		mReadAhead->mThread = std::thread( [this, readAhead] {
+			std::unique_lock<std::mutex> lock( readAhead->mMutex );
+			while( true ) {
+				readAhead->mCondition.wait( lock, [readAhead] { return readAhead->mQuit || readAhead->mState == ReadAhead::PENDING; } );
+				if( readAhead->mQuit )
+					break;
+
+				off_t offset = readAhead->mOffset;
+				lock.unlock();
+				size_t bytesRead = readAt( offset, mNextBlock, mOptions.getBlockSize() );
+				lock.lock();
+
+				readAhead->mBytesRead = bytesRead;
+				readAhead->mState = ReadAhead::DONE;
+				readAhead->mCondition.notify_all();
+			}
+		} );
+	}
+}
+
+IStreamFileBlock::~IStreamFileBlock()
+{
+	if( mReadAhead ) {
+		{
+			std::lock_guard<std::mutex> lock( mReadAhead->mMutex );
+			mReadAhead->mQuit = true;
+		}
+		mReadAhead->mCondition.notify_all();
+		mReadAhead->mThread.join();
+	}
+
+#if defined( CINDER_MSW ) || defined( CINDER_WINRT )
+	if( mHandle != INVALID_HANDLE_VALUE )
+		::CloseHandle( mHandle );
+#else
+	if( mFd >= 0 )
+		::close( mFd );
+#endif
+	if( mBlock )
+		freeBlock( mBlock );
+	if( mNextBlock )
+		freeBlock( mNextBlock );
+
+	if( mDeleteOnDestroy && ( ! mFileName.empty() ) )
+		fs::remove( mFileName );
+}
+
+size_t IStreamFileBlock::readAt( off_t offset, void *dest, size_t size ) const
+{
+	uint8_t *destBytes = reinterpret_cast<uint8_t*>( dest );
+	size_t result = 0;
+	while( result < size ) {
+#if defined( CINDER_MSW ) || defined( CINDER_WINRT )
+		// an OVERLAPPED offset makes ReadFile positional on a synchronous handle
+		OVERLAPPED overlapped = {};
+		uint64_t readOffset = static_cast<uint64_t>( offset ) + result;
+		overlapped.Offset = static_cast<DWORD>( readOffset );
+		overlapped.OffsetHigh = static_cast<DWORD>( readOffset >> 32 );
+		DWORD bytesRead = 0;
+		DWORD toRead = static_cast<DWORD>( std::min<size_t>( size - result, 1 << 30 ) );
+		if( ! ::ReadFile( mHandle, destBytes + result, toRead, &bytesRead, &overlapped ) || bytesRead == 0 )
+			break;
+#else
+		ssize_t bytesRead = ::pread( mFd, destBytes + result, size - result, offset + result );
+		if( bytesRead < 0 && errno == EINTR )
+			continue;
+		else if( bytesRead <= 0 )
+			break;
+#endif
+		result += bytesRead;
+	}
+
+	return result;
+}
+
+void IStreamFileBlock::requestReadAhead( off_t offset )
+{
+	{
+		std::lock_guard<std::mutex> lock( mReadAhead->mMutex );
+		mReadAhead->mOffset = offset;
+		mReadAhead->mState = ReadAhead::PENDING;
+	}
+	mReadAhead->mCondition.notify_all();
+}
+
+bool IStreamFileBlock::loadBlock( off_t offset )
+{
+	const size_t blockSize = mOptions.getBlockSize();
+	off_t blockOffset = offset - offset % blockSize;
+
+	bool loaded = false;
+	if( mReadAhead ) {
+		// a read in flight is always waited out, since it fills mNextBlock
+		std::unique_lock<std::mutex> lock( mReadAhead->mMutex );
+		mReadAhead->mCondition.wait( lock, [this] { return mReadAhead->mState != ReadAhead::PENDING; } );
+		if( mReadAhead->mState == ReadAhead::DONE && mReadAhead->mOffset == blockOffset ) {
+			std::swap( mBlock, mNextBlock );
+			mBlockDataSize = mReadAhead->mBytesRead;
+			loaded = true;
+		}
+		mReadAhead->mState = ReadAhead::IDLE;
+	}
+	if( ! loaded )
+		mBlockDataSize = readAt( blockOffset, mBlock, blockSize );
+	mBlockFileOffset = blockOffset;
+
+	if( mReadAhead && blockOffset + (off_t)blockSize < mSize )
+		requestReadAhead( blockOffset + blockSize );
+
+	if( offset >= mBlockFileOffset + (off_t)mBlockDataSize ) {
+		mBlockFileOffset = offset;
+		mBlockDataSize = 0;
+		mReadPos = mReadEnd = mBlock;
+		return false;
+	}
+
+	mReadPos = mBlock + ( offset - mBlockFileOffset );
+	mReadEnd = mBlock + mBlockDataSize;
+	return true;
+}
+
+size_t IStreamFileBlock::readDataImpl( void *dest, size_t size )
+{
+	uint8_t *destBytes = reinterpret_cast<uint8_t*>( dest );
+	size_t result = 0;
+	while( result < size ) {
+		size_t available = mReadEnd - mReadPos;
+		if( available ) {
+			size_t amount = std::min( available, size - result );
+			memcpy( destBytes + result, mReadPos, amount );
+			mReadPos += amount;
+			result += amount;
+		}
+		else if( size - result >= mOptions.getBlockSize() ) { // too big to be worth buffering, so read straight into dest
+			off_t offset = tell();
+			size_t bytesRead = readAt( offset, destBytes + result, size - result );
+			result += bytesRead;
+			// leave an empty block at the new position, which the next small read loads from
+			mBlockFileOffset = offset + bytesRead;
+			mBlockDataSize = 0;
+			mReadPos = mReadEnd = mBlock;
+			if( bytesRead == 0 )
+				break;
+		}
+		else if( ! loadBlock( tell() ) )
+			break;
+	}
+
+	return result;
+}
+
+size_t IStreamFileBlock::readDataAvailable( void *dest, size_t maxSize )
+{
+	return readDataImpl( dest, maxSize );
+}
+
+void IStreamFileBlock::IORead( void *t, size_t size )
+{
+	if( readDataImpl( t, size ) != size )
+		throw StreamExc();
+}
+
+void IStreamFileBlock::seekAbsolute( off_t absoluteOffset )
+{
+	if( absoluteOffset < 0 )
+		absoluteOffset += mSize;
+	if( absoluteOffset < 0 || absoluteOffset > mSize )
+		throw StreamExc();
+
+	// keep the current block when the offset falls inside it
+	if( absoluteOffset >= mBlockFileOffset && absoluteOffset <= mBlockFileOffset + (off_t)mBlockDataSize )
+		mReadPos = mBlock + ( absoluteOffset - mBlockFileOffset );
+	else {
+		mBlockFileOffset = absoluteOffset;
+		mBlockDataSize = 0;
+		mReadPos = mReadEnd = mBlock;
+	}
+}
+
+void IStreamFileBlock::seekRelative( off_t relativeOffset )
+{
+	// range-checked here, as seekAbsolute() would treat a negative result as relative to the end
+	off_t absoluteOffset = tell() + relativeOffset;
+	if( absoluteOffset < 0 || absoluteOffset > mSize )
+		throw StreamExc();
+	seekAbsolute( absoluteOffset );
+}
+
+off_t IStreamFileBlock::tell() const
+{
+	return mBlockFileOffset + static_cast<off_t>( mReadPos - mBlock );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////
 // OStreamFile
 OStreamFileRef OStreamFile::create( FILE *file, bool ownsFile )
@@ -424,10 +734,12 @@ IStreamMemRef IStreamMem::create( const void *data, size_t size )
 	return IStreamMemRef( new IStreamMem( data, size ) );
 }
 
+// the whole of the data is the read window, so mReadPos is the stream's position
 IStreamMem::IStreamMem( const void *aData, size_t aDataSize )
 	: IStreamCinder(), mData( reinterpret_cast<const uint8_t*>( aData ) ), mDataSize( aDataSize )
 {
-	mOffset = 0;
+	mReadPos = mData;
+	mReadEnd = mData + mDataSize;
 }
 
 IStreamMem::~IStreamMem()
@@ -436,15 +748,13 @@ IStreamMem::~IStreamMem()
 
 size_t IStreamMem::readDataAvailable( void *dest, size_t maxSize )
 {
-	if ( mOffset + maxSize > mDataSize ) {
-		maxSize = mDataSize - mOffset;
-		memcpy( dest, mData + mOffset, maxSize );
-		mOffset = mDataSize;
-	}
-	else {
-		memcpy( dest, mData + mOffset, maxSize );
-		mOffset += maxSize;
-	}
+	size_t offset = mReadPos - mData;
+	if( offset >= mDataSize )
+		return 0;
+
+	maxSize = std::min( maxSize, mDataSize - offset );
+	memcpy( dest, mReadPos, maxSize );
+	mReadPos += maxSize;
 	
 	return maxSize;	
 }
@@ -452,35 +762,31 @@ size_t IStreamMem::readDataAvailable( void *dest, size_t maxSize )
 void IStreamMem::seekAbsolute( off_t absoluteOffset )
 {
 	if( absoluteOffset < 0 )
-		absoluteOffset = mDataSize + absoluteOffset;
-	mOffset = absoluteOffset;
-	if( absoluteOffset > static_cast<off_t>( mDataSize ) )
+		absoluteOffset += mDataSize;
+	if( absoluteOffset < 0 || absoluteOffset > static_cast<off_t>( mDataSize ) )
 		throw StreamExc();
+	mReadPos = mData + absoluteOffset;
 }
 
 void IStreamMem::seekRelative( off_t relativeOffset )
 {
-	mOffset += relativeOffset;
-	if( mOffset > mDataSize )
+	off_t absoluteOffset = tell() + relativeOffset;
+	if( absoluteOffset < 0 || absoluteOffset > static_cast<off_t>( mDataSize ) )
 		throw StreamExc();
-}
-
-off_t IStreamMem::tell() const
-{
-	return static_cast<off_t>( mOffset );
+	mReadPos = mData + absoluteOffset;
 }
 
 bool IStreamMem::isEof() const
 {
-	return mOffset >= mDataSize;
+	return mReadPos >= mReadEnd;
 }
 
 void IStreamMem::IORead( void *t, size_t size )
 {
-	if ( mOffset + size > mDataSize )
+	if( size > static_cast<size_t>( mReadEnd - mReadPos ) )
 		throw StreamExc();
-	memcpy( t, mData + mOffset, size );
-	mOffset += size;
+	memcpy( t, mReadPos, size );
+	mReadPos += size;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
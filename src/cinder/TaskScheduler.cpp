@@ -0,0 +1,338 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/TaskScheduler.h"
+#include "cinder/ConcurrentQueue.h"
+
+#include <thread>
+
+// the Linux headless app has no event loop to post main thread continuations to
+#if ! defined( CINDER_LINUX )
+	#include "cinder/app/AppBase.h"
+#endif
+
+#if defined( _MSC_VER )
+	#define CI_TASK_THREAD_LOCAL __declspec( thread )
+#else
+	#define CI_TASK_THREAD_LOCAL __thread
+#endif
+
+using namespace std;
+
+namespace cinder {
+
+namespace {
+
+// identifies the worker running on this thread, if any
+CI_TASK_THREAD_LOCAL const TaskScheduler	*sCurrentScheduler = nullptr;
+CI_TASK_THREAD_LOCAL size_t					sCurrentWorkerIndex = 0;
+
+// how many times an idle thread yields before going to sleep
+const int NUM_IDLE_SPINS = 64;
+
+once_flag			sSharedOnce;
+TaskSchedulerRef	sShared;
+
+} // anonymous namespace
+
+struct TaskScheduler::Worker {
+	mutex			mMutex;
+	deque<TaskRef>	mTasks;		// the worker pushes and pops at the back, thieves take from the front
+	thread			mThread;
+};
+
+struct TaskScheduler::Signals {
+	detail::QueueSignal		mWorkQueued;	// idle workers wait on this
+	detail::QueueSignal		mProgress;		// threads in waitFor() wait on this, for a task to complete or be queued
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Task
+Task::Task( TaskScheduler *scheduler, const function<void()> &fn, bool mainThread )
+	: mScheduler( scheduler ), mFn( fn ), mMainThread( mainThread ), mNumPending( 1 ), mDone( false )
+{
+}
+
+void Task::dependsOn( const TaskRef &other )
+{
+	lock_guard<mutex> lock( other->mMutex );
+	if( ! other->mDone.load( memory_order_relaxed ) ) {
+		mNumPending.fetch_add( 1, memory_order_relaxed );
+		other->mDependents.push_back( shared_from_this() );
+	}
+}
+
+TaskRef Task::then( const function<void()> &fn )
+{
+	TaskRef task = mScheduler->createTask( fn );
+	task->dependsOn( shared_from_this() );
+	mScheduler->submit( task );
+	return task;
+}
+
+TaskRef Task::thenOnMainThread( const function<void()> &fn )
+{
+	TaskRef task( new Task( mScheduler, fn, true ) );
+	task->dependsOn( shared_from_this() );
+	mScheduler->submit( task );
+	return task;
+}
+
+void Task::wait()
+{
+	if( ! isDone() )
+		mScheduler->waitFor( [this] { return isDone(); } );
+	if( mException )
+		rethrow_exception( mException );
+}
+
+void Task::run()
+{
+	try {
+		mFn();
+	}
+	catch( ... ) {
+		mException = current_exception();
+	}
+	// releases anything the function captured
+	mFn = nullptr;
+
+	vector<TaskRef> dependents;
+	{
+		lock_guard<mutex> lock( mMutex );
+		mDone.store( true, memory_order_release );
+		dependents.swap( mDependents );
+	}
+	mScheduler->complete( dependents );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// TaskScheduler
+TaskSchedulerRef TaskScheduler::create( const Options &options )
+{
+	return TaskSchedulerRef( new TaskScheduler( options ) );
+}
+
+TaskSchedulerRef TaskScheduler::get()
+{
+	call_once( sSharedOnce, [] { sShared = create(); } );
+	return sShared;
+}
+
+TaskScheduler::TaskScheduler( const Options &options )
+	: mNumQueued( 0 ), mQuit( false ), mSignals( new Signals )
+{
+	size_t numThreads = options.getNumThreads();
+	if( numThreads == 0 )
+		numThreads = std::max<size_t>( thread::hardware_concurrency(), 2 ) - 1;
+
+	for( size_t i = 0; i < numThreads; ++i )
+		mWorkers.emplace_back( new Worker );
+	// started only once mWorkers is complete, since the workers steal from each other
+	for( size_t i = 0; i < numThreads; ++i )
+		mWorkers[i]->mThread = thread( &TaskScheduler::workerLoop, this, i );
+}
+
+TaskScheduler::~TaskScheduler()
+{
+	mQuit = true;
+	mSignals->mWorkQueued.notify();
+	for( auto &worker : mWorkers )
+		worker->mThread.join();
+}
+
+TaskRef TaskScheduler::createTask( const function<void()> &fn )
+{
+	return TaskRef( new Task( this, fn, false ) );
+}
+
+void TaskScheduler::submit( const TaskRef &task )
+{
+	if( task->release() )
+		schedule( task );
+}
+
+TaskRef TaskScheduler::async( const function<void()> &fn )
+{
+	TaskRef task = createTask( fn );
+	schedule( task );
+	return task;
+}
+
+bool TaskScheduler::isWorkerThread() const
+{
+	return sCurrentScheduler == this;
+}
+
+void TaskScheduler::schedule( const TaskRef &task )
+{
+	if( task->mMainThread ) {
+#if ! defined( CINDER_LINUX )
+		app::AppBase *app = app::AppBase::get();
+		if( app ) {
+			app->dispatchAsync( [task] { task->run(); } );
+			return;
+		}
+#endif
+		task->run();
+		return;
+	}
+
+	if( isWorkerThread() ) {
+		Worker &worker = *mWorkers[sCurrentWorkerIndex];
+		lock_guard<mutex> lock( worker.mMutex );
+		worker.mTasks.push_back( task );
+	}
+	else {
+		lock_guard<mutex> lock( mInjectedMutex );
+		mInjected.push_back( task );
+	}
+
+	mNumQueued.fetch_add( 1 );
+	mSignals->mWorkQueued.notifyOne();
+	mSignals->mProgress.notify();
+}
+
+void TaskScheduler::complete( vector<TaskRef> &dependents )
+{
+	for( auto &dependent : dependents ) {
+		if( dependent->release() )
+			schedule( dependent );
+	}
+	mSignals->mProgress.notify();
+}
+
+bool TaskScheduler::runQueuedTask()
+{
+	// the count can briefly trail the deques, in which case the caller checks again after waiting on a signal
+	if( mNumQueued.load( memory_order_relaxed ) <= 0 )
+		return false;
+
+	TaskRef task;
+	size_t firstVictim = 0;
+	if( isWorkerThread() ) {
+		Worker &worker = *mWorkers[sCurrentWorkerIndex];
+		lock_guard<mutex> lock( worker.mMutex );
+		if( ! worker.mTasks.empty() ) {
+			task = std::move( worker.mTasks.back() );
+			worker.mTasks.pop_back();
+		}
+		firstVictim = sCurrentWorkerIndex + 1;
+	}
+
+	if( ! task ) {
+		lock_guard<mutex> lock( mInjectedMutex );
+		if( ! mInjected.empty() ) {
+			task = std::move( mInjected.front() );
+			mInjected.pop_front();
+		}
+	}
+
+	for( size_t i = 0; i < mWorkers.size() && ! task; ++i ) {
+		Worker &victim = *mWorkers[( firstVictim + i ) % mWorkers.size()];
+		lock_guard<mutex> lock( victim.mMutex );
+		if( ! victim.mTasks.empty() ) {
+			task = std::move( victim.mTasks.front() );
+			victim.mTasks.pop_front();
+		}
+	}
+
+	if( ! task )
+		return false;
+
+	mNumQueued.fetch_sub( 1 );
+	task->run();
+	return true;
+}
+
+void TaskScheduler::waitFor( const function<bool()> &done )
+{
+	auto ready = [&] { return done() || mNumQueued.load() > 0; };
+	while( ! done() ) {
+		if( runQueuedTask() )
+			continue;
+
+		// what's being waited on is usually close to finishing, so yield for a while before sleeping
+		int spin = 0;
+		while( spin < NUM_IDLE_SPINS && ! ready() ) {
+			this_thread::yield();
+			++spin;
+		}
+		if( spin == NUM_IDLE_SPINS )
+			mSignals->mProgress.wait( ready );
+	}
+}
+
+void TaskScheduler::workerLoop( size_t index )
+{
+	sCurrentScheduler = this;
+	sCurrentWorkerIndex = index;
+
+	auto ready = [this] { return mQuit.load() || mNumQueued.load() > 0; };
+	while( ! mQuit ) {
+		if( runQueuedTask() )
+			continue;
+
+		int spin = 0;
+		while( spin < NUM_IDLE_SPINS && ! ready() ) {
+			this_thread::yield();
+			++spin;
+		}
+		if( spin == NUM_IDLE_SPINS )
+			mSignals->mWorkQueued.wait( ready );
+	}
+}
+
+void TaskScheduler::parallelForChunks( size_t numChunks, const function<void( size_t )> &runChunk )
+{
+	atomic<size_t> nextChunk( 0 ), numHelpersDone( 0 );
+	atomic<bool> failed( false );
+	exception_ptr error;
+	auto runChunks = [&] {
+		try {
+			for( size_t chunk = nextChunk++; chunk < numChunks && ! failed; chunk = nextChunk++ )
+				runChunk( chunk );
+		}
+		catch( ... ) {
+			if( ! failed.exchange( true ) )
+				error = current_exception();
+		}
+	};
+
+	// helpers that start after every chunk has been claimed return immediately, so a busy pool just runs more of the chunks here
+	const size_t numHelpers = std::min( numChunks - 1, mWorkers.size() );
+	for( size_t i = 0; i < numHelpers; ++i ) {
+		async( [&] {
+			runChunks();
+			numHelpersDone.fetch_add( 1, memory_order_release );
+		} );
+	}
+
+	runChunks();
+	waitFor( [&] { return numHelpersDone.load( memory_order_acquire ) == numHelpers; } );
+
+	if( error )
+		rethrow_exception( error );
+}
+
+} // namespace cinder
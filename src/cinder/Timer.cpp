@@ -28,14 +28,27 @@
 	#include <windows.h>
 #elif defined( CINDER_COCOA )
 	#include <CoreFoundation/CoreFoundation.h>
+#elif defined( CINDER_LINUX )
+	#include <time.h>
 #endif
 
 namespace cinder {
 
+#if defined( CINDER_LINUX )
+namespace {
+double monotonicSeconds()
+{
+	::timespec ts;
+	::clock_gettime( CLOCK_MONOTONIC, &ts );
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+} // anonymous namespace
+#endif
+
 Timer::Timer()
 	: mIsStopped( true )
 {
-#if defined( CINDER_COCOA )
+#if defined( CINDER_COCOA ) || defined( CINDER_LINUX )
 	mEndTime = mStartTime = -1;
 #elif (defined( CINDER_MSW ) || defined( CINDER_WINRT))
 	::LARGE_INTEGER nativeFreq;
@@ -48,7 +61,7 @@ Timer::Timer()
 Timer::Timer( bool startOnConstruction )
 	: mIsStopped( true )
 {
-#if defined( CINDER_COCOA )
+#if defined( CINDER_COCOA ) || defined( CINDER_LINUX )
 		mEndTime = mStartTime = -1;
 #elif (defined( CINDER_MSW ) || defined( CINDER_WINRT))
 	::LARGE_INTEGER nativeFreq;
@@ -69,6 +82,8 @@ void Timer::start( double offsetSeconds )
 	::LARGE_INTEGER rawTime;
 	::QueryPerformanceCounter( &rawTime );
 	mStartTime = rawTime.QuadPart * mInvNativeFreq - offsetSeconds;
+#elif defined( CINDER_LINUX )
+	mStartTime = monotonicSeconds() - offsetSeconds;
 #endif
 
 	mIsStopped = false;
@@ -85,6 +100,8 @@ double Timer::getSeconds() const
 	::LARGE_INTEGER rawTime;
 	::QueryPerformanceCounter( &rawTime );
 	return (rawTime.QuadPart * mInvNativeFreq) - mStartTime;
+#elif defined( CINDER_LINUX )
+		return monotonicSeconds() - mStartTime;
 #endif
 	}
 }
@@ -98,6 +115,8 @@ void Timer::stop()
 		::LARGE_INTEGER rawTime;
 		::QueryPerformanceCounter( &rawTime );
 		mEndTime = rawTime.QuadPart * mInvNativeFreq;
+#elif defined( CINDER_LINUX )
+		mEndTime = monotonicSeconds();
 #endif
 		mIsStopped = true;
 	}
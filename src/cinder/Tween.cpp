@@ -24,6 +24,7 @@
 
 #include "cinder/Tween.h"
 #include "cinder/Timeline.h"
+#include "cinder/TweenEngine.h"
 
 #include <algorithm>
 
@@ -63,12 +64,17 @@ AnimBase::AnimBase( const AnimBase &rhs, void *voidPtr )
 	if( mParentTimeline ) {
 		mParentTimeline->cloneAndReplaceTarget( rhs.mVoidPtr, mVoidPtr );
 	}	
+	mParentEngine = rhs.mParentEngine;
+	if( mParentEngine )
+		mParentEngine->cloneAndReplaceTarget( rhs.mVoidPtr, mVoidPtr );
 }
 
 AnimBase::~AnimBase()
 {
 	if( mParentTimeline )
 		mParentTimeline->removeTarget( mVoidPtr );
+	if( mParentEngine )
+		mParentEngine->removeTarget( mVoidPtr );
 }
 
 void AnimBase::set( const AnimBase &rhs )
@@ -77,6 +83,9 @@ void AnimBase::set( const AnimBase &rhs )
 	if( mParentTimeline ) {
 		mParentTimeline->cloneAndReplaceTarget( rhs.mVoidPtr, mVoidPtr );
 	}	
+	setParentEngine( rhs.mParentEngine );
+	if( mParentEngine )
+		mParentEngine->cloneAndReplaceTarget( rhs.mVoidPtr, mVoidPtr );
 }
 
 // Implements move semantics
@@ -86,10 +95,16 @@ void AnimBase::setReplace( const AnimBase &rhs )
 	if( mParentTimeline ) {
 		mParentTimeline->replaceTarget( rhs.mVoidPtr, mVoidPtr );
 	}	
+	setParentEngine( rhs.mParentEngine );
+	if( mParentEngine )
+		mParentEngine->replaceTarget( rhs.mVoidPtr, mVoidPtr );
 }
 
 bool AnimBase::isComplete() const
 {
+	if( mParentEngine && mParentEngine->hasTarget( mVoidPtr ) )
+		return false;
+
 	if( ! mParentTimeline )
 		return true;
 	else {
@@ -106,6 +121,9 @@ void AnimBase::stop()
 	if( mParentTimeline )
 		mParentTimeline->removeTarget( mVoidPtr );
 	mParentTimeline.reset();
+	if( mParentEngine )
+		mParentEngine->removeTarget( mVoidPtr );
+	mParentEngine.reset();
 }
 
 void AnimBase::setParentTimeline( TimelineRef parentTimeline )
@@ -116,6 +134,14 @@ void AnimBase::setParentTimeline( TimelineRef parentTimeline )
 	mParentTimeline = parentTimeline;  		
 }
 
+void AnimBase::setParentEngine( TweenEngineRef parentEngine )
+{
+	if( mParentEngine && ( parentEngine != mParentEngine ) ) {
+		mParentEngine->removeTarget( mVoidPtr );
+	}
+	mParentEngine = parentEngine;
+}
+
 // these are to provide a compiler firewall to use Timeline from the TweenOptions
 void TweenBase::Options::appendTo( TweenBase &tweenBase, void *endTarget, float offset )
 {
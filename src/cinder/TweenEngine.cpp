@@ -0,0 +1,651 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/TweenEngine.h"
+#include "cinder/Easing.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_TWEENENGINE_SSE2
+	#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace cinder {
+
+namespace {
+
+// Each family of easing equations is evaluated from its ease-in curve f, with ease-out as 1 - f(1 - t) and ease-in/out as
+// 0.5 * f(2t) for the first half and 1 - 0.5 * f(2 - 2t) for the second, which matches Easing.h to within rounding.
+template<int N>
+struct EasePoly {
+	float operator()( float x ) const
+	{
+		float result = x;
+		for( int i = 1; i < N; ++i )
+			result *= x;
+		return result;
+	}
+#if defined( CINDER_TWEENENGINE_SSE2 )
+	__m128 operator()( __m128 x ) const
+	{
+		__m128 result = x;
+		for( int i = 1; i < N; ++i )
+			result = _mm_mul_ps( result, x );
+		return result;
+	}
+#endif
+};
+
+struct EaseCirc {
+	float operator()( float x ) const
+	{
+		return 1 - sqrt( std::max( 1 - x * x, 0.0f ) );
+	}
+#if defined( CINDER_TWEENENGINE_SSE2 )
+	__m128 operator()( __m128 x ) const
+	{
+		__m128 one = _mm_set1_ps( 1 );
+		return _mm_sub_ps( one, _mm_sqrt_ps( _mm_max_ps( _mm_sub_ps( one, _mm_mul_ps( x, x ) ), _mm_setzero_ps() ) ) );
+	}
+#endif
+};
+
+struct EaseBack {
+	EaseBack( float s ) : mS( s ) {}
+
+	float operator()( float x ) const
+	{
+		return x * x * ( ( mS + 1 ) * x - mS );
+	}
+#if defined( CINDER_TWEENENGINE_SSE2 )
+	__m128 operator()( __m128 x ) const
+	{
+		__m128 s = _mm_set1_ps( mS );
+		__m128 s1 = _mm_set1_ps( mS + 1 );
+		return _mm_mul_ps( _mm_mul_ps( x, x ), _mm_sub_ps( _mm_mul_ps( s1, x ), s ) );
+	}
+#endif
+
+	float mS;
+};
+
+template<typename F>
+void easeInBatch( const F &f, const float *t, float *result, size_t count )
+{
+	size_t i = 0;
+#if defined( CINDER_TWEENENGINE_SSE2 )
+	for( ; i + 4 <= count; i += 4 )
+		_mm_storeu_ps( result + i, f( _mm_loadu_ps( t + i ) ) );
+#endif
+	for( ; i < count; ++i )
+		result[i] = f( t[i] );
+}
+
+template<typename F>
+void easeOutBatch( const F &f, const float *t, float *result, size_t count )
+{
+	size_t i = 0;
+#if defined( CINDER_TWEENENGINE_SSE2 )
+	__m128 one = _mm_set1_ps( 1 );
+	for( ; i + 4 <= count; i += 4 )
+		_mm_storeu_ps( result + i, _mm_sub_ps( one, f( _mm_sub_ps( one, _mm_loadu_ps( t + i ) ) ) ) );
+#endif
+	for( ; i < count; ++i )
+		result[i] = 1 - f( 1 - t[i] );
+}
+
+template<typename F>
+void easeInOutBatch( const F &f, const float *t, float *result, size_t count )
+{
+	size_t i = 0;
+#if defined( CINDER_TWEENENGINE_SSE2 )
+	__m128 half = _mm_set1_ps( 0.5f ), one = _mm_set1_ps( 1 ), two = _mm_set1_ps( 2 );
+	for( ; i + 4 <= count; i += 4 ) {
+		__m128 x = _mm_loadu_ps( t + i );
+		__m128 firstHalf = _mm_cmplt_ps( x, half );
+		__m128 twoX = _mm_add_ps( x, x );
+		// 2t in the first half and 2 - 2t in the second, so both halves evaluate f over [0, 1]
+		__m128 u = _mm_or_ps( _mm_and_ps( firstHalf, twoX ), _mm_andnot_ps( firstHalf, _mm_sub_ps( two, twoX ) ) );
+		__m128 y = _mm_mul_ps( half, f( u ) );
+		_mm_storeu_ps( result + i, _mm_or_ps( _mm_and_ps( firstHalf, y ), _mm_andnot_ps( firstHalf, _mm_sub_ps( one, y ) ) ) );
+	}
+#endif
+	for( ; i < count; ++i ) {
+		if( t[i] < 0.5f )
+			result[i] = 0.5f * f( 2 * t[i] );
+		else
+			result[i] = 1 - 0.5f * f( 2 - 2 * t[i] );
+	}
+}
+
+template<float (*EASE_FN)( float )>
+void easeScalarBatch( const float *t, float *result, size_t count )
+{
+	for( size_t i = 0; i < count; ++i )
+		result[i] = EASE_FN( t[i] );
+}
+
+} // anonymous namespace
+
+void easeBatch( EaseType ease, const float *t, float *result, size_t count )
+{
+	const float backS = 1.70158f;
+	switch( ease ) {
+		case EASE_NONE:				copy( t, t + count, result ); break;
+		case EASE_IN_QUAD:			easeInBatch( EasePoly<2>(), t, result, count ); break;
+		case EASE_OUT_QUAD:			easeOutBatch( EasePoly<2>(), t, result, count ); break;
+		case EASE_IN_OUT_QUAD:		easeInOutBatch( EasePoly<2>(), t, result, count ); break;
+		case EASE_IN_CUBIC:			easeInBatch( EasePoly<3>(), t, result, count ); break;
+		case EASE_OUT_CUBIC:		easeOutBatch( EasePoly<3>(), t, result, count ); break;
+		case EASE_IN_OUT_CUBIC:		easeInOutBatch( EasePoly<3>(), t, result, count ); break;
+		case EASE_IN_QUART:			easeInBatch( EasePoly<4>(), t, result, count ); break;
+		case EASE_OUT_QUART:		easeOutBatch( EasePoly<4>(), t, result, count ); break;
+		case EASE_IN_OUT_QUART:		easeInOutBatch( EasePoly<4>(), t, result, count ); break;
+		case EASE_IN_QUINT:			easeInBatch( EasePoly<5>(), t, result, count ); break;
+		case EASE_OUT_QUINT:		easeOutBatch( EasePoly<5>(), t, result, count ); break;
+		case EASE_IN_OUT_QUINT:		easeInOutBatch( EasePoly<5>(), t, result, count ); break;
+		// sine and exponential easing have no cheap vector form in SSE2, so they stay scalar
+		case EASE_IN_SINE:			easeScalarBatch<easeInSine>( t, result, count ); break;
+		case EASE_OUT_SINE:			easeScalarBatch<easeOutSine>( t, result, count ); break;
+		case EASE_IN_OUT_SINE:		easeScalarBatch<easeInOutSine>( t, result, count ); break;
+		case EASE_IN_EXPO:			easeScalarBatch<easeInExpo>( t, result, count ); break;
+		case EASE_OUT_EXPO:			easeScalarBatch<easeOutExpo>( t, result, count ); break;
+		case EASE_IN_OUT_EXPO:		easeScalarBatch<easeInOutExpo>( t, result, count ); break;
+		case EASE_IN_CIRC:			easeInBatch( EaseCirc(), t, result, count ); break;
+		case EASE_OUT_CIRC:			easeOutBatch( EaseCirc(), t, result, count ); break;
+		case EASE_IN_OUT_CIRC:		easeInOutBatch( EaseCirc(), t, result, count ); break;
+		case EASE_IN_BACK:			easeInBatch( EaseBack( backS ), t, result, count ); break;
+		case EASE_OUT_BACK:			easeOutBatch( EaseBack( backS ), t, result, count ); break;
+		case EASE_IN_OUT_BACK:		easeInOutBatch( EaseBack( backS * 1.525f ), t, result, count ); break;
+		default:					copy( t, t + count, result ); break;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// TweenEngine
+TweenEngine::TweenEngine()
+	: mCurrentTime( 0 ), mTracks( NUM_EASE_TYPES * 4 ), mNumPending( 0 )
+{
+}
+
+TweenEngine::Id TweenEngine::add( float *target, int numComponents, const float *startValue, const float *endValue, float startTime, float duration, const Options &options )
+{
+	TweenDesc desc;
+	desc.mTarget = target;
+	for( int c = 0; c < numComponents; ++c ) {
+		desc.mStart[c] = startValue ? startValue[c] : 0;
+		desc.mEnd[c] = endValue[c];
+	}
+	desc.mStartTime = startTime + options.mDelay;
+	desc.mDuration = duration;
+	desc.mNumComponents = (uint8_t)numComponents;
+	desc.mEase = (uint8_t)options.mEase;
+	desc.mLoop = options.mLoop;
+	desc.mCopyStartValue = ( startValue == nullptr );
+
+	return add( desc, options.mFinishFn );
+}
+
+TweenEngine::Id TweenEngine::addAfter( float *target, int numComponents, const float *endValue, float duration, const Options &options )
+{
+	int64_t last = findLast( target );
+	if( last < 0 )
+		return add( target, numComponents, nullptr, endValue, mCurrentTime, duration, options );
+
+	// start from where the last tween ends, rather than whatever the target holds when this one starts
+	TweenDesc lastDesc;
+	getDesc( (uint32_t)last, &lastDesc );
+	return add( target, numComponents, lastDesc.mEnd, endValue, lastDesc.mStartTime + lastDesc.mDuration, duration, options );
+}
+
+TweenEngine::Id TweenEngine::add( const TweenDesc &desc, const function<void ()> &finishFn )
+{
+	uint32_t slotIndex;
+	if( ! mFreeSlots.empty() ) {
+		slotIndex = mFreeSlots.back();
+		mFreeSlots.pop_back();
+	}
+	else {
+		slotIndex = (uint32_t)mSlots.size();
+		mSlots.push_back( Slot() );
+		mSlots.back().mGeneration = 0;
+	}
+
+	Slot &slot = mSlots[slotIndex];
+	slot.mState = SLOT_PENDING;
+	slot.mDesc = desc;
+	slot.mDesc.mDuration = std::max( desc.mDuration, 1e-6f );
+	++mNumPending;
+
+	mTargets.insert( make_pair( (void*)desc.mTarget, slotIndex ) );
+	if( finishFn )
+		mFinishFns[slotIndex] = finishFn;
+
+	Id id = makeId( slotIndex );
+	// tweens which start now skip the queue
+	if( desc.mStartTime <= mCurrentTime )
+		start( slotIndex );
+	else {
+		mPending.push_back( make_pair( desc.mStartTime, id ) );
+		push_heap( mPending.begin(), mPending.end(), greater<pair<float, Id>>() );
+	}
+
+	return id;
+}
+
+void TweenEngine::start( uint32_t slotIndex )
+{
+	Slot &slot = mSlots[slotIndex];
+	const TweenDesc &desc = slot.mDesc;
+	uint32_t trackIndex = desc.mEase * 4 + desc.mNumComponents - 1;
+	Track &track = mTracks[trackIndex];
+
+	track.mTargets.push_back( desc.mTarget );
+	for( int c = 0; c < desc.mNumComponents; ++c ) {
+		track.mStart[c].push_back( desc.mCopyStartValue ? desc.mTarget[c] : desc.mStart[c] );
+		track.mEnd[c].push_back( desc.mEnd[c] );
+	}
+	track.mStartTime.push_back( desc.mStartTime );
+	track.mEndTime.push_back( desc.mStartTime + desc.mDuration );
+	track.mInvDuration.push_back( 1 / desc.mDuration );
+	track.mLoop.push_back( desc.mLoop ? 1 : 0 );
+	track.mSlots.push_back( slotIndex );
+
+	slot.mState = SLOT_RUNNING;
+	slot.mTrack = trackIndex;
+	slot.mIndex = (uint32_t)track.mSlots.size() - 1;
+	--mNumPending;
+}
+
+void TweenEngine::stepTo( float absoluteTime )
+{
+	mCurrentTime = absoluteTime;
+
+	// start pending tweens in order, skipping any which were removed while they waited
+	while( ! mPending.empty() && mPending.front().first <= mCurrentTime ) {
+		Id id = mPending.front().second;
+		pop_heap( mPending.begin(), mPending.end(), greater<pair<float, Id>>() );
+		mPending.pop_back();
+		const Slot *slot = findSlot( id );
+		if( slot && slot->mState == SLOT_PENDING )
+			start( (uint32_t)id );
+	}
+
+	// every completed tween is written before any running one, so a tween which follows another on the same target wins
+	for( uint32_t t = 0; t < (uint32_t)mTracks.size(); ++t ) {
+		if( ! mTracks[t].mSlots.empty() )
+			completeTrack( t );
+	}
+	for( uint32_t t = 0; t < (uint32_t)mTracks.size(); ++t ) {
+		if( ! mTracks[t].mSlots.empty() )
+			evaluateTrack( t );
+	}
+
+	// finish functions run last, as they may add or remove tweens
+	if( ! mFinishedFns.empty() ) {
+		vector<function<void ()>> finishedFns;
+		finishedFns.swap( mFinishedFns );
+		for( auto &fn : finishedFns )
+			fn();
+	}
+}
+
+void TweenEngine::completeTrack( uint32_t trackIndex )
+{
+	Track &track = mTracks[trackIndex];
+	const size_t count = track.mSlots.size();
+	const float *endTime = track.mEndTime.data();
+
+	mCompleted.clear();
+	size_t i = 0;
+#if defined( CINDER_TWEENENGINE_SSE2 )
+	__m128 now = _mm_set1_ps( mCurrentTime );
+	for( ; i + 4 <= count; i += 4 ) {
+		int mask = _mm_movemask_ps( _mm_cmpge_ps( now, _mm_loadu_ps( endTime + i ) ) );
+		if( mask ) {
+			for( int lane = 0; lane < 4; ++lane ) {
+				if( mask & ( 1 << lane ) )
+					mCompleted.push_back( uint32_t( i + lane ) );
+			}
+		}
+	}
+#endif
+	for( ; i < count; ++i ) {
+		if( mCurrentTime >= endTime[i] )
+			mCompleted.push_back( (uint32_t)i );
+	}
+
+	if( mCompleted.empty() )
+		return;
+
+	const int numComponents = trackIndex % 4 + 1;
+	// descending, so that removing a tween never moves one which is still to be visited
+	for( auto it = mCompleted.rbegin(); it != mCompleted.rend(); ++it ) {
+		uint32_t index = *it;
+		if( track.mLoop[index] ) {
+			float duration = track.mEndTime[index] - track.mStartTime[index];
+			float cycles = floor( ( mCurrentTime - track.mStartTime[index] ) / duration );
+			track.mStartTime[index] += cycles * duration;
+			track.mEndTime[index] = track.mStartTime[index] + duration;
+			continue;
+		}
+
+		float *target = track.mTargets[index];
+		for( int c = 0; c < numComponents; ++c )
+			target[c] = track.mEnd[c][index];
+
+		uint32_t slotIndex = track.mSlots[index];
+		auto fnIt = mFinishFns.find( slotIndex );
+		if( fnIt != mFinishFns.end() )
+			mFinishedFns.push_back( fnIt->second );
+		removeRunning( trackIndex, index );
+	}
+}
+
+namespace {
+
+template<int NUM_COMPONENTS>
+void writeTrack( float * const *targets, const vector<float> *start, const vector<float> *end, const float *eased, size_t count )
+{
+	for( size_t i = 0; i < count; ++i ) {
+		float e = eased[i];
+		float *target = targets[i];
+		// same arithmetic as tweenLerp()
+		for( int c = 0; c < NUM_COMPONENTS; ++c )
+			target[c] = start[c][i] * ( 1 - e ) + end[c][i] * e;
+	}
+}
+
+} // anonymous namespace
+
+void TweenEngine::evaluateTrack( uint32_t trackIndex )
+{
+	Track &track = mTracks[trackIndex];
+	const size_t count = track.mSlots.size();
+	if( mTimes.size() < count ) {
+		mTimes.resize( count );
+		mEased.resize( count );
+	}
+
+	const float *startTime = track.mStartTime.data();
+	const float *invDuration = track.mInvDuration.data();
+	float *times = mTimes.data();
+	size_t i = 0;
+#if defined( CINDER_TWEENENGINE_SSE2 )
+	__m128 now = _mm_set1_ps( mCurrentTime ), zero = _mm_setzero_ps(), one = _mm_set1_ps( 1 );
+	for( ; i + 4 <= count; i += 4 ) {
+		__m128 t = _mm_mul_ps( _mm_sub_ps( now, _mm_loadu_ps( startTime + i ) ), _mm_loadu_ps( invDuration + i ) );
+		_mm_storeu_ps( times + i, _mm_min_ps( _mm_max_ps( t, zero ), one ) );
+	}
+#endif
+	for( ; i < count; ++i )
+		times[i] = std::min( std::max( ( mCurrentTime - startTime[i] ) * invDuration[i], 0.0f ), 1.0f );
+
+	easeBatch( EaseType( trackIndex / 4 ), times, mEased.data(), count );
+
+	switch( trackIndex % 4 + 1 ) {
+		case 1: writeTrack<1>( track.mTargets.data(), track.mStart, track.mEnd, mEased.data(), count ); break;
+		case 2: writeTrack<2>( track.mTargets.data(), track.mStart, track.mEnd, mEased.data(), count ); break;
+		case 3: writeTrack<3>( track.mTargets.data(), track.mStart, track.mEnd, mEased.data(), count ); break;
+		case 4: writeTrack<4>( track.mTargets.data(), track.mStart, track.mEnd, mEased.data(), count ); break;
+	}
+}
+
+void TweenEngine::removeRunning( uint32_t trackIndex, uint32_t index )
+{
+	Track &track = mTracks[trackIndex];
+	uint32_t slotIndex = track.mSlots[index];
+	uint32_t last = (uint32_t)track.mSlots.size() - 1;
+	const int numComponents = trackIndex % 4 + 1;
+
+	// drop the tween from its target's entries
+	auto range = mTargets.equal_range( track.mTargets[index] );
+	for( auto it = range.first; it != range.second; ++it ) {
+		if( it->second == slotIndex ) {
+			mTargets.erase( it );
+			break;
+		}
+	}
+
+	if( index != last ) {
+		track.mTargets[index] = track.mTargets[last];
+		for( int c = 0; c < numComponents; ++c ) {
+			track.mStart[c][index] = track.mStart[c][last];
+			track.mEnd[c][index] = track.mEnd[c][last];
+		}
+		track.mStartTime[index] = track.mStartTime[last];
+		track.mEndTime[index] = track.mEndTime[last];
+		track.mInvDuration[index] = track.mInvDuration[last];
+		track.mLoop[index] = track.mLoop[last];
+		track.mSlots[index] = track.mSlots[last];
+		mSlots[track.mSlots[index]].mIndex = index;
+	}
+
+	track.mTargets.pop_back();
+	for( int c = 0; c < numComponents; ++c ) {
+		track.mStart[c].pop_back();
+		track.mEnd[c].pop_back();
+	}
+	track.mStartTime.pop_back();
+	track.mEndTime.pop_back();
+	track.mInvDuration.pop_back();
+	track.mLoop.pop_back();
+	track.mSlots.pop_back();
+
+	freeSlot( slotIndex );
+}
+
+void TweenEngine::freeSlot( uint32_t slotIndex )
+{
+	Slot &slot = mSlots[slotIndex];
+	slot.mState = SLOT_FREE;
+	++slot.mGeneration;
+	mFreeSlots.push_back( slotIndex );
+	if( ! mFinishFns.empty() )
+		mFinishFns.erase( slotIndex );
+}
+
+const TweenEngine::Slot* TweenEngine::findSlot( Id id ) const
+{
+	uint32_t slotIndex = uint32_t( id & 0xFFFFFFFF );
+	if( slotIndex >= mSlots.size() )
+		return nullptr;
+	const Slot &slot = mSlots[slotIndex];
+	if( slot.mState == SLOT_FREE || slot.mGeneration != uint32_t( id >> 32 ) )
+		return nullptr;
+	return &slot;
+}
+
+bool TweenEngine::contains( Id id ) const
+{
+	return findSlot( id ) != nullptr;
+}
+
+bool TweenEngine::remove( Id id )
+{
+	const Slot *slot = findSlot( id );
+	if( ! slot )
+		return false;
+
+	uint32_t slotIndex = uint32_t( id & 0xFFFFFFFF );
+	if( slot->mState == SLOT_RUNNING )
+		removeRunning( slot->mTrack, slot->mIndex );
+	else {
+		// the queue entry is skipped when it comes up, since the generation no longer matches
+		auto range = mTargets.equal_range( slot->mDesc.mTarget );
+		for( auto it = range.first; it != range.second; ++it ) {
+			if( it->second == slotIndex ) {
+				mTargets.erase( it );
+				break;
+			}
+		}
+		--mNumPending;
+		freeSlot( slotIndex );
+	}
+
+	return true;
+}
+
+void TweenEngine::removeTarget( void *target )
+{
+	auto range = mTargets.equal_range( target );
+	if( range.first == range.second )
+		return;
+
+	vector<uint32_t> slots;
+	for( auto it = range.first; it != range.second; ++it )
+		slots.push_back( it->second );
+	for( uint32_t slotIndex : slots )
+		remove( makeId( slotIndex ) );
+}
+
+void TweenEngine::getDesc( uint32_t slotIndex, TweenDesc *result ) const
+{
+	const Slot &slot = mSlots[slotIndex];
+	if( slot.mState == SLOT_PENDING ) {
+		*result = slot.mDesc;
+		return;
+	}
+
+	const Track &track = mTracks[slot.mTrack];
+	const uint32_t index = slot.mIndex;
+	result->mTarget = track.mTargets[index];
+	result->mNumComponents = uint8_t( slot.mTrack % 4 + 1 );
+	result->mEase = uint8_t( slot.mTrack / 4 );
+	for( int c = 0; c < result->mNumComponents; ++c ) {
+		result->mStart[c] = track.mStart[c][index];
+		result->mEnd[c] = track.mEnd[c][index];
+	}
+	result->mStartTime = track.mStartTime[index];
+	result->mDuration = track.mEndTime[index] - track.mStartTime[index];
+	result->mLoop = track.mLoop[index] != 0;
+	result->mCopyStartValue = false;
+}
+
+int64_t TweenEngine::findLast( void *target ) const
+{
+	int64_t result = -1;
+	float resultEndTime = 0;
+	auto range = mTargets.equal_range( target );
+	for( auto it = range.first; it != range.second; ++it ) {
+		TweenDesc desc;
+		getDesc( it->second, &desc );
+		float endTime = desc.mStartTime + desc.mDuration;
+		if( result < 0 || endTime > resultEndTime ) {
+			result = it->second;
+			resultEndTime = endTime;
+		}
+	}
+
+	return result;
+}
+
+float TweenEngine::findEndTimeOf( void *target ) const
+{
+	int64_t last = findLast( target );
+	if( last < 0 )
+		return mCurrentTime;
+
+	TweenDesc desc;
+	getDesc( (uint32_t)last, &desc );
+	return desc.mStartTime + desc.mDuration;
+}
+
+void TweenEngine::cloneAndReplaceTarget( void *target, void *replacementTarget )
+{
+	auto range = mTargets.equal_range( target );
+	if( range.first == range.second )
+		return;
+
+	// collected first, since adding tweens invalidates the range
+	vector<pair<TweenDesc, function<void ()>>> clones;
+	for( auto it = range.first; it != range.second; ++it ) {
+		clones.push_back( make_pair( TweenDesc(), function<void ()>() ) );
+		getDesc( it->second, &clones.back().first );
+		clones.back().first.mTarget = reinterpret_cast<float*>( replacementTarget );
+		auto fnIt = mFinishFns.find( it->second );
+		if( fnIt != mFinishFns.end() )
+			clones.back().second = fnIt->second;
+	}
+
+	for( auto &clone : clones ) {
+		// a running tween's copy must not start again from the replacement's current value
+		if( clone.first.mStartTime <= mCurrentTime )
+			clone.first.mCopyStartValue = false;
+		add( clone.first, clone.second );
+	}
+}
+
+void TweenEngine::replaceTarget( void *target, void *replacementTarget )
+{
+	auto range = mTargets.equal_range( target );
+	if( range.first == range.second )
+		return;
+
+	vector<uint32_t> slots;
+	for( auto it = range.first; it != range.second; ++it )
+		slots.push_back( it->second );
+	mTargets.erase( range.first, range.second );
+
+	for( uint32_t slotIndex : slots ) {
+		Slot &slot = mSlots[slotIndex];
+		if( slot.mState == SLOT_RUNNING )
+			mTracks[slot.mTrack].mTargets[slot.mIndex] = reinterpret_cast<float*>( replacementTarget );
+		else
+			slot.mDesc.mTarget = reinterpret_cast<float*>( replacementTarget );
+		mTargets.insert( make_pair( replacementTarget, slotIndex ) );
+	}
+}
+
+void TweenEngine::clear()
+{
+	for( auto &track : mTracks )
+		track = Track();
+	// slots are kept rather than cleared, so that their generations still invalidate old Ids
+	mFreeSlots.clear();
+	for( uint32_t slotIndex = 0; slotIndex < (uint32_t)mSlots.size(); ++slotIndex ) {
+		if( mSlots[slotIndex].mState != SLOT_FREE ) {
+			mSlots[slotIndex].mState = SLOT_FREE;
+			++mSlots[slotIndex].mGeneration;
+		}
+		mFreeSlots.push_back( slotIndex );
+	}
+	mPending.clear();
+	mNumPending = 0;
+	mTargets.clear();
+	mFinishFns.clear();
+}
+
+size_t TweenEngine::getNumRunning() const
+{
+	size_t result = 0;
+	for( const auto &track : mTracks )
+		result += track.mSlots.size();
+	return result;
+}
+
+} // namespace cinder
@@ -25,6 +25,7 @@
 */
 
 #include "cinder/Xml.h"
+#include "cinder/XmlDocument.h"
 #include "cinder/Utilities.h"
 #include <boost/algorithm/string.hpp>
 
@@ -189,6 +190,16 @@ XmlTree::XmlTree( const std::string &xmlString, ParseOptions parseOptions )
 	setNodeType( NODE_DOCUMENT ); // call this after parse - constructor replaces it	
 }
 
+XmlTree::XmlTree( const XmlNodeView &node )
+	: mParent( 0 ), mNodeType( NODE_ELEMENT )
+{
+	if( ! node )
+		return;
+
+	parseItem( *node.getRapidXmlNode(), NULL, this, node.getDocument()->getParseOptions() );
+	setNodeType( node.getNodeType() ); // call this after parse - constructor replaces it
+}
+
 void parseItem( const rapidxml::xml_node<> &node, XmlTree *parent, XmlTree *result, const XmlTree::ParseOptions &options )
 {
 	*result = XmlTree( node.name(), node.value(), parent );
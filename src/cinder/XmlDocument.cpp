@@ -0,0 +1,399 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/XmlDocument.h"
+#include "cinder/MemoryMappedFile.h"
+
+#include "rapidxml/rapidxml.hpp"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+namespace cinder {
+
+namespace {
+
+// elements with fewer element children are scanned rather than indexed
+const size_t MIN_INDEXED_CHILDREN = 8;
+
+inline char foldCase( char c )
+{
+	return ( c >= 'A' && c <= 'Z' ) ? char( c + ( 'a' - 'A' ) ) : c;
+}
+
+// matches the children XmlTree's parser keeps for the same ParseOptions
+bool isVisible( const rapidxml::xml_node<> *node, const XmlTree::ParseOptions &options )
+{
+	switch( node->type() ) {
+		case rapidxml::node_element:
+		case rapidxml::node_comment:
+			return true;
+		case rapidxml::node_cdata:
+			return ! options.getCollapseCData();
+		case rapidxml::node_data:
+			return ! options.getIgnoreDataChildren();
+		default:
+			return false;
+	}
+}
+
+} // anonymous namespace
+
+bool XmlStringView::equalsIgnoreCase( const char *str, size_t length ) const
+{
+	if( mSize != length )
+		return false;
+	for( size_t i = 0; i < length; ++i ) {
+		if( foldCase( mData[i] ) != foldCase( str[i] ) )
+			return false;
+	}
+	return true;
+}
+
+XmlStringView XmlAttrView::getName() const
+{
+	return mAttr ? XmlStringView( mAttr->name(), mAttr->name_size() ) : XmlStringView();
+}
+
+XmlStringView XmlAttrView::getValue() const
+{
+	return mAttr ? XmlStringView( mAttr->value(), mAttr->value_size() ) : XmlStringView();
+}
+
+XmlAttrView XmlAttrView::getNext() const
+{
+	return XmlAttrView( mAttr ? mAttr->next_attribute() : nullptr );
+}
+
+XmlTree::NodeType XmlNodeView::getNodeType() const
+{
+	if( ! mNode )
+		return XmlTree::NODE_UNKNOWN;
+
+	switch( mNode->type() ) {
+		case rapidxml::node_document:	return XmlTree::NODE_DOCUMENT;
+		case rapidxml::node_element:	return XmlTree::NODE_ELEMENT;
+		case rapidxml::node_cdata:		return XmlTree::NODE_CDATA;
+		case rapidxml::node_comment:	return XmlTree::NODE_COMMENT;
+		case rapidxml::node_data:		return XmlTree::NODE_DATA;
+		default:						return XmlTree::NODE_UNKNOWN;
+	}
+}
+
+XmlStringView XmlNodeView::getTag() const
+{
+	return mNode ? XmlStringView( mNode->name(), mNode->name_size() ) : XmlStringView();
+}
+
+XmlStringView XmlNodeView::getValue() const
+{
+	return mNode ? XmlStringView( mNode->value(), mNode->value_size() ) : XmlStringView();
+}
+
+XmlNodeView XmlNodeView::getParent() const
+{
+	return XmlNodeView( mDocument, mNode ? mNode->parent() : nullptr );
+}
+
+XmlNodeView XmlNodeView::getFirstChild() const
+{
+	if( ! mNode )
+		return XmlNodeView();
+
+	rapidxml::xml_node<> *child = mNode->first_node();
+	while( child && ! isVisible( child, mDocument->mParseOptions ) )
+		child = child->next_sibling();
+	return XmlNodeView( mDocument, child );
+}
+
+XmlNodeView XmlNodeView::getNextSibling() const
+{
+	// the document node has no siblings, and next_sibling() requires a parent
+	if( ! mNode || ! mNode->parent() )
+		return XmlNodeView();
+
+	rapidxml::xml_node<> *sibling = mNode->next_sibling();
+	while( sibling && ! isVisible( sibling, mDocument->mParseOptions ) )
+		sibling = sibling->next_sibling();
+	return XmlNodeView( mDocument, sibling );
+}
+
+XmlAttrView XmlNodeView::getFirstAttribute() const
+{
+	return XmlAttrView( mNode ? mNode->first_attribute() : nullptr );
+}
+
+XmlAttrView XmlNodeView::findAttribute( const string &attrName ) const
+{
+	if( ! mNode )
+		return XmlAttrView();
+
+	for( rapidxml::xml_attribute<> *attr = mNode->first_attribute(); attr; attr = attr->next_attribute() ) {
+		if( attr->name_size() == attrName.size() && memcmp( attr->name(), attrName.data(), attrName.size() ) == 0 )
+			return XmlAttrView( attr );
+	}
+	return XmlAttrView();
+}
+
+XmlStringView XmlNodeView::getAttributeValue( const string &attrName ) const
+{
+	return findAttribute( attrName ).getValue();
+}
+
+template<typename VisitT>
+void XmlNodeView::visitChildren( const XmlDocument *document, rapidxml::xml_node<> *parent, const XmlPath &path, size_t component, VisitT visit )
+{
+	const string &tag = path.mTags[component];
+	pair<rapidxml::xml_node<>* const*, rapidxml::xml_node<>* const*> children;
+	if( document->findIndexedChildren( parent, path.mNameIds[component], &children ) ) {
+		for( ; children.first != children.second; ++children.first ) {
+			rapidxml::xml_node<> *child = *children.first;
+			if( path.mCaseSensitive && ! XmlStringView( child->name(), child->name_size() ).equals( tag.data(), tag.size() ) )
+				continue;
+			if( ! visit( child ) )
+				return;
+		}
+	}
+	else {
+		for( rapidxml::xml_node<> *child = parent->first_node(); child; child = child->next_sibling() ) {
+			if( child->type() != rapidxml::node_element )
+				continue;
+			XmlStringView childTag( child->name(), child->name_size() );
+			if( ! ( path.mCaseSensitive ? childTag.equals( tag.data(), tag.size() ) : childTag.equalsIgnoreCase( tag.data(), tag.size() ) ) )
+				continue;
+			if( ! visit( child ) )
+				return;
+		}
+	}
+}
+
+XmlNodeView XmlNodeView::findChild( const XmlPath &path ) const
+{
+	if( ! mNode )
+		return XmlNodeView();
+	if( path.mDocument != mDocument )
+		throw XmlPathExc( "XmlPath was compiled against a different XmlDocument" );
+
+	rapidxml::xml_node<> *node = mNode;
+	for( size_t component = 0; component < path.mNameIds.size(); ++component ) {
+		rapidxml::xml_node<> *found = nullptr;
+		visitChildren( mDocument, node, path, component, [&]( rapidxml::xml_node<> *child ) {
+			found = child;
+			return false;
+		} );
+		if( ! found )
+			return XmlNodeView();
+		node = found;
+	}
+
+	return XmlNodeView( mDocument, node );
+}
+
+XmlNodeView XmlNodeView::findChild( const string &relativePath, bool caseSensitive, char separator ) const
+{
+	if( ! mNode )
+		return XmlNodeView();
+
+	return findChild( mDocument->compilePath( relativePath, caseSensitive, separator ) );
+}
+
+void XmlNodeView::findAll( const XmlPath &path, vector<XmlNodeView> *result ) const
+{
+	if( ! mNode || path.empty() )
+		return;
+	if( path.mDocument != mDocument )
+		throw XmlPathExc( "XmlPath was compiled against a different XmlDocument" );
+
+	findAllFrom( path, 0, result );
+}
+
+void XmlNodeView::findAllFrom( const XmlPath &path, size_t component, vector<XmlNodeView> *result ) const
+{
+	bool leaf = component + 1 == path.mNameIds.size();
+	visitChildren( mDocument, mNode, path, component, [&]( rapidxml::xml_node<> *child ) {
+		if( leaf )
+			result->push_back( XmlNodeView( mDocument, child ) );
+		else
+			XmlNodeView( mDocument, child ).findAllFrom( path, component + 1, result );
+		return true;
+	} );
+}
+
+size_t XmlDocument::NameHash::operator()( const XmlStringView &name ) const
+{
+	// FNV-1a over the case-folded name
+	size_t hash = 2166136261u;
+	for( size_t i = 0; i < name.size(); ++i )
+		hash = ( hash ^ (unsigned char)foldCase( name.data()[i] ) ) * 16777619u;
+	return hash;
+}
+
+XmlDocument::XmlDocument( const XmlTree::ParseOptions &parseOptions )
+	: mParseOptions( parseOptions )
+{
+}
+
+XmlDocument::~XmlDocument()
+{
+}
+
+XmlDocumentRef XmlDocument::create( const DataSourceRef &dataSource, const XmlTree::ParseOptions &parseOptions )
+{
+	XmlDocumentRef result( new XmlDocument( parseOptions ) );
+	// a mapped file is copied straight into the document's buffer, rather than read into a Buffer and copied again
+	if( dataSource->isFilePath() ) {
+		MemoryMappedFileRef file = MemoryMappedFile::create( dataSource->getFilePath() );
+		file->setAccessHint( MemoryMappedFile::ACCESS_SEQUENTIAL );
+		result->parse( static_cast<const char*>( file->getData() ), file->getSize() );
+	}
+	else {
+		BufferRef buffer = dataSource->getBuffer();
+		result->parse( static_cast<const char*>( buffer->getData() ), buffer->getSize() );
+	}
+
+	return result;
+}
+
+XmlDocumentRef XmlDocument::create( const string &xmlString, const XmlTree::ParseOptions &parseOptions )
+{
+	XmlDocumentRef result( new XmlDocument( parseOptions ) );
+	result->parse( xmlString.data(), xmlString.size() );
+	return result;
+}
+
+void XmlDocument::parse( const char *data, size_t size )
+{
+	// RapidXML parses in place, terminating names and values and translating entities, so it needs a writable copy of the source
+	mBuffer.reset( new char[size + 1] );
+	if( size )
+		memcpy( mBuffer.get(), data, size );
+	mBuffer[size] = 0;
+
+	mDoc.reset( new rapidxml::xml_document<>() );
+	if( mParseOptions.getParseComments() )
+		mDoc->parse<rapidxml::parse_comment_nodes | rapidxml::parse_doctype_node>( mBuffer.get() );
+	else
+		mDoc->parse<rapidxml::parse_doctype_node>( mBuffer.get() );
+}
+
+XmlNodeView XmlDocument::getRoot() const
+{
+	return XmlNodeView( this, mDoc.get() );
+}
+
+XmlStringView XmlDocument::getDocType() const
+{
+	for( rapidxml::xml_node<> *node = mDoc->first_node(); node; node = node->next_sibling() ) {
+		if( node->type() == rapidxml::node_doctype )
+			return XmlStringView( node->value(), node->value_size() );
+	}
+	return XmlStringView();
+}
+
+XmlPath XmlDocument::compilePath( const string &relativePath, bool caseSensitive, char separator ) const
+{
+	std::call_once( mIndexBuilt, [this] { buildIndex(); } );
+
+	XmlPath result;
+	result.mDocument = this;
+	result.mCaseSensitive = caseSensitive;
+	for( const string &tag : split( relativePath, separator ) ) {
+		if( tag.empty() )
+			continue;
+
+		// a tag which no indexed element has as a child only matches children of elements which aren't indexed
+		auto nameIt = mNameIds.find( XmlStringView( tag.c_str(), tag.size() ) );
+		result.mNameIds.push_back( nameIt != mNameIds.end() ? nameIt->second : numeric_limits<uint32_t>::max() );
+		result.mTags.push_back( tag );
+	}
+
+	return result;
+}
+
+void XmlDocument::buildIndex() const
+{
+	// the children of each indexed element are grouped by name, keeping document order within a name, so a query looks up one contiguous range
+	vector<pair<uint32_t, rapidxml::xml_node<>*>> children;
+	vector<rapidxml::xml_node<>*> parents( 1, mDoc.get() );
+	while( ! parents.empty() ) {
+		rapidxml::xml_node<> *parent = parents.back();
+		parents.pop_back();
+
+		size_t numChildren = 0;
+		for( rapidxml::xml_node<> *child = parent->first_node(); child; child = child->next_sibling() ) {
+			if( child->type() != rapidxml::node_element )
+				continue;
+			++numChildren;
+			if( child->first_node() )
+				parents.push_back( child );
+		}
+		if( numChildren < MIN_INDEXED_CHILDREN )
+			continue;
+
+		children.clear();
+		for( rapidxml::xml_node<> *child = parent->first_node(); child; child = child->next_sibling() ) {
+			if( child->type() != rapidxml::node_element )
+				continue;
+			auto nameIt = mNameIds.insert( make_pair( XmlStringView( child->name(), child->name_size() ), (uint32_t)mNameIds.size() ) ).first;
+			children.push_back( make_pair( nameIt->second, child ) );
+		}
+
+		stable_sort( children.begin(), children.end(), []( const pair<uint32_t, rapidxml::xml_node<>*> &lhs, const pair<uint32_t, rapidxml::xml_node<>*> &rhs ) {
+			return lhs.first < rhs.first;
+		} );
+
+		mIndexedParents.insert( parent );
+		for( size_t run = 0; run < children.size(); ) {
+			size_t runEnd = run + 1;
+			while( runEnd < children.size() && children[runEnd].first == children[run].first )
+				++runEnd;
+
+			ChildKey key = { parent, children[run].first };
+			mChildRanges[key] = make_pair( (uint32_t)mIndexedChildren.size(), (uint32_t)( runEnd - run ) );
+			for( size_t i = run; i < runEnd; ++i )
+				mIndexedChildren.push_back( children[i].second );
+			run = runEnd;
+		}
+	}
+}
+
+bool XmlDocument::findIndexedChildren( const rapidxml::xml_node<> *parent, uint32_t nameId, pair<rapidxml::xml_node<>* const*, rapidxml::xml_node<>* const*> *result ) const
+{
+	if( ! mIndexedParents.count( parent ) )
+		return false;
+
+	ChildKey key = { parent, nameId };
+	auto rangeIt = mChildRanges.find( key );
+	if( rangeIt == mChildRanges.end() ) {
+		result->first = result->second = nullptr;
+	}
+	else {
+		result->first = mIndexedChildren.data() + rangeIt->second.first;
+		result->second = result->first + rangeIt->second.second;
+	}
+	return true;
+}
+
+} // namespace cinder
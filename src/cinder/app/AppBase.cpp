@@ -39,6 +39,7 @@
 #include "cinder/Timeline.h"
 #include "cinder/Thread.h"
 #include "cinder/Log.h"
+#include "cinder/Profiler.h"
 
 using namespace std;
 
@@ -157,6 +158,7 @@ void AppBase::privateSetup__()
 
 void AppBase::privateUpdate__()
 {
+	Profiler::get()->newFrame();
 	mFrameCount++;
 
 	// service asio::io_service
@@ -168,11 +170,14 @@ void AppBase::privateUpdate__()
 			mainWin->getRenderer()->makeCurrentContext();
 	}
 
-	mSignalUpdate.emit();
+	{
+		CI_PROFILE( "App::update" );
+		mSignalUpdate.emit();
 
-	update();
+		update();
 
-	mTimeline->stepTo( static_cast<float>( getElapsedSeconds() ) );
+		mTimeline->stepTo( static_cast<float>( getElapsedSeconds() ) );
+	}
 
 	double now = mTimer.getSeconds();
 	if( now > mFpsLastSampleTime + mFpsSampleInterval ) {
@@ -30,6 +30,8 @@
 	#include "cinder/app/msw/PlatformMsw.h"
 #elif defined( CINDER_WINRT )
 	#include "cinder/app/winrt/PlatformWinRt.h"
+#elif defined( CINDER_LINUX )
+	#include "cinder/app/linux/PlatformLinux.h"
 #endif
 
 using namespace std;
@@ -54,6 +56,8 @@ Platform* Platform::get()
 		sInstance = new PlatformMsw;
 #elif defined( CINDER_WINRT )
 		sInstance = new PlatformWinRt;
+#elif defined( CINDER_LINUX )
+		sInstance = new PlatformLinux;
 #endif
 	}
 
@@ -27,7 +27,9 @@
 	#include "cinder/gl/platform.h"
 #endif
 
-#include "cinder/app/AppBase.h"
+#if ! defined( CINDER_LINUX )
+	#include "cinder/app/AppBase.h"
+#endif
 
 #if defined( CINDER_COCOA )
 	#include "cinder/cocoa/CinderCocoa.h"
@@ -42,6 +42,9 @@
 	#endif
 #elif defined( CINDER_WINRT )
 	#include "cinder/app/msw/RendererImplGlAngle.h"
+#elif defined( CINDER_LINUX )
+	#include "cinder/app/linux/RendererImplGlHeadless.h"
+	#include "cinder/gl/Fbo.h"
 #endif
 
 namespace cinder { namespace app {
@@ -347,6 +350,73 @@ Surface	RendererGl::copyWindowSurface( const Area &area, int32_t windowHeightPix
 	ip::flipVertical( &s );
 	return s;
 }
+#elif defined( CINDER_LINUX )
+RendererGl::~RendererGl()
+{
+	delete mImpl;
+}
+
+void RendererGl::setup( const ivec2 &size, RendererRef sharedRenderer )
+{
+	if( ! mImpl )
+		mImpl = new RendererImplGlHeadless( this );
+	if( ! mImpl->initialize( size, sharedRenderer ) )
+		throw ExcRendererAllocation( "RendererImplGlHeadless initialization failed; neither surfaceless EGL nor OSMesa is available." );
+}
+
+void RendererGl::kill()
+{
+	mImpl->kill();
+}
+
+void RendererGl::setFrameSize( int width, int height )
+{
+	mImpl->setFrameSize( ivec2( width, height ) );
+}
+
+const gl::FboRef& RendererGl::getFbo() const
+{
+	return mImpl->getFbo();
+}
+
+void RendererGl::startDraw()
+{
+	if( mStartDrawFn )
+		mStartDrawFn( this );
+	else {
+		mImpl->makeCurrentContext();
+		mImpl->bindDefaultFramebuffer();
+	}
+}
+
+void RendererGl::makeCurrentContext( bool force )
+{
+	mImpl->makeCurrentContext( force );
+}
+
+void RendererGl::swapBuffers()
+{
+	mImpl->swapBuffers();
+}
+
+void RendererGl::finishDraw()
+{
+	if( mFinishDrawFn )
+		mFinishDrawFn( this );
+	else
+		mImpl->swapBuffers();
+}
+
+void RendererGl::defaultResize()
+{
+	mImpl->defaultResize();
+}
+
+Surface	RendererGl::copyWindowSurface( const Area &area, int32_t /*windowHeightPixels*/ )
+{
+	// Fbo::readPixels8u() takes a top-left origin Area and resolves multisampling as needed
+	return mImpl->getFbo()->readPixels8u( area );
+}
 #endif
 
 } } // namespace cinder::app
\ No newline at end of file
@@ -25,6 +25,7 @@
 #include "cinder/Cinder.h"
 #include "cinder/app/Window.h"
 #include "cinder/app/AppBase.h"
+#include "cinder/Profiler.h"
 
 #if defined( CINDER_MSW )
 	#include "cinder/app/msw/AppImplMsw.h"
@@ -424,6 +425,7 @@ void Window::emitDraw()
 	getRenderer()->makeCurrentContext( false );
 #endif	
 	
+	CI_PROFILE_GPU( "App::draw" );
 	mSignalDraw.emit();
 	getApp()->draw();
 	mSignalPostDraw.emit();
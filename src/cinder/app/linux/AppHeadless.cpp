@@ -0,0 +1,123 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/app/linux/AppHeadless.h"
+#include "cinder/gl/Context.h"
+#include "cinder/gl/Environment.h"
+#include "cinder/Log.h"
+#include "cinder/Profiler.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace cinder { namespace app {
+
+AppHeadless*			AppHeadless::sInstance = nullptr;
+AppHeadless::Settings	AppHeadless::sSettingsFromMain;
+RendererRef				AppHeadless::sRendererFromMain;
+
+AppHeadless::AppHeadless()
+	: mSettings( sSettingsFromMain ), mFrameCount( 0 ), mShouldQuit( false )
+{
+	mRenderer = std::dynamic_pointer_cast<RendererGl>( sRendererFromMain );
+	if( ! mRenderer )
+		throw ExcRendererAllocation( "AppHeadless requires a RendererGl" );
+
+	mRenderer->setup( mSettings.getWindowSize(), RendererRef() );
+	sInstance = this;
+}
+
+AppHeadless::~AppHeadless()
+{
+	mRenderer->kill();
+	sRendererFromMain.reset();
+	sInstance = nullptr;
+}
+
+void AppHeadless::prepareLaunch( Settings *settings, const RendererRef &defaultRenderer, const char *title, int argc, char * const argv[] )
+{
+	for( int arg = 1; arg < argc; ++arg ) {
+		if( ! strcmp( argv[arg], "--frames" ) && arg + 1 < argc )
+			settings->setNumFrames( (uint32_t)strtoul( argv[++arg], nullptr, 10 ) );
+		else if( ! strcmp( argv[arg], "--size" ) && arg + 2 < argc ) {
+			int width = atoi( argv[++arg] );
+			int height = atoi( argv[++arg] );
+			settings->setWindowSize( width, height );
+		}
+	}
+
+	CI_LOG_I( title << ": rendering " << settings->getNumFrames() << " frames at " << settings->getWindowSize() );
+	sSettingsFromMain = *settings;
+	sRendererFromMain = defaultRenderer;
+}
+
+double AppHeadless::getElapsedSeconds() const
+{
+	if( mSettings.getFixedTimestep() > 0 )
+		return mFrameCount * mSettings.getFixedTimestep();
+	else
+		return mTimer.getSeconds();
+}
+
+float AppHeadless::getAverageFps() const
+{
+	double seconds = mTimer.getSeconds();
+	return ( seconds > 0 ) ? (float)( mFrameCount / seconds ) : 0.0f;
+}
+
+int AppHeadless::run()
+{
+	try {
+		mRenderer->makeCurrentContext();
+		mRenderer->defaultResize();
+		setup();
+
+		mTimer.start();
+		while( ! mShouldQuit && ( mSettings.getNumFrames() == 0 || mFrameCount < mSettings.getNumFrames() ) ) {
+			Profiler::get()->newFrame();
+			{
+				CI_PROFILE( "App::update" );
+				update();
+			}
+			mRenderer->startDraw();
+			{
+				CI_PROFILE_GPU( "App::draw" );
+				draw();
+			}
+			mRenderer->finishDraw();
+			++mFrameCount;
+		}
+		mTimer.stop();
+
+		cleanup();
+	}
+	catch( std::exception &exc ) {
+		CI_LOG_EXCEPTION( "exception during headless run", exc );
+		return 1;
+	}
+
+	CI_LOG_I( "rendered " << mFrameCount << " frames in " << mTimer.getSeconds() << "s (" << getAverageFps() << " fps)" );
+	return 0;
+}
+
+} } // namespace cinder::app
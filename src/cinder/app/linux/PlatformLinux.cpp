@@ -0,0 +1,125 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/app/linux/PlatformLinux.h"
+
+#include <cstdlib>
+#include <execinfo.h>
+#include <time.h>
+#include <unistd.h>
+
+extern char **environ;
+
+using namespace std;
+
+namespace cinder { namespace app {
+
+PlatformLinux::PlatformLinux()
+{
+	char buffer[4096];
+	ssize_t length = ::readlink( "/proc/self/exe", buffer, sizeof(buffer) - 1 );
+	if( length > 0 )
+		setExecutablePath( fs::path( string( buffer, length ) ).parent_path() );
+}
+
+DataSourceRef PlatformLinux::loadResource( const fs::path &resourcePath )
+{
+	fs::path fullPath = getResourcePath( resourcePath );
+	if( fullPath.empty() )
+		throw ResourceLoadExc( resourcePath );
+
+	return DataSourcePath::create( fullPath );
+}
+
+fs::path PlatformLinux::getResourceDirectory() const
+{
+	return getExecutablePath() / "resources";
+}
+
+fs::path PlatformLinux::getResourcePath( const fs::path &rsrcRelativePath ) const
+{
+	fs::path result = getResourceDirectory() / rsrcRelativePath;
+	return fs::exists( result ) ? result : fs::path();
+}
+
+map<string,string> PlatformLinux::getEnvironmentVariables()
+{
+	map<string,string> result;
+	for( char **env = environ; env && *env; ++env ) {
+		string entry( *env );
+		size_t equals = entry.find( '=' );
+		if( equals != string::npos )
+			result[entry.substr( 0, equals )] = entry.substr( equals + 1 );
+	}
+
+	return result;
+}
+
+fs::path PlatformLinux::expandPath( const fs::path &path )
+{
+	string pathStr = path.string();
+	if( ! pathStr.empty() && pathStr[0] == '~' )
+		pathStr = getHomeDirectory().string() + pathStr.substr( 1 );
+
+	char buffer[PATH_MAX];
+	if( ::realpath( pathStr.c_str(), buffer ) )
+		return fs::path( buffer );
+	else
+		return fs::path( pathStr );
+}
+
+fs::path PlatformLinux::getHomeDirectory()
+{
+	const char *home = ::getenv( "HOME" );
+	return fs::path( home ? home : "/" );
+}
+
+fs::path PlatformLinux::getDocumentsDirectory()
+{
+	return getHomeDirectory() / "Documents";
+}
+
+void PlatformLinux::sleep( float milliseconds )
+{
+	::timespec ts;
+	ts.tv_sec = (time_t)( milliseconds / 1000 );
+	ts.tv_nsec = (long)( ( milliseconds - ts.tv_sec * 1000 ) * 1000000 );
+	::nanosleep( &ts, nullptr );
+}
+
+vector<string> PlatformLinux::stackTrace()
+{
+	void *frames[128];
+	int numFrames = ::backtrace( frames, 128 );
+	char **symbols = ::backtrace_symbols( frames, numFrames );
+
+	vector<string> result;
+	// skip this function
+	for( int i = 1; i < numFrames && symbols; ++i )
+		result.push_back( symbols[i] );
+	::free( symbols );
+
+	return result;
+}
+
+} } // namespace cinder::app
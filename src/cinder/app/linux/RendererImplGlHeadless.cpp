@@ -0,0 +1,112 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/app/linux/RendererImplGlHeadless.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/Context.h"
+#include "cinder/gl/Environment.h"
+#include "cinder/gl/Fbo.h"
+#include "cinder/gl/wrapper.h"
+#include "cinder/Log.h"
+
+namespace cinder { namespace app {
+
+RendererImplGlHeadless::RendererImplGlHeadless( RendererGl *aRenderer )
+	: mRenderer( aRenderer ), mSize( 0 )
+{
+}
+
+bool RendererImplGlHeadless::initialize( const ivec2 &size, RendererRef sharedRenderer )
+{
+	const RendererGl::Options &options = mRenderer->getOptions();
+
+	RendererGl *sharedRendererGl = dynamic_cast<RendererGl*>( sharedRenderer.get() );
+	const gl::PlatformDataLinux *sharedPlatformData = nullptr;
+	if( sharedRendererGl && sharedRendererGl->mImpl && sharedRendererGl->mImpl->mCinderContext )
+		sharedPlatformData = dynamic_cast<const gl::PlatformDataLinux*>( sharedRendererGl->mImpl->mCinderContext->getPlatformData().get() );
+
+	std::shared_ptr<gl::PlatformDataLinux> platformData;
+	try {
+		platformData = gl::PlatformDataLinux::create( options.getVersion().first, options.getVersion().second, options.getCoreProfile(), options.getDebug(), sharedPlatformData );
+	}
+	catch( gl::ExcContextAllocation & ) {
+		return false;
+	}
+
+	platformData->mDebugLogSeverity = options.getDebugLogSeverity();
+	platformData->mDebugBreakSeverity = options.getDebugBreakSeverity();
+	platformData->mObjectTracking = options.getObjectTracking();
+
+	gl::Environment::setCore();
+	gl::env()->initializeFunctionPointers();
+	mCinderContext = gl::Context::createFromExisting( platformData );
+	mCinderContext->makeCurrent();
+
+	setFrameSize( size );
+
+	return true;
+}
+
+void RendererImplGlHeadless::kill()
+{
+	mFbo.reset();
+	mCinderContext.reset(); // the Context owns the platform context, which is destroyed along with it
+	gl::Context::reflectCurrent( nullptr );
+}
+
+void RendererImplGlHeadless::setFrameSize( const ivec2 &size )
+{
+	if( mFbo && size == mSize )
+		return;
+
+	mSize = glm::max( size, ivec2( 1 ) );
+	const RendererGl::Options &options = mRenderer->getOptions();
+	auto format = gl::Fbo::Format().samples( options.getMsaa() ).stencilBuffer( options.getStencil() );
+	mFbo = gl::Fbo::create( mSize.x, mSize.y, format );
+	bindDefaultFramebuffer();
+}
+
+void RendererImplGlHeadless::bindDefaultFramebuffer()
+{
+	// there is no window system framebuffer, so the Fbo replaces the bottom of the framebuffer stack
+	gl::context()->bindFramebuffer( mFbo );
+}
+
+void RendererImplGlHeadless::defaultResize() const
+{
+	gl::viewport( 0, 0, mSize.x, mSize.y );
+	gl::setMatricesWindow( mSize.x, mSize.y );
+}
+
+void RendererImplGlHeadless::swapBuffers() const
+{
+	// nothing is presented; flushing keeps the driver's queue bounded when frames are issued back to back
+	glFlush();
+}
+
+void RendererImplGlHeadless::makeCurrentContext( bool force )
+{
+	mCinderContext->makeCurrent( force );
+}
+
+} } // namespace cinder::app
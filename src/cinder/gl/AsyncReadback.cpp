@@ -0,0 +1,332 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/gl/platform.h" // must be first
+#include "cinder/gl/AsyncReadback.h"
+
+#if ! defined( CINDER_GL_ES )
+
+#include "cinder/gl/scoped.h"
+#include "cinder/CinderAssert.h"
+#include "cinder/Log.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace cinder { namespace gl {
+
+// Retains the pixel memory of released Surfaces so that steady-state readback never allocates
+struct AsyncReadback::SurfacePool {
+	SurfacePool( size_t maxPooled )
+		: mMaxPooled( maxPooled )
+	{}
+
+	~SurfacePool()
+	{
+		for( auto &entry : mFree )
+			delete [] entry.second;
+	}
+
+	uint8_t* acquire( size_t size )
+	{
+		{
+			lock_guard<mutex> lock( mMutex );
+			for( auto it = mFree.begin(); it != mFree.end(); ++it ) {
+				if( it->first == size ) {
+					uint8_t *result = it->second;
+					mFree.erase( it );
+					return result;
+				}
+			}
+		}
+
+		return new uint8_t[size];
+	}
+
+	void release( uint8_t *data, size_t size )
+	{
+		lock_guard<mutex> lock( mMutex );
+		if( mFree.size() < mMaxPooled )
+			mFree.push_back( make_pair( size, data ) );
+		else
+			delete [] data;
+	}
+
+	size_t							mMaxPooled;
+	mutex							mMutex;
+	vector<pair<size_t, uint8_t*>>	mFree;
+};
+
+AsyncReadbackRef AsyncReadback::create( const Format &format )
+{
+	return AsyncReadbackRef( new AsyncReadback( format ) );
+}
+
+AsyncReadback::AsyncReadback( const Format &format )
+	: mFormat( format ), mWriteIndex( 0 ), mReadIndex( 0 ), mNextReadId( 0 ),
+	mWorkQueue( std::max<size_t>( format.getNumBuffers(), 1 ) ), mShouldQuit( false )
+{
+	CI_ASSERT( mFormat.getNumBuffers() > 0 );
+
+	for( size_t i = 0; i < std::max<size_t>( mFormat.getNumBuffers(), 1 ); ++i ) {
+		mSlots.emplace_back( new Slot );
+		mSlots.back()->mPbo = Pbo::create( GL_PIXEL_PACK_BUFFER );
+		mSlots.back()->mPbo->setUsage( GL_STREAM_READ );
+	}
+
+	mSurfacePool = make_shared<SurfacePool>( mFormat.getMaxPooledSurfaces() );
+
+	if( mFormat.isThreaded() )
+		mWorkerThread = unique_ptr<thread>( new thread( bind( &AsyncReadback::workerThreadFn, this ) ) );
+}
+
+AsyncReadback::~AsyncReadback()
+{
+	if( mWorkerThread ) {
+		mShouldQuit = true;
+		mWorkQueue.cancel();
+		mWorkerThread->join();
+	}
+
+	// anything still mapped must be unmapped before the PBOs are destroyed
+	for( auto &slot : mSlots ) {
+		if( slot->mState == Slot::MAPPED )
+			slot->mPbo->unmap();
+	}
+}
+
+uint64_t AsyncReadback::readPixels( const FboRef &fbo, const Area &area, GLenum attachment )
+{
+	// the ring is full; the oldest read has to be delivered before its PBO can be reused
+	Slot *slot = mSlots[mWriteIndex].get();
+	while( slot->mState != Slot::EMPTY )
+		retire( mSlots[mReadIndex].get(), true );
+
+	// resolve first, so that we read from the single-sampled framebuffer
+	fbo->resolveTextures();
+
+	const Area clippedArea = area.getClipBy( fbo->getBounds() );
+	const int32_t width = clippedArea.getWidth();
+	const int32_t height = clippedArea.getHeight();
+	const GLint srcY0 = fbo->getHeight() - clippedArea.y2;
+
+	GLuint readFramebufferId = fbo->getResolveId();
+	GLint readX = clippedArea.x1, readY = srcY0;
+
+	if( mFormat.isFlipVertical() ) {
+		// mirror the area into an intermediate framebuffer so that the rows come back top-down
+		if( ! mFlipFbo || mFlipFbo->getWidth() != width || mFlipFbo->getHeight() != height ) {
+			auto flipFormat = Fbo::Format().disableColor().disableDepth().attachment( GL_COLOR_ATTACHMENT0, Renderbuffer::create( width, height, GL_RGBA8 ) );
+			mFlipFbo = Fbo::create( width, height, flipFormat );
+		}
+
+		ScopedFramebuffer readScp( GL_READ_FRAMEBUFFER, fbo->getResolveId() );
+		ScopedFramebuffer drawScp( GL_DRAW_FRAMEBUFFER, mFlipFbo->getId() );
+		glReadBuffer( attachment );
+		glBlitFramebuffer( clippedArea.x1, srcY0, clippedArea.x2, srcY0 + height, 0, height, width, 0, GL_COLOR_BUFFER_BIT, GL_NEAREST );
+
+		readFramebufferId = mFlipFbo->getId();
+		attachment = GL_COLOR_ATTACHMENT0;
+		readX = readY = 0;
+	}
+
+	const GLsizeiptr size = width * height * 4;
+	ScopedFramebuffer readScp( GL_FRAMEBUFFER, readFramebufferId );
+	ScopedBuffer bufferScp( slot->mPbo );
+	if( (GLsizeiptr)slot->mPbo->getSize() != size )
+		slot->mPbo->bufferData( size, nullptr, GL_STREAM_READ );
+
+	glReadBuffer( attachment );
+	glReadPixels( readX, readY, width, height, mFormat.isBgra() ? GL_BGRA : GL_RGBA, GL_UNSIGNED_BYTE, nullptr );
+
+	slot->mFence = Sync::create();
+	slot->mState = Slot::PENDING;
+	slot->mWidth = width;
+	slot->mHeight = height;
+	slot->mReadId = mNextReadId++;
+
+	mWriteIndex = ( mWriteIndex + 1 ) % mSlots.size();
+
+	return slot->mReadId;
+}
+
+void AsyncReadback::update()
+{
+	// fences signal in submission order, so we can stop at the first one still in flight
+	const size_t numSlots = mSlots.size();
+	for( size_t i = 0; i < numSlots; ++i ) {
+		Slot *slot = mSlots[( mReadIndex + i ) % numSlots].get();
+		if( slot->mState == Slot::EMPTY )
+			break;
+		else if( slot->mState == Slot::PENDING ) {
+			GLenum status = slot->mFence->clientWaitSync( GL_SYNC_FLUSH_COMMANDS_BIT, 0 );
+			if( status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED )
+				break;
+			mapAndDispatch( slot );
+		}
+	}
+
+	// unmap the oldest slots whose contents have been copied out
+	while( mSlots[mReadIndex]->mState == Slot::MAPPED && mSlots[mReadIndex]->mCopied )
+		retire( mSlots[mReadIndex].get(), false );
+}
+
+void AsyncReadback::flush()
+{
+	while( mSlots[mReadIndex]->mState != Slot::EMPTY )
+		retire( mSlots[mReadIndex].get(), true );
+}
+
+void AsyncReadback::retire( Slot *slot, bool block )
+{
+	CI_ASSERT( slot == mSlots[mReadIndex].get() );
+
+	if( slot->mState == Slot::PENDING ) {
+		GLenum status = slot->mFence->clientWaitSync( GL_SYNC_FLUSH_COMMANDS_BIT, 0 );
+		while( block && status == GL_TIMEOUT_EXPIRED )
+			status = slot->mFence->clientWaitSync( 0, 1000000 ); // 1ms
+		if( status == GL_TIMEOUT_EXPIRED )
+			return;
+		else if( status == GL_WAIT_FAILED )
+			CI_LOG_E( "glClientWaitSync failed, reading back anyway" );
+		mapAndDispatch( slot );
+	}
+
+	if( slot->mState == Slot::MAPPED ) {
+		if( ! slot->mCopied ) {
+			if( ! block )
+				return;
+			unique_lock<mutex> lock( mCopiedMutex );
+			mCopiedCond.wait( lock, [slot] { return slot->mCopied.load(); } );
+		}
+
+		slot->mPbo->unmap();
+		slot->mMapped = nullptr;
+		slot->mFence.reset();
+		slot->mState = Slot::EMPTY;
+		mReadIndex = ( mReadIndex + 1 ) % mSlots.size();
+	}
+}
+
+void AsyncReadback::mapAndDispatch( Slot *slot )
+{
+	slot->mMapped = reinterpret_cast<const uint8_t*>( slot->mPbo->mapBufferRange( 0, slot->mWidth * slot->mHeight * 4, GL_MAP_READ_BIT ) );
+	slot->mCopied = false;
+	slot->mState = Slot::MAPPED;
+
+	if( mWorkerThread )
+		mWorkQueue.pushFront( slot );
+	else
+		deliver( slot );
+}
+
+void AsyncReadback::deliver( Slot *slot )
+{
+	Surface8uRef surface;
+	if( slot->mMapped ) {
+		surface = acquireSurface( slot->mWidth, slot->mHeight );
+		// rows are tightly packed on both sides since we always read 4 bytes per pixel
+		memcpy( surface->getData(), slot->mMapped, slot->mWidth * slot->mHeight * 4 );
+	}
+	else
+		CI_LOG_E( "Failed to map PBO for read " << slot->mReadId );
+
+	const uint64_t readId = slot->mReadId;
+
+	{
+		lock_guard<mutex> lock( mCopiedMutex );
+		slot->mCopied = true;
+	}
+	mCopiedCond.notify_all();
+
+	if( ! surface )
+		return;
+
+	if( mCompletionFn )
+		mCompletionFn( surface, readId );
+	else {
+		lock_guard<mutex> lock( mCompletedMutex );
+		mCompleted.push_back( make_pair( surface, readId ) );
+	}
+}
+
+void AsyncReadback::workerThreadFn()
+{
+	ThreadSetup threadSetup;
+
+	while( ! mShouldQuit ) {
+		Slot *slot = nullptr;
+		mWorkQueue.popBack( &slot );
+		if( mShouldQuit || ! slot )
+			break;
+
+		deliver( slot );
+	}
+}
+
+Surface8uRef AsyncReadback::acquireSurface( int32_t width, int32_t height )
+{
+	const size_t size = width * height * 4;
+	uint8_t *data = mSurfacePool->acquire( size );
+	SurfaceChannelOrder channelOrder( mFormat.isBgra() ? SurfaceChannelOrder::BGRA : SurfaceChannelOrder::RGBA );
+
+	// the deleter hands the pixel memory back to the pool, or frees it if the AsyncReadback is gone
+	weak_ptr<SurfacePool> poolWeak = mSurfacePool;
+	return Surface8uRef( new Surface8u( data, width, height, width * 4, channelOrder ), [poolWeak, data, size]( Surface8u *surface ) {
+		delete surface;
+		auto pool = poolWeak.lock();
+		if( pool )
+			pool->release( data, size );
+		else
+			delete [] data;
+	} );
+}
+
+bool AsyncReadback::getNextSurface( Surface8uRef *result, uint64_t *readId )
+{
+	lock_guard<mutex> lock( mCompletedMutex );
+	if( mCompleted.empty() )
+		return false;
+
+	*result = mCompleted.front().first;
+	if( readId )
+		*readId = mCompleted.front().second;
+	mCompleted.pop_front();
+	return true;
+}
+
+size_t AsyncReadback::getNumPending() const
+{
+	size_t result = 0;
+	for( auto &slot : mSlots ) {
+		if( slot->mState != Slot::EMPTY )
+			++result;
+	}
+
+	return result;
+}
+
+} } // namespace cinder::gl
+
+#endif // ! defined( CINDER_GL_ES )
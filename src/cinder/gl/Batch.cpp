@@ -28,6 +28,7 @@
 #include "cinder/gl/scoped.h"
 
 #include "cinder/Log.h"
+#include "cinder/Profiler.h"
 
 namespace cinder { namespace gl {
 
@@ -100,6 +101,7 @@ void Batch::replaceVboMesh( const VboMeshRef &vboMesh )
 
 void Batch::draw( GLint first, GLsizei count )
 {
+	CI_PROFILE_GPU( "Batch::draw" );
 	auto ctx = gl::context();
 	
 	gl::ScopedGlslProg ScopedGlslProg( mGlsl );
@@ -111,6 +113,7 @@ void Batch::draw( GLint first, GLsizei count )
 #if (! defined( CINDER_GL_ES_2 )) || defined( CINDER_COCOA_TOUCH )
 void Batch::drawInstanced( GLsizei instanceCount )
 {
+	CI_PROFILE_GPU( "Batch::drawInstanced" );
 	auto ctx = gl::context();
 	
 	gl::ScopedGlslProg ScopedGlslProg( mGlsl );
@@ -134,7 +137,7 @@ void Batch::reassignContext( Context *context )
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // VertBatch
 VertBatch::VertBatch( GLenum primType, bool useContextDefaultBuffers )
-	: mPrimType( primType )
+	: mPrimType( primType ), mVao( nullptr ), mDirtyBegin( SIZE_MAX ), mDirtyEnd( 0 ), mUploadedLayout( -1 ), mUploadedCapacity( 0 ), mVaoGlsl( nullptr ), mVaoGlslHandle( 0 )
 {
 	if( useContextDefaultBuffers ) {
 		auto ctx = gl::context();
@@ -205,6 +208,42 @@ void VertBatch::addVertex( const vec4 &v )
 		while( mTexCoords.size() < mVertices.size() )
 			mTexCoords.push_back( mTexCoords.back() );	
 	}
+
+	markDirty( mVertices.size() - 1, mVertices.size() );
+}
+
+void VertBatch::setVertex( size_t index, const vec4 &v )
+{
+	CI_ASSERT( index < mVertices.size() );
+	mVertices[index] = v;
+	markDirty( index, index + 1 );
+}
+
+void VertBatch::setNormal( size_t index, const vec3 &n )
+{
+	CI_ASSERT( index < mNormals.size() );
+	mNormals[index] = n;
+	markDirty( index, index + 1 );
+}
+
+void VertBatch::setColor( size_t index, const ColorAf &c )
+{
+	CI_ASSERT( index < mColors.size() );
+	mColors[index] = c;
+	markDirty( index, index + 1 );
+}
+
+void VertBatch::setTexCoord( size_t index, const vec4 &t )
+{
+	CI_ASSERT( index < mTexCoords.size() );
+	mTexCoords[index] = t;
+	markDirty( index, index + 1 );
+}
+
+void VertBatch::markDirty( size_t begin, size_t end )
+{
+	mDirtyBegin = std::min( mDirtyBegin, begin );
+	mDirtyEnd = std::max( mDirtyEnd, end );
 }
 
 void VertBatch::begin( GLenum primType )
@@ -219,17 +258,17 @@ void VertBatch::end()
 
 void VertBatch::clear()
 {
+	// the vectors keep their capacity and the buffers are kept for the vertices which follow
 	mVertices.clear();
 	mNormals.clear();
 	mColors.clear();
 	mTexCoords.clear();
-	mVbo.reset();
-	mVao = nullptr;
+	mDirtyBegin = SIZE_MAX;
+	mDirtyEnd = 0;
 }
 
 void VertBatch::draw()
 {
-	// this pushes the VAO, which needs to be popped
 	setupBuffers();
 	ScopedVao vao( mVao );
 	
@@ -238,6 +277,51 @@ void VertBatch::draw()
 	ctx->drawArrays( mPrimType, 0, (GLsizei)mVertices.size() );
 }
 
+int VertBatch::getLayout() const
+{
+	return ( mNormals.empty() ? 0 : LAYOUT_NORMALS ) | ( mColors.empty() ? 0 : LAYOUT_COLORS ) | ( mTexCoords.empty() ? 0 : LAYOUT_TEX_COORDS );
+}
+
+namespace {
+
+size_t floatsPerVertex( int layout, int normalsBit, int colorsBit, int texCoordsBit )
+{
+	return 4 + ( ( layout & normalsBit ) ? 3 : 0 ) + ( ( layout & colorsBit ) ? 4 : 0 ) + ( ( layout & texCoordsBit ) ? 4 : 0 );
+}
+
+// attributes specified before the first vertex can leave their vector shorter than mVertices
+template<typename T>
+const T& attribAt( const std::vector<T> &values, size_t index )
+{
+	return ( index < values.size() ) ? values[index] : values.back();
+}
+
+} // anonymous namespace
+
+void VertBatch::interleave( int layout, size_t begin, size_t end )
+{
+	const size_t numFloats = floatsPerVertex( layout, LAYOUT_NORMALS, LAYOUT_COLORS, LAYOUT_TEX_COORDS );
+	mInterleaved.resize( ( end - begin ) * numFloats );
+
+	float *dst = mInterleaved.data();
+	for( size_t i = begin; i < end; ++i ) {
+		memcpy( dst, &mVertices[i], sizeof( vec4 ) );
+		dst += 4;
+		if( layout & LAYOUT_NORMALS ) {
+			memcpy( dst, &attribAt( mNormals, i ), sizeof( vec3 ) );
+			dst += 3;
+		}
+		if( layout & LAYOUT_COLORS ) {
+			memcpy( dst, &attribAt( mColors, i ), sizeof( ColorAf ) );
+			dst += 4;
+		}
+		if( layout & LAYOUT_TEX_COORDS ) {
+			memcpy( dst, &attribAt( mTexCoords, i ), sizeof( vec4 ) );
+			dst += 4;
+		}
+	}
+}
+
 // Leaves mVAO bound
 void VertBatch::setupBuffers()
 {
@@ -247,91 +331,107 @@ void VertBatch::setupBuffers()
 	if( ! glslProg )
 		return;
 
-	const size_t verticesSizeBytes = mVertices.size() * sizeof(vec4);
-	const size_t normalsSizeBytes = mNormals.size() * sizeof(vec3);
-	const size_t colorsSizeBytes = mColors.size() * sizeof(ColorAf);
-	const size_t texCoordsSizeBytes = mTexCoords.size() * sizeof(vec4);
-	size_t totalSizeBytes = verticesSizeBytes + normalsSizeBytes + colorsSizeBytes + texCoordsSizeBytes;
-
-	// allocate the VBO if we don't have one yet (which implies we're not using the context defaults)
-	bool forceUpload = false;
-	if( ! mVbo ) {
-		// allocate the VBO and upload the data
-		mVbo = gl::Vbo::create( GL_ARRAY_BUFFER, totalSizeBytes );
-		forceUpload = true;
-	}
-	
-	ScopedBuffer ScopedBuffer( mVbo );
-	// if this VBO was freshly made, or we don't own the buffer because we use the context defaults
-	if( ( forceUpload || ( ! mOwnsBuffers ) ) && ( ! mVertices.empty() ) ) {
-		mVbo->ensureMinimumSize( totalSizeBytes );
-		
-		// upload positions
-		GLintptr offset = 0;
-		mVbo->bufferSubData( offset, verticesSizeBytes, &mVertices[0] );
-		offset += verticesSizeBytes;
-		
-		// upload normals
-		if( ! mNormals.empty() ) {
-			mVbo->bufferSubData( offset, normalsSizeBytes, &mNormals[0] );
-			offset += normalsSizeBytes;
+	const int layout = getLayout();
+	const size_t stride = floatsPerVertex( layout, LAYOUT_NORMALS, LAYOUT_COLORS, LAYOUT_TEX_COORDS ) * sizeof( float );
+	const size_t numVertices = mVertices.size();
+
+	// the context's default buffers are shared, so everything is uploaded and the VAO respecified for every draw
+	if( ! mOwnsBuffers ) {
+		interleave( layout, 0, numVertices );
+		ScopedBuffer bufferScp( mVbo );
+		if( ! mInterleaved.empty() ) {
+			mVbo->ensureMinimumSize( mInterleaved.size() * sizeof( float ) );
+			mVbo->bufferSubData( 0, mInterleaved.size() * sizeof( float ), mInterleaved.data() );
 		}
 
-		// upload colors
-		if( ! mColors.empty() ) {
-			mVbo->bufferSubData( offset, colorsSizeBytes, &mColors[0] );
-			offset += colorsSizeBytes;
-		}
+		ctx->pushVao();
+		mVao->replacementBindBegin();
+		setupVertexAttribs( layout );
+		mVao->replacementBindEnd();
+		ctx->popVao();
+		return;
+	}
 
-		// upload texCoords
-		if( ! mTexCoords.empty() ) {
-			mVbo->bufferSubData( offset, texCoordsSizeBytes, &mTexCoords[0] );
-			offset += texCoordsSizeBytes;
+	// everything is uploaded again when the stride changes or the vertices outgrow the Vbo, which grows with some headroom
+	if( layout != mUploadedLayout || numVertices > mUploadedCapacity || ! mVbo ) {
+		size_t capacity = numVertices;
+		if( layout == mUploadedLayout && mUploadedCapacity > 0 )
+			capacity += numVertices / 2;
+		capacity = std::max<size_t>( capacity, 1 );
+
+		if( ! mVbo )
+			mVbo = gl::Vbo::create( GL_ARRAY_BUFFER, capacity * stride, nullptr, GL_DYNAMIC_DRAW );
+		else {
+			ScopedBuffer bufferScp( mVbo );
+			mVbo->bufferData( capacity * stride, nullptr, GL_DYNAMIC_DRAW );
 		}
+		mUploadedCapacity = capacity;
+		mDirtyBegin = 0;
+		mDirtyEnd = numVertices;
 	}
 
-	// Setup the VAO
-	ctx->pushVao(); // this will be popped by draw()
-	if( ! mOwnsBuffers )
-		mVao->replacementBindBegin();
-	else {
+	mDirtyEnd = std::min( mDirtyEnd, numVertices );
+	if( mDirtyBegin < mDirtyEnd ) {
+		interleave( layout, mDirtyBegin, mDirtyEnd );
+		ScopedBuffer bufferScp( mVbo );
+		mVbo->bufferSubData( mDirtyBegin * stride, mInterleaved.size() * sizeof( float ), mInterleaved.data() );
+	}
+	mDirtyBegin = SIZE_MAX;
+	mDirtyEnd = 0;
+
+	// a fresh VAO avoids leaving attributes enabled which the new GlslProg doesn't have
+	if( ! mVaoStorage || layout != mUploadedLayout || glslProg != mVaoGlsl || glslProg->getHandle() != mVaoGlslHandle ) {
 		mVaoStorage = gl::Vao::create();
 		mVao = mVaoStorage.get();
-		mVao->bind();
+		ScopedVao vaoScp( mVao );
+		setupVertexAttribs( layout );
+		mVaoGlsl = glslProg;
+		mVaoGlslHandle = glslProg->getHandle();
 	}
 
+	mUploadedLayout = layout;
+}
+
+void VertBatch::setupVertexAttribs( int layout )
+{
+	auto ctx = gl::context();
+	auto glslProg = ctx->getGlslProg();
+	const GLsizei stride = (GLsizei)( floatsPerVertex( layout, LAYOUT_NORMALS, LAYOUT_COLORS, LAYOUT_TEX_COORDS ) * sizeof( float ) );
+
 	gl::ScopedBuffer vboScope( mVbo );
 	size_t offset = 0;
 	if( glslProg->hasAttribSemantic( geom::Attrib::POSITION ) ) {
 		int loc = glslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 		ctx->enableVertexAttribArray( loc );
-		ctx->vertexAttribPointer( loc, 4, GL_FLOAT, false, 0, (const GLvoid*)offset );
-		offset += verticesSizeBytes;
+		ctx->vertexAttribPointer( loc, 4, GL_FLOAT, false, stride, (const GLvoid*)offset );
 	}
+	offset += sizeof( vec4 );
 
-	if( glslProg->hasAttribSemantic( geom::Attrib::NORMAL ) && ( ! mNormals.empty() ) ) {
-		int loc = glslProg->getAttribSemanticLocation( geom::Attrib::NORMAL );
-		ctx->enableVertexAttribArray( loc );
-		ctx->vertexAttribPointer( loc, 3, GL_FLOAT, false, 0, (const GLvoid*)offset );
-		offset += normalsSizeBytes;
+	if( layout & LAYOUT_NORMALS ) {
+		if( glslProg->hasAttribSemantic( geom::Attrib::NORMAL ) ) {
+			int loc = glslProg->getAttribSemanticLocation( geom::Attrib::NORMAL );
+			ctx->enableVertexAttribArray( loc );
+			ctx->vertexAttribPointer( loc, 3, GL_FLOAT, false, stride, (const GLvoid*)offset );
+		}
+		offset += sizeof( vec3 );
 	}
 
-	if( glslProg->hasAttribSemantic( geom::Attrib::COLOR ) && ( ! mColors.empty() ) ) {
-		int loc = glslProg->getAttribSemanticLocation( geom::Attrib::COLOR );
-		ctx->enableVertexAttribArray( loc );
-		ctx->vertexAttribPointer( loc, 4, GL_FLOAT, false, 0, (const GLvoid*)offset );
-		offset += colorsSizeBytes;
+	if( layout & LAYOUT_COLORS ) {
+		if( glslProg->hasAttribSemantic( geom::Attrib::COLOR ) ) {
+			int loc = glslProg->getAttribSemanticLocation( geom::Attrib::COLOR );
+			ctx->enableVertexAttribArray( loc );
+			ctx->vertexAttribPointer( loc, 4, GL_FLOAT, false, stride, (const GLvoid*)offset );
+		}
+		offset += sizeof( ColorAf );
 	}
 
-	if( glslProg->hasAttribSemantic( geom::Attrib::TEX_COORD_0 ) && ( ! mTexCoords.empty() ) ) {
-		int loc = glslProg->getAttribSemanticLocation( geom::Attrib::TEX_COORD_0 );
-		ctx->enableVertexAttribArray( loc );
-		ctx->vertexAttribPointer( loc, 4, GL_FLOAT, false, 0, (const GLvoid*)offset );
+	if( layout & LAYOUT_TEX_COORDS ) {
+		if( glslProg->hasAttribSemantic( geom::Attrib::TEX_COORD_0 ) ) {
+			int loc = glslProg->getAttribSemanticLocation( geom::Attrib::TEX_COORD_0 );
+			ctx->enableVertexAttribArray( loc );
+			ctx->vertexAttribPointer( loc, 4, GL_FLOAT, false, stride, (const GLvoid*)offset );
+		}
 	}
-	
-	if( ! mOwnsBuffers )
-		mVao->replacementBindEnd();
-	ctx->popVao();
 }
 
 } } // namespace cinder::gl
\ No newline at end of file
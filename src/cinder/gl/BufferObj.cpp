@@ -209,7 +209,14 @@ GLuint BufferObj::getBindingConstantForTarget( GLenum target )
 			return GL_TRANSFORM_FEEDBACK_BUFFER_BINDING;
 		case GL_UNIFORM_BUFFER:
 			return GL_UNIFORM_BUFFER_BINDING;
+		case GL_COPY_READ_BUFFER:
+			return GL_COPY_READ_BUFFER_BINDING;
+		case GL_COPY_WRITE_BUFFER:
+			return GL_COPY_WRITE_BUFFER_BINDING;
+		case GL_DRAW_INDIRECT_BUFFER:
+			return GL_DRAW_INDIRECT_BUFFER_BINDING;
 #endif
+
 		default:
 			return 0;
 	}
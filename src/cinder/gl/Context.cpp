@@ -34,7 +34,11 @@
 #include "cinder/Log.h"
 #include "cinder/Utilities.h"
 
-#include "cinder/app/AppBase.h"
+#if defined( CINDER_LINUX )
+	#include "cinder/app/linux/AppHeadless.h"
+#else
+	#include "cinder/app/AppBase.h"
+#endif
 
 #if defined( CINDER_MSW )
 	#include <Windows.h>
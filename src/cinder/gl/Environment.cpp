@@ -37,6 +37,13 @@
 	#include "EGL/egl.h"
 #elif defined( CINDER_MSW )
 	#include <windows.h>
+#elif defined( CINDER_LINUX )
+	#define EGL_NO_X11
+	#define MESA_EGL_NO_X11_HEADERS
+	#include <EGL/egl.h>
+	#include <EGL/eglext.h>
+	#include <dlfcn.h>
+	#include <mutex>
 #endif
 
 #include "cinder/Log.h"
@@ -74,6 +81,149 @@ Environment* env()
 	return sEnvironment;
 }
 
+#if defined( CINDER_LINUX )
+namespace {
+// OSMesa is loaded at runtime so that neither its headers (which collide with glload's) nor the library are required when EGL is available
+struct OsMesaApi {
+	typedef OSMesaContext	(*CreateContextAttribsFn)( const int *attribList, OSMesaContext sharelist );
+	typedef unsigned char	(*MakeCurrentFn)( OSMesaContext ctx, void *buffer, GLenum type, GLsizei width, GLsizei height );
+	typedef void			(*DestroyContextFn)( OSMesaContext ctx );
+
+	enum { FORMAT = 0x22, DEPTH_BITS = 0x30, STENCIL_BITS = 0x31, ACCUM_BITS = 0x32, PROFILE = 0x33, CORE_PROFILE = 0x34, COMPAT_PROFILE = 0x35,
+			CONTEXT_MAJOR_VERSION = 0x36, CONTEXT_MINOR_VERSION = 0x37 };
+
+	static const OsMesaApi* get()
+	{
+		static OsMesaApi sApi;
+		static std::once_flag sLoadedFlag;
+		std::call_once( sLoadedFlag, [] {
+			void *lib = nullptr;
+			for( const char *name : { "libOSMesa.so.8", "libOSMesa.so.6", "libOSMesa.so" } ) {
+				if( ( lib = ::dlopen( name, RTLD_NOW | RTLD_GLOBAL ) ) != nullptr )
+					break;
+			}
+			if( lib ) {
+				sApi.mCreateContextAttribs = (CreateContextAttribsFn)::dlsym( lib, "OSMesaCreateContextAttribs" );
+				sApi.mMakeCurrent = (MakeCurrentFn)::dlsym( lib, "OSMesaMakeCurrent" );
+				sApi.mDestroyContext = (DestroyContextFn)::dlsym( lib, "OSMesaDestroyContext" );
+			}
+		} );
+
+		return ( sApi.mCreateContextAttribs && sApi.mMakeCurrent && sApi.mDestroyContext ) ? &sApi : nullptr;
+	}
+
+	CreateContextAttribsFn	mCreateContextAttribs = nullptr;
+	MakeCurrentFn			mMakeCurrent = nullptr;
+	DestroyContextFn		mDestroyContext = nullptr;
+};
+
+#if ! defined( EGL_PLATFORM_SURFACELESS_MESA )
+	#define EGL_PLATFORM_SURFACELESS_MESA	0x31DD
+#endif
+
+EGLDisplay getHeadlessEglDisplay()
+{
+	static EGLDisplay sDisplay = EGL_NO_DISPLAY;
+	static std::once_flag sInitializedFlag;
+	std::call_once( sInitializedFlag, [] {
+		auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)::eglGetProcAddress( "eglGetPlatformDisplayEXT" );
+		if( getPlatformDisplay )
+			sDisplay = getPlatformDisplay( EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr );
+		if( sDisplay == EGL_NO_DISPLAY )
+			sDisplay = ::eglGetDisplay( EGL_DEFAULT_DISPLAY );
+
+		EGLint major, minor;
+		if( sDisplay == EGL_NO_DISPLAY || ! ::eglInitialize( sDisplay, &major, &minor ) ) {
+			CI_LOG_W( "Failed to initialize an EGL display" );
+			sDisplay = EGL_NO_DISPLAY;
+		}
+		else if( ! ::eglBindAPI( EGL_OPENGL_API ) ) {
+			CI_LOG_W( "EGL " << major << "." << minor << " does not support desktop OpenGL" );
+			sDisplay = EGL_NO_DISPLAY;
+		}
+	} );
+
+	return sDisplay;
+}
+
+PlatformDataLinux* createEglPlatformData( int majorVersion, int minorVersion, bool coreProfile, bool debug, const PlatformDataLinux *sharedPlatformData )
+{
+	EGLDisplay display = getHeadlessEglDisplay();
+	if( display == EGL_NO_DISPLAY )
+		return nullptr;
+
+	// there is no surface, so the config only matters for sharing; prefer one which could back a pbuffer
+	EGLConfig config = nullptr;
+	EGLint numConfigs = 0;
+	const EGLint configAttribs[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8, EGL_NONE };
+	const EGLint anyConfigAttribs[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+	if( ! ::eglChooseConfig( display, configAttribs, &config, 1, &numConfigs ) || numConfigs < 1 ) {
+		if( ! ::eglChooseConfig( display, anyConfigAttribs, &config, 1, &numConfigs ) || numConfigs < 1 )
+			config = nullptr; // EGL_NO_CONFIG_KHR
+	}
+	if( sharedPlatformData )
+		config = sharedPlatformData->mConfig;
+
+	const EGLint contextAttribs[] = {
+		EGL_CONTEXT_MAJOR_VERSION_KHR, majorVersion,
+		EGL_CONTEXT_MINOR_VERSION_KHR, minorVersion,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, coreProfile ? EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR : EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT_KHR,
+		EGL_CONTEXT_FLAGS_KHR, debug ? EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR : 0,
+		EGL_NONE
+	};
+	EGLContext sharedContext = sharedPlatformData ? sharedPlatformData->mContext : EGL_NO_CONTEXT;
+	EGLContext context = ::eglCreateContext( display, config, sharedContext, contextAttribs );
+	if( context == EGL_NO_CONTEXT ) {
+		CI_LOG_W( "eglCreateContext failed for OpenGL " << majorVersion << "." << minorVersion << ", error: 0x" << std::hex << ::eglGetError() << std::dec );
+		return nullptr;
+	}
+
+	// requires EGL_KHR_surfaceless_context, which every Mesa driver (including llvmpipe) exposes
+	if( ! ::eglMakeCurrent( display, EGL_NO_SURFACE, EGL_NO_SURFACE, context ) ) {
+		CI_LOG_W( "eglMakeCurrent without a surface failed, error: 0x" << std::hex << ::eglGetError() << std::dec );
+		::eglDestroyContext( display, context );
+		return nullptr;
+	}
+
+	return new PlatformDataLinux( context, display, config );
+}
+
+PlatformDataLinux* createOsMesaPlatformData( int majorVersion, int minorVersion, bool coreProfile, const PlatformDataLinux *sharedPlatformData )
+{
+	const OsMesaApi *api = OsMesaApi::get();
+	if( ! api )
+		return nullptr;
+
+	const int attribs[] = {
+		OsMesaApi::FORMAT, GL_RGBA,
+		OsMesaApi::DEPTH_BITS, 24,
+		OsMesaApi::STENCIL_BITS, 8,
+		OsMesaApi::ACCUM_BITS, 0,
+		OsMesaApi::PROFILE, coreProfile ? OsMesaApi::CORE_PROFILE : OsMesaApi::COMPAT_PROFILE,
+		OsMesaApi::CONTEXT_MAJOR_VERSION, majorVersion,
+		OsMesaApi::CONTEXT_MINOR_VERSION, minorVersion,
+		0
+	};
+	OSMesaContext context = api->mCreateContextAttribs( attribs, sharedPlatformData ? sharedPlatformData->mOsMesaContext : nullptr );
+	if( ! context ) {
+		CI_LOG_W( "OSMesaCreateContextAttribs failed for OpenGL " << majorVersion << "." << minorVersion );
+		return nullptr;
+	}
+
+	auto result = new PlatformDataLinux( context );
+	if( ! api->mMakeCurrent( context, result->mOsMesaBuffer, GL_UNSIGNED_BYTE, 1, 1 ) ) {
+		CI_LOG_W( "OSMesaMakeCurrent failed" );
+		api->mDestroyContext( context );
+		delete result;
+		return nullptr;
+	}
+
+	return result;
+}
+} // anonymous namespace
+#endif // defined( CINDER_LINUX )
+
 namespace {
 void destroyPlatformData( Context::PlatformData *data )
 {
@@ -90,6 +240,15 @@ void destroyPlatformData( Context::PlatformData *data )
 	auto platformData = dynamic_cast<PlatformDataMsw*>( data );
 	::wglMakeCurrent( NULL, NULL );
 	::wglDeleteContext( platformData->mGlrc );
+#elif defined( CINDER_LINUX )
+	auto platformData = dynamic_cast<PlatformDataLinux*>( data );
+	if( platformData->mBackend == PlatformDataLinux::EGL ) {
+		if( ::eglGetCurrentContext() == platformData->mContext )
+			::eglMakeCurrent( platformData->mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+		::eglDestroyContext( platformData->mDisplay, platformData->mContext );
+	}
+	else
+		OsMesaApi::get()->mDestroyContext( platformData->mOsMesaContext );
 #endif
 
 	delete data;
@@ -142,6 +301,12 @@ ContextRef Environment::createSharedContext( const Context *sharedContext )
 	}
 	::wglMakeCurrent( sharedContextDc, rc );
 	shared_ptr<Context::PlatformData> platformData = shared_ptr<Context::PlatformData>( new PlatformDataMsw( sharedContextPlatformData, rc, sharedContextDc ), destroyPlatformData );
+#elif defined( CINDER_LINUX )
+	auto sharedContextPlatformData = dynamic_pointer_cast<PlatformDataLinux>( sharedContext->getPlatformData() );
+	// PlatformDataLinux::create() makes the new context current, so remember what to restore afterwards
+	const Context *prevContext = Context::getCurrent();
+	shared_ptr<Context::PlatformData> platformData = PlatformDataLinux::create( sharedContextPlatformData->mMajorVersion, sharedContextPlatformData->mMinorVersion,
+			sharedContextPlatformData->mCoreProfile, sharedContextPlatformData->mDebug, sharedContextPlatformData.get() );
 #endif
 
 	ContextRef result( new Context( platformData ) );
@@ -156,6 +321,8 @@ ContextRef Environment::createSharedContext( const Context *sharedContext )
 	assert( status );
 #elif defined( CINDER_MSW )
 	::wglMakeCurrent( prevDc, prevContext );
+#elif defined( CINDER_LINUX )
+	makeContextCurrent( prevContext );
 #endif
 
 	return result;
@@ -199,7 +366,53 @@ void Environment::makeContextCurrent( const Context *context )
 	else {
 		::wglMakeCurrent( NULL, NULL );
 	}
+#elif defined( CINDER_LINUX )
+	if( context ) {
+		auto platformData = dynamic_pointer_cast<PlatformDataLinux>( context->getPlatformData() );
+		if( platformData->mBackend == PlatformDataLinux::EGL ) {
+			EGLBoolean status = ::eglMakeCurrent( platformData->mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, platformData->mContext );
+			assert( status );
+		}
+		else
+			OsMesaApi::get()->mMakeCurrent( platformData->mOsMesaContext, platformData->mOsMesaBuffer, GL_UNSIGNED_BYTE, 1, 1 );
+	}
+	else if( ::eglGetCurrentContext() != EGL_NO_CONTEXT )
+		::eglMakeCurrent( ::eglGetCurrentDisplay(), EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
 #endif
 }
 
+#if defined( CINDER_LINUX )
+std::shared_ptr<PlatformDataLinux> PlatformDataLinux::create( int majorVersion, int minorVersion, bool coreProfile, bool debug, const PlatformDataLinux *sharedPlatformData )
+{
+	PlatformDataLinux *result = nullptr;
+	// a shared context has to come from the same backend as the context it shares with
+	if( ! sharedPlatformData || sharedPlatformData->mBackend == EGL )
+		result = createEglPlatformData( majorVersion, minorVersion, coreProfile, debug, sharedPlatformData );
+	if( ! result && ( ! sharedPlatformData || sharedPlatformData->mBackend == OSMESA ) ) {
+		if( ! sharedPlatformData )
+			CI_LOG_I( "Surfaceless EGL unavailable, falling back to OSMesa" );
+		result = createOsMesaPlatformData( majorVersion, minorVersion, coreProfile, sharedPlatformData );
+	}
+
+	if( ! result ) {
+		CI_LOG_E( "Failed to create a headless OpenGL " << majorVersion << "." << minorVersion << " context with either EGL or OSMesa" );
+		throw ExcContextAllocation();
+	}
+
+	result->mMajorVersion = majorVersion;
+	result->mMinorVersion = minorVersion;
+	result->mCoreProfile = coreProfile;
+	if( sharedPlatformData ) {
+		result->mDebug = sharedPlatformData->mDebug;
+		result->mObjectTracking = sharedPlatformData->mObjectTracking;
+		result->mDebugLogSeverity = sharedPlatformData->mDebugLogSeverity;
+		result->mDebugBreakSeverity = sharedPlatformData->mDebugBreakSeverity;
+	}
+	else
+		result->mDebug = debug;
+
+	return std::shared_ptr<PlatformDataLinux>( result, destroyPlatformData );
+}
+#endif
+
 } } // namespace cinder::gl
\ No newline at end of file
@@ -0,0 +1,177 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/gl/InstanceBuffer.h"
+
+#if ! defined( CINDER_GL_ES_2 )
+
+#include "cinder/gl/scoped.h"
+#include "cinder/TaskScheduler.h"
+
+using namespace std;
+
+namespace cinder { namespace gl {
+
+InstanceBufferRef InstanceBuffer::create( uint32_t maxInstances, const Format &format )
+{
+	return InstanceBufferRef( new InstanceBuffer( maxInstances, format ) );
+}
+
+InstanceBuffer::InstanceBuffer( uint32_t maxInstances, const Format &format )
+	: mMaxInstances( maxInstances ), mNumBuffers( std::max( format.getNumBuffers(), 1 ) ), mAttribs( format.getAttribs() ),
+	mCurrentBuffer( 0 ), mMappedBuffer( -1 ), mMappedPtr( nullptr ), mNumInstances( 0 )
+{
+	// interleave the attributes, keeping each 4-byte aligned
+	mStride = 0;
+	for( auto &attrib : mAttribs ) {
+		attrib.setOffset( mStride );
+		mStride += ( attrib.getByteSize() + 3 ) & ~3;
+	}
+	for( auto &attrib : mAttribs )
+		attrib.setStride( mStride );
+
+	mVbo = Vbo::create( GL_ARRAY_BUFFER, mStride * mMaxInstances * mNumBuffers, nullptr, GL_STREAM_DRAW );
+	if( ! format.getLabel().empty() )
+		mVbo->setLabel( format.getLabel() );
+	mFences.resize( mNumBuffers );
+}
+
+InstanceBuffer::~InstanceBuffer()
+{
+	if( mMappedPtr ) {
+		ScopedBuffer bufferScp( mVbo );
+		mVbo->unmap();
+	}
+}
+
+const geom::AttribInfo& InstanceBuffer::findAttrib( geom::Attrib attrib ) const
+{
+	for( const auto &info : mAttribs ) {
+		if( info.getAttrib() == attrib )
+			return info;
+	}
+
+	throw geom::ExcMissingAttrib();
+}
+
+geom::BufferLayout InstanceBuffer::getBufferLayout( int bufferIndex ) const
+{
+	const size_t bufferOffset = bufferIndex * mStride * mMaxInstances;
+	geom::BufferLayout layout;
+	for( const auto &attrib : mAttribs )
+		layout.append( attrib.getAttrib(), attrib.getDataType(), attrib.getDims(), mStride, bufferOffset + attrib.getOffset(), 1 );
+	return layout;
+}
+
+void InstanceBuffer::map( uint32_t numInstances )
+{
+	CI_ASSERT_MSG( ! mMappedPtr, "InstanceBuffer is already mapped" );
+	numInstances = std::min( numInstances, mMaxInstances );
+
+	int buffer = ( mCurrentBuffer + 1 ) % mNumBuffers;
+	// the fence was placed after the buffer's last draw; with enough buffers it has long since signaled
+	if( mFences[buffer] ) {
+		while( mFences[buffer]->clientWaitSync( GL_SYNC_FLUSH_COMMANDS_BIT, 1000000 ) == GL_TIMEOUT_EXPIRED )
+			;
+		mFences[buffer].reset();
+	}
+
+	ScopedBuffer bufferScp( mVbo );
+	const GLsizeiptr length = std::max<GLsizeiptr>( numInstances * mStride, 1 );
+	mMappedPtr = reinterpret_cast<uint8_t*>( mVbo->mapBufferRange( buffer * mStride * mMaxInstances, length, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT ) );
+	mMappedBuffer = buffer;
+	mNumMappedInstances = numInstances;
+}
+
+void InstanceBuffer::unmap()
+{
+	CI_ASSERT_MSG( mMappedPtr, "InstanceBuffer is not mapped" );
+
+	ScopedBuffer bufferScp( mVbo );
+	mVbo->unmap();
+	mMappedPtr = nullptr;
+	mCurrentBuffer = mMappedBuffer;
+	mNumInstances = mNumMappedInstances;
+}
+
+void InstanceBuffer::fill( uint32_t numInstances, const function<void( uint32_t begin, uint32_t end )> &fn, size_t numThreads )
+{
+	map( numInstances );
+	numInstances = mNumMappedInstances;
+
+	// the calling thread fills ranges alongside the shared scheduler's workers
+	TaskSchedulerRef scheduler = TaskScheduler::get();
+	if( numThreads == 0 )
+		numThreads = scheduler->getNumWorkers() + 1;
+	const size_t rangeSize = std::max<size_t>( ( numInstances + numThreads - 1 ) / numThreads, 1 );
+	try {
+		scheduler->parallelFor( 0, numInstances, rangeSize, [&]( size_t begin, size_t end ) {
+			fn( (uint32_t)begin, (uint32_t)end );
+		} );
+	}
+	catch( ... ) {
+		// parallelFor() only throws once every range has returned. The partly filled buffer is unmapped without replacing the current one.
+		ScopedBuffer bufferScp( mVbo );
+		mVbo->unmap();
+		mMappedPtr = nullptr;
+		throw;
+	}
+
+	unmap();
+}
+
+void InstanceBuffer::drawInstanced( const BatchRef &batch )
+{
+	CI_ASSERT_MSG( ! mMappedPtr, "InstanceBuffer must be unmapped before drawing" );
+	if( mNumInstances == 0 )
+		return;
+
+	// drop entries whose source Batch has been destroyed, since its address may be reused
+	for( auto it = mInstancedBatches.begin(); it != mInstancedBatches.end(); ) {
+		if( it->second.mSource.expired() )
+			it = mInstancedBatches.erase( it );
+		else
+			++it;
+	}
+
+	auto &instanced = mInstancedBatches[batch.get()];
+	if( instanced.mVboMesh != batch->getVboMesh() || instanced.mGlsl != batch->getGlslProg() ) {
+		instanced.mSource = batch;
+		instanced.mVboMesh = batch->getVboMesh();
+		instanced.mGlsl = batch->getGlslProg();
+		instanced.mBatches.clear();
+		const auto &mesh = instanced.mVboMesh;
+		for( int i = 0; i < mNumBuffers; ++i ) {
+			auto instanceMesh = VboMesh::create( mesh->getNumVertices(), mesh->getGlPrimitive(), mesh->getVertexArrayLayoutVbos(), mesh->getNumIndices(), mesh->getIndexDataType(), mesh->getIndexVbo() );
+			instanceMesh->appendVbo( getBufferLayout( i ), mVbo );
+			instanced.mBatches.push_back( Batch::create( instanceMesh, batch->getGlslProg(), batch->getAttributeMapping() ) );
+		}
+	}
+
+	instanced.mBatches[mCurrentBuffer]->drawInstanced( mNumInstances );
+	mFences[mCurrentBuffer] = Sync::create();
+}
+
+} } // namespace cinder::gl
+
+#endif // ! defined( CINDER_GL_ES_2 )
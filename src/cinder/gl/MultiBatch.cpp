@@ -0,0 +1,372 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cinder/gl/MultiBatch.h"
+
+#if ! defined( CINDER_GL_ES )
+
+#include "cinder/gl/Context.h"
+#include "cinder/gl/GlslProg.h"
+#include "cinder/gl/scoped.h"
+#include "cinder/Log.h"
+
+using namespace std;
+
+namespace cinder { namespace gl {
+
+namespace {
+// matches the layout glMultiDrawElementsIndirect() expects
+struct DrawElementsIndirectCommand {
+	GLuint	mCount;
+	GLuint	mInstanceCount;
+	GLuint	mFirstIndex;
+	GLint	mBaseVertex;
+	GLuint	mBaseInstance;
+};
+
+// Interleaved buffers can be concatenated whole; planar buffers have to be concatenated per-attribute since their offsets scale with the vertex count
+bool isInterleaved( const geom::BufferLayout &layout )
+{
+	const auto &attribs = layout.getAttribs();
+	if( attribs.size() <= 1 )
+		return true;
+
+	size_t totalBytes = 0;
+	for( const auto &attrib : attribs ) {
+		if( attrib.getStride() != attribs[0].getStride() )
+			return false;
+		totalBytes += attrib.getByteSize();
+	}
+
+	return attribs[0].getStride() >= totalBytes;
+}
+
+// A stride of 0 means the attribute is tightly packed
+size_t getInterleavedStride( const geom::BufferLayout &layout )
+{
+	if( layout.getAttribs().empty() )
+		return 0;
+
+	const auto &attrib = layout.getAttribs().front();
+	return attrib.getStride() ? attrib.getStride() : attrib.getByteSize();
+}
+
+bool isLayoutCompatible( const geom::BufferLayout &a, const geom::BufferLayout &b )
+{
+	if( a.getAttribs().size() != b.getAttribs().size() || isInterleaved( a ) != isInterleaved( b ) )
+		return false;
+
+	for( size_t i = 0; i < a.getAttribs().size(); ++i ) {
+		const auto &attribA = a.getAttribs()[i];
+		const auto &attribB = b.getAttribs()[i];
+		if( attribA.getAttrib() != attribB.getAttrib() || attribA.getDims() != attribB.getDims() || attribA.getDataType() != attribB.getDataType() )
+			return false;
+		if( isInterleaved( a ) && ( getInterleavedStride( a ) != getInterleavedStride( b ) || attribA.getOffset() != attribB.getOffset() ) )
+			return false;
+	}
+
+	return true;
+}
+
+void copyBufferSubData( const BufferObjRef &src, GLintptr srcOffset, const BufferObjRef &dst, GLintptr dstOffset, GLsizeiptr size )
+{
+	if( size <= 0 )
+		return;
+
+	ScopedBuffer readScp( GL_COPY_READ_BUFFER, src->getId() );
+	ScopedBuffer writeScp( GL_COPY_WRITE_BUFFER, dst->getId() );
+	glCopyBufferSubData( GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, srcOffset, dstOffset, size );
+}
+} // anonymous namespace
+
+MultiBatchRef MultiBatch::create( const vector<VboMeshRef> &meshes, const GlslProgRef &glsl, const Format &format, const AttributeMapping &attributeMapping )
+{
+	return MultiBatchRef( new MultiBatch( meshes, glsl, format, attributeMapping ) );
+}
+
+MultiBatch::MultiBatch( const vector<VboMeshRef> &meshes, const GlslProgRef &glsl, const Format &format, const AttributeMapping &attributeMapping )
+	: mFormat( format ), mGlsl( glsl ), mDirtyDrawDataBegin( 0 ), mDirtyDrawDataEnd( 0 ), mCommandsDirty( true ), mNumVisibleCommands( 0 )
+{
+	auto version = gl::getVersion();
+	bool hasMultiDrawIndirect = ( version.first > 4 || ( version.first == 4 && version.second >= 3 ) )
+			|| ( gl::isExtensionAvailable( "GL_ARB_multi_draw_indirect" ) && gl::isExtensionAvailable( "GL_ARB_base_instance" ) );
+	mMultiDrawIndirect = hasMultiDrawIndirect && ! format.getForceFallback();
+
+	packMeshes( meshes );
+	mDirtyDrawDataBegin = mDraws.size();
+
+	mDrawData.resize( mDraws.size(), DrawData{ mat4(), vec4( 0 ) } );
+	mDrawDataTexture = BufferTexture::create( mDrawData.data(), mDrawData.size() * sizeof(DrawData), GL_RGBA32F, GL_DYNAMIC_DRAW );
+
+	// each instanced draw reads its own index through baseInstance
+	vector<GLint> drawIds( mDraws.size() );
+	for( size_t i = 0; i < drawIds.size(); ++i )
+		drawIds[i] = (GLint)i;
+	mDrawIdVbo = Vbo::create( GL_ARRAY_BUFFER, drawIds, GL_STATIC_DRAW );
+	if( mMultiDrawIndirect )
+		mIndirectBuffer = Vbo::create( GL_DRAW_INDIRECT_BUFFER, mDraws.size() * sizeof(DrawElementsIndirectCommand), nullptr, GL_DYNAMIC_DRAW );
+
+	initVao( attributeMapping );
+}
+
+void MultiBatch::packMeshes( const vector<VboMeshRef> &meshes )
+{
+	if( meshes.empty() )
+		throw MultiBatchExc( "MultiBatch requires at least one VboMesh" );
+
+	const VboMeshRef &first = meshes.front();
+	const auto &firstLayouts = first->getVertexArrayLayoutVbos();
+
+	// validate and total everything up
+	uint32_t totalVertices = 0, totalIndices = 0;
+	bool needsIntIndices = false;
+	for( const auto &mesh : meshes ) {
+		if( mesh->getGlPrimitive() != first->getGlPrimitive() )
+			throw MultiBatchExc( "MultiBatch requires every VboMesh to have the same primitive" );
+		const auto &layouts = mesh->getVertexArrayLayoutVbos();
+		if( layouts.size() != firstLayouts.size() )
+			throw MultiBatchExc( "MultiBatch requires every VboMesh to have the same number of vertex buffers" );
+		for( size_t b = 0; b < layouts.size(); ++b ) {
+			if( ! isLayoutCompatible( layouts[b].first, firstLayouts[b].first ) )
+				throw MultiBatchExc( "MultiBatch requires every VboMesh to have the same vertex buffer layouts" );
+			for( const auto &attrib : layouts[b].first.getAttribs() ) {
+				if( attrib.getInstanceDivisor() != 0 )
+					throw MultiBatchExc( "MultiBatch does not support instanced attributes" );
+			}
+		}
+
+		if( mesh->getNumIndices() > 0 )
+			needsIntIndices = needsIntIndices || ( mesh->getIndexDataType() == GL_UNSIGNED_INT );
+		else
+			needsIntIndices = needsIntIndices || ( mesh->getNumVertices() > 65536 );
+
+		totalVertices += mesh->getNumVertices();
+		totalIndices += ( mesh->getNumIndices() > 0 ) ? mesh->getNumIndices() : mesh->getNumVertices();
+	}
+
+	// allocate the shared vertex buffers, with layouts rebased for the combined vertex count
+	vector<pair<geom::BufferLayout,VboRef>> packedLayouts;
+	for( const auto &layoutVbo : firstLayouts ) {
+		const geom::BufferLayout &layout = layoutVbo.first;
+		size_t totalBytes;
+		if( isInterleaved( layout ) ) {
+			totalBytes = totalVertices * getInterleavedStride( layout );
+			packedLayouts.push_back( make_pair( layout, Vbo::create( GL_ARRAY_BUFFER, totalBytes, nullptr, GL_STATIC_DRAW ) ) );
+		}
+		else {
+			geom::BufferLayout packedLayout;
+			size_t offset = 0;
+			for( const auto &attrib : layout.getAttribs() ) {
+				packedLayout.append( attrib.getAttrib(), attrib.getDataType(), attrib.getDims(), attrib.getByteSize(), offset );
+				offset += attrib.getByteSize() * totalVertices;
+			}
+			totalBytes = offset;
+			packedLayouts.push_back( make_pair( packedLayout, Vbo::create( GL_ARRAY_BUFFER, totalBytes, nullptr, GL_STATIC_DRAW ) ) );
+		}
+	}
+
+	const GLenum indexType = needsIntIndices ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+	const size_t indexBytes = needsIntIndices ? sizeof(uint32_t) : sizeof(uint16_t);
+	VboRef indexVbo = Vbo::create( GL_ELEMENT_ARRAY_BUFFER, totalIndices * indexBytes, nullptr, GL_STATIC_DRAW );
+
+	// copy every mesh into place; vertex data and matching index data never leave the GPU
+	mDraws.reserve( meshes.size() );
+	uint32_t baseVertex = 0, firstIndex = 0;
+	for( const auto &mesh : meshes ) {
+		const auto &layouts = mesh->getVertexArrayLayoutVbos();
+		for( size_t b = 0; b < layouts.size(); ++b ) {
+			const geom::BufferLayout &srcLayout = layouts[b].first;
+			if( isInterleaved( srcLayout ) ) {
+				size_t stride = getInterleavedStride( srcLayout );
+				copyBufferSubData( layouts[b].second, 0, packedLayouts[b].second, baseVertex * stride, mesh->getNumVertices() * stride );
+			}
+			else {
+				for( size_t a = 0; a < srcLayout.getAttribs().size(); ++a ) {
+					const auto &srcAttrib = srcLayout.getAttribs()[a];
+					const auto &dstAttrib = packedLayouts[b].first.getAttribs()[a];
+					copyBufferSubData( layouts[b].second, srcAttrib.getOffset(), packedLayouts[b].second,
+							dstAttrib.getOffset() + baseVertex * dstAttrib.getByteSize(), mesh->getNumVertices() * srcAttrib.getByteSize() );
+				}
+			}
+		}
+
+		uint32_t numIndices = mesh->getNumIndices();
+		if( numIndices > 0 && mesh->getIndexDataType() == indexType ) {
+			copyBufferSubData( mesh->getIndexVbo(), 0, indexVbo, firstIndex * indexBytes, numIndices * indexBytes );
+		}
+		else if( numIndices > 0 ) { // 16-bit indices into a 32-bit index buffer; widen on the CPU
+			vector<uint16_t> shortIndices( numIndices );
+			mesh->getIndexVbo()->getBufferSubData( 0, numIndices * sizeof(uint16_t), shortIndices.data() );
+			vector<uint32_t> intIndices( shortIndices.begin(), shortIndices.end() );
+			indexVbo->bufferSubData( firstIndex * indexBytes, numIndices * indexBytes, intIndices.data() );
+		}
+		else { // non-indexed geometry gets sequential indices
+			numIndices = mesh->getNumVertices();
+			if( needsIntIndices ) {
+				vector<uint32_t> indices( numIndices );
+				for( uint32_t i = 0; i < numIndices; ++i )
+					indices[i] = i;
+				indexVbo->bufferSubData( firstIndex * indexBytes, numIndices * indexBytes, indices.data() );
+			}
+			else {
+				vector<uint16_t> indices( numIndices );
+				for( uint32_t i = 0; i < numIndices; ++i )
+					indices[i] = (uint16_t)i;
+				indexVbo->bufferSubData( firstIndex * indexBytes, numIndices * indexBytes, indices.data() );
+			}
+		}
+
+		mDraws.push_back( Draw{ numIndices, firstIndex, (GLint)baseVertex, true } );
+		baseVertex += mesh->getNumVertices();
+		firstIndex += numIndices;
+	}
+
+	mVboMesh = VboMesh::create( totalVertices, first->getGlPrimitive(), packedLayouts, totalIndices, indexType, indexVbo );
+}
+
+void MultiBatch::initVao( const AttributeMapping &attributeMapping )
+{
+	auto ctx = gl::context();
+	ctx->pushBufferBinding( GL_ARRAY_BUFFER );
+
+	mVao = Vao::create();
+	ctx->pushVao( mVao );
+
+	// ciDrawId is supplied below rather than by the VboMesh; mapping it keeps buildVao() from warning that it's missing
+	auto mapping = attributeMapping;
+	mapping.insert( make_pair( geom::USER_DEFINED, string( "ciDrawId" ) ) );
+	mVboMesh->buildVao( mGlsl, mapping );
+
+	mDrawIdLocation = mGlsl->getAttribLocation( "ciDrawId" );
+	mDrawDataLocation = mGlsl->getUniformLocation( "ciDrawData" );
+	// the fallback path leaves the array disabled and sets the generic attribute value before each draw instead
+	if( mDrawIdLocation >= 0 && mMultiDrawIndirect ) {
+		mDrawIdVbo->bind();
+		ctx->enableVertexAttribArray( mDrawIdLocation );
+		ctx->vertexAttribIPointer( mDrawIdLocation, 1, GL_INT, 0, nullptr );
+		ctx->vertexAttribDivisor( mDrawIdLocation, 1 );
+	}
+
+	ctx->popVao();
+	ctx->popBufferBinding( GL_ARRAY_BUFFER );
+}
+
+void MultiBatch::setTransform( size_t drawIndex, const mat4 &transform )
+{
+	mDrawData[drawIndex].mTransform = transform;
+	mDirtyDrawDataBegin = std::min( mDirtyDrawDataBegin, drawIndex );
+	mDirtyDrawDataEnd = std::max( mDirtyDrawDataEnd, drawIndex + 1 );
+}
+
+void MultiBatch::setMaterialId( size_t drawIndex, uint32_t materialId )
+{
+	mDrawData[drawIndex].mData.x = (float)materialId;
+	mDirtyDrawDataBegin = std::min( mDirtyDrawDataBegin, drawIndex );
+	mDirtyDrawDataEnd = std::max( mDirtyDrawDataEnd, drawIndex + 1 );
+}
+
+void MultiBatch::setVisible( size_t drawIndex, bool visible )
+{
+	if( mDraws[drawIndex].mVisible != visible ) {
+		mDraws[drawIndex].mVisible = visible;
+		mCommandsDirty = true;
+	}
+}
+
+void MultiBatch::updateBuffers()
+{
+	// only the range of draws touched since the last draw() is uploaded
+	if( mDirtyDrawDataEnd > mDirtyDrawDataBegin ) {
+		mDrawDataTexture->getBufferObj()->bufferSubData( mDirtyDrawDataBegin * sizeof(DrawData), ( mDirtyDrawDataEnd - mDirtyDrawDataBegin ) * sizeof(DrawData), &mDrawData[mDirtyDrawDataBegin] );
+		mDirtyDrawDataBegin = mDraws.size();
+		mDirtyDrawDataEnd = 0;
+	}
+
+	if( mCommandsDirty && mMultiDrawIndirect ) {
+		vector<DrawElementsIndirectCommand> commands;
+		commands.reserve( mDraws.size() );
+		for( size_t i = 0; i < mDraws.size(); ++i ) {
+			const Draw &draw = mDraws[i];
+			if( draw.mVisible )
+				commands.push_back( DrawElementsIndirectCommand{ draw.mCount, 1, draw.mFirstIndex, draw.mBaseVertex, (GLuint)i } );
+		}
+		if( ! commands.empty() )
+			mIndirectBuffer->bufferSubData( 0, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data() );
+		mNumVisibleCommands = (GLsizei)commands.size();
+	}
+	mCommandsDirty = false;
+}
+
+void MultiBatch::draw()
+{
+	auto ctx = gl::context();
+	updateBuffers();
+
+	ScopedGlslProg glslScp( mGlsl );
+	ScopedVao vaoScp( mVao );
+	ctx->setDefaultShaderVars();
+
+	ScopedTextureBind drawDataScp( mDrawDataTexture->getTarget(), mDrawDataTexture->getId(), mFormat.getDrawDataTextureUnit() );
+	if( mDrawDataLocation >= 0 )
+		mGlsl->uniform( mDrawDataLocation, (int)mFormat.getDrawDataTextureUnit() );
+
+	const GLenum primitive = mVboMesh->getGlPrimitive();
+	const GLenum indexType = mVboMesh->getIndexDataType();
+	if( mMultiDrawIndirect ) {
+		if( mNumVisibleCommands > 0 ) {
+			ScopedBuffer indirectScp( mIndirectBuffer );
+			glMultiDrawElementsIndirect( primitive, indexType, nullptr, mNumVisibleCommands, 0 );
+		}
+	}
+	else {
+		const size_t indexBytes = ( indexType == GL_UNSIGNED_INT ) ? sizeof(uint32_t) : sizeof(uint16_t);
+		for( size_t i = 0; i < mDraws.size(); ++i ) {
+			const Draw &draw = mDraws[i];
+			if( ! draw.mVisible )
+				continue;
+			if( mDrawIdLocation >= 0 )
+				glVertexAttribI1i( mDrawIdLocation, (GLint)i );
+			glDrawElementsBaseVertex( primitive, draw.mCount, indexType, (const GLvoid*)( draw.mFirstIndex * indexBytes ), draw.mBaseVertex );
+		}
+	}
+}
+
+string MultiBatch::getGlslDeclarations()
+{
+	return	"uniform samplerBuffer ciDrawData;\n"
+			"in int ciDrawId;\n"
+			"mat4 ciDrawTransform()\n"
+			"{\n"
+			"	int base = ciDrawId * 5;\n"
+			"	return mat4( texelFetch( ciDrawData, base ), texelFetch( ciDrawData, base + 1 ), texelFetch( ciDrawData, base + 2 ), texelFetch( ciDrawData, base + 3 ) );\n"
+			"}\n"
+			"uint ciDrawMaterialId()\n"
+			"{\n"
+			"	return uint( texelFetch( ciDrawData, ciDrawId * 5 + 4 ).x );\n"
+			"}\n";
+}
+
+} } // namespace cinder::gl
+
+#endif // ! defined( CINDER_GL_ES )
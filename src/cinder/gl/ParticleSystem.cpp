@@ -0,0 +1,429 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/gl/ParticleSystem.h"
+
+#if ! defined( CINDER_GL_ES_2 )
+
+#include "cinder/gl/Context.h"
+#include "cinder/gl/draw.h"
+#include "cinder/gl/scoped.h"
+#include "cinder/gl/wrapper.h"
+#include "cinder/CinderAssert.h"
+
+using namespace std;
+
+namespace cinder { namespace gl {
+
+namespace {
+
+#if defined( CINDER_GL_ES )
+const char *sVersionHeader = "#version 300 es\nprecision highp float;\nprecision highp int;\n";
+#else
+const char *sVersionHeader = "#version 150\n";
+#endif
+
+// hashing after Chris Wellons' lowbias32; simplex noise after Ian McEwan and Stefan Gustavson's webgl-noise (MIT)
+const char *sUpdateHelpers = R"(
+uint ciHash( uint x )
+{
+	x ^= x >> 16u; x *= 0x7feb352du;
+	x ^= x >> 15u; x *= 0x846ca68bu;
+	x ^= x >> 16u;
+	return x;
+}
+
+// returns a value in [0,1) and advances seed
+float ciRandom( inout uint seed )
+{
+	seed = ciHash( seed );
+	return float( seed >> 8u ) * ( 1.0 / 16777216.0 );
+}
+
+vec3 ciRandomInSphere( inout uint seed )
+{
+	float z = ciRandom( seed ) * 2.0 - 1.0;
+	float a = ciRandom( seed ) * 6.2831853;
+	float r = sqrt( 1.0 - z * z );
+	return vec3( r * cos( a ), r * sin( a ), z ) * pow( ciRandom( seed ), 1.0 / 3.0 );
+}
+
+vec3 ciMod289( vec3 x ) { return x - floor( x * ( 1.0 / 289.0 ) ) * 289.0; }
+vec4 ciMod289( vec4 x ) { return x - floor( x * ( 1.0 / 289.0 ) ) * 289.0; }
+vec4 ciPermute( vec4 x ) { return ciMod289( ( x * 34.0 + 1.0 ) * x ); }
+
+float ciSimplexNoise( vec3 v )
+{
+	const vec2 C = vec2( 1.0 / 6.0, 1.0 / 3.0 );
+	const vec4 D = vec4( 0.0, 0.5, 1.0, 2.0 );
+
+	vec3 i = floor( v + dot( v, C.yyy ) );
+	vec3 x0 = v - i + dot( i, C.xxx );
+	vec3 g = step( x0.yzx, x0.xyz );
+	vec3 l = 1.0 - g;
+	vec3 i1 = min( g.xyz, l.zxy );
+	vec3 i2 = max( g.xyz, l.zxy );
+	vec3 x1 = x0 - i1 + C.xxx;
+	vec3 x2 = x0 - i2 + C.yyy;
+	vec3 x3 = x0 - D.yyy;
+
+	i = ciMod289( i );
+	vec4 p = ciPermute( ciPermute( ciPermute( i.z + vec4( 0.0, i1.z, i2.z, 1.0 ) ) + i.y + vec4( 0.0, i1.y, i2.y, 1.0 ) ) + i.x + vec4( 0.0, i1.x, i2.x, 1.0 ) );
+
+	vec3 ns = 0.142857142857 * D.wyz - D.xzx;
+	vec4 j = p - 49.0 * floor( p * ns.z * ns.z );
+	vec4 x_ = floor( j * ns.z );
+	vec4 y_ = floor( j - 7.0 * x_ );
+	vec4 x = x_ * ns.x + ns.yyyy;
+	vec4 y = y_ * ns.x + ns.yyyy;
+	vec4 h = 1.0 - abs( x ) - abs( y );
+	vec4 b0 = vec4( x.xy, y.xy );
+	vec4 b1 = vec4( x.zw, y.zw );
+	vec4 s0 = floor( b0 ) * 2.0 + 1.0;
+	vec4 s1 = floor( b1 ) * 2.0 + 1.0;
+	vec4 sh = -step( h, vec4( 0.0 ) );
+	vec4 a0 = b0.xzyw + s0.xzyw * sh.xxyy;
+	vec4 a1 = b1.xzyw + s1.xzyw * sh.zzww;
+	vec3 p0 = vec3( a0.xy, h.x );
+	vec3 p1 = vec3( a0.zw, h.y );
+	vec3 p2 = vec3( a1.xy, h.z );
+	vec3 p3 = vec3( a1.zw, h.w );
+
+	vec4 norm = 1.79284291400159 - 0.85373472095314 * vec4( dot( p0, p0 ), dot( p1, p1 ), dot( p2, p2 ), dot( p3, p3 ) );
+	p0 *= norm.x; p1 *= norm.y; p2 *= norm.z; p3 *= norm.w;
+
+	vec4 m = max( 0.6 - vec4( dot( x0, x0 ), dot( x1, x1 ), dot( x2, x2 ), dot( x3, x3 ) ), 0.0 );
+	m = m * m;
+	return 42.0 * dot( m * m, vec4( dot( p0, x0 ), dot( p1, x1 ), dot( p2, x2 ), dot( p3, x3 ) ) );
+}
+
+vec3 ciSimplexNoiseVec3( vec3 v )
+{
+	return vec3( ciSimplexNoise( v ), ciSimplexNoise( v + vec3( 31.416, -47.853, 12.793 ) ), ciSimplexNoise( v + vec3( -233.145, -113.408, -185.31 ) ) );
+}
+)";
+
+const char *sUpdateMain = R"(
+void main()
+{
+	Particle p;
+	p.position = ciParticlePosition.xyz;
+	p.age = ciParticlePosition.w;
+	p.velocity = ciParticleVelocity.xyz;
+	p.lifetime = ciParticleVelocity.w;
+	p.color = ciParticleColor;
+#if defined( CI_PARTICLE_DATA )
+	p.data = ciParticleData;
+#else
+	p.data = vec4( 0.0 );
+#endif
+
+	uint seed = ciHash( uint( gl_VertexID ) ^ ciHash( ciParticleSeed ) );
+	bool alive = p.age < p.lifetime;
+	// the emission window starts at the cursor and wraps around the end of the buffer
+	int slot = ( gl_VertexID - ciParticleEmitStart + ciParticleMaxParticles ) % ciParticleMaxParticles;
+
+	if( ciParticleReset ) {
+		p = Particle( vec3( 0.0 ), 0.0, vec3( 0.0 ), 0.0, vec4( 0.0 ), vec4( 0.0 ) );
+	}
+	else if( slot < ciParticleEmitCount && ( ciParticleOverwriteLive || ! alive ) ) {
+		float dt = ciParticleDeltaTime;
+		p.position = ciParticleEmitPosition + ciRandomInSphere( seed ) * ciParticleEmitRadius;
+		p.age = 0.0;
+		p.velocity = ciParticleEmitVelocity + ciRandomInSphere( seed ) * ciParticleEmitVelocitySpread;
+		p.lifetime = mix( ciParticleEmitLifetime.x, ciParticleEmitLifetime.y, ciRandom( seed ) );
+		p.color = ciParticleEmitColor;
+		p.data = vec4( 0.0 );
+		ciEmitParticle( p, dt, seed );
+	}
+	else if( alive ) {
+		float dt = ciParticleDeltaTime;
+		vec3 force = ciParticleGravity;
+		if( ciParticleNoise.x != 0.0 )
+			force += ciParticleNoise.x * ciSimplexNoiseVec3( p.position * ciParticleNoise.y + vec3( 0.0, 0.0, ciParticleTime * ciParticleNoise.z ) );
+		for( int i = 0; i < CI_PARTICLE_MAX_ATTRACTORS; ++i ) {
+			vec3 d = ciParticleAttractors[i].xyz - p.position;
+			float distSq = dot( d, d ) + 0.01;
+			force += ciParticleAttractors[i].w * d * inversesqrt( distSq * distSq * distSq );
+		}
+		p.velocity = ( p.velocity + force * dt ) * exp( -ciParticleDrag * dt );
+
+		ciUpdateParticle( p, dt, seed );
+
+		p.position += p.velocity * dt;
+		p.age += dt;
+	}
+
+	ciParticleOutPosition = vec4( p.position, p.age );
+	ciParticleOutVelocity = vec4( p.velocity, p.lifetime );
+	ciParticleOutColor = p.color;
+#if defined( CI_PARTICLE_DATA )
+	ciParticleOutData = p.data;
+#endif
+}
+)";
+
+string buildUpdateVertexShader( const ParticleSystem::Format &format )
+{
+	string s = sVersionHeader;
+	if( format.isCustomDataEnabled() )
+		s += "#define CI_PARTICLE_DATA\n";
+	s += "#define CI_PARTICLE_MAX_ATTRACTORS " + to_string( ParticleSystem::MAX_ATTRACTORS ) + "\n";
+	s +=	"in vec4 ciParticlePosition;\n"
+			"in vec4 ciParticleVelocity;\n"
+			"in vec4 ciParticleColor;\n"
+			"out vec4 ciParticleOutPosition;\n"
+			"out vec4 ciParticleOutVelocity;\n"
+			"out vec4 ciParticleOutColor;\n";
+	if( format.isCustomDataEnabled() )
+		s += "in vec4 ciParticleData;\nout vec4 ciParticleOutData;\n";
+
+	s +=	"uniform float ciParticleDeltaTime;\n"
+			"uniform float ciParticleTime;\n"
+			"uniform uint ciParticleSeed;\n"
+			"uniform bool ciParticleReset;\n"
+			"uniform int ciParticleMaxParticles;\n"
+			"uniform int ciParticleEmitStart;\n"
+			"uniform int ciParticleEmitCount;\n"
+			"uniform bool ciParticleOverwriteLive;\n"
+			"uniform vec3 ciParticleEmitPosition;\n"
+			"uniform float ciParticleEmitRadius;\n"
+			"uniform vec3 ciParticleEmitVelocity;\n"
+			"uniform float ciParticleEmitVelocitySpread;\n"
+			"uniform vec2 ciParticleEmitLifetime;\n"
+			"uniform vec4 ciParticleEmitColor;\n"
+			"uniform vec3 ciParticleGravity;\n"
+			"uniform float ciParticleDrag;\n"
+			"uniform vec3 ciParticleNoise;\n"
+			"uniform vec4 ciParticleAttractors[CI_PARTICLE_MAX_ATTRACTORS];\n"
+			"struct Particle { vec3 position; float age; vec3 velocity; float lifetime; vec4 color; vec4 data; };\n";
+
+	s += sUpdateHelpers;
+	s += format.getDeclarations() + "\n";
+	s += "void ciEmitParticle( inout Particle p, float dt, inout uint seed )\n{\n" + format.getEmitSnippet() + "\n}\n";
+	s += "void ciUpdateParticle( inout Particle p, float dt, inout uint seed )\n{\n" + format.getUpdateSnippet() + "\n}\n";
+	s += sUpdateMain;
+	return s;
+}
+
+const char *sPointVertexShader = R"(
+uniform mat4 ciModelViewProjection;
+in vec4 ciParticlePosition;
+in vec4 ciParticleVelocity;
+in vec4 ciParticleColor;
+out vec4 vColor;
+
+void main()
+{
+	vColor = ciParticleColor;
+	// dead particles are placed beyond the far plane
+	if( ciParticlePosition.w < ciParticleVelocity.w )
+		gl_Position = ciModelViewProjection * vec4( ciParticlePosition.xyz, 1.0 );
+	else
+		gl_Position = vec4( 0.0, 0.0, 2.0, 1.0 );
+	gl_PointSize = 1.0;
+}
+)";
+
+const char *sPointFragmentShader = R"(
+in vec4 vColor;
+out vec4 oColor;
+
+void main()
+{
+	oColor = vColor;
+}
+)";
+
+} // anonymous namespace
+
+ParticleSystemRef ParticleSystem::create( const Format &format )
+{
+	return ParticleSystemRef( new ParticleSystem( format ) );
+}
+
+ParticleSystem::ParticleSystem( const Format &format )
+	: mMaxParticles( std::max<uint32_t>( format.getMaxParticles(), 1 ) ), mCustomData( format.isCustomDataEnabled() ), mOverwriteLive( format.isOverwriteLiveEnabled() ),
+	mSourceIndex( 0 ), mEmitCursor( 0 ), mNumPendingEmission( 0 ), mEmissionRate( 0 ), mEmissionRemainder( 0 ),
+	mGravity( 0 ), mDrag( 0 ), mNoise( 0 ), mTime( 0 ), mFrame( 0 )
+{
+	for( auto &attractor : mAttractors )
+		attractor = vec4( 0 );
+
+	mStride = ( mCustomData ? 4 : 3 ) * sizeof( vec4 );
+
+	vector<string> varyings = { "ciParticleOutPosition", "ciParticleOutVelocity", "ciParticleOutColor" };
+	if( mCustomData )
+		varyings.push_back( "ciParticleOutData" );
+
+	auto glslFormat = GlslProg::Format().vertex( buildUpdateVertexShader( format ) )
+		.feedbackFormat( GL_INTERLEAVED_ATTRIBS ).feedbackVaryings( varyings )
+		.attribLocation( "ciParticlePosition", 0 ).attribLocation( "ciParticleVelocity", 1 ).attribLocation( "ciParticleColor", 2 );
+	if( mCustomData )
+		glslFormat.attribLocation( "ciParticleData", 3 );
+#if defined( CINDER_GL_ES )
+	// ES requires a fragment shader even though rasterization is discarded
+	glslFormat.fragment( string( sVersionHeader ) + "out vec4 oColor;\nvoid main() { oColor = vec4( 0.0 ); }\n" );
+#endif
+	if( ! format.getLabel().empty() )
+		glslFormat.label( format.getLabel() + " update" );
+	mUpdateGlsl = GlslProg::create( glslFormat );
+
+	const int numAttribs = mCustomData ? 4 : 3;
+	for( int i = 0; i < 2; ++i ) {
+		mVbos[i] = Vbo::create( GL_ARRAY_BUFFER, mMaxParticles * mStride, nullptr, GL_DYNAMIC_COPY );
+		if( ! format.getLabel().empty() )
+			mVbos[i]->setLabel( format.getLabel() + " " + to_string( i ) );
+
+		mUpdateVaos[i] = Vao::create();
+		ScopedVao vaoScp( mUpdateVaos[i] );
+		ScopedBuffer bufferScp( mVbos[i] );
+		for( int attrib = 0; attrib < numAttribs; ++attrib ) {
+			enableVertexAttribArray( attrib );
+			vertexAttribPointer( attrib, 4, GL_FLOAT, GL_FALSE, (GLsizei)mStride, (const GLvoid*)( attrib * sizeof( vec4 ) ) );
+		}
+	}
+
+	// the buffers' initial contents are undefined, so the first pass kills every particle
+	clear();
+}
+
+void ParticleSystem::setAttractor( int index, const vec3 &position, float strength )
+{
+	CI_ASSERT( index >= 0 && index < MAX_ATTRACTORS );
+	mAttractors[index] = vec4( position, strength );
+}
+
+void ParticleSystem::update( float deltaTime )
+{
+	mEmissionRemainder += mEmissionRate * deltaTime;
+	uint32_t numRateParticles = (uint32_t)mEmissionRemainder;
+	mEmissionRemainder -= numRateParticles;
+
+	uint32_t emitCount = std::min( mNumPendingEmission + numRateParticles, mMaxParticles );
+	mNumPendingEmission = 0;
+
+	mTime += deltaTime;
+	runUpdate( deltaTime, emitCount, false );
+	mEmitCursor = ( mEmitCursor + emitCount ) % mMaxParticles;
+}
+
+void ParticleSystem::clear()
+{
+	mNumPendingEmission = 0;
+	mEmissionRemainder = 0;
+	mEmitCursor = 0;
+	runUpdate( 0, 0, true );
+}
+
+void ParticleSystem::runUpdate( float deltaTime, uint32_t emitCount, bool reset )
+{
+	ScopedGlslProg glslScp( mUpdateGlsl );
+	ScopedState discardScp( GL_RASTERIZER_DISCARD, true );
+
+	mUpdateGlsl->uniform( "ciParticleDeltaTime", deltaTime );
+	mUpdateGlsl->uniform( "ciParticleTime", mTime );
+	mUpdateGlsl->uniform( "ciParticleSeed", mFrame++ );
+	mUpdateGlsl->uniform( "ciParticleReset", reset );
+	mUpdateGlsl->uniform( "ciParticleMaxParticles", (int)mMaxParticles );
+	mUpdateGlsl->uniform( "ciParticleEmitStart", (int)mEmitCursor );
+	mUpdateGlsl->uniform( "ciParticleEmitCount", (int)emitCount );
+	mUpdateGlsl->uniform( "ciParticleOverwriteLive", mOverwriteLive );
+	if( emitCount > 0 ) {
+		mUpdateGlsl->uniform( "ciParticleEmitPosition", mEmitter.getPosition() );
+		mUpdateGlsl->uniform( "ciParticleEmitRadius", mEmitter.getRadius() );
+		mUpdateGlsl->uniform( "ciParticleEmitVelocity", mEmitter.getVelocity() );
+		mUpdateGlsl->uniform( "ciParticleEmitVelocitySpread", mEmitter.getVelocitySpread() );
+		mUpdateGlsl->uniform( "ciParticleEmitLifetime", vec2( mEmitter.getLifetimeMin(), mEmitter.getLifetimeMax() ) );
+		mUpdateGlsl->uniform( "ciParticleEmitColor", vec4( mEmitter.getColor() ) );
+	}
+	mUpdateGlsl->uniform( "ciParticleGravity", mGravity );
+	mUpdateGlsl->uniform( "ciParticleDrag", mDrag );
+	mUpdateGlsl->uniform( "ciParticleNoise", mNoise );
+	mUpdateGlsl->uniform( "ciParticleAttractors", mAttractors, MAX_ATTRACTORS );
+
+	const int destIndex = 1 - mSourceIndex;
+	ScopedVao vaoScp( mUpdateVaos[mSourceIndex] );
+	bindBufferBase( GL_TRANSFORM_FEEDBACK_BUFFER, 0, mVbos[destIndex] );
+	beginTransformFeedback( GL_POINTS );
+	drawArrays( GL_POINTS, 0, mMaxParticles );
+	endTransformFeedback();
+
+	mSourceIndex = destIndex;
+}
+
+geom::BufferLayout ParticleSystem::getBufferLayout( uint32_t instanceDivisor ) const
+{
+	geom::BufferLayout layout;
+	layout.append( geom::CUSTOM_0, 4, mStride, 0, instanceDivisor );
+	layout.append( geom::CUSTOM_1, 4, mStride, sizeof( vec4 ), instanceDivisor );
+	layout.append( geom::CUSTOM_2, 4, mStride, 2 * sizeof( vec4 ), instanceDivisor );
+	if( mCustomData )
+		layout.append( geom::CUSTOM_3, 4, mStride, 3 * sizeof( vec4 ), instanceDivisor );
+	return layout;
+}
+
+Batch::AttributeMapping ParticleSystem::getAttributeMapping()
+{
+	return { { geom::CUSTOM_0, "ciParticlePosition" }, { geom::CUSTOM_1, "ciParticleVelocity" }, { geom::CUSTOM_2, "ciParticleColor" }, { geom::CUSTOM_3, "ciParticleData" } };
+}
+
+void ParticleSystem::draw( const GlslProgRef &glsl )
+{
+	GlslProgRef drawGlsl = glsl;
+	if( ! drawGlsl ) {
+		if( ! mPointGlsl )
+			mPointGlsl = GlslProg::create( string( sVersionHeader ) + sPointVertexShader, string( sVersionHeader ) + sPointFragmentShader );
+		drawGlsl = mPointGlsl;
+	}
+
+	// the Batches are rebuilt only when the GlslProg changes
+	if( ! mPointBatches[0] || mPointBatches[0]->getGlslProg() != drawGlsl ) {
+		for( int i = 0; i < 2; ++i ) {
+			auto mesh = VboMesh::create( mMaxParticles, GL_POINTS, { { getBufferLayout(), mVbos[i] } } );
+			mPointBatches[i] = Batch::create( mesh, drawGlsl, getAttributeMapping() );
+		}
+	}
+
+	mPointBatches[mSourceIndex]->draw();
+}
+
+void ParticleSystem::setInstanceMesh( const VboMeshRef &mesh, const GlslProgRef &glsl )
+{
+	// both Batches share the mesh's Vbos and differ only in which particle buffer supplies the instance attributes
+	for( int i = 0; i < 2; ++i ) {
+		auto instanceMesh = VboMesh::create( mesh->getNumVertices(), mesh->getGlPrimitive(), mesh->getVertexArrayLayoutVbos(), mesh->getNumIndices(), mesh->getIndexDataType(), mesh->getIndexVbo() );
+		instanceMesh->appendVbo( getBufferLayout( 1 ), mVbos[i] );
+		mInstanceBatches[i] = Batch::create( instanceMesh, glsl, getAttributeMapping() );
+	}
+}
+
+void ParticleSystem::drawInstanced()
+{
+	CI_ASSERT_MSG( mInstanceBatches[0], "setInstanceMesh() must be called before drawInstanced()" );
+	mInstanceBatches[mSourceIndex]->drawInstanced( mMaxParticles );
+}
+
+} } // namespace cinder::gl
+
+#endif // ! defined( CINDER_GL_ES_2 )
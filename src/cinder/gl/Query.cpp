@@ -154,6 +154,64 @@ double QueryTimeSwapped::getElapsedSeconds() const
 	return static_cast<double>( getElapsedNanoseconds() ) * 0.000000001;
 }
 
+/////////////////////////////////////////////////////////////////////////////////
+// ProfilerGpuTimer
+
+ProfilerGpuTimerRef ProfilerGpuTimer::create()
+{
+	return ProfilerGpuTimerRef( new ProfilerGpuTimer );
+}
+
+ProfilerGpuTimer::~ProfilerGpuTimer()
+{
+	if( ! mQueries.empty() )
+		glDeleteQueries( (GLsizei)mQueries.size(), mQueries.data() );
+}
+
+uint32_t ProfilerGpuTimer::issueTimestamp()
+{
+	uint32_t handle;
+	if( mFreeHandles.empty() ) {
+		GLuint id;
+		glGenQueries( 1, &id );
+		handle = (uint32_t)mQueries.size();
+		mQueries.push_back( id );
+	}
+	else {
+		handle = mFreeHandles.back();
+		mFreeHandles.pop_back();
+	}
+
+	glQueryCounter( mQueries[handle], GL_TIMESTAMP );
+	return handle;
+}
+
+bool ProfilerGpuTimer::getTimestamp( uint32_t handle, uint64_t *resultNanoseconds )
+{
+	GLint available = 0;
+	glGetQueryObjectiv( mQueries[handle], GL_QUERY_RESULT_AVAILABLE, &available );
+	if( ! available )
+		return false;
+
+	GLuint64 value = 0;
+	glGetQueryObjectui64v( mQueries[handle], GL_QUERY_RESULT, &value );
+	*resultNanoseconds = value;
+	return true;
+}
+
+void ProfilerGpuTimer::releaseTimestamp( uint32_t handle )
+{
+	mFreeHandles.push_back( handle );
+}
+
+bool ProfilerGpuTimer::getCurrentTime( uint64_t *resultNanoseconds )
+{
+	GLint64 value = 0;
+	glGetInteger64v( GL_TIMESTAMP, &value );
+	*resultNanoseconds = (uint64_t)value;
+	return value != 0;
+}
+
 #endif // ! defined( CINDER_GL_ES )
 
 } } // namespace cinder::gl
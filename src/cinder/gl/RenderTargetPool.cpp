@@ -0,0 +1,276 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/gl/platform.h" // must be first
+#include "cinder/gl/RenderTargetPool.h"
+
+#include <algorithm>
+#include <functional>
+
+using namespace std;
+
+namespace cinder { namespace gl {
+
+namespace {
+
+// Estimates the size of a single texel of \a internalFormat; compressed formats are never render targets and are counted as 1 byte
+size_t getBytesPerTexel( GLint internalFormat )
+{
+	if( internalFormat <= 0 )
+		return 4;
+
+	GLenum dataFormat, dataType;
+	bool compressed = false;
+	TextureBase::getInternalFormatInfo( internalFormat, &dataFormat, &dataType, nullptr, &compressed );
+	if( compressed )
+		return 1;
+
+	size_t channels;
+	switch( dataFormat ) {
+		case GL_RG:
+#if ! defined( CINDER_GL_ES_2 )
+		case GL_RG_INTEGER:
+#endif
+			channels = 2; break;
+		case GL_RGB:
+#if ! defined( CINDER_GL_ES_2 )
+		case GL_RGB_INTEGER:
+#endif
+			channels = 3; break;
+		case GL_RGBA:
+#if ! defined( CINDER_GL_ES_2 )
+		case GL_RGBA_INTEGER:
+#endif
+			channels = 4; break;
+		default:
+			channels = 1; break;
+	}
+
+	switch( dataType ) {
+		case GL_UNSIGNED_BYTE:
+		case GL_BYTE:
+			return channels;
+		case GL_UNSIGNED_SHORT:
+		case GL_SHORT:
+#if ! defined( CINDER_GL_ES_2 )
+		case GL_HALF_FLOAT:
+#endif
+			return channels * 2;
+		case GL_UNSIGNED_INT:
+		case GL_INT:
+		case GL_FLOAT:
+			return channels * 4;
+#if ! defined( CINDER_GL_ES_2 )
+		case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+			return 8;
+#endif
+		default: // packed formats such as GL_UNSIGNED_INT_24_8 and GL_UNSIGNED_INT_2_10_10_10_REV
+			return 4;
+	}
+}
+
+size_t getTextureBytes( const ivec2 &size, GLint internalFormat, bool mipmapping )
+{
+	size_t result = size.x * size.y * getBytesPerTexel( internalFormat );
+	// a full mip chain adds a third
+	return mipmapping ? result + result / 3 : result;
+}
+
+} // anonymous namespace
+
+RenderTargetPool::TextureKey::TextureKey( const TextureBase::Format &format )
+	: mTarget( format.getTarget() ), mInternalFormat( format.getInternalFormat() ), mMipmapping( format.hasMipmapping() ),
+	mMinFilter( format.getMinFilter() ), mMagFilter( format.getMagFilter() ), mWrapS( format.getWrapS() ), mWrapT( format.getWrapT() ), mCompareMode( format.getCompareMode() )
+{
+}
+
+bool RenderTargetPool::TextureKey::operator==( const TextureKey &rhs ) const
+{
+	return mTarget == rhs.mTarget && mInternalFormat == rhs.mInternalFormat && mMipmapping == rhs.mMipmapping
+		&& mMinFilter == rhs.mMinFilter && mMagFilter == rhs.mMagFilter && mWrapS == rhs.mWrapS && mWrapT == rhs.mWrapT && mCompareMode == rhs.mCompareMode;
+}
+
+bool RenderTargetPool::Key::operator==( const Key &rhs ) const
+{
+	return mSize == rhs.mSize && mIsFbo == rhs.mIsFbo && mColorTextureKey == rhs.mColorTextureKey && mDepthTextureKey == rhs.mDepthTextureKey
+		&& mColorTexture == rhs.mColorTexture && mDepthTexture == rhs.mDepthTexture && mDepthBuffer == rhs.mDepthBuffer && mStencilBuffer == rhs.mStencilBuffer
+		&& mDepthBufferInternalFormat == rhs.mDepthBufferInternalFormat && mSamples == rhs.mSamples && mCoverageSamples == rhs.mCoverageSamples;
+}
+
+RenderTargetPoolRef RenderTargetPool::create( const Format &format )
+{
+	return RenderTargetPoolRef( new RenderTargetPool( format ) );
+}
+
+RenderTargetPool::RenderTargetPool( const Format &format )
+	: mFormat( format ), mFrameCount( 0 ), mNumAllocations( 0 )
+{
+}
+
+FboRef RenderTargetPool::acquireFbo( const ivec2 &size, const Fbo::Format &format )
+{
+	if( ! format.mAttachmentsBuffer.empty() || ! format.mAttachmentsTexture.empty() )
+		throw RenderTargetPoolExc( "RenderTargetPool does not support Fbo::Formats with explicit attachments" );
+
+	Key key;
+	key.mSize = size;
+	key.mIsFbo = true;
+	key.mColorTexture = format.mColorTexture;
+	if( key.mColorTexture )
+		key.mColorTextureKey = TextureKey( format.mColorTextureFormat );
+	key.mDepthTexture = format.mDepthTexture;
+	if( key.mDepthTexture )
+		key.mDepthTextureKey = TextureKey( format.mDepthTextureFormat );
+	key.mDepthBuffer = format.mDepthBuffer;
+	if( key.mDepthBuffer )
+		key.mDepthBufferInternalFormat = format.mDepthBufferInternalFormat;
+	key.mStencilBuffer = format.mStencilBuffer;
+	key.mSamples = format.mSamples;
+	key.mCoverageSamples = format.mCoverageSamples;
+
+	Entry *entry = findFree( key );
+	if( ! entry ) {
+		unique_ptr<Entry> newEntry( new Entry );
+		newEntry->mKey = key;
+		newEntry->mFbo = Fbo::create( size.x, size.y, format );
+
+		// multisampled attachments are renderbuffers which resolve into the textures
+		size_t samples = std::max( format.mSamples, 1 );
+		size_t numBytes = 0;
+		if( format.mColorTexture ) {
+			numBytes += getTextureBytes( size, format.mColorTextureFormat.getInternalFormat(), format.mColorTextureFormat.hasMipmapping() );
+			if( format.mSamples > 0 )
+				numBytes += samples * getTextureBytes( size, format.mColorTextureFormat.getInternalFormat(), false );
+		}
+		if( format.mDepthTexture ) {
+			numBytes += getTextureBytes( size, format.mDepthTextureFormat.getInternalFormat(), false );
+			if( format.mSamples > 0 )
+				numBytes += samples * getTextureBytes( size, format.mDepthTextureFormat.getInternalFormat(), false );
+		}
+		else if( format.mDepthBuffer || format.mStencilBuffer )
+			numBytes += samples * getTextureBytes( size, format.mDepthBuffer ? format.mDepthBufferInternalFormat : GL_STENCIL_INDEX8, false );
+		newEntry->mNumBytes = numBytes;
+
+		entry = newEntry.get();
+		mEntries.push_back( std::move( newEntry ) );
+		++mNumAllocations;
+	}
+
+	entry->mInUse = true;
+	entry->mLastUsedFrame = mFrameCount;
+	// the result aliases a handle whose deleter hands the Fbo back to the pool. Fbo is enable_shared_from_this, so a second owner of the Fbo itself
+	// could re-point its shared_from_this() at the handle, which would expire once the Fbo is handed back
+	shared_ptr<void> handle( nullptr, std::bind( &RenderTargetPool::markFree, shared_from_this(), entry ) );
+	return FboRef( handle, entry->mFbo.get() );
+}
+
+Texture2dRef RenderTargetPool::acquireTexture( const ivec2 &size, const Texture2d::Format &format )
+{
+	Key key;
+	key.mSize = size;
+	key.mColorTexture = true;
+	key.mColorTextureKey = TextureKey( format );
+
+	Entry *entry = findFree( key );
+	if( ! entry ) {
+		unique_ptr<Entry> newEntry( new Entry );
+		newEntry->mKey = key;
+		newEntry->mTexture = Texture2d::create( size.x, size.y, format );
+		newEntry->mNumBytes = getTextureBytes( size, newEntry->mTexture->getInternalFormat(), format.hasMipmapping() );
+
+		entry = newEntry.get();
+		mEntries.push_back( std::move( newEntry ) );
+		++mNumAllocations;
+	}
+
+	entry->mInUse = true;
+	entry->mLastUsedFrame = mFrameCount;
+	shared_ptr<void> handle( nullptr, std::bind( &RenderTargetPool::markFree, shared_from_this(), entry ) );
+	return Texture2dRef( handle, entry->mTexture.get() );
+}
+
+RenderTargetPool::Entry* RenderTargetPool::findFree( const Key &key )
+{
+	for( auto &entry : mEntries ) {
+		if( ! entry->mInUse && entry->mKey == key )
+			return entry.get();
+	}
+
+	return nullptr;
+}
+
+void RenderTargetPool::markFree( Entry *entry )
+{
+	entry->mInUse = false;
+	entry->mLastUsedFrame = mFrameCount;
+}
+
+void RenderTargetPool::endFrame()
+{
+	++mFrameCount;
+
+	uint32_t frameCount = mFrameCount, maxUnusedFrames = mFormat.getMaxUnusedFrames();
+	mEntries.erase( remove_if( mEntries.begin(), mEntries.end(), [=]( const unique_ptr<Entry> &entry ) {
+		return ! entry->mInUse && frameCount - entry->mLastUsedFrame > maxUnusedFrames;
+	} ), mEntries.end() );
+}
+
+void RenderTargetPool::clear()
+{
+	mEntries.erase( remove_if( mEntries.begin(), mEntries.end(), []( const unique_ptr<Entry> &entry ) {
+		return ! entry->mInUse;
+	} ), mEntries.end() );
+}
+
+size_t RenderTargetPool::getNumTargetsInUse() const
+{
+	size_t result = 0;
+	for( const auto &entry : mEntries ) {
+		if( entry->mInUse )
+			++result;
+	}
+
+	return result;
+}
+
+size_t RenderTargetPool::getNumBytes() const
+{
+	size_t result = 0;
+	for( const auto &entry : mEntries )
+		result += entry->mNumBytes;
+
+	return result;
+}
+
+size_t RenderTargetPool::getNumBytesInUse() const
+{
+	size_t result = 0;
+	for( const auto &entry : mEntries ) {
+		if( entry->mInUse )
+			result += entry->mNumBytes;
+	}
+
+	return result;
+}
+
+} } // namespace cinder::gl
@@ -31,6 +31,7 @@
 #include "cinder/gl/scoped.h"
 #include "cinder/ip/Flip.h"
 #include "cinder/Log.h"
+#include "cinder/Profiler.h"
 #include <stdio.h>
 #include <algorithm>
 #include <memory>
@@ -1086,6 +1087,7 @@ Texture2d::Texture2d( const TextureData &data, Format format )
 template<typename T>
 void Texture2d::setData( const SurfaceT<T> &original, bool createStorage, int mipLevel, const ivec2 &destOffset )
 {
+	CI_PROFILE_GPU( "Texture2d upload" );
 	SurfaceT<T> intermediate;
 	bool useIntermediate = false;
 	
@@ -1120,6 +1122,7 @@ void Texture2d::setData( const SurfaceT<T> &original, bool createStorage, int mi
 template<typename T>
 void Texture2d::setData( const ChannelT<T> &original, bool createStorage, int mipLevel, const ivec2 &destOffset )
 {
+	CI_PROFILE_GPU( "Texture2d upload" );
 	ChannelT<T> intermediate;
 	bool useIntermediate = false;
 	
@@ -1158,6 +1161,7 @@ void Texture2d::setData( const ChannelT<T> &original, bool createStorage, int mi
 
 void Texture2d::initData( const void *data, GLenum dataFormat, const Format &format )
 {
+	CI_PROFILE_GPU( "Texture2d upload" );
 	ScopedTextureBind tbs( mTarget, mTextureId );
 	
 	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
@@ -1278,6 +1282,7 @@ void Texture2d::initData( const ImageSourceRef &imageSource, const Format &forma
 
 void Texture2d::update( const void *data, GLenum dataFormat, GLenum dataType, int mipLevel, int width, int height, const ivec2 &destLowerLeftOffset )
 {
+	CI_PROFILE_GPU( "Texture2d upload" );
 	ScopedTextureBind tbs( mTarget, mTextureId );
 	glTexSubImage2D( mTarget, mipLevel, destLowerLeftOffset.x, destLowerLeftOffset.y, width, height, dataFormat, dataType, data );
 }
@@ -1325,6 +1330,7 @@ void Texture2d::update( const PboRef &pbo, GLenum format, GLenum type, const Are
 	CI_ASSERT_ERROR( pbo->getTarget() == GL_PIXEL_UNPACK_BUFFER )
 	*/
 	
+	CI_PROFILE_GPU( "Texture2d upload" );
 	ScopedBuffer bufScp( (BufferObjRef)( pbo ) );
 	ScopedTextureBind tbs( mTarget, mTextureId );
 	glTexSubImage2D( mTarget, mipLevel, destArea.getX1(), mActualSize.y - destArea.getY2(), destArea.getWidth(), destArea.getHeight(), format, type, reinterpret_cast<const GLvoid*>( pboByteOffset ) );
@@ -1953,6 +1959,8 @@ void TextureData::init()
 	mSwizzleMask[1] = GL_GREEN;
 	mSwizzleMask[2] = GL_BLUE;
 	mSwizzleMask[3] = GL_ALPHA;
+	mExternalDataStore = nullptr;
+	mDataStoreSize = 0;
 }
 
 TextureData::~TextureData()
@@ -2003,8 +2011,16 @@ void TextureData::unmapDataStore()
 #endif
 }
 
+void TextureData::setExternalDataStore( const void *data, size_t size )
+{
+	mExternalDataStore = reinterpret_cast<const uint8_t*>( data );
+	mDataStoreSize = size;
+}
+
 void* TextureData::getDataStorePtr( size_t offset ) const
 {
+	if( mExternalDataStore )
+		return const_cast<uint8_t*>( mExternalDataStore ) + offset;
 #if ! defined( CINDER_GL_ES )
 	if( mPbo && mPboMappedPtr ) {
 		return ((uint8_t*)mPboMappedPtr) + offset;
@@ -2046,6 +2062,7 @@ void Texture2d::update( const TextureData &textureData )
 	if( textureData.getWidth() != mActualSize.x || textureData.getHeight() != mActualSize.y )
 		replace( textureData );
 	else {
+		CI_PROFILE_GPU( "Texture2d upload" );
 		ScopedTextureBind bindScope( mTarget, mTextureId );
 		if( textureData.getUnpackAlignment() != 0 )
 			glPixelStorei( GL_UNPACK_ALIGNMENT, textureData.getUnpackAlignment() );
@@ -2065,6 +2082,7 @@ void Texture2d::update( const TextureData &textureData )
 
 void Texture2d::replace( const TextureData &textureData )
 {
+	CI_PROFILE_GPU( "Texture2d upload" );
 	mActualSize = ivec2( textureData.getWidth(), textureData.getHeight() );
 	mCleanBounds = Area( 0, 0, mActualSize.x, mActualSize.y );
 	mInternalFormat = textureData.getInternalFormat();
@@ -89,7 +89,7 @@ void parseKtx( const DataSourceRef &dataSource, TextureData *resultData )
 		
 		uint32_t imageSize;
 		ktxStream->readData( &imageSize, sizeof(imageSize) );
-		if( level == 0 ) { // if this is our first level, we need to allocate storage. If mipmapping is on we need double the memory required for the first level
+		if( level == 0 && ! resultData->hasExternalDataStore() ) { // if this is our first level, we need to allocate storage. If mipmapping is on we need double the memory required for the first level
 			if( header.numberOfMipmapLevels > 1 )
 				resultData->allocateDataStore( imageSize * 2 );
 			else
@@ -102,10 +102,18 @@ void parseKtx( const DataSourceRef &dataSource, TextureData *resultData )
 				for( int zSlice = 0; zSlice < header.pixelDepth + 1; ++zSlice ) { // curently always 0 -> 1
 					resultData->push_back( TextureData::Level() );
 					resultData->back().dataSize = imageSize;
-					resultData->back().offset = byteOffset;
-					if( byteOffset + imageSize > resultData->getDataStoreSize() )
-						throw TextureDataStoreTooSmallExc();
-					ktxStream->readData( resultData->getDataStorePtr( byteOffset ), imageSize );
+					if( resultData->hasExternalDataStore() ) { // an external store holds the whole file, so the level is wherever the stream is
+						resultData->back().offset = (size_t)ktxStream->tell();
+						if( resultData->back().offset + imageSize > resultData->getDataStoreSize() )
+							throw TextureDataStoreTooSmallExc();
+						ktxStream->seekRelative( imageSize );
+					}
+					else {
+						resultData->back().offset = byteOffset;
+						if( byteOffset + imageSize > resultData->getDataStoreSize() )
+							throw TextureDataStoreTooSmallExc();
+						ktxStream->readData( resultData->getDataStorePtr( byteOffset ), imageSize );
+					}
 					resultData->back().width = std::max<int>( 1, header.pixelWidth >> level );
 					resultData->back().height = std::max<int>( 1, header.pixelHeight >> level );
 					resultData->back().depth = zSlice;
@@ -254,7 +262,8 @@ void parseDds( const DataSourceRef &dataSource, TextureData *resultData )
 	resultData->setHeight( ddsd.dwHeight );
 	resultData->setDepth( 1 );
 
-	int numMipMaps = ddsd.dwMipMapCount;
+	// dwMipMapCount includes the top level, and is 0 when the file has no mipmaps
+	int numLevels = std::max<int>( 1, ddsd.dwMipMapCount );
 	int dataFormat;
 	int32_t blockSizeBytes = 16;
 	switch( ddsd.ddpfPixelFormat.dwFourCC ) { 
@@ -332,27 +341,36 @@ void parseDds( const DataSourceRef &dataSource, TextureData *resultData )
 
 	// calculate the space we need
 	uint32_t spaceRequired = 0;
-	for( int level = 0; level <= numMipMaps && (ddsd.dwWidth || ddsd.dwHeight); ++level )
+	for( int level = 0; level < numLevels && (ddsd.dwWidth || ddsd.dwHeight); ++level )
 		spaceRequired += calcImageLevelSize( level );
-	resultData->allocateDataStore( spaceRequired );
+	if( ! resultData->hasExternalDataStore() )
+		resultData->allocateDataStore( spaceRequired );
 
 	resultData->mapDataStore();
 	size_t byteOffset = 0;
-	for( int level = 0; level <= numMipMaps && (ddsd.dwWidth || ddsd.dwHeight); ++level ) { 
+	for( int level = 0; level < numLevels && (ddsd.dwWidth || ddsd.dwHeight); ++level ) { 
 		int levelWidth = std::max<int>( 1, (ddsd.dwWidth>>level) );
 		int levelHeight = std::max<int>( 1, (ddsd.dwHeight>>level) );
 		const uint32_t imageSize = calcImageLevelSize( level );
 
 		resultData->push_back( TextureData::Level() );
 		resultData->back().dataSize = imageSize;
-		resultData->back().offset = byteOffset;
-		if( byteOffset + imageSize > resultData->getDataStoreSize() )
-			throw TextureDataStoreTooSmallExc();
 		resultData->back().width = levelWidth;
 		resultData->back().height = levelHeight;
 		resultData->back().depth = 0;
 
-		ddsStream->readDataAvailable( resultData->getDataStorePtr( byteOffset ), imageSize );
+		if( resultData->hasExternalDataStore() ) { // an external store holds the whole file, so the level is wherever the stream is
+			resultData->back().offset = (size_t)ddsStream->tell();
+			if( resultData->back().offset + imageSize > resultData->getDataStoreSize() )
+				throw TextureDataStoreTooSmallExc();
+			ddsStream->seekRelative( imageSize );
+		}
+		else {
+			resultData->back().offset = byteOffset;
+			if( byteOffset + imageSize > resultData->getDataStoreSize() )
+				throw TextureDataStoreTooSmallExc();
+			ddsStream->readDataAvailable( resultData->getDataStorePtr( byteOffset ), imageSize );
+		}
 		byteOffset += imageSize;
 	}
 
@@ -0,0 +1,217 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/gl/platform.h" // has to be first
+#include "cinder/gl/TextureStreamer.h"
+
+#if ! defined( CINDER_GL_ES_2 )
+
+#include "cinder/gl/TextureFormatParsers.h"
+#include "cinder/gl/scoped.h"
+#include "cinder/DataSource.h"
+#include "cinder/Profiler.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+namespace cinder { namespace gl {
+
+namespace {
+
+bool isMipmapFilter( GLenum filter )
+{
+	return filter == GL_NEAREST_MIPMAP_NEAREST || filter == GL_LINEAR_MIPMAP_NEAREST || filter == GL_NEAREST_MIPMAP_LINEAR || filter == GL_LINEAR_MIPMAP_LINEAR;
+}
+
+} // anonymous namespace
+
+TextureStreamerRef TextureStreamer::createFromKtx( const fs::path &path, const Format &format )
+{
+	return TextureStreamerRef( new TextureStreamer( path, false, format ) );
+}
+
+#if ! defined( CINDER_GL_ES ) || defined( CINDER_GL_ANGLE )
+TextureStreamerRef TextureStreamer::createFromDds( const fs::path &path, const Format &format )
+{
+	return TextureStreamerRef( new TextureStreamer( path, true, format ) );
+}
+#endif
+
+TextureStreamer::TextureStreamer( const fs::path &path, bool dds, const Format &format )
+	: mResidentLevel( 0 ), mNextRow( 0 ), mUploadBudget( format.getUploadBudget() ), mNumBytesUploaded( 0 ), mNumBytesTotal( 0 )
+{
+	mFile = MemoryMappedFile::create( path );
+
+	// the parsers only walk the headers through this stream and record where each level lives in the mapping; no pixel data is copied
+	mTextureData.setExternalDataStore( mFile->getData(), mFile->getSize() );
+	auto dataSource = DataSourceBuffer::create( Buffer::create( const_cast<void*>( mFile->getData() ), mFile->getSize() ), path );
+#if ! defined( CINDER_GL_ES ) || defined( CINDER_GL_ANGLE )
+	if( dds )
+		parseDds( dataSource, &mTextureData );
+	else
+#endif
+		parseKtx( dataSource, &mTextureData );
+
+	const int numLevels = getNumLevels();
+	if( numLevels == 0 )
+		throw TextureDataExc( "No mip levels in " + path.string() );
+
+	GLuint textureId;
+	glGenTextures( 1, &textureId );
+	mTexture = Texture2d::create( GL_TEXTURE_2D, textureId, mTextureData.getWidth(), mTextureData.getHeight(), false );
+
+	ScopedTextureBind bindScp( GL_TEXTURE_2D, textureId );
+	ScopedBuffer unpackBufferScp( GL_PIXEL_UNPACK_BUFFER, 0 );
+	// allocate every level up front; GL_TEXTURE_BASE_LEVEL then limits sampling to the levels that have been uploaded
+	for( int level = 0; level < numLevels; ++level ) {
+		const TextureData::Level &levelData = mTextureData.getLevel( level );
+		if( mTextureData.getDataType() != 0 )
+			glTexImage2D( GL_TEXTURE_2D, level, mTextureData.getInternalFormat(), levelData.width, levelData.height, 0, mTextureData.getDataFormat(), mTextureData.getDataType(), nullptr );
+		else
+			glCompressedTexImage2D( GL_TEXTURE_2D, level, mTextureData.getInternalFormat(), levelData.width, levelData.height, 0, levelData.dataSize, nullptr );
+		mNumBytesTotal += levelData.dataSize;
+	}
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, numLevels - 1 );
+
+	const Texture2d::Format &textureFormat = format.getTextureFormat();
+	mTexture->setWrap( textureFormat.getWrapS(), textureFormat.getWrapT() );
+	mTexture->setMagFilter( textureFormat.getMagFilter() );
+	if( numLevels > 1 && ! isMipmapFilter( textureFormat.getMinFilter() ) )
+		mTexture->setMinFilter( GL_LINEAR_MIPMAP_LINEAR );
+	else
+		mTexture->setMinFilter( textureFormat.getMinFilter() );
+	if( textureFormat.getMaxAnisotropy() > 1.0f )
+		mTexture->setMaxAnisotropy( textureFormat.getMaxAnisotropy() );
+	if( ! textureFormat.getLabel().empty() )
+		mTexture->setLabel( textureFormat.getLabel() );
+
+	const auto &swizzleMask = textureFormat.getSwizzleMask();
+	if( swizzleMask[0] != GL_RED || swizzleMask[1] != GL_GREEN || swizzleMask[2] != GL_BLUE || swizzleMask[3] != GL_ALPHA ) {
+#if ! defined( CINDER_GL_ES )
+		glTexParameteriv( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask.data() );
+#else
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, swizzleMask[0] );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, swizzleMask[1] );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, swizzleMask[2] );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, swizzleMask[3] );
+#endif
+	}
+
+	// upload whole levels from the smallest up while they fit in the initial budget, always including the smallest
+	mResidentLevel = numLevels;
+	size_t initialBytes = 0;
+	while( mResidentLevel > 0 ) {
+		size_t levelBytes = mTextureData.getLevel( mResidentLevel - 1 ).dataSize;
+		if( mResidentLevel < numLevels && initialBytes + levelBytes > format.getInitialBudget() )
+			break;
+		initialBytes += uploadRows( levelBytes, true );
+	}
+
+	if( isComplete() )
+		mFile.reset();
+}
+
+bool TextureStreamer::update()
+{
+	if( isComplete() )
+		return true;
+
+	CI_PROFILE_GPU( "TextureStreamer upload" );
+	size_t uploaded = 0;
+	while( ! isComplete() && ( uploaded == 0 || uploaded < mUploadBudget ) ) {
+		size_t bytes = uploadRows( mUploadBudget - std::min( uploaded, mUploadBudget ), uploaded == 0 );
+		if( bytes == 0 )
+			break;
+		uploaded += bytes;
+	}
+
+	// every level now lives in the texture, so the pages of the file are no longer needed
+	if( isComplete() )
+		mFile.reset();
+
+	return isComplete();
+}
+
+void TextureStreamer::finish()
+{
+	CI_PROFILE_GPU( "TextureStreamer upload" );
+	while( ! isComplete() )
+		uploadRows( numeric_limits<size_t>::max(), true );
+
+	mFile.reset();
+}
+
+size_t TextureStreamer::uploadRows( size_t budget, bool atLeastOneRow )
+{
+	const int level = mResidentLevel - 1;
+	const TextureData::Level &levelData = mTextureData.getLevel( level );
+	const bool compressed = mTextureData.getDataType() == 0;
+
+	// compressed levels are uploaded in rows of 4x4 blocks, since sub-image updates have to start and end on block boundaries
+	const int rowHeight = compressed ? 4 : 1;
+	const int numRows = ( levelData.height + rowHeight - 1 ) / rowHeight;
+	const size_t rowBytes = levelData.dataSize / numRows;
+	int rows = (int)std::min<size_t>( numRows - mNextRow, budget / rowBytes );
+	if( rows == 0 ) {
+		if( ! atLeastOneRow )
+			return 0;
+		rows = 1;
+	}
+
+	const int y = mNextRow * rowHeight;
+	const int height = std::min( rows * rowHeight, levelData.height - y );
+	const size_t bytes = rows * rowBytes;
+	const uint8_t *data = reinterpret_cast<const uint8_t*>( mTextureData.getDataStorePtr( levelData.offset ) ) + mNextRow * rowBytes;
+
+	ScopedTextureBind bindScp( GL_TEXTURE_2D, mTexture->getId() );
+	ScopedBuffer unpackBufferScp( GL_PIXEL_UNPACK_BUFFER, 0 );
+	GLint prevUnpackAlignment = 0;
+	if( mTextureData.getUnpackAlignment() != 0 ) {
+		glGetIntegerv( GL_UNPACK_ALIGNMENT, &prevUnpackAlignment );
+		glPixelStorei( GL_UNPACK_ALIGNMENT, mTextureData.getUnpackAlignment() );
+	}
+
+	if( compressed )
+		glCompressedTexSubImage2D( GL_TEXTURE_2D, level, 0, y, levelData.width, height, mTextureData.getInternalFormat(), (GLsizei)bytes, data );
+	else
+		glTexSubImage2D( GL_TEXTURE_2D, level, 0, y, levelData.width, height, mTextureData.getDataFormat(), mTextureData.getDataType(), data );
+
+	if( prevUnpackAlignment != 0 )
+		glPixelStorei( GL_UNPACK_ALIGNMENT, prevUnpackAlignment );
+
+	mNextRow += rows;
+	mNumBytesUploaded += bytes;
+	if( mNextRow == numRows ) {
+		mResidentLevel = level;
+		mNextRow = 0;
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, mResidentLevel );
+	}
+
+	return bytes;
+}
+
+} } // namespace cinder::gl
+
+#endif // ! defined( CINDER_GL_ES_2 )
@@ -0,0 +1,340 @@
+/*
+ Copyright (c) 2015, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/gl/platform.h" // has to be first
+#include "cinder/gl/TileRender.h"
+#include "cinder/gl/Context.h"
+#include "cinder/gl/wrapper.h"
+#include "cinder/DataTarget.h"
+#include "cinder/ImageTargetFilePngStream.h"
+
+#if ! defined( CINDER_GL_ES )
+	#include "cinder/gl/AsyncReadback.h"
+#endif
+
+using namespace std;
+
+namespace cinder { namespace gl {
+
+// Describes the output to the ImageTarget and converts rows of RGBA tiles into its layout. Rows are pushed as tiles arrive rather than pulled by load().
+class TileRender::OutputSource : public ImageSource {
+  public:
+	OutputSource( int32_t width, int32_t height, bool alpha )
+		: mRowFunc( nullptr )
+	{
+		setSize( width, height );
+		setColorModel( ImageIo::CM_RGB );
+		setDataType( ImageIo::UINT8 );
+		setChannelOrder( alpha ? ImageIo::RGBA : ImageIo::RGBX );
+	}
+
+	void load( ImageTargetRef /*target*/ ) override
+	{
+		throw ImageIoExceptionFailedLoad( "TileRender's output can only be written by TileRender::nextTile()" );
+	}
+
+	void prepare( const ImageTargetRef &target )
+	{
+		mTarget = target;
+		mRowFunc = setupRowFunc( target );
+	}
+
+	void pushRow( int32_t row, const uint8_t *data )
+	{
+		( this->*mRowFunc )( mTarget, row, data );
+	}
+
+  private:
+	ImageTargetRef	mTarget;
+	RowFunc			mRowFunc;
+};
+
+TileRender::TileRender( int32_t imageWidth, int32_t imageHeight, int32_t tileWidth, int32_t tileHeight, const Fbo::Format &fboFormat )
+	: mImageWidth( imageWidth ), mImageHeight( imageHeight ), mCurrentTile( -1 ), mNumTilesReceived( 0 )
+{
+	mTileWidth = std::min( tileWidth, imageWidth );
+	mTileHeight = std::min( tileHeight, imageHeight );
+	mNumTilesX = ( mImageWidth + mTileWidth - 1 ) / mTileWidth;
+	mNumTilesY = ( mImageHeight + mTileHeight - 1 ) / mTileHeight;
+
+	mFbo = Fbo::create( mTileWidth, mTileHeight, fboFormat );
+#if ! defined( CINDER_GL_ES )
+	mReadback = AsyncReadback::create();
+	mReadback->setCompletionFn( [this]( const Surface8uRef &tile, uint64_t /*readId*/ ) {
+		tileReceived( *tile );
+	} );
+#endif
+
+	// default to the window's matrices, stretched over the image
+	setMatricesWindow( mImageWidth, mImageHeight );
+}
+
+TileRender::~TileRender()
+{
+	// an abandoned loop still has to restore the GL state and let outstanding reads land before the callback's target goes away
+	if( mCurrentTile >= 0 ) {
+		try {
+			finish();
+		}
+		catch( ... ) {
+		}
+	}
+}
+
+void TileRender::setOutput( const fs::path &path, ImageTarget::Options options, bool alpha )
+{
+	string extension = path.extension().string();
+	if( ! extension.empty() && extension[0] == '.' )
+		extension = extension.substr( 1 );
+
+	auto source = make_shared<OutputSource>( mImageWidth, mImageHeight, alpha );
+	ImageTargetRef target;
+	if( extension == "png" )
+		target = ImageTargetFilePngStream::create( writeFile( path ), source, options );
+	else
+		target = ImageIoRegistrar::createTarget( writeFile( path ), source, options, extension );
+	if( ! target )
+		throw ImageIoExceptionUnknownExtension( "Could not create target for image with extension: " + extension );
+
+	mOutputSource = source;
+	mImageTarget = target;
+	mOutputSource->prepare( mImageTarget );
+}
+
+void TileRender::setOutput( const ImageTargetRef &imageTarget )
+{
+	mOutputSource = make_shared<OutputSource>( mImageWidth, mImageHeight, imageTarget->hasAlpha() );
+	mImageTarget = imageTarget;
+	mOutputSource->prepare( mImageTarget );
+}
+
+ImageSourceRef TileRender::getImageSource( bool alpha ) const
+{
+	return make_shared<OutputSource>( mImageWidth, mImageHeight, alpha );
+}
+
+Area TileRender::getCurrentTileArea() const
+{
+	if( mCurrentTile < 0 )
+		return Area::zero();
+
+	int32_t x = ( mCurrentTile % mNumTilesX ) * mTileWidth;
+	int32_t y = ( mCurrentTile / mNumTilesX ) * mTileHeight;
+	return Area( x, y, std::min( x + mTileWidth, mImageWidth ), std::min( y + mTileHeight, mImageHeight ) );
+}
+
+bool TileRender::nextTile()
+{
+	if( mCurrentTile < 0 ) {
+		// the output is either a band one row of tiles tall which streams to the target, or the whole image
+		if( mImageTarget )
+			mBand = Surface8u( mImageWidth, mTileHeight, true, SurfaceChannelOrder::RGBA );
+		else
+			mSurface = Surface8u( mImageWidth, mImageHeight, true, SurfaceChannelOrder::RGBA );
+		mNumTilesReceived = 0;
+		mError = nullptr;
+
+		auto ctx = gl::context();
+		ctx->pushFramebuffer( mFbo );
+		ctx->pushViewport();
+		gl::pushMatrices();
+	}
+	else
+		endTile();
+
+	if( ++mCurrentTile == getNumTiles() ) {
+		finish();
+		return false;
+	}
+
+	beginTile();
+	return true;
+}
+
+void TileRender::beginTile()
+{
+	// the Fbo is read top-down, so partial tiles along the right and bottom edges sit in its upper-left
+	Area area = getCurrentTileArea();
+	gl::viewport( ivec2( 0, mTileHeight - area.getHeight() ), area.getSize() );
+	updateMatrices();
+}
+
+void TileRender::endTile()
+{
+	Area area = getCurrentTileArea();
+	Area fboArea( 0, 0, area.getWidth(), area.getHeight() );
+#if ! defined( CINDER_GL_ES )
+	// the read completes while the next tile renders
+	mReadback->readPixels( mFbo, fboArea );
+	mReadback->update();
+#else
+	tileReceived( mFbo->readPixels8u( fboArea ) );
+#endif
+}
+
+void TileRender::finish()
+{
+#if ! defined( CINDER_GL_ES )
+	mReadback->flush();
+	{
+		unique_lock<mutex> lock( mReceivedMutex );
+		mReceivedCond.wait( lock, [this] { return mNumTilesReceived == getNumTiles() || mError; } );
+	}
+#endif
+
+	gl::popMatrices();
+	auto ctx = gl::context();
+	ctx->popViewport();
+	ctx->popFramebuffer();
+	mCurrentTile = -1;
+
+	mBand = Surface8u();
+	ImageTargetRef target = mImageTarget;
+	mImageTarget.reset();
+	mOutputSource.reset();
+
+	if( mError )
+		rethrow_exception( mError );
+	if( target )
+		target->finalize();
+}
+
+void TileRender::tileReceived( const Surface8u &tile )
+{
+	{
+		lock_guard<mutex> lock( mReceivedMutex );
+		if( mError )
+			return;
+	}
+
+	// tiles arrive in the order they were read
+	const int32_t tileIndex = mNumTilesReceived;
+	const int32_t tileX = ( tileIndex % mNumTilesX ) * mTileWidth;
+	const int32_t tileY = ( tileIndex / mNumTilesX ) * mTileHeight;
+
+	try {
+		if( mImageTarget ) {
+			mBand.copyFrom( tile, tile.getBounds(), ivec2( tileX, 0 ) );
+			// the last tile in a row completes the band, whose rows can go straight to the target
+			if( tileIndex % mNumTilesX == mNumTilesX - 1 ) {
+				for( int32_t row = 0; row < tile.getHeight(); ++row )
+					mOutputSource->pushRow( tileY + row, mBand.getData( ivec2( 0, row ) ) );
+			}
+		}
+		else
+			mSurface.copyFrom( tile, tile.getBounds(), ivec2( tileX, tileY ) );
+	}
+	catch( ... ) {
+		lock_guard<mutex> lock( mReceivedMutex );
+		mError = current_exception();
+	}
+
+	{
+		lock_guard<mutex> lock( mReceivedMutex );
+		++mNumTilesReceived;
+	}
+	mReceivedCond.notify_all();
+}
+
+void TileRender::setMatrices( const CameraPersp &camera )
+{
+	camera.getFrustum( &mFrustumLeft, &mFrustumTop, &mFrustumRight, &mFrustumBottom, &mNearClip, &mFarClip );
+	mPerspective = true;
+	mViewMatrix = camera.getViewMatrix();
+	if( mCurrentTile >= 0 )
+		updateMatrices();
+}
+
+void TileRender::setMatrices( const CameraOrtho &camera )
+{
+	camera.getFrustum( &mFrustumLeft, &mFrustumTop, &mFrustumRight, &mFrustumBottom, &mNearClip, &mFarClip );
+	mPerspective = false;
+	mViewMatrix = camera.getViewMatrix();
+	if( mCurrentTile >= 0 )
+		updateMatrices();
+}
+
+void TileRender::setMatricesWindow( int32_t windowWidth, int32_t windowHeight, bool originUpperLeft )
+{
+	if( originUpperLeft )
+		ortho( 0, (float)windowWidth, (float)windowHeight, 0, -1, 1 );
+	else
+		ortho( 0, (float)windowWidth, 0, (float)windowHeight, -1, 1 );
+}
+
+void TileRender::setMatricesWindowPersp( int32_t windowWidth, int32_t windowHeight, float fovDegrees, float nearPlane, float farPlane, bool originUpperLeft )
+{
+	CameraPersp cam( windowWidth, windowHeight, fovDegrees, nearPlane, farPlane );
+	setMatrices( cam );
+	if( originUpperLeft ) {
+		mViewMatrix *= glm::scale( vec3( 1, -1, 1 ) );
+		mViewMatrix *= glm::translate( vec3( 0, (float)-windowHeight, 0 ) );
+		if( mCurrentTile >= 0 )
+			updateMatrices();
+	}
+}
+
+void TileRender::frustum( float left, float right, float bottom, float top, float nearPlane, float farPlane )
+{
+	setFrustum( left, right, bottom, top, nearPlane, farPlane, true );
+}
+
+void TileRender::ortho( float left, float right, float bottom, float top, float nearPlane, float farPlane )
+{
+	setFrustum( left, right, bottom, top, nearPlane, farPlane, false );
+}
+
+void TileRender::setFrustum( float left, float right, float bottom, float top, float nearPlane, float farPlane, bool perspective )
+{
+	mFrustumLeft = left;
+	mFrustumRight = right;
+	mFrustumBottom = bottom;
+	mFrustumTop = top;
+	mNearClip = nearPlane;
+	mFarClip = farPlane;
+	mPerspective = perspective;
+	mViewMatrix = mat4();
+	if( mCurrentTile >= 0 )
+		updateMatrices();
+}
+
+// narrows the frustum to the current tile's share of the image
+void TileRender::updateMatrices()
+{
+	Area area = getCurrentTileArea();
+	const float x1 = area.x1 / (float)mImageWidth, x2 = area.x2 / (float)mImageWidth;
+	const float y1 = area.y1 / (float)mImageHeight, y2 = area.y2 / (float)mImageHeight;
+	const float left = mFrustumLeft + ( mFrustumRight - mFrustumLeft ) * x1;
+	const float right = mFrustumLeft + ( mFrustumRight - mFrustumLeft ) * x2;
+	const float top = mFrustumTop + ( mFrustumBottom - mFrustumTop ) * y1;
+	const float bottom = mFrustumTop + ( mFrustumBottom - mFrustumTop ) * y2;
+
+	if( mPerspective )
+		gl::setProjectionMatrix( glm::frustum( left, right, bottom, top, mNearClip, mFarClip ) );
+	else
+		gl::setProjectionMatrix( glm::ortho( left, right, bottom, top, mNearClip, mFarClip ) );
+	gl::setViewMatrix( mViewMatrix );
+	gl::setModelMatrix( mat4() );
+}
+
+} } // namespace cinder::gl
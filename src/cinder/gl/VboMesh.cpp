@@ -58,35 +58,57 @@ class VboMeshSource : public geom::Source {
 class VboMeshGeomTarget : public geom::Target {
   public:
 	struct BufferData {
-		BufferData( const geom::BufferLayout &layout, uint8_t *data, size_t dataSize )
-			: mLayout( layout ), mData( data ), mDataSize( dataSize )
+		//! Stages data in system memory until copyBuffers()
+		BufferData( const geom::BufferLayout &layout, size_t dataSize )
+			: mLayout( layout ), mStorage( new uint8_t[dataSize] ), mDataSize( dataSize ), mMapped( false )
+		{
+			mData = mStorage.get();
+		}
+		//! Writes straight into \a mappedData, the mapped memory of a VBO
+		BufferData( const geom::BufferLayout &layout, uint8_t *mappedData, size_t dataSize )
+			: mLayout( layout ), mData( mappedData ), mDataSize( dataSize ), mMapped( true )
 		{}
 		BufferData( BufferData &&rhs )
-			: mLayout( rhs.mLayout ), mData( std::move( rhs.mData ) ), mDataSize( rhs.mDataSize )
-		{}
+			: mLayout( rhs.mLayout ), mStorage( std::move( rhs.mStorage ) ), mData( rhs.mData ), mDataSize( rhs.mDataSize ), mMapped( rhs.mMapped )
+		{
+			rhs.mMapped = false;
+		}
 	
 		geom::BufferLayout			mLayout;
-		std::unique_ptr<uint8_t[]>	mData;
+		std::unique_ptr<uint8_t[]>	mStorage;
+		uint8_t						*mData;
 		size_t						mDataSize;
+		bool						mMapped;
 	};
 
 	VboMeshGeomTarget( geom::Primitive prim, VboMesh *vboMesh )
 		: mPrimitive( prim ), mVboMesh( vboMesh )
 	{
 		mVboMesh->mNumIndices = 0; // this may be replaced later with a copyIndices call
-		// create a vector of temporary data that parallels the VboMesh's vertexData
+		// The VBOs have already been allocated, so map them and let the Source write directly into them. Staging the vertex data
+		// in system memory instead means the mesh exists twice on the CPU before glBufferData() copies it, and is only our fallback.
 		for( const auto &vertexArrayBuffer : mVboMesh->getVertexArrayLayoutVbos() ) {
 			size_t requiredBytes = vertexArrayBuffer.first.calcRequiredStorage( mVboMesh->mNumVertices );
-			mBufferData.push_back( BufferData( vertexArrayBuffer.first, new uint8_t[requiredBytes], requiredBytes ) );
+			uint8_t *mappedData = nullptr;
+#if ! defined( CINDER_GL_ES_2 )
+			if( requiredBytes > 0 )
+				mappedData = reinterpret_cast<uint8_t*>( vertexArrayBuffer.second->mapBufferRange( 0, requiredBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT ) );
+#endif
+			if( mappedData )
+				mBufferData.push_back( BufferData( vertexArrayBuffer.first, mappedData, requiredBytes ) );
+			else
+				mBufferData.push_back( BufferData( vertexArrayBuffer.first, requiredBytes ) );
 		}
 	}
+	//! Unmaps any VBOs still mapped, in case the Source threw before copyBuffers()
+	~VboMeshGeomTarget();
 	
 	virtual geom::Primitive	getPrimitive() const;
 	virtual uint8_t	getAttribDims( geom::Attrib attr ) const override;
 	virtual void copyAttrib( geom::Attrib attr, uint8_t dims, size_t strideBytes, const float *srcData, size_t count ) override;
 	virtual void copyIndices( geom::Primitive primitive, const uint32_t *source, size_t numIndices, uint8_t requiredBytesPerIndex ) override;
 	
-	//! Must be called in order to upload temporary 'mBufferData' to VBOs
+	//! Must be called in order to unmap the VBOs written to directly, or upload temporary 'mBufferData' to VBOs
 	void	copyBuffers();
 	
   protected:
@@ -95,6 +117,16 @@ class VboMeshGeomTarget : public geom::Target {
 	VboMesh						*mVboMesh;
 };
 
+VboMeshGeomTarget::~VboMeshGeomTarget()
+{
+#if ! defined( CINDER_GL_ES_2 )
+	for( size_t i = 0; i < mBufferData.size(); ++i ) {
+		if( mBufferData[i].mMapped )
+			mVboMesh->mVertexArrayVbos[i].second->unmap();
+	}
+#endif
+}
+
 geom::Primitive	VboMeshGeomTarget::getPrimitive() const
 {
 	return mPrimitive;
@@ -114,13 +146,15 @@ void VboMeshGeomTarget::copyAttrib( geom::Attrib attr, uint8_t dims, size_t stri
 	// we need to find which element of 'mBufferData' containts 'attr'
 	uint8_t *dstData = nullptr;
 	uint8_t dstDims;
+	geom::DataType dstDataType;
 	size_t dstStride, dstDataSize;
 	for( const auto &bufferData : mBufferData ) {
 		if( bufferData.mLayout.hasAttrib( attr ) ) {
 			auto attrInfo = bufferData.mLayout.getAttribInfo( attr );
 			dstDims = attrInfo.getDims();
+			dstDataType = attrInfo.getDataType();
 			dstStride = attrInfo.getStride();
-			dstData = bufferData.mData.get() + attrInfo.getOffset();
+			dstData = bufferData.mData + attrInfo.getOffset();
 			dstDataSize = bufferData.mDataSize;
 			break;
 		}
@@ -134,20 +168,49 @@ void VboMeshGeomTarget::copyAttrib( geom::Attrib attr, uint8_t dims, size_t stri
 	}
 	
 	// verify we have room for this data
-	auto testDstStride = dstStride ? dstStride : ( dstDims * sizeof(float) );
+	auto testDstStride = dstStride ? dstStride : geom::getDataTypeByteSize( dstDataType, dstDims );
 	if( dstDataSize < count * testDstStride ) {
 		CI_LOG_E( "copyAttrib() called with inadequate attrib data storage allocated" );
 		return;
 	}
 	
-	if( dstData )
-		geom::copyData( dims, srcData, count, dstDims, dstStride, reinterpret_cast<float*>( dstData ) );
+	if( dstData ) {
+		if( dstDataType == geom::DataType::FLOAT )
+			geom::copyData( dims, srcData, count, dstDims, dstStride, reinterpret_cast<float*>( dstData ) );
+		else
+			geom::packData( dims, srcData, count, dstDataType, dstDims, dstStride, dstData );
+	}
 }
 
 void VboMeshGeomTarget::copyIndices( geom::Primitive primitive, const uint32_t *source, size_t numIndices, uint8_t requiredBytesPerIndex )
 {
 	mVboMesh->mNumIndices = (uint32_t)numIndices;
 
+#if ! defined( CINDER_GL_ES_2 )
+	// as with the vertex data, convert the indices straight into the mapped index VBO
+	size_t indexBytes = numIndices * ( ( requiredBytesPerIndex <= 2 ) ? sizeof(uint16_t) : sizeof(uint32_t) );
+	if( indexBytes > 0 ) {
+		if( ! mVboMesh->mIndices )
+			mVboMesh->mIndices = Vbo::create( GL_ELEMENT_ARRAY_BUFFER, indexBytes );
+		else
+			mVboMesh->mIndices->ensureMinimumSize( indexBytes );
+
+		void *mappedIndices = mVboMesh->mIndices->mapBufferRange( 0, indexBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT );
+		if( mappedIndices ) {
+			if( requiredBytesPerIndex <= 2 ) {
+				mVboMesh->mIndexType = GL_UNSIGNED_SHORT;
+				copyIndexData( source, numIndices, reinterpret_cast<uint16_t*>( mappedIndices ) );
+			}
+			else {
+				mVboMesh->mIndexType = GL_UNSIGNED_INT;
+				copyIndexData( source, numIndices, reinterpret_cast<uint32_t*>( mappedIndices ) );
+			}
+			mVboMesh->mIndices->unmap();
+			return;
+		}
+	}
+#endif
+
 	if( requiredBytesPerIndex <= 2 ) {
 		mVboMesh->mIndexType = GL_UNSIGNED_SHORT;
 		std::unique_ptr<uint16_t[]> indices( new uint16_t[numIndices] );
@@ -170,10 +233,17 @@ void VboMeshGeomTarget::copyIndices( geom::Primitive primitive, const uint32_t *
 
 void VboMeshGeomTarget::copyBuffers()
 {
-	// iterate all the buffers in mBufferData and upload them to the corresponding VBO in the VboMesh
+	// iterate all the buffers in mBufferData and unmap or upload them to the corresponding VBO in the VboMesh
 	for( auto bufferDataIt = mBufferData.begin(); bufferDataIt != mBufferData.end(); ++bufferDataIt ) {
 		auto vertexArrayIt = mVboMesh->mVertexArrayVbos.begin() + std::distance( mBufferData.begin(), bufferDataIt );
-		vertexArrayIt->second->copyData( bufferDataIt->mDataSize, bufferDataIt->mData.get() );
+#if ! defined( CINDER_GL_ES_2 )
+		if( bufferDataIt->mMapped ) {
+			vertexArrayIt->second->unmap();
+			bufferDataIt->mMapped = false;
+			continue;
+		}
+#endif
+		vertexArrayIt->second->copyData( bufferDataIt->mDataSize, bufferDataIt->mData );
 	}
 }
 
@@ -191,6 +261,11 @@ VboMesh::Layout& VboMesh::Layout::attrib( geom::Attrib attrib, uint8_t dims )
 	return *this;
 }
 
+VboMesh::Layout& VboMesh::Layout::attrib( geom::Attrib attrib, uint8_t dims, geom::DataType dataType )
+{
+	return this->attrib( geom::AttribInfo( attrib, dataType, dims, 0, 0, 0 ) );
+}
+
 VboMesh::Layout& VboMesh::Layout::attrib( const geom::AttribInfo &attribInfo )
 {
 	for( auto attribIt = mAttribInfos.begin(); attribIt != mAttribInfos.end(); ) {
@@ -425,10 +500,30 @@ void VboMesh::buildVao( const GlslProg* shader, const AttribGlslMap &attributeMa
 				}
 				
 				uint32_t dataTypeBytes = 0;
+				GLenum glDataType = GL_FLOAT;
+				GLboolean normalized = GL_FALSE;
 				switch ( vertAttribInfo.getDataType() ) {
 					case geom::DataType::FLOAT: dataTypeBytes = 4; break;
 					case geom::DataType::INTEGER: dataTypeBytes = 4; break;
 					case geom::DataType::DOUBLE: dataTypeBytes = 8; break;
+#if defined( CINDER_GL_ES_2 )
+					case geom::DataType::HALF_FLOAT: dataTypeBytes = 2; glDataType = GL_HALF_FLOAT_OES; break;
+#else
+					case geom::DataType::HALF_FLOAT: dataTypeBytes = 2; glDataType = GL_HALF_FLOAT; break;
+#endif
+					case geom::DataType::SNORM16: dataTypeBytes = 2; glDataType = GL_SHORT; normalized = GL_TRUE; break;
+					case geom::DataType::UNORM16: dataTypeBytes = 2; glDataType = GL_UNSIGNED_SHORT; normalized = GL_TRUE; break;
+					case geom::DataType::SNORM8: dataTypeBytes = 1; glDataType = GL_BYTE; normalized = GL_TRUE; break;
+					case geom::DataType::UNORM8: dataTypeBytes = 1; glDataType = GL_UNSIGNED_BYTE; normalized = GL_TRUE; break;
+					// the packed vector types only make sense as a single vertex pointer of fixed size
+#if defined( CINDER_GL_ES_2 )
+					case geom::DataType::SNORM_10_10_10_2:
+						CI_LOG_E( geom::attribToString( vertAttribInfo.getAttrib() ) << " uses SNORM_10_10_10_2, which ES 2 does not support, skipping attribute" );
+						continue;
+#else
+					case geom::DataType::SNORM_10_10_10_2: dataTypeBytes = 1; glDataType = GL_INT_2_10_10_10_REV; normalized = GL_TRUE; numDimsPerVertexPointer = 4; break;
+#endif
+					case geom::DataType::OCTAHEDRAL: dataTypeBytes = 2; glDataType = GL_SHORT; normalized = GL_TRUE; numDimsPerVertexPointer = 2; break;
 				}
 				
 				uint32_t numTimes = numLocationsExpected * shaderAttribCount;
@@ -436,7 +531,7 @@ void VboMesh::buildVao( const GlslProg* shader, const AttribGlslMap &attributeMa
 				for( int i = 0; i < numTimes; i++ ) {
 					ctx->enableVertexAttribArray( shaderLoc + i );
 					if( vertAttribInfo.getDataType() != geom::DataType::INTEGER )
-						ctx->vertexAttribPointer( shaderLoc + i, numDimsPerVertexPointer, GL_FLOAT, GL_FALSE, (GLsizei)vertAttribInfo.getStride(), (const void*)(vertAttribInfo.getOffset() + currentInnerOffset) );
+						ctx->vertexAttribPointer( shaderLoc + i, numDimsPerVertexPointer, glDataType, normalized, (GLsizei)vertAttribInfo.getStride(), (const void*)(vertAttribInfo.getOffset() + currentInnerOffset) );
 #if ! defined( CINDER_GL_ES_2 )
 					else
 						ctx->vertexAttribIPointer( shaderLoc + i, numDimsPerVertexPointer, GL_INT, (GLsizei)vertAttribInfo.getStride(), (const void*)(vertAttribInfo.getOffset() + currentInnerOffset) );
@@ -586,6 +681,9 @@ VboMesh::MappedAttrib<T> VboMesh::mapAttribImpl( geom::Attrib attr, int dims, bo
 	if( dims != attribInfo.getDims() ) {
 		CI_LOG_W( "Mapping geom::Attrib of dims " << (int)attribInfo.getDims() << " to type of dims " << dims );	
 	}
+	if( attribInfo.getDataType() != geom::DataType::FLOAT ) {
+		CI_LOG_W( "Mapping packed geom::Attrib " << geom::attribToString( attr ) << " as float data" );
+	}
 
 	auto stride = ( attribInfo.getStride() == 0 ) ? sizeof(T) : attribInfo.getStride();
 	return VboMesh::MappedAttrib<T>( this, layoutVbo->second, ((uint8_t*)dataPtr) + attribInfo.getOffset(), stride );
@@ -789,8 +887,12 @@ void VboMesh::echoVertices( std::ostream &os, const vector<uint32_t> &indices, b
 		for( const auto &attribInfo : vertArrayVbo.first.getAttribs() ) {
 			attribSemanticNames.push_back( geom::attribToString( attribInfo.getAttrib() ) );
 			attribData.push_back( vector<string>() );
-			size_t stride = ( attribInfo.getStride() == 0 ) ? attribInfo.getDims() * sizeof(float) : attribInfo.getStride();
+			size_t stride = ( attribInfo.getStride() == 0 ) ? attribInfo.getByteSize() : attribInfo.getStride();
 			for( size_t vIt : indices ) {
+				if( attribInfo.getDataType() != geom::DataType::FLOAT ) {
+					attribData.back().push_back( "(packed)" );
+					continue;
+				}
 				ostringstream ss;
 				const float *dataFloat = reinterpret_cast<const float*>( (const uint8_t*)rawData + attribInfo.getOffset() + vIt * stride );
 				for( uint8_t d = 0; d < attribInfo.getDims(); ++d ) {
@@ -893,7 +995,17 @@ void VboMeshSource::loadInto( geom::Target *target, const geom::AttribSet &reque
 		const void *rawData = vertArrayVbo.second->map( GL_READ_ONLY );
 		// now iterate the attributes associated with this VBO
 		for( const auto &attribInfo : vertArrayVbo.first.getAttribs() ) {
-			target->copyAttrib( attribInfo.getAttrib(), attribInfo.getDims(), attribInfo.getStride(), (const float*)((const uint8_t*)rawData + attribInfo.getOffset()), getNumVertices() );
+			const uint8_t *attribData = (const uint8_t*)rawData + attribInfo.getOffset();
+			geom::DataType dataType = attribInfo.getDataType();
+			bool tightlyPacked = attribInfo.getStride() == 0 || attribInfo.getStride() == attribInfo.getByteSize();
+			if( dataType == geom::DataType::INTEGER || dataType == geom::DataType::DOUBLE || ( dataType == geom::DataType::FLOAT && tightlyPacked ) )
+				target->copyAttrib( attribInfo.getAttrib(), attribInfo.getDims(), attribInfo.getStride(), (const float*)attribData, getNumVertices() );
+			else {
+				// packed and interleaved attributes are expanded to tightly packed floats, as not every geom::Target respects the stride
+				vector<float> unpacked( getNumVertices() * attribInfo.getDims() );
+				geom::unpackData( dataType, attribInfo.getDims(), attribInfo.getStride(), attribData, getNumVertices(), unpacked.data() );
+				target->copyAttrib( attribInfo.getAttrib(), attribInfo.getDims(), 0, unpacked.data(), getNumVertices() );
+			}
 		}
 		
 		vertArrayVbo.second->unmap();
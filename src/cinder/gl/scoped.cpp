@@ -22,10 +22,11 @@
  */
 
 #include "cinder/gl/scoped.h"
-#include "Cinder/gl/Context.h"
+#include "cinder/gl/Context.h"
 #include "cinder/gl/BufferObj.h"
 #include "cinder/gl/Fbo.h"
 #include "cinder/CinderAssert.h"
+#include "cinder/Profiler.h"
 
 using namespace std;
 
@@ -170,24 +171,27 @@ ScopedFramebuffer::ScopedFramebuffer( const FboRef &fbo, GLenum target )
 	: mCtx( gl::context() ), mTarget( target )
 {
 	mCtx->pushFramebuffer( fbo, target );
+#if CI_PROFILING
+	Profiler::get()->pushMarker( "Fbo pass", true );
+#endif
 }
 
 ScopedFramebuffer::ScopedFramebuffer( GLenum target, GLuint framebufferId )
 	: mCtx( gl::context() ), mTarget( target )
 {
 	mCtx->pushFramebuffer( target, framebufferId );
+#if CI_PROFILING
+	Profiler::get()->pushMarker( "Fbo pass", true );
+#endif
 }
 
 ScopedFramebuffer::~ScopedFramebuffer()
 {	
-#if ! defined( SUPPORTS_FBO_MULTISAMPLING )
-	mCtx->popFramebuffer( GL_FRAMEBUFFER );
-#else
-	if( mTarget == GL_FRAMEBUFFER || mTarget == GL_READ_FRAMEBUFFER )
-		mCtx->popFramebuffer( GL_READ_FRAMEBUFFER );
-	if( mTarget == GL_FRAMEBUFFER || mTarget == GL_DRAW_FRAMEBUFFER )
-		mCtx->popFramebuffer( GL_DRAW_FRAMEBUFFER );
+#if CI_PROFILING
+	Profiler::get()->popMarker();
 #endif
+	// the Context knows whether read and draw framebuffers are tracked separately
+	mCtx->popFramebuffer( mTarget );
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
@@ -25,6 +25,7 @@
 #include "cinder/Filter.h"
 #include "cinder/Rect.h"
 #include "cinder/ChanTraits.h"
+#include "cinder/TaskScheduler.h"
 
 #include <math.h>
 #include <vector>
@@ -159,7 +160,6 @@ void resample( const vector<const ChannelT<T>*> &srcChannels, const FilterBase &
 	int32_t srcWidth = (int32_t)clippedSrcRect.getWidth(), srcHeight = (int32_t)clippedSrcRect.getHeight();
 	int32_t srcOffsetX = static_cast<int32_t>( floor( clippedSrcRect.getX1() ) );
 	int32_t srcOffsetY = static_cast<int32_t>( floor( clippedSrcRect.getY1() ) );
-	vector<pair<int32_t,unique_ptr<typename SCALETRAIT<T>::SUMT[]>>> linesBuffer;
 
 	m.sx = dstWidth / (float)srcWidth;
 	m.sy = dstHeight / (float)srcHeight;
@@ -176,46 +176,59 @@ void resample( const vector<const ChannelT<T>*> &srcChannels, const FilterBase &
 	filterParamsY.supp = std::max( 0.5f, filterParamsY.scale * filter.getSupport() );
 	filterParamsY.width = (int32_t)ceil( 2.0f * filterParamsY.supp );
 
-	for( int32_t i = 0; i < filterParamsY.width; i++ )
-		linesBuffer.push_back( std::make_pair( -1, unique_ptr<typename SCALETRAIT<T>::SUMT[]>( new typename SCALETRAIT<T>::SUMT[dstWidth] ) ) );
-
-	WeightTable<typename SCALETRAIT<T>::SUMT> *xWeights, yWeights;
-	typename SCALETRAIT<T>::SUMT *xWeightBuffer, *xWeightPtr;
-	xWeights = (WeightTable<typename SCALETRAIT<T>::SUMT>*)malloc( sizeof(WeightTable<int32_t>) * dstWidth );
-	xWeightBuffer = (typename SCALETRAIT<T>::SUMT*)malloc( sizeof(typename SCALETRAIT<T>::SUMT) * dstWidth * filterParamsX.width );
-	yWeights.weight = (typename SCALETRAIT<T>::SUMT*)malloc( sizeof(typename SCALETRAIT<T>::SUMT) * filterParamsY.width );
-	unique_ptr<typename SCALETRAIT<T>::SUMT[]> accum = unique_ptr<typename SCALETRAIT<T>::SUMT[]>( new typename SCALETRAIT<T>::SUMT[dstWidth] );
+	typedef typename SCALETRAIT<T>::SUMT SUMT;
+	WeightTable<SUMT> *xWeights;
+	SUMT *xWeightBuffer, *xWeightPtr;
+	xWeights = (WeightTable<SUMT>*)malloc( sizeof(WeightTable<SUMT>) * dstWidth );
+	xWeightBuffer = (SUMT*)malloc( sizeof(SUMT) * dstWidth * filterParamsX.width );
 
 	xWeightPtr = xWeightBuffer;
 	for ( int32_t bx = 0; bx < dstWidth; bx++, xWeightPtr += filterParamsX.width ) {
 		xWeights[bx].weight = xWeightPtr;
-		makeWeightTable<T,typename SCALETRAIT<T>::SUMT>( bx, MAP(bx, m.sx, m.ux), filter, &filterParamsX, srcWidth, true, &xWeights[bx] );
+		makeWeightTable<T,SUMT>( bx, MAP(bx, m.sx, m.ux), filter, &filterParamsX, srcWidth, true, &xWeights[bx] );
 	}
 
-	for( size_t chan = 0; chan < srcChannels.size(); ++chan ) {
-		for ( int32_t dstY = 0; dstY < dstHeight; ++dstY ) {     // loop over dest scanlines
-			// prepare a weight table for dest y position by
-			makeWeightTable<T,typename SCALETRAIT<T>::SUMT>( dstY, MAP(dstY, m.sy, m.uy), filter, &filterParamsY, srcHeight, false, &yWeights );
-
-			memset( accum.get(), 0, sizeof(int32_t) * dstWidth );
-
-			// loop over source scanlines that influence this dest scanline
-			for ( int32_t ayf = yWeights.start; ayf < yWeights.end; ayf++ ) {
-				typename SCALETRAIT<T>::SUMT *line = linesBuffer[ayf % filterParamsY.width].second.get();
-				if( linesBuffer[ayf % filterParamsY.width].first != ayf ) {
-					scanlineFilterChannelToBuffer( xWeights, srcOffsetX, srcOffsetY + ayf, *(srcChannels[chan]), line, dstWidth );
-					linesBuffer[ayf % filterParamsY.width].first = ayf;
+	// bands of dest scanlines are resampled in parallel, each with its own cache of horizontally filtered source lines
+	auto resampleRows = [&]( size_t rowBegin, size_t rowEnd ) {
+		vector<pair<int32_t,unique_ptr<SUMT[]>>> linesBuffer;
+		for( int32_t i = 0; i < filterParamsY.width; i++ )
+			linesBuffer.push_back( std::make_pair( -1, unique_ptr<SUMT[]>( new SUMT[dstWidth] ) ) );
+		unique_ptr<SUMT[]> yWeightBuffer( new SUMT[filterParamsY.width] ), accum( new SUMT[dstWidth] );
+		WeightTable<SUMT> yWeights;
+		yWeights.weight = yWeightBuffer.get();
+
+		for( size_t chan = 0; chan < srcChannels.size(); ++chan ) {
+			for( auto &line : linesBuffer )
+				line.first = -1;
+
+			for ( int32_t dstY = (int32_t)rowBegin; dstY < (int32_t)rowEnd; ++dstY ) {     // loop over dest scanlines
+				// prepare a weight table for dest y position by
+				makeWeightTable<T,SUMT>( dstY, MAP(dstY, m.sy, m.uy), filter, &filterParamsY, srcHeight, false, &yWeights );
+
+				memset( accum.get(), 0, sizeof(SUMT) * dstWidth );
+
+				// loop over source scanlines that influence this dest scanline
+				for ( int32_t ayf = yWeights.start; ayf < yWeights.end; ayf++ ) {
+					SUMT *line = linesBuffer[ayf % filterParamsY.width].second.get();
+					if( linesBuffer[ayf % filterParamsY.width].first != ayf ) {
+						scanlineFilterChannelToBuffer( xWeights, srcOffsetX, srcOffsetY + ayf, *(srcChannels[chan]), line, dstWidth );
+						linesBuffer[ayf % filterParamsY.width].first = ayf;
+					}
+					scanlineAccumulate<SUMT,SUMT>( yWeights.weight[ayf - yWeights.start], line, dstWidth, accum.get() );
 				}
-				scanlineAccumulate<typename SCALETRAIT<T>::SUMT,typename SCALETRAIT<T>::SUMT>( yWeights.weight[ayf - yWeights.start], line, dstWidth, accum.get() );
-			}
 
-			scanlineShiftAccumToChannel( accum.get(), clippedDstArea.getX1(), clippedDstArea.getY1() + dstY, dstWidth, dstChannels[chan] );
+				scanlineShiftAccumToChannel( accum.get(), clippedDstArea.getX1(), clippedDstArea.getY1() + dstY, dstWidth, dstChannels[chan] );
+			}
 		}
-	}
+	};
+
+	// each band refilters the source lines overlapping the band above it, so bands are kept tall enough for that to be cheap
+	TaskSchedulerRef scheduler = TaskScheduler::get();
+	size_t rowsPerBand = std::max<size_t>( 64, dstHeight / ( 2 * ( scheduler->getNumWorkers() + 1 ) ) + 1 );
+	scheduler->parallelFor( 0, dstHeight, rowsPerBand, resampleRows );
 
 	free( xWeights );
 	free( xWeightBuffer );
-	free( yWeights.weight );
 }
 
 template<typename LT, typename AT>
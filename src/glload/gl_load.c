@@ -88,6 +88,38 @@ static PROC WinGetProcAddress(const char *name)
 	#else
 		#if defined(__sgi) || defined(__sun)
 			#define IntGetProcAddress(name) SunGetProcAddress(name)
+		#elif defined(__linux__)
+			#include <dlfcn.h>
+
+			/* Headless contexts are created through either EGL or OSMesa, so resolve through whichever loader
+			   is present in the process (OSMesa is dlopen'd RTLD_GLOBAL) rather than linking against GLX. */
+			typedef void* (*LinuxGetProcAddressFn)(const char*);
+			typedef void* (*LinuxGetCurrentContextFn)(void);
+
+			static void* LinuxGetProcAddress (const char *name)
+			{
+				static void* h = NULL;
+				void* result = NULL;
+				void* fn;
+
+				if (h == NULL)
+					if ((h = dlopen(NULL, RTLD_LAZY)) == NULL) return NULL;
+
+				fn = dlsym(h, "OSMesaGetCurrentContext");
+				if (fn && ((LinuxGetCurrentContextFn)fn)() != NULL)
+				{
+					fn = dlsym(h, "OSMesaGetProcAddress");
+					if (fn && (result = ((LinuxGetProcAddressFn)fn)(name)) != NULL) return result;
+				}
+				if ((fn = dlsym(h, "eglGetProcAddress")) != NULL)
+					if ((result = ((LinuxGetProcAddressFn)fn)(name)) != NULL) return result;
+				if ((fn = dlsym(h, "glXGetProcAddressARB")) != NULL)
+					if ((result = ((LinuxGetProcAddressFn)fn)(name)) != NULL) return result;
+
+				return dlsym(h, name);
+			}
+
+			#define IntGetProcAddress(name) LinuxGetProcAddress(name)
 		#else /* GLX */
 		    #include <GL/glx.h>
 
@@ -0,0 +1,236 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/ConcurrentQueue.h"
+#include "cinder/ConcurrentCircularBuffer.h"
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Checks SpscQueue and MpmcQueue for lost, duplicated or reordered items, move-only items and cancellation, then compares their throughput with
+// ConcurrentCircularBuffer passing integers between threads. Results are written to the console.
+class ConcurrentQueueTestApp : public App {
+  public:
+	void setup() override;
+	void draw() override;
+
+  private:
+	void	testSpsc();
+	void	testMpmc();
+	void	testMoveOnly();
+	void	testCancel();
+
+	template<typename PushFn, typename PopFn>
+	double	runBenchmark( int numProducers, int numConsumers, size_t itemsPerProducer, const PushFn &push, const PopFn &pop );
+	void	benchmark( int numProducers, int numConsumers );
+};
+
+void ConcurrentQueueTestApp::setup()
+{
+	testSpsc();
+	testMpmc();
+	testMoveOnly();
+	testCancel();
+
+	benchmark( 1, 1 );
+	benchmark( 4, 4 );
+}
+
+void ConcurrentQueueTestApp::testSpsc()
+{
+	const size_t count = 2000000;
+	SpscQueue<size_t> queue( 1000 );
+	thread producer( [&] {
+		for( size_t i = 0; i < count; ) {
+			// alternate single pushes with batches
+			if( i % 3 ) {
+				queue.push( i );
+				++i;
+			}
+			else {
+				size_t batch[37];
+				size_t batchSize = std::min<size_t>( 37, count - i );
+				for( size_t b = 0; b < batchSize; ++b )
+					batch[b] = i + b;
+				i += queue.pushBatch( batch, batchSize );
+			}
+		}
+	} );
+
+	size_t expected = 0;
+	while( expected < count ) {
+		size_t items[50];
+		size_t numPopped = ( expected % 2 ) ? queue.popBatch( items, 50 ) : ( queue.pop( &items[0] ) ? 1 : 0 );
+		for( size_t i = 0; i < numPopped; ++i ) {
+			if( items[i] != expected++ )
+				throw std::runtime_error( "SpscQueue reordered an item" );
+		}
+	}
+	producer.join();
+	if( ! queue.isEmpty() || queue.getCapacity() != 1024 )
+		throw std::runtime_error( "SpscQueue size" );
+	console() << "SpscQueue: passed " << count << " items in order" << endl;
+}
+
+void ConcurrentQueueTestApp::testMpmc()
+{
+	const int numProducers = 4, numConsumers = 4;
+	const size_t itemsPerProducer = 500000;
+	MpmcQueue<uint64_t> queue( 256 );
+
+	// each item carries its producer in the high bits, and every consumer must see each producer's items in order
+	vector<vector<uint64_t>> received( numConsumers );
+	vector<thread> threads;
+	for( int p = 0; p < numProducers; ++p ) {
+		threads.emplace_back( [&, p] {
+			for( uint64_t i = 0; i < itemsPerProducer; ++i )
+				queue.push( ( uint64_t( p ) << 32 ) | i );
+		} );
+	}
+	for( int c = 0; c < numConsumers; ++c ) {
+		threads.emplace_back( [&, c] {
+			uint64_t items[16];
+			size_t numPopped;
+			while( ( numPopped = queue.popBatch( items, 16 ) ) > 0 )
+				received[c].insert( received[c].end(), items, items + numPopped );
+		} );
+	}
+	for( int p = 0; p < numProducers; ++p )
+		threads[p].join();
+	while( ! queue.isEmpty() )
+		this_thread::yield();
+	queue.cancel();
+	for( int c = 0; c < numConsumers; ++c )
+		threads[numProducers + c].join();
+
+	vector<size_t> counts( numProducers );
+	for( auto &items : received ) {
+		vector<int64_t> last( numProducers, -1 );
+		for( uint64_t item : items ) {
+			int p = int( item >> 32 );
+			int64_t i = int64_t( item & 0xffffffff );
+			if( i <= last[p] )
+				throw std::runtime_error( "MpmcQueue reordered a producer's items" );
+			last[p] = i;
+			++counts[p];
+		}
+	}
+	for( size_t count : counts ) {
+		if( count != itemsPerProducer )
+			throw std::runtime_error( "MpmcQueue lost or duplicated an item" );
+	}
+	console() << "MpmcQueue: passed " << numProducers << " producers, " << numConsumers << " consumers" << endl;
+}
+
+void ConcurrentQueueTestApp::testMoveOnly()
+{
+	SpscQueue<unique_ptr<int>> spsc( 4 );
+	MpmcQueue<unique_ptr<int>> mpmc( 4 );
+	for( int i = 0; i < 3; ++i ) {
+		spsc.push( unique_ptr<int>( new int( i ) ) );
+		mpmc.push( unique_ptr<int>( new int( i ) ) );
+	}
+
+	unique_ptr<int> item;
+	vector<unique_ptr<int>> items;
+	if( ! spsc.tryPop( &item ) || *item != 0 || spsc.popBatch( back_inserter( items ), 10 ) != 2 || *items[1] != 2 )
+		throw std::runtime_error( "SpscQueue move-only items" );
+	if( ! mpmc.tryPop( &item ) || *item != 0 || mpmc.tryPopBatch( back_inserter( items ), 10 ) != 2 || *items[3] != 2 )
+		throw std::runtime_error( "MpmcQueue move-only items" );
+
+	// items left in a queue are destroyed with it
+	spsc.push( std::move( items[0] ) );
+	mpmc.push( std::move( items[1] ) );
+	console() << "move-only items: passed" << endl;
+}
+
+void ConcurrentQueueTestApp::testCancel()
+{
+	SpscQueue<int> empty( 4 );
+	MpmcQueue<int> full( 2 );
+	full.push( 1 );
+	full.push( 2 );
+
+	bool popped = true, pushed = true;
+	thread consumer( [&] { int item; popped = empty.pop( &item ); } );
+	thread producer( [&] { pushed = full.push( 3 ); } );
+	this_thread::sleep_for( chrono::milliseconds( 50 ) );
+	empty.cancel();
+	full.cancel();
+	consumer.join();
+	producer.join();
+	if( popped || pushed || ! empty.isCanceled() )
+		throw std::runtime_error( "cancel() didn't wake a blocked thread" );
+	console() << "cancel: passed" << endl;
+}
+
+template<typename PushFn, typename PopFn>
+double ConcurrentQueueTestApp::runBenchmark( int numProducers, int numConsumers, size_t itemsPerProducer, const PushFn &push, const PopFn &pop )
+{
+	vector<thread> threads;
+	auto start = chrono::steady_clock::now();
+	for( int p = 0; p < numProducers; ++p ) {
+		threads.emplace_back( [&] {
+			for( size_t i = 0; i < itemsPerProducer; ++i )
+				push( i );
+		} );
+	}
+	const size_t itemsPerConsumer = itemsPerProducer * numProducers / numConsumers;
+	for( int c = 0; c < numConsumers; ++c ) {
+		threads.emplace_back( [&] {
+			for( size_t i = 0; i < itemsPerConsumer; ++i )
+				pop();
+		} );
+	}
+	for( auto &thread : threads )
+		thread.join();
+
+	double seconds = chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+	return itemsPerProducer * numProducers / seconds / 1e6;
+}
+
+void ConcurrentQueueTestApp::benchmark( int numProducers, int numConsumers )
+{
+	const size_t itemsPerProducer = 4000000 / numProducers;
+	const size_t capacity = 1024;
+
+	ConcurrentCircularBuffer<size_t> circularBuffer( capacity );
+	double circularRate = runBenchmark( numProducers, numConsumers, itemsPerProducer, [&]( size_t i ) { circularBuffer.pushFront( i ); },
+			[&] { size_t item; circularBuffer.popBack( &item ); } );
+
+	MpmcQueue<size_t> mpmc( capacity );
+	double mpmcRate = runBenchmark( numProducers, numConsumers, itemsPerProducer, [&]( size_t i ) { mpmc.push( i ); }, [&] { size_t item; mpmc.pop( &item ); } );
+
+	console() << numProducers << " producers, " << numConsumers << " consumers: ConcurrentCircularBuffer " << circularRate << "M items/s, MpmcQueue " << mpmcRate << "M items/s";
+	if( numProducers == 1 && numConsumers == 1 ) {
+		SpscQueue<size_t> spsc( capacity );
+		double spscRate = runBenchmark( 1, 1, itemsPerProducer, [&]( size_t i ) { spsc.push( i ); }, [&] { size_t item; spsc.pop( &item ); } );
+
+		// batches of 64 on both sides
+		SpscQueue<size_t> spscBatch( capacity );
+		double batchRate = runBenchmark( 1, 1, itemsPerProducer / 64, [&]( size_t i ) {
+			size_t items[64];
+			for( size_t b = 0; b < 64; ++b )
+				items[b] = i * 64 + b;
+			spscBatch.pushBatch( items, 64 );
+		}, [&] {
+			size_t items[64];
+			for( size_t numPopped = 0; numPopped < 64; )
+				numPopped += spscBatch.popBatch( items, 64 - numPopped );
+		} ) * 64;
+		console() << ", SpscQueue " << spscRate << "M items/s, SpscQueue batches of 64 " << batchRate << "M items/s";
+	}
+	console() << endl;
+}
+
+void ConcurrentQueueTestApp::draw()
+{
+	gl::clear();
+}
+
+CINDER_APP( ConcurrentQueueTestApp, RendererGl )
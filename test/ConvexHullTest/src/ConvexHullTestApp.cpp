@@ -0,0 +1,240 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/ConvexHull.h"
+#include "cinder/Rand.h"
+#include "cinder/Timer.h"
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/geometries/point_xy.hpp>
+#include <boost/geometry/geometries/polygon.hpp>
+
+#include <map>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Checks calcConvexHull() in 2D against boost::geometry::convex_hull, which it replaced, and in 3D against a brute force hull, then checks
+// large 3D hulls are closed and contain every point, and reports timings. Results are written to the console.
+class ConvexHullTestApp : public App {
+  public:
+	void setup() override;
+	void draw() override;
+
+  private:
+	void	test2d( const string &name, const vector<vec2> &points );
+	void	test3dAgainstBruteForce();
+	void	test3d( const string &name, const vector<vec3> &points );
+};
+
+namespace {
+
+enum Distribution { SQUARE, DISC, CIRCLE };
+
+bool lessXY( const vec2 &a, const vec2 &b )
+{
+	return a.x < b.x || ( a.x == b.x && a.y < b.y );
+}
+
+vector<vec2> makePoints2d( Distribution distribution, size_t count )
+{
+	Rand rand( 1 );
+	vector<vec2> points( count );
+	for( auto &p : points ) {
+		if( distribution == SQUARE )
+			p = vec2( rand.nextFloat( -1, 1 ), rand.nextFloat( -1, 1 ) );
+		else if( distribution == DISC )
+			p = rand.nextVec2() * sqrt( rand.nextFloat() );
+		else
+			p = rand.nextVec2();
+	}
+	return points;
+}
+
+vector<vec3> makePoints3d( Distribution distribution, size_t count )
+{
+	Rand rand( 1 );
+	vector<vec3> points( count );
+	for( auto &p : points ) {
+		if( distribution == SQUARE )
+			p = vec3( rand.nextFloat( -1, 1 ), rand.nextFloat( -1, 1 ), rand.nextFloat( -1, 1 ) );
+		else if( distribution == DISC )
+			p = rand.nextVec3() * pow( rand.nextFloat(), 1 / 3.0f );
+		else
+			p = rand.nextVec3();
+	}
+	return points;
+}
+
+// the previous implementation of calcConvexHull()
+PolyLine2f calcConvexHullBoost( const vector<vec2> &points )
+{
+	typedef boost::geometry::model::polygon<boost::geometry::model::d2::point_xy<double> > polygon;
+	polygon poly;
+	for( const vec2 &p : points )
+		poly.outer().push_back( boost::geometry::make<boost::geometry::model::d2::point_xy<double> >( p.x, p.y ) );
+
+	polygon hull;
+	boost::geometry::convex_hull( poly, hull );
+
+	PolyLine2f result;
+	for( auto &p : hull.outer() )
+		result.push_back( vec2( boost::geometry::get<0>( p ), boost::geometry::get<1>( p ) ) );
+	return result;
+}
+
+// Returns whether every directed edge appears once and is matched by its reverse, and the Euler characteristic is 2
+bool isClosedManifold( const TriMesh &mesh )
+{
+	map<pair<uint32_t, uint32_t>, int> edges;
+	const vector<uint32_t> &indices = mesh.getIndices();
+	for( size_t t = 0; t < indices.size(); t += 3 ) {
+		for( int e = 0; e < 3; ++e ) {
+			if( ++edges[make_pair( indices[t + e], indices[t + ( e + 1 ) % 3] )] > 1 )
+				return false;
+		}
+	}
+	for( auto &edge : edges ) {
+		if( ! edges.count( make_pair( edge.first.second, edge.first.first ) ) )
+			return false;
+	}
+	return (int)mesh.getNumVertices() - (int)edges.size() / 2 + (int)mesh.getNumTriangles() == 2;
+}
+
+// Returns the largest distance of \a points in front of any of \a mesh's faces
+double calcMaxOutsideDistance( const TriMesh &mesh, const vector<vec3> &points )
+{
+	double maxDistance = 0;
+	const vec3 *positions = mesh.getPositions<3>();
+	const vector<uint32_t> &indices = mesh.getIndices();
+	for( size_t t = 0; t < indices.size(); t += 3 ) {
+		dvec3 p0( positions[indices[t]] ), p1( positions[indices[t + 1]] ), p2( positions[indices[t + 2]] );
+		dvec3 normal = normalize( cross( p1 - p0, p2 - p0 ) );
+		for( const vec3 &p : points )
+			maxDistance = std::max( maxDistance, dot( normal, dvec3( p ) - p0 ) );
+	}
+	return maxDistance;
+}
+
+} // anonymous namespace
+
+void ConvexHullTestApp::setup()
+{
+	const char *names[] = { "square", "disc", "circle" };
+	for( size_t count : { 1000, 100000, 1000000 } ) {
+		for( Distribution distribution : { SQUARE, DISC, CIRCLE } )
+			test2d( to_string( count ) + " points in a " + names[distribution], makePoints2d( distribution, count ) );
+	}
+
+	test3dAgainstBruteForce();
+	const char *names3d[] = { "cube", "ball", "sphere" };
+	for( size_t count : { 1000, 100000, 1000000 } ) {
+		for( Distribution distribution : { SQUARE, DISC, CIRCLE } )
+			test3d( to_string( count ) + " points in a " + names3d[distribution], makePoints3d( distribution, count ) );
+	}
+
+	// a mesh, whose vertices are all on its hull, and a flat point set
+	TriMesh sphere( geom::Sphere().subdivisions( 64 ) );
+	TriMesh sphereHull = calcConvexHull( sphere );
+	console() << "hull of a " << sphere.getNumVertices() << " vertex geom::Sphere: " << sphereHull.getNumVertices() << " vertices, closed: " << isClosedManifold( sphereHull ) << endl;
+	vector<vec3> flat;
+	for( const vec2 &p : makePoints2d( DISC, 1000 ) )
+		flat.push_back( vec3( p, 2 ) );
+	console() << "hull of coplanar points: " << calcConvexHull( flat ).getNumTriangles() << " triangles" << endl;
+	console() << "hull of no points: " << calcConvexHull( (const vec2*)nullptr, 0 ).size() << " points, " << calcConvexHull( (const vec3*)nullptr, 0 ).getNumTriangles() << " triangles" << endl;
+}
+
+void ConvexHullTestApp::test2d( const string &name, const vector<vec2> &points )
+{
+	const int numRuns = points.size() > 100000 ? 3 : 20;
+	PolyLine2f reference, result, parallelResult;
+	Timer timer( true );
+	for( int run = 0; run < numRuns; ++run )
+		reference = calcConvexHullBoost( points );
+	double boostSeconds = timer.getSeconds() / numRuns;
+
+	timer.start();
+	for( int run = 0; run < numRuns; ++run )
+		result = calcConvexHull( points );
+	double seconds = timer.getSeconds() / numRuns;
+
+	timer.start();
+	for( int run = 0; run < numRuns; ++run )
+		parallelResult = calcConvexHull( points, ConvexHullOptions().parallelSort() );
+	double parallelSeconds = timer.getSeconds() / numRuns;
+
+	// boost treats nearly collinear points as collinear, where calcConvexHull() decides exactly, so they can differ by a few points
+	vector<vec2> sortedResult( result.begin(), result.end() - 1 ), sortedReference( reference.begin(), reference.end() - 1 ), difference;
+	sort( sortedResult.begin(), sortedResult.end(), lessXY );
+	sort( sortedReference.begin(), sortedReference.end(), lessXY );
+	set_symmetric_difference( sortedResult.begin(), sortedResult.end(), sortedReference.begin(), sortedReference.end(), back_inserter( difference ), lessXY );
+	string comparison = difference.empty() ? "matches boost" : to_string( difference.size() ) + " nearly collinear points differ from boost";
+	if( parallelResult.getPoints() != result.getPoints() )
+		comparison += ", PARALLEL SORT DIFFERS";
+
+	console() << "2D, " << name << ": " << result.size() - 1 << " hull points, " << comparison << ", boost " << boostSeconds * 1000
+			<< " ms, native " << seconds * 1000 << " ms (" << boostSeconds / seconds << "x), parallel sort " << parallelSeconds * 1000 << " ms" << endl;
+}
+
+// on random sets of points, a point is a hull vertex exactly when it is on a triangle of points that has every other point behind it
+void ConvexHullTestApp::test3dAgainstBruteForce()
+{
+	Rand rand( 2 );
+	int numMismatches = 0;
+	for( int trial = 0; trial < 50; ++trial ) {
+		vector<vec3> points( 40 );
+		for( auto &p : points )
+			p = vec3( rand.nextFloat( -1, 1 ), rand.nextFloat( -1, 1 ), rand.nextFloat( -1, 1 ) );
+
+		vector<bool> isHullVertex( points.size(), false );
+		for( size_t i = 0; i < points.size(); ++i ) {
+			for( size_t j = i + 1; j < points.size(); ++j ) {
+				for( size_t k = j + 1; k < points.size(); ++k ) {
+					dvec3 normal = cross( dvec3( points[j] ) - dvec3( points[i] ), dvec3( points[k] ) - dvec3( points[i] ) );
+					int numAbove = 0, numBelow = 0;
+					for( const vec3 &p : points ) {
+						double d = dot( normal, dvec3( p ) - dvec3( points[i] ) );
+						numAbove += d > 1e-12 ? 1 : 0;
+						numBelow += d < -1e-12 ? 1 : 0;
+					}
+					if( numAbove == 0 || numBelow == 0 )
+						isHullVertex[i] = isHullVertex[j] = isHullVertex[k] = true;
+				}
+			}
+		}
+
+		TriMesh hull = calcConvexHull( points );
+		vector<bool> inHull( points.size(), false );
+		for( size_t v = 0; v < hull.getNumVertices(); ++v )
+			inHull[find( points.begin(), points.end(), hull.getPositions<3>()[v] ) - points.begin()] = true;
+		if( inHull != isHullVertex || ! isClosedManifold( hull ) )
+			++numMismatches;
+	}
+	console() << "3D against brute force: " << ( numMismatches ? to_string( numMismatches ) + " of 50 hulls DIFFER" : "all 50 hulls match" ) << endl;
+}
+
+void ConvexHullTestApp::test3d( const string &name, const vector<vec3> &points )
+{
+	const int numRuns = points.size() > 100000 ? 3 : 20;
+	TriMesh hull;
+	Timer timer( true );
+	for( int run = 0; run < numRuns; ++run )
+		hull = calcConvexHull( points );
+	double seconds = timer.getSeconds() / numRuns;
+
+	// checking every point against every face is quadratic, so large sets are sampled
+	vector<vec3> sample;
+	for( size_t p = 0; p < points.size(); p += std::max<size_t>( points.size() / 20000, 1 ) )
+		sample.push_back( points[p] );
+	console() << "3D, " << name << ": " << hull.getNumVertices() << " vertices, " << hull.getNumTriangles() << " triangles, closed: " << isClosedManifold( hull )
+			<< ", farthest point outside: " << calcMaxOutsideDistance( hull, sample ) << ", " << seconds * 1000 << " ms, "
+			<< points.size() / seconds / 1e6 << "M points/s" << endl;
+}
+
+void ConvexHullTestApp::draw()
+{
+	gl::clear();
+}
+
+CINDER_APP( ConvexHullTestApp, RendererGl )
@@ -1,106 +1,101 @@
 #include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/gl/TileRender.h"
 #include "cinder/Camera.h"
+#include "cinder/ImageIo.h"
+#include "cinder/Timer.h"
 #include "cinder/Utilities.h"
-#include "cinder/gl/TileRender.h"
 
 using namespace ci;
 using namespace ci::app;
+using namespace std;
 
+// Renders the scene at many times the window's resolution with gl::TileRender and reports throughput in megapixels per second.
+// Press space to stream a 20000x12000 PNG to the home directory a row of tiles at a time, or 's' to assemble a 3x Surface in memory and write it with writeImage().
 class GLTileRenderTestApp : public App {
- public:
-	void setup();
-	void keyDown( KeyEvent event );
+  public:
+	void setup() override;
+	void keyDown( KeyEvent event ) override;
+	void update() override;
+	void draw() override;
 
-	void update();
-	void drawFrame();
-	void draw();
-	
-	CameraPersp mCam;
-	float		mCurrentRotation;
-};
+  private:
+	void	drawScene();
+	void	renderTiled( int32_t width, int32_t height, bool stream );
 
-static GLubyte smiley[] = // 16x16 smiley face, courtesy of OpenGL Super Bible
-{
-	0x03, 0xc0, 0, 0, /*       ****       */
-	0x0f, 0xf0, 0, 0, /*     ********     */
-	0x1e, 0x78, 0, 0, /*    ****  ****    */
-	0x39, 0x9c, 0, 0, /*   ***  **  ***   */
-	0x77, 0xee, 0, 0, /*  *** ****** ***  */
-	0x6f, 0xf6, 0, 0, /*  ** ******** **  */
-	0xff, 0xff, 0, 0, /* **************** */
-	0xff, 0xff, 0, 0, /* **************** */
-	0xff, 0xff, 0, 0, /* **************** */
-	0xff, 0xff, 0, 0, /* **************** */
-	0x73, 0xce, 0, 0, /*  ***  ****  ***  */
-	0x73, 0xce, 0, 0, /*  ***  ****  ***  */
-	0x3f, 0xfc, 0, 0, /*   ************   */
-	0x1f, 0xf8, 0, 0, /*    **********    */
-	0x0f, 0xf0, 0, 0, /*     ********     */
-	0x03, 0xc0, 0, 0  /*       ****       */
+	CameraPersp		mCam;
+	gl::BatchRef	mTorus;
+	float			mRotation;
 };
 
 void GLTileRenderTestApp::setup()
 {
-	CameraPersp cam;
-	mCam.lookAt( vec3( 0, 0, 10 ), vec3::zero() );
+	mCam.lookAt( vec3( 0, 0, 10 ), vec3( 0 ) );
 	mCam.setPerspective( 60.0f, getWindowAspectRatio(), 1, 50 );
+	mTorus = gl::Batch::create( geom::Torus().subdivisionsAxis( 64 ).subdivisionsHeight( 32 ).radius( 2, 1 ), gl::getStockShader( gl::ShaderDef().lambert().color() ) );
+	mRotation = 0;
 }
 
 void GLTileRenderTestApp::keyDown( KeyEvent event )
 {
-	if( event.getChar() == ' ' ) {
-		gl::TileRender tr( getWindowWidth() * 3, getWindowHeight() * 3, 11, 131 );
-		tr.setMatrices( mCam );
-		while( tr.nextTile() ) {
-			drawFrame();
-		}
-		writeImage( getHomeDirectory() + "tileRenderOutput.png", tr.getSurface() );
-	}
+	if( event.getChar() == ' ' )
+		renderTiled( 20000, 12000, true );
+	else if( event.getChar() == 's' )
+		renderTiled( getWindowWidth() * 3, getWindowHeight() * 3, false );
+}
+
+void GLTileRenderTestApp::renderTiled( int32_t width, int32_t height, bool stream )
+{
+	// the frustum is stretched over the image, so its aspect ratio has to match
+	CameraPersp cam = mCam;
+	cam.setAspectRatio( width / (float)height );
+
+	fs::path path = getHomeDirectory() / "tileRenderOutput.png";
+	Timer timer( true );
+	gl::TileRender tr( width, height, 1024, 1024 );
+	if( stream )
+		tr.setOutput( path );
+	tr.setMatrices( cam );
+	while( tr.nextTile() )
+		drawScene();
+	if( ! stream )
+		writeImage( path, tr.getSurface() );
+	timer.stop();
+
+	double megapixels = width * (double)height / 1e6;
+	console() << ( stream ? "streamed " : "assembled " ) << width << "x" << height << " in " << tr.getNumTiles() << " tiles: "
+			<< timer.getSeconds() << " s, " << megapixels / timer.getSeconds() << " MP/s" << endl;
 }
 
 void GLTileRenderTestApp::update()
 {
-	mCurrentRotation = getElapsedSeconds() * 3;
+	mRotation = (float)getElapsedSeconds();
 }
 
-void GLTileRenderTestApp::drawFrame()
+void GLTileRenderTestApp::drawScene()
 {
-	glClearColor( 0.1f, 0.1f, 0.3f, 1.0f );
-	glClear( GL_COLOR_BUFFER_BIT );
-		
-	gl::pushModelView();
-		glRotatef( mCurrentRotation, 0, 0, 1.0f );
-		glBegin( GL_TRIANGLES );
-			glColor3f( 1, 0, 0 );
-			glVertex2f( 0, -5 );
-			glColor3f( 0, 1, 0 );
-			glVertex2f( 5, 5 );
-			glColor3f( 0, 0, 1 );
-			glVertex2f( -5, 5 );
-		glEnd();
-	gl::popModelView();
-	
-	glLineWidth( 17.0f );
-	glColor3f( 1, 0.5f, 0.25f );
-	glBegin( GL_LINE_LOOP );
-		glVertex2f( 0, 5 );
-		glVertex2f( -5, -5 );
-		glVertex2f( 3, -3 );
-		glVertex2f( 7, -7 );
-		glVertex2f( 7, 7 );
-		glVertex2f( -1, 2 );
-	glEnd();	
-	
-	glColor3f( 1, 1, 0 );
-	glRasterPos2i( 0, 0 );
-	glBitmap( 16, 16, 0.0, 0.0, 0, 0, smiley );
+	gl::clear( Color( 0.1f, 0.1f, 0.3f ) );
+	gl::ScopedDepth depthScp( true );
+
+	for( int i = 0; i < 5; ++i ) {
+		gl::ScopedModelMatrix modelScp;
+		gl::translate( vec3( ( i - 2 ) * 3.0f, 0, -i * 2.0f ) );
+		gl::rotate( mRotation + i, vec3( 1, 1, 0 ) );
+		gl::color( Color( CM_HSV, i / 5.0f, 0.7f, 1 ) );
+		mTorus->draw();
+	}
+
+	// thin lines make seams between tiles easy to spot
+	gl::color( Color( 1, 0.5f, 0.25f ) );
+	for( int i = -10; i <= 10; ++i )
+		gl::drawLine( vec3( i, -10, -5 ), vec3( -i, 10, -5 ) );
 }
 
 void GLTileRenderTestApp::draw()
 {
 	gl::setMatrices( mCam );
-
-	drawFrame();
+	drawScene();
 }
 
-CINDER_APP( GLTileRenderTestApp, RendererGL )
+CINDER_APP( GLTileRenderTestApp, RendererGl )
@@ -1,10 +1,14 @@
 #include "cinder/app/App.h"
 #include "cinder/Json.h"
+#include "cinder/JsonDocument.h"
+#include "cinder/Timer.h"
 
 #include "Resources.h"
 
 #include "jsoncpp/json.h"
 
+#include <sstream>
+
 using namespace ci;
 using namespace ci::app;
 using namespace std;
@@ -16,6 +20,8 @@ class JsonTestApp : public App {
 	void setup();
 
 	void testComments();
+	void testDocument();
+	void benchmarkDocument();
 };
 
 void JsonTestApp::setup()
@@ -86,6 +92,8 @@ void JsonTestApp::setup()
 	console() << test64.getValue() << endl;
 
 	testComments();
+	testDocument();
+	benchmarkDocument();
 
 	console() << "complete." << endl;
 }
@@ -180,4 +188,80 @@ void JsonTestApp::testComments()
 	}
 }
 
+void JsonTestApp::testDocument()
+{
+	console() << "testing JsonDocument.." << endl;
+
+	// members are sorted when serialized through jsoncpp, so the order of the document doesn't matter here
+	string library = loadString( loadResource( RES_JSON ) );
+	JsonTree parsed( library );
+	JsonTree converted( JsonDocument::create( library ) );
+	console() << "JsonTree from JsonDocument matches: " << ( parsed.serialize() == converted.serialize() ) << endl;
+	console() << "Path: " << converted.getChild( "library.owner.city" ).getPath() << endl;
+
+	JsonDocumentRef doc = JsonDocument::create( string( "{ \"values\": [ 1, -2, 0.5, 1e300, 18446744073709551615 ], \"text\": \"caf\\u00e9 \\\"quoted\\\"\" }" ) );
+	const JsonValue &values = doc->getRoot()["values"];
+	for( const JsonValue &value : values )
+		console() << value.getDouble() << " ";
+	console() << "last as uint64: " << values[4].getUInt64() << endl;
+	console() << "text: " << doc->getRoot()["text"].getString() << endl;
+
+	try {
+		JsonDocument::create( string( "{ \"a\": [ 1, 2 }" ) );
+	}
+	catch( JsonTree::ExcJsonParserError &exc ) {
+		console() << "expected error: " << exc.what() << endl;
+	}
+
+	struct CountingHandler : public JsonSaxHandler {
+		CountingHandler() : mNumValues( 0 ) {}
+		bool onInt( int64_t value ) override		{ ++mNumValues; return true; }
+		bool onDouble( double value ) override		{ ++mNumValues; return true; }
+		bool onString( const char *str, size_t length ) override	{ ++mNumValues; return true; }
+		size_t mNumValues;
+	} handler;
+	parseJson( loadResource( RES_JSON ), &handler );
+	console() << "SAX numbers and strings: " << handler.mNumValues << endl;
+}
+
+// generates about 30 MB of JSON in memory, and compares parsing it with JsonTree, JsonDocument and parseJson()
+void JsonTestApp::benchmarkDocument()
+{
+	ostringstream ss;
+	ss << "{\"objects\":[";
+	for( int i = 0; i < 200000; ++i ) {
+		ss << ( i ? "," : "" ) << "{\"name\":\"object_" << i << "\",\"id\":" << i << ",\"visible\":" << ( i % 2 ? "true" : "false" )
+			<< ",\"position\":[" << i * 0.25 << "," << i * -1.5 << "," << i / 3.0 << "],\"tags\":[\"a\",\"b\\tc\"],"
+			<< "\"transform\":{\"scale\":1.5,\"rotation\":[0,0.7071,0,0.7071]}}";
+	}
+	ss << "]}";
+	BufferRef buffer = Buffer::create( ss.str().size() );
+	memcpy( buffer->getData(), ss.str().data(), buffer->getSize() );
+	double megabytes = buffer->getSize() / 1e6;
+	console() << "benchmarking " << megabytes << " MB.." << endl;
+
+	Timer timer( true );
+	JsonDocumentRef doc = JsonDocument::create( DataSourceBuffer::create( buffer ) );
+	timer.stop();
+	console() << "JsonDocument: " << timer.getSeconds() * 1000 << " ms, " << megabytes / timer.getSeconds() << " MB/s, "
+			<< doc->getAllocatedSize() / 1e6 << " MB allocated" << endl;
+
+	timer.start();
+	JsonTree lazy( doc );
+	double x = lazy.getChild( "objects[1000].position[1]" ).getValue<double>();
+	timer.stop();
+	console() << "JsonTree from JsonDocument, one lookup: " << timer.getSeconds() * 1000 << " ms (" << x << ")" << endl;
+
+	struct NullHandler : public JsonSaxHandler {} handler;
+	timer.start();
+	parseJson( static_cast<const char*>( buffer->getData() ), buffer->getSize(), &handler );
+	timer.stop();
+	console() << "parseJson: " << timer.getSeconds() * 1000 << " ms, " << megabytes / timer.getSeconds() << " MB/s" << endl;
+
+	timer.start();
+	JsonTree tree( DataSourceBuffer::create( buffer ) );
+	timer.stop();
+	console() << "JsonTree: " << timer.getSeconds() * 1000 << " ms, " << megabytes / timer.getSeconds() << " MB/s" << endl;
+}
+
 CINDER_APP( JsonTestApp, Renderer2d )
@@ -0,0 +1,206 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/Log.h"
+#include "cinder/CinderAssert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Logs from many threads into a file with synchronous writes, async logging that blocks when its queue is full, and async logging
+// that drops records, then reports throughput and the latency of individual CI_LOG_I calls. Results are written to the console.
+class LogTestApp : public App {
+  public:
+	void setup() override;
+	void draw() override;
+
+  private:
+	enum Mode { SYNC, ASYNC_BLOCK, ASYNC_DROP };
+
+	void	runBenchmark( Mode mode, int numThreads, int recordsPerThread );
+	void	runFilteredBenchmark();
+	void	runReentrantTest();
+	void	runReconfigureTest();
+
+	fs::path	mLogPath;
+};
+
+void LogTestApp::setup()
+{
+	mLogPath = getAppPath() / "LogTest.log";
+
+	for( int numThreads : { 1, 4, 16 } ) {
+		for( Mode mode : { SYNC, ASYNC_BLOCK, ASYNC_DROP } )
+			runBenchmark( mode, numThreads, 20000 );
+	}
+	runFilteredBenchmark();
+	runReentrantTest();
+	runReconfigureTest();
+
+	log::manager()->restoreToDefault();
+	fs::remove( mLogPath );
+}
+
+void LogTestApp::runBenchmark( Mode mode, int numThreads, int recordsPerThread )
+{
+	log::manager()->resetLogger( new log::LoggerFileThreadSafe( mLogPath, false ) );
+	if( mode == ASYNC_BLOCK )
+		log::manager()->enableAsyncLogging( 8192, log::OVERFLOW_BLOCK );
+	else if( mode == ASYNC_DROP )
+		log::manager()->enableAsyncLogging( 1024, log::OVERFLOW_DROP );
+
+	vector<vector<double>> latencies( numThreads );
+	vector<thread> threads;
+	auto start = chrono::steady_clock::now();
+	for( int t = 0; t < numThreads; ++t ) {
+		threads.emplace_back( [&, t] {
+			auto &threadLatencies = latencies[t];
+			threadLatencies.reserve( recordsPerThread );
+			for( int i = 0; i < recordsPerThread; ++i ) {
+				auto before = chrono::steady_clock::now();
+				CI_LOG_I( "worker " << t << " record " << i << " value " << i * 0.5f );
+				threadLatencies.push_back( chrono::duration<double, micro>( chrono::steady_clock::now() - before ).count() );
+			}
+		} );
+	}
+	for( auto &thread : threads )
+		thread.join();
+	double callSeconds = chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+
+	// throughput counts the time for every record to reach the file
+	size_t numDropped = log::manager()->getNumDroppedRecords();
+	log::manager()->disableAsyncLogging();
+	double totalSeconds = chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+
+	vector<double> all;
+	for( auto &threadLatencies : latencies )
+		all.insert( all.end(), threadLatencies.begin(), threadLatencies.end() );
+	sort( all.begin(), all.end() );
+
+	const char *names[] = { "sync", "async block", "async drop" };
+	size_t numRecords = all.size();
+	console() << names[mode] << ", " << numThreads << " threads: " << ( numRecords - numDropped ) / totalSeconds / 1000 << "k records/s written, "
+			<< numRecords / callSeconds / 1000 << "k calls/s, latency p50 " << all[numRecords / 2] << " us, p99 " << all[numRecords * 99 / 100]
+			<< " us, max " << all.back() << " us";
+	if( mode == ASYNC_DROP )
+		console() << ", " << numDropped << " dropped";
+	console() << endl;
+}
+
+// records below the manager's level are discarded before the message is formatted
+void LogTestApp::runFilteredBenchmark()
+{
+	log::manager()->resetLogger( new log::LoggerFileThreadSafe( mLogPath, false ) );
+	log::manager()->setLevel( log::LEVEL_WARNING );
+
+	const int numRecords = 1000000;
+	auto start = chrono::steady_clock::now();
+	for( int i = 0; i < numRecords; ++i )
+		CI_LOG_I( "filtered record " << i << " value " << i * 0.5f );
+	double seconds = chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+
+	console() << "filtered below LEVEL_WARNING: " << seconds / numRecords * 1e9 << " ns per call" << endl;
+	log::manager()->setLevel( log::LEVEL_VERBOSE );
+}
+
+// a Logger which logs from its own write(), as one reporting its own I/O errors might
+class LoggerReentrant : public log::Logger {
+  public:
+	LoggerReentrant() : mNumWritten( 0 ), mNumNested( 0 ), mInWrite( false ) {}
+
+	void write( const log::Metadata &meta, const string &text ) override
+	{
+		++mNumWritten;
+		if( mInWrite )
+			++mNumNested;
+		else {
+			mInWrite = true;
+			CI_LOG_W( "nested record for " << text );
+			mInWrite = false;
+		}
+	}
+
+	atomic<size_t>	mNumWritten, mNumNested;
+	bool			mInWrite;
+};
+
+// under OVERFLOW_BLOCK, records logged by the background thread itself must not wait for room in the queue
+void LogTestApp::runReentrantTest()
+{
+	LoggerReentrant *logger = new LoggerReentrant;
+	log::manager()->resetLogger( logger );
+	log::manager()->enableAsyncLogging( 16, log::OVERFLOW_BLOCK );
+
+	const int numThreads = 4, recordsPerThread = 10000;
+	vector<thread> threads;
+	for( int t = 0; t < numThreads; ++t ) {
+		threads.emplace_back( [=] {
+			for( int i = 0; i < recordsPerThread; ++i )
+				CI_LOG_I( "worker " << t << " record " << i );
+		} );
+	}
+	for( auto &thread : threads )
+		thread.join();
+	log::manager()->disableAsyncLogging();
+
+	console() << "reentrant Logger: " << logger->mNumWritten << " records written, " << logger->mNumNested << " of them from the background thread" << endl;
+}
+
+// counts records into a total shared by every instance, so records survive the Logger that was current when they were queued
+class LoggerCounting : public log::Logger {
+  public:
+	LoggerCounting( atomic<size_t> *numWritten ) : mNumWritten( numWritten ) {}
+
+	void write( const log::Metadata &/*meta*/, const string &/*text*/ ) override	{ ++*mNumWritten; }
+
+	atomic<size_t>	*mNumWritten;
+};
+
+// Loggers are reset, added and removed while records are still queued, which must neither race with the background thread
+// nor lose records. The first Logger only counts records written before the stack changes.
+void LogTestApp::runReconfigureTest()
+{
+	atomic<size_t> numWritten( 0 ), numWrittenFirst( 0 );
+	log::manager()->resetLogger( new LoggerCounting( &numWrittenFirst ) );
+	log::manager()->enableAsyncLogging( 64, log::OVERFLOW_BLOCK );
+
+	const int numThreads = 4, recordsPerThread = 10000;
+	for( int i = 0; i < 100; ++i )
+		CI_LOG_I( "queued before reconfiguring " << i );
+	// records queued before the stack changes are written to the previous Logger
+	log::manager()->resetLogger( new LoggerCounting( &numWritten ) );
+	CI_ASSERT( numWrittenFirst == 100 );
+
+	vector<thread> threads;
+	for( int t = 0; t < numThreads; ++t ) {
+		threads.emplace_back( [=] {
+			for( int i = 0; i < recordsPerThread; ++i )
+				CI_LOG_I( "worker " << t << " record " << i );
+		} );
+	}
+	for( int i = 0; i < 1000; ++i ) {
+		log::Logger *extra = new LoggerCounting( &numWritten );
+		log::manager()->addLogger( extra );
+		log::manager()->removeLogger( extra );
+		log::manager()->resetLogger( new LoggerCounting( &numWritten ) );
+	}
+	for( auto &thread : threads )
+		thread.join();
+	log::manager()->disableAsyncLogging();
+
+	console() << "reconfigured Logger: " << numWritten << " of " << numThreads * recordsPerThread << " records written" << endl;
+	CI_ASSERT( numWritten >= numThreads * recordsPerThread );
+}
+
+void LogTestApp::draw()
+{
+	gl::clear();
+}
+
+CINDER_APP( LogTestApp, RendererGl )
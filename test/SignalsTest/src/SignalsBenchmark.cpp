@@ -105,6 +105,65 @@ static void benchSignalEmissionGroups()
 	<< endl;
 }
 
+// profile time for emission with \a numSlots slots, connected as function pointers or as lambdas capturing a pointer
+static void benchSignalEmissionN( uint64_t numSlots, bool lambdas )
+{
+	Signal<void ( void*, uint64_t )> sigIncrement;
+	uint64_t *counter = &sTestCounter;
+	for( uint64_t s = 0; s < numSlots; s++ ) {
+		if( lambdas )
+			sigIncrement.connect( [counter]( void*, uint64_t v ) { *counter += v; } );
+		else
+			sigIncrement.connect( testCounterAdd2 );
+	}
+
+	const uint64_t numEmissions = 10000000 / numSlots;
+	const uint64_t startCounter = TestCounter::get();
+	const uint64_t benchStart = timestampBenchmark();
+
+	uint64_t i;
+	for( i = 0; i < numEmissions; i++ )
+		sigIncrement.emit( nullptr, 1 );
+
+	const uint64_t benchDone = timestampBenchmark();
+	const uint64_t endCounter = TestCounter::get();
+
+	assert( endCounter - startCounter == ( i * numSlots ) );
+
+	cout << "OK" << endl;
+	cout << "\tper emission: " << double( benchDone - benchStart ) / double( i ) << "ns"
+	<< ", per slot: " << double( benchDone - benchStart ) / double( i * numSlots ) << "ns"
+	<< endl;
+}
+
+// profile time for emission with \a numSlots slots, while one slot disconnects and another connects during every emission
+static void benchSignalEmissionChurn( uint64_t numSlots )
+{
+	Signal<void ( void*, uint64_t )> sigIncrement;
+	for( uint64_t s = 0; s < numSlots; s++ )
+		sigIncrement.connect( testCounterAdd2 );
+
+	Connection churn = sigIncrement.connect( testCounterAdd2 );
+	sigIncrement.connect( [&]( void*, uint64_t ) {
+		churn.disconnect();
+		churn = sigIncrement.connect( testCounterAdd2 );
+	} );
+
+	const uint64_t numEmissions = 1000000;
+	const uint64_t benchStart = timestampBenchmark();
+
+	uint64_t i;
+	for( i = 0; i < numEmissions; i++ )
+		sigIncrement.emit( nullptr, 1 );
+
+	const uint64_t benchDone = timestampBenchmark();
+
+	assert( sigIncrement.getNumSlots() == numSlots + 2 );
+
+	cout << "OK" << endl;
+	cout << "\tper emission: " << double( benchDone - benchStart ) / double( i ) << "ns" << endl;
+}
+
 // the time of a plain callback
 static void benchPlainCallbackLoop()
 {
@@ -156,6 +215,14 @@ int main()
 	benchSignalEmission5();
 	cout << "Benchmark: emmission with groups (2 groups, 4 slots): ";
 	benchSignalEmissionGroups();
+	for( uint64_t numSlots : { 1, 10, 100 } ) {
+		cout << "Benchmark: emission (" << numSlots << " function pointer slots): ";
+		benchSignalEmissionN( numSlots, false );
+		cout << "Benchmark: emission (" << numSlots << " lambda slots): ";
+		benchSignalEmissionN( numSlots, true );
+	}
+	cout << "Benchmark: emission with a disconnect and connect per emission (10 slots): ";
+	benchSignalEmissionChurn( 10 );
 	cout << "Benchmark: plain callback loop: ";
 	benchPlainCallbackLoop();
 	cout << "Benchmark: std::function callback loop: ";
@@ -5,6 +5,8 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <atomic>
+#include <thread>
 
 using namespace std;
 using namespace ci;
@@ -555,6 +557,136 @@ struct TestConnectionToggling {
 	}
 };
 
+struct TestDisconnectDuringEmit {
+	static void run()
+	{
+		Signal<void (int)> signal;
+		int sum = 0;
+
+		// a slot disconnecting itself and the slot after it, which must not be called
+		Connection self, next;
+		self = signal.connect( [&]( int amount ) { sum += amount; self.disconnect(); next.disconnect(); } );
+		next = signal.connect( [&]( int amount ) { sum += 100; } );
+		auto last = signal.connect( [&]( int amount ) { sum += amount; } );
+
+		signal.emit( 1 );
+		assert( sum == 2 );
+		assert( ! self.isConnected() );
+		assert( ! next.isConnected() );
+		assert( last.isConnected() );
+		assert( signal.getNumSlots() == 1 );
+
+		signal.emit( 1 );
+		assert( sum == 3 );
+	}
+};
+
+struct TestConnectDuringEmit {
+	static void run()
+	{
+		Signal<void (int)> signal;
+		int sum = 0;
+		Connection added;
+
+		// slots connected during an emission are first called by the next one
+		signal.connect( [&]( int amount ) {
+			if( ! added.isConnected() )
+				added = signal.connect( 1, [&]( int amount ) { sum += amount * 10; } );
+			sum += amount;
+		} );
+
+		signal.emit( 1 );
+		assert( sum == 1 );
+		assert( added.isConnected() );
+		assert( signal.getNumSlots() == 2 );
+
+		signal.emit( 1 );
+		assert( sum == 12 );
+	}
+};
+
+struct TestArgumentsByReference {
+	struct CopyCounter {
+		CopyCounter( int *numCopies ) : mNumCopies( numCopies ) {}
+		CopyCounter( const CopyCounter &other ) : mNumCopies( other.mNumCopies ) { ++*mNumCopies; }
+
+		int *mNumCopies;
+	};
+
+	static void run()
+	{
+		Signal<void ( CopyCounter )> signal;
+		for( int i = 0; i < 10; i++ )
+			signal.connect( []( const CopyCounter & ) {} );
+
+		int numCopies = 0;
+		signal.emit( CopyCounter( &numCopies ) );
+		assert( numCopies == 0 );
+	}
+};
+
+struct TestThreadSafeEmit {
+	static void run()
+	{
+		Signal<void (int)> signal;
+		signal.setThreadSafe();
+		assert( signal.isThreadSafe() );
+
+		std::atomic<int> sum( 0 );
+		signal.connect( [&]( int amount ) { sum += amount; } );
+
+		// connections come and go while other threads emit
+		std::vector<std::thread> threads;
+		for( int t = 0; t < 4; t++ ) {
+			threads.emplace_back( [&] {
+				for( int i = 0; i < 10000; i++ )
+					signal.emit( 1 );
+			} );
+		}
+		for( int i = 0; i < 1000; i++ ) {
+			auto connection = signal.connect( []( int ) {} );
+			connection.disconnect();
+		}
+		for( auto &thread : threads )
+			thread.join();
+
+		assert( sum == 40000 );
+		assert( signal.getNumSlots() == 1 );
+	}
+};
+
+struct TestVoidSignalDiscardsResult {
+	struct A {
+		A() : mAccum( 0 ) {}
+		bool boolMethod( int amount )	{ mAccum += amount; return true; }
+
+		int mAccum;
+	};
+
+	static int sCalls;
+	static int intFn()	{ return ++sCalls; }
+
+	static void run()
+	{
+		// callables returning a value can be connected to signals returning void
+		Signal<void ()> sig;
+		int lambdaCalls = 0;
+		sig.connect( &intFn );
+		sig.connect( [&] { return ++lambdaCalls; } );
+		sig.emit();
+		assert( sCalls == 1 );
+		assert( lambdaCalls == 1 );
+
+		A a;
+		Signal<void (int)> sigInt;
+		sigInt.connect( std::bind( &A::boolMethod, &a, std::placeholders::_1 ) );
+		sigInt.emit( 3 );
+		assert( a.mAccum == 3 );
+	}
+};
+
+int TestVoidSignalDiscardsResult::sCalls = 0;
+
 template <typename TestT>
 void runTest()
 {
@@ -578,5 +710,10 @@ int main()
 	runTest<TestCollectorBitwiseAnd>();
 	runTest<TestCollectorAppEvent>();
 	runTest<TestConnectionToggling>();
+	runTest<TestDisconnectDuringEmit>();
+	runTest<TestConnectDuringEmit>();
+	runTest<TestArgumentsByReference>();
+	runTest<TestThreadSafeEmit>();
+	runTest<TestVoidSignalDiscardsResult>();
 	return 0;
 }
\ No newline at end of file
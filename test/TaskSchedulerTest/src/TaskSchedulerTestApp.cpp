@@ -0,0 +1,302 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/TaskScheduler.h"
+#include "cinder/ip/Resize.h"
+#include "cinder/Surface.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <limits>
+#include <thread>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Checks task dependencies, continuations, exceptions, nested waits and the parallel helpers of the shared TaskScheduler, then measures the
+// overhead of spawning tasks and of parallelFor chunks against std::async and std::thread. Results are written to the console.
+class TaskSchedulerTestApp : public App {
+  public:
+	void setup() override;
+	void update() override;
+	void draw() override;
+
+  private:
+	void	testGraph( const TaskSchedulerRef &scheduler );
+	void	testParallel( const TaskSchedulerRef &scheduler );
+	void	testExceptions( const TaskSchedulerRef &scheduler );
+	void	benchmarkSpawn();
+	void	benchmarkParallelFor();
+	void	benchmarkResize();
+
+	TaskRef				mMainThreadTask;
+	atomic<bool>		mRanOnMainThread;
+};
+
+namespace {
+
+double secondsSince( chrono::steady_clock::time_point start )
+{
+	return chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+}
+
+} // anonymous namespace
+
+void TaskSchedulerTestApp::setup()
+{
+	console() << "shared TaskScheduler: " << TaskScheduler::get()->getNumWorkers() << " workers, " << thread::hardware_concurrency() << " cores" << endl;
+
+	// also run on more workers than cores, so that tasks are stolen and preempted mid-flight even on small machines
+	for( auto scheduler : { TaskScheduler::get(), TaskScheduler::create( TaskScheduler::Options().numThreads( 7 ) ) } ) {
+		testGraph( scheduler );
+		testParallel( scheduler );
+		testExceptions( scheduler );
+	}
+
+	benchmarkSpawn();
+	benchmarkParallelFor();
+	benchmarkResize();
+
+	// checked in update(), once the continuation has come through the event loop
+	mRanOnMainThread = false;
+	mMainThreadTask = TaskScheduler::get()->async( [] { this_thread::sleep_for( chrono::milliseconds( 10 ) ); } )->thenOnMainThread( [this] {
+		mRanOnMainThread = isPrimaryThread();
+	} );
+}
+
+// a diamond of tasks, each of which checks that everything it depends on has already run
+void TaskSchedulerTestApp::testGraph( const TaskSchedulerRef &scheduler )
+{
+	for( int iteration = 0; iteration < 1000; ++iteration ) {
+		atomic<int> order( 0 );
+		int a = -1, b = -1, c = -1, d = -1;
+		TaskRef taskA = scheduler->createTask( [&] { a = order++; } );
+		TaskRef taskB = scheduler->createTask( [&] { b = order++; } );
+		TaskRef taskC = scheduler->createTask( [&] { c = order++; } );
+		TaskRef taskD = scheduler->createTask( [&] { d = order++; } );
+		taskB->dependsOn( taskA );
+		taskC->dependsOn( taskA );
+		taskD->dependsOn( taskB );
+		taskD->dependsOn( taskC );
+		// submitted in reverse, so nothing runs before its dependencies are released
+		scheduler->submit( taskD );
+		scheduler->submit( taskC );
+		scheduler->submit( taskB );
+		scheduler->submit( taskA );
+
+		int e = -1;
+		TaskRef taskE = taskD->then( [&] { e = order++; } );
+		taskE->wait();
+		if( ! ( a < b && a < c && b < d && c < d && d < e && e == 4 ) || ! taskD->isDone() )
+			throw std::runtime_error( "task ran before its dependencies" );
+	}
+
+	// tasks that wait on other tasks run queued work instead of blocking a worker
+	atomic<int> numLeaves( 0 );
+	vector<TaskRef> roots;
+	for( int i = 0; i < 64; ++i ) {
+		roots.push_back( scheduler->async( [&] {
+			vector<TaskRef> leaves;
+			for( int j = 0; j < 64; ++j )
+				leaves.push_back( scheduler->async( [&] { ++numLeaves; } ) );
+			for( auto &leaf : leaves )
+				leaf->wait();
+		} ) );
+	}
+	for( auto &root : roots )
+		root->wait();
+	if( numLeaves != 64 * 64 )
+		throw std::runtime_error( "nested tasks" );
+
+	console() << "task graphs, " << scheduler->getNumWorkers() << " workers: passed" << endl;
+}
+
+void TaskSchedulerTestApp::testParallel( const TaskSchedulerRef &scheduler )
+{
+	for( size_t grainSize : { 1, 7, 1000, 100000 } ) {
+		const size_t begin = 13, end = 100003;
+		vector<atomic<int>> visits( end );
+		for( auto &visit : visits )
+			visit = 0;
+		scheduler->parallelFor( begin, end, grainSize, [&]( size_t chunkBegin, size_t chunkEnd ) {
+			if( chunkEnd - chunkBegin > grainSize )
+				throw std::runtime_error( "parallelFor chunk larger than the grain size" );
+			for( size_t i = chunkBegin; i < chunkEnd; ++i )
+				++visits[i];
+		} );
+		for( size_t i = 0; i < end; ++i ) {
+			if( visits[i] != ( i >= begin ? 1 : 0 ) )
+				throw std::runtime_error( "parallelFor visited an index " + to_string( visits[i] ) + " times" );
+		}
+
+		// reduced in order, so a non-commutative reduce matches the serial result
+		string expected;
+		for( size_t i = begin; i < end; i += 997 )
+			expected += to_string( i ) + ",";
+		string result = scheduler->parallelReduce( begin, end, grainSize, string(), [&]( size_t chunkBegin, size_t chunkEnd ) {
+			string part;
+			for( size_t i = chunkBegin; i < chunkEnd; ++i ) {
+				if( ( i - begin ) % 997 == 0 )
+					part += to_string( i ) + ",";
+			}
+			return part;
+		}, []( const string &a, const string &b ) { return a + b; } );
+		if( result != expected )
+			throw std::runtime_error( "parallelReduce" );
+	}
+
+	// parallelFor nested inside a parallelFor
+	atomic<size_t> total( 0 );
+	scheduler->parallelFor( 0, 100, 1, [&]( size_t, size_t ) {
+		scheduler->parallelFor( 0, 1000, 10, [&]( size_t chunkBegin, size_t chunkEnd ) { total += chunkEnd - chunkBegin; } );
+	} );
+	if( total != 100 * 1000 )
+		throw std::runtime_error( "nested parallelFor" );
+
+	console() << "parallelFor and parallelReduce, " << scheduler->getNumWorkers() << " workers: passed" << endl;
+}
+
+void TaskSchedulerTestApp::testExceptions( const TaskSchedulerRef &scheduler )
+{
+	bool ranContinuation = false;
+	TaskRef task = scheduler->async( [] { throw std::runtime_error( "expected" ); } );
+	TaskRef continuation = task->then( [&] { ranContinuation = true; } );
+	continuation->wait();
+
+	bool caught = false;
+	try {
+		task->wait();
+	}
+	catch( std::runtime_error & ) {
+		caught = true;
+	}
+
+	bool caughtParallel = false;
+	try {
+		scheduler->parallelFor( 0, 1000, 1, [&]( size_t begin, size_t ) {
+			if( begin == 500 )
+				throw std::runtime_error( "expected" );
+		} );
+	}
+	catch( std::runtime_error & ) {
+		caughtParallel = true;
+	}
+
+	if( ! caught || ! caughtParallel || ! ranContinuation )
+		throw std::runtime_error( "task exceptions" );
+	console() << "exceptions, " << scheduler->getNumWorkers() << " workers: passed" << endl;
+}
+
+void TaskSchedulerTestApp::benchmarkSpawn()
+{
+	TaskSchedulerRef scheduler = TaskScheduler::get();
+	atomic<int> counter( 0 );
+	const int count = 100000;
+
+	// one task at a time, so this is the round trip of submitting, running and waiting
+	auto start = chrono::steady_clock::now();
+	for( int i = 0; i < count; ++i )
+		scheduler->async( [&] { ++counter; } )->wait();
+	console() << "async + wait: " << secondsSince( start ) / count * 1e9 << " ns per task" << endl;
+
+	// many tasks in flight
+	start = chrono::steady_clock::now();
+	vector<TaskRef> tasks;
+	tasks.reserve( count );
+	for( int i = 0; i < count; ++i )
+		tasks.push_back( scheduler->async( [&] { ++counter; } ) );
+	for( auto &task : tasks )
+		task->wait();
+	console() << count << " tasks in flight: " << secondsSince( start ) / count * 1e9 << " ns per task" << endl;
+
+	// a chain of continuations
+	start = chrono::steady_clock::now();
+	TaskRef last = scheduler->async( [&] { ++counter; } );
+	for( int i = 1; i < count; ++i )
+		last = last->then( [&] { ++counter; } );
+	last->wait();
+	console() << "chain of " << count << " continuations: " << secondsSince( start ) / count * 1e9 << " ns per task" << endl;
+
+	const int threadCount = count / 10;
+	start = chrono::steady_clock::now();
+	for( int i = 0; i < threadCount; ++i )
+		std::async( std::launch::async, [&] { ++counter; } ).wait();
+	console() << "std::async + wait: " << secondsSince( start ) / threadCount * 1e9 << " ns per task" << endl;
+
+	start = chrono::steady_clock::now();
+	for( int i = 0; i < threadCount; ++i )
+		thread( [&] { ++counter; } ).join();
+	console() << "std::thread + join: " << secondsSince( start ) / threadCount * 1e9 << " ns per task" << endl;
+}
+
+void TaskSchedulerTestApp::benchmarkParallelFor()
+{
+	TaskSchedulerRef scheduler = TaskScheduler::get();
+	const size_t count = 1 << 22;
+	vector<float> values( count );
+	for( size_t i = 0; i < count; ++i )
+		values[i] = i * 0.001f;
+
+	auto work = [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i )
+			values[i] = sqrt( values[i] + 1 );
+	};
+
+	// the best of several runs, since the differences are small next to the loop itself
+	auto bestOf = [&]( const function<void()> &fn ) {
+		double best = numeric_limits<double>::max();
+		for( int run = 0; run < 5; ++run ) {
+			auto start = chrono::steady_clock::now();
+			fn();
+			best = std::min( best, secondsSince( start ) );
+		}
+		return best;
+	};
+
+	double serialSeconds = bestOf( [&] { work( 0, count ); } );
+	console() << "serial loop over " << count << " floats: " << serialSeconds * 1000 << " ms" << endl;
+
+	for( size_t grainSize : { 64, 1024, 16384, 262144 } ) {
+		double seconds = bestOf( [&] { scheduler->parallelFor( 0, count, grainSize, work ); } );
+		size_t numChunks = ( count + grainSize - 1 ) / grainSize;
+		console() << "parallelFor, grain " << grainSize << ": " << seconds * 1000 << " ms, " << ( seconds - serialSeconds ) / numChunks * 1e9 << " ns overhead per chunk" << endl;
+	}
+
+	auto start = chrono::steady_clock::now();
+	double sum = scheduler->parallelReduce( 0, count, 16384, 0.0, [&]( size_t begin, size_t end ) {
+		double partial = 0;
+		for( size_t i = begin; i < end; ++i )
+			partial += values[i];
+		return partial;
+	}, []( double a, double b ) { return a + b; } );
+	console() << "parallelReduce, grain 16384: " << secondsSince( start ) * 1000 << " ms (sum " << sum << ")" << endl;
+}
+
+void TaskSchedulerTestApp::benchmarkResize()
+{
+	Surface8u source( 4096, 4096, true );
+	uint8_t *data = source.getData();
+	for( size_t i = 0; i < source.getRowBytes() * source.getHeight(); ++i )
+		data[i] = static_cast<uint8_t>( i * 7 + ( i >> 12 ) );
+
+	auto start = chrono::steady_clock::now();
+	Surface8u result = ip::resizeCopy( source, source.getBounds(), ivec2( 1920, 1080 ) );
+	console() << "ip::resize 4096x4096 to 1920x1080: " << secondsSince( start ) * 1000 << " ms" << endl;
+}
+
+void TaskSchedulerTestApp::update()
+{
+	if( mMainThreadTask && mMainThreadTask->isDone() ) {
+		console() << "thenOnMainThread: " << ( mRanOnMainThread ? "passed" : "FAILED" ) << endl;
+		mMainThreadTask.reset();
+	}
+}
+
+void TaskSchedulerTestApp::draw()
+{
+	gl::clear();
+}
+
+CINDER_APP( TaskSchedulerTestApp, RendererGl )
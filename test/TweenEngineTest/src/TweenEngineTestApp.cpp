@@ -0,0 +1,158 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/Timeline.h"
+#include "cinder/TweenEngine.h"
+#include "cinder/Rand.h"
+#include "cinder/Timer.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Animates 100k points with a TweenEngine and reports CPU time per step. Press 't' to compare against a Timeline, and
+// 's' to toggle between every tween running at once and tweens staggered over 100 seconds, where most of them are idle.
+class TweenEngineTestApp : public App {
+  public:
+	void setup() override;
+	void keyDown( KeyEvent event ) override;
+	void update() override;
+	void draw() override;
+
+  private:
+	void	createTweens();
+	void	checkAgainstTimeline();
+
+	vector<Anim<vec2>>	mPositions;
+	vector<Anim<Color>>	mColors;
+	TimelineRef			mTimeline;
+	TweenEngineRef		mEngine;
+	bool				mUseTimeline, mStaggered;
+
+	double				mStepSeconds;
+	size_t				mNumFrames;
+};
+
+static const int NUM_POINTS = 100000;
+
+void TweenEngineTestApp::setup()
+{
+	// a separate Timeline from the app's, so that both are stepped the same way
+	mTimeline = Timeline::create();
+	mEngine = TweenEngine::create();
+	mUseTimeline = false;
+	mStaggered = false;
+
+	checkAgainstTimeline();
+	createTweens();
+}
+
+void TweenEngineTestApp::createTweens()
+{
+	mTimeline->clear();
+	mEngine->clear();
+	mPositions.assign( NUM_POINTS, Anim<vec2>() );
+	mColors.assign( NUM_POINTS, Anim<Color>() );
+
+	Rand rand( 1 );
+	for( int i = 0; i < NUM_POINTS; ++i ) {
+		vec2 start( rand.nextFloat(), rand.nextFloat() ), end( rand.nextFloat(), rand.nextFloat() );
+		Color color( CM_HSV, rand.nextFloat(), 0.7f, 1 );
+		float duration = mStaggered ? 1 : rand.nextFloat( 2, 4 );
+		float delay = mStaggered ? rand.nextFloat( 0, 100 ) : 0;
+		bool loop = ! mStaggered;
+
+		if( mUseTimeline ) {
+			mTimeline->apply( &mPositions[i], start, end, duration, EaseInOutQuad() ).delay( delay ).loop( loop );
+			mTimeline->apply( &mColors[i], Color::white(), color, duration, EaseOutCubic() ).delay( delay ).loop( loop );
+		}
+		else {
+			mEngine->apply( &mPositions[i], start, end, duration, TweenEngine::Options().ease( EASE_IN_OUT_QUAD ).delay( delay ).loop( loop ) );
+			mEngine->apply( &mColors[i], Color::white(), color, duration, TweenEngine::Options().ease( EASE_OUT_CUBIC ).delay( delay ).loop( loop ) );
+		}
+	}
+
+	mStepSeconds = 0;
+	mNumFrames = 0;
+}
+
+// runs the same tweens through a Timeline and a TweenEngine, including appended tweens and every EaseType, and reports the largest difference
+void TweenEngineTestApp::checkAgainstTimeline()
+{
+	const EaseFn easeFns[NUM_EASE_TYPES] = { EaseNone(), EaseInQuad(), EaseOutQuad(), EaseInOutQuad(), EaseInCubic(), EaseOutCubic(), EaseInOutCubic(),
+		EaseInQuart(), EaseOutQuart(), EaseInOutQuart(), EaseInQuint(), EaseOutQuint(), EaseInOutQuint(), EaseInSine(), EaseOutSine(), EaseInOutSine(),
+		EaseInExpo(), EaseOutExpo(), EaseInOutExpo(), EaseInCirc(), EaseOutCirc(), EaseInOutCirc(), EaseInBack(), EaseOutBack(), EaseInOutBack() };
+
+	TimelineRef referenceTimeline = Timeline::create();
+	TweenEngineRef engine = TweenEngine::create();
+	const int count = 1000;
+	vector<Anim<vec3>> reference( count ), result( count );
+	for( int i = 0; i < count; ++i ) {
+		int ease = i % NUM_EASE_TYPES;
+		float duration = 0.5f + ( i % 7 ) * 0.3f, delay = ( i % 5 ) * 0.2f;
+		vec3 end( i, 2 * i, -i );
+		referenceTimeline->apply( &reference[i], end, duration, easeFns[ease] ).delay( delay );
+		referenceTimeline->appendTo( &reference[i], -end, duration * 0.5f, easeFns[ease] );
+		engine->apply( &result[i], end, duration, TweenEngine::Options().ease( EaseType( ease ) ).delay( delay ) );
+		engine->appendTo( &result[i], -end, duration * 0.5f, TweenEngine::Options().ease( EaseType( ease ) ) );
+	}
+
+	float maxError = 0;
+	for( int step = 0; step < 300; ++step ) {
+		referenceTimeline->step( 1 / 60.0f );
+		engine->step( 1 / 60.0f );
+		for( int i = 0; i < count; ++i )
+			maxError = std::max( maxError, length( reference[i]() - result[i]() ) / ( 1 + length( reference[i]() ) ) );
+	}
+
+	size_t numIncomplete = 0;
+	for( auto &anim : result )
+		numIncomplete += anim.isComplete() ? 0 : 1;
+	console() << "largest relative difference from Timeline: " << maxError << ", " << numIncomplete << " Anims incomplete, " << engine->getNumTweens() << " tweens left" << endl;
+}
+
+void TweenEngineTestApp::keyDown( KeyEvent event )
+{
+	if( event.getChar() == 't' ) {
+		mUseTimeline = ! mUseTimeline;
+		createTweens();
+	}
+	else if( event.getChar() == 's' ) {
+		mStaggered = ! mStaggered;
+		createTweens();
+	}
+}
+
+void TweenEngineTestApp::update()
+{
+	Timer timer( true );
+	if( mUseTimeline )
+		mTimeline->step( 1 / 60.0f );
+	else
+		mEngine->step( 1 / 60.0f );
+	timer.stop();
+
+	if( mNumFrames > 0 )
+		mStepSeconds += timer.getSeconds();
+	if( ++mNumFrames % 120 == 0 ) {
+		console() << ( mUseTimeline ? "Timeline" : "TweenEngine" ) << ( mStaggered ? ", staggered" : ", all running" ) << ": "
+				<< mStepSeconds / ( mNumFrames - 1 ) * 1000 << " ms CPU per step" << endl;
+	}
+}
+
+void TweenEngineTestApp::draw()
+{
+	gl::clear();
+	gl::setMatricesWindow( 1, 1 );
+
+	gl::VertBatch vertBatch( GL_POINTS );
+	for( int i = 0; i < NUM_POINTS; ++i ) {
+		vertBatch.color( mColors[i] );
+		vertBatch.vertex( mPositions[i] );
+	}
+	vertBatch.draw();
+}
+
+CINDER_APP( TweenEngineTestApp, RendererGl, []( App::Settings *settings ) {
+	settings->disableFrameRate();
+} )
@@ -1,8 +1,12 @@
 #include "cinder/app/App.h"
 #include "cinder/gl/gl.h"
 #include "cinder/Xml.h"
+#include "cinder/XmlDocument.h"
+#include "cinder/Timer.h"
 #include "cinder/Utilities.h"
 
+#include <sstream>
+
 //#include "rapidxml/rapidxml.hpp"
 //#include "rapidxml/rapidxml_print.hpp"
 
@@ -16,6 +20,9 @@ class XMLTestApp : public App {
 	void mouseDown( MouseEvent event );	
 	void update();
 	void draw();
+
+	void testDocument();
+	void benchmarkDocument();
 };
 
 // Finds the track named \a searchTrack in the music library \a library. Throws XmlTree::ChildNotFoundExc() if none is found.
@@ -82,12 +89,107 @@ void XMLTestApp::setup()
 	XmlTree albumCopy = copyFirstAlbum( doc / "library" );
 	console() << ( albumCopy / "track" ).getPath() << std::endl; // should print 'newRoot/track'
 
+	testDocument();
+	benchmarkDocument();
+
 	// This code only works in VC2010
 /*	std::for_each( doc.begin( "library/album" ), doc.end(), []( const XmlTree &child ) {
 		app::console() << child.getChild( "title" ).getValue() << std::endl;
 	} );*/
 }
 
+void XMLTestApp::testDocument()
+{
+	console() << "testing XmlDocument.." << endl;
+
+	XmlDocumentRef doc = XmlDocument::create( loadFile( getAssetPath( "library.xml" ) ) );
+	ostringstream parsed, converted;
+	parsed << XmlTree( loadFile( getAssetPath( "library.xml" ) ) );
+	converted << XmlTree( doc->getRoot() );
+	console() << "XmlTree from XmlDocument matches: " << ( parsed.str() == converted.str() ) << endl;
+
+	XmlNodeView root = doc->getRoot();
+	XmlNodeView city = root.findChild( "///library/////owner/city" );
+	console() << "city: " << city.getValue().c_str() << ", case-insensitive: " << root.findChild( "LIBRARY/Owner/CITY" ).getValue().c_str()
+			<< ", case-sensitive found: " << bool( root.findChild( "LIBRARY/Owner/CITY", true ) ) << endl;
+
+	// the same tracks, in the same order, as iterating an XmlTree with the filter path
+	XmlPath tracks = doc->compilePath( "library/album/track" );
+	vector<string> fromDocument, fromTree;
+	for( const XmlNodeView &track : root.findAll( tracks ) )
+		fromDocument.push_back( track.getValue().str() + " " + track.getAttributeValue( "id" ).str() );
+	XmlTree tree( loadFile( getAssetPath( "library.xml" ) ) );
+	for( XmlTree::ConstIter track = tree.begin( "library/album/track" ); track != tree.end(); ++track )
+		fromTree.push_back( track->getValue() + " " + track->getAttribute( "id" ).getValue() );
+	console() << "findAll matches XmlTree::Iter: " << ( fromDocument == fromTree ) << " (" << fromDocument.size() << " tracks)" << endl;
+
+	XmlNodeView album = root.findChild( "library/album" );
+	for( const XmlNodeView &child : album )
+		console() << "Tag: " << child.getTag().c_str() << "  Value: " << child.getValue().c_str() << endl;
+	console() << "year: " << album.getAttributeValue( "year", 0 ) << ", missing: " << album.getAttributeValue( "label", -1 ) << endl;
+	console() << "album copied to an XmlTree: " << XmlTree( album ).getChild( "title" ).getValue() << endl;
+}
+
+// generates about 30 MB of SVG-like XML in memory, and compares loading and querying it with XmlTree and XmlDocument
+void XMLTestApp::benchmarkDocument()
+{
+	ostringstream ss;
+	ss << "<?xml version=\"1.0\"?>\n<svg width=\"1000\" height=\"1000\">\n";
+	for( int group = 0; group < 100; ++group ) {
+		ss << "<g id=\"group" << group << "\" transform=\"translate(" << group << ",0)\">\n";
+		for( int i = 0; i < 2000; ++i ) {
+			if( i % 2 )
+				ss << "<path id=\"p" << i << "\" d=\"M" << i << " 0 L" << i * 0.5 << " " << i << " Z\" fill=\"#ff0000\" stroke=\"none\"/>\n";
+			else
+				ss << "<circle id=\"c" << i << "\" cx=\"" << i << "\" cy=\"" << group << "\" r=\"2.5\" style=\"fill:blue\"><title>&lt;circle " << i << "&gt;</title></circle>\n";
+		}
+		ss << "<desc>group " << group << "</desc>\n</g>\n";
+	}
+	ss << "</svg>\n";
+	BufferRef buffer = Buffer::create( ss.str().size() );
+	memcpy( buffer->getData(), ss.str().data(), buffer->getSize() );
+	double megabytes = buffer->getSize() / 1e6;
+	console() << "benchmarking " << megabytes << " MB.." << endl;
+
+	Timer timer( true );
+	XmlDocumentRef doc = XmlDocument::create( DataSourceBuffer::create( buffer ) );
+	timer.stop();
+	console() << "XmlDocument: " << timer.getSeconds() * 1000 << " ms, " << megabytes / timer.getSeconds() << " MB/s" << endl;
+
+	timer.start();
+	XmlPath descPath = doc->compilePath( "svg/g/desc" );
+	timer.stop();
+	console() << "XmlDocument index: " << timer.getSeconds() * 1000 << " ms" << endl;
+
+	// each group's desc follows its 2000 shapes
+	timer.start();
+	size_t numFound = 0;
+	for( int i = 0; i < 1000; ++i )
+		numFound += doc->getRoot().findChild( descPath ) ? 1 : 0;
+	size_t numDescs = doc->getRoot().findAll( descPath ).size();
+	timer.stop();
+	console() << "XmlDocument 1000 getChild + findAll: " << timer.getSeconds() * 1000 << " ms (" << numFound << ", " << numDescs << ")" << endl;
+
+	timer.start();
+	XmlTree tree( DataSourceBuffer::create( buffer ) );
+	timer.stop();
+	console() << "XmlTree: " << timer.getSeconds() * 1000 << " ms, " << megabytes / timer.getSeconds() << " MB/s" << endl;
+
+	timer.start();
+	numFound = numDescs = 0;
+	for( int i = 0; i < 1000; ++i )
+		numFound += tree.hasChild( "svg/g/desc" ) ? 1 : 0;
+	for( XmlTree::ConstIter desc = tree.begin( "svg/g/desc" ); desc != tree.end(); ++desc )
+		++numDescs;
+	timer.stop();
+	console() << "XmlTree 1000 getChild + Iter: " << timer.getSeconds() * 1000 << " ms (" << numFound << ", " << numDescs << ")" << endl;
+
+	timer.start();
+	XmlTree converted( doc->getRoot().findChild( "svg/g" ) );
+	timer.stop();
+	console() << "XmlTree of one group from XmlDocument: " << timer.getSeconds() * 1000 << " ms, " << converted.getChildren().size() << " children" << endl;
+}
+
 void XMLTestApp::mouseDown( MouseEvent event )
 {
 	XmlTree doc = XmlTree::createDoc();
@@ -0,0 +1,112 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/gl/AsyncReadback.h"
+#include "cinder/Log.h"
+#include "cinder/Timer.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Compares the CPU cost per frame of Fbo::readPixels8u() against gl::AsyncReadback. Press 's' to toggle modes.
+class AsyncReadbackTestApp : public App {
+  public:
+	void setup() override;
+	void keyDown( KeyEvent event ) override;
+	void update() override;
+	void draw() override;
+
+  private:
+	void	renderScene();
+
+	gl::FboRef				mFbo;
+	gl::AsyncReadbackRef	mReadback;
+	bool					mUseAsync;
+
+	Timer					mTimer;
+	double					mReadSeconds;
+	size_t					mNumReads;
+	atomic<size_t>			mNumDelivered;
+	uint32_t				mChecksum;
+};
+
+void AsyncReadbackTestApp::setup()
+{
+	mFbo = gl::Fbo::create( 1920, 1080, gl::Fbo::Format().samples( 4 ) );
+	mReadback = gl::AsyncReadback::create( gl::AsyncReadback::Format().bgra() );
+	mReadback->setCompletionFn( [this]( const Surface8uRef &surface, uint64_t readId ) {
+		// the top-left pixel should be red, which verifies both the BGRA packing and the GPU flip
+		auto pixel = surface->getPixel( ivec2( 0, 0 ) );
+		if( pixel.r < 200 || pixel.b > 50 )
+			CI_LOG_E( "unexpected top-left pixel: " << pixel << " for read " << readId );
+		mChecksum += pixel.r;
+		++mNumDelivered;
+	} );
+
+	mUseAsync = true;
+	mReadSeconds = 0;
+	mNumReads = 0;
+	mNumDelivered = 0;
+	mChecksum = 0;
+}
+
+void AsyncReadbackTestApp::keyDown( KeyEvent event )
+{
+	if( event.getChar() == 's' ) {
+		mReadback->flush();
+		mUseAsync = ! mUseAsync;
+		mReadSeconds = 0;
+		mNumReads = 0;
+		console() << "mode: " << ( mUseAsync ? "AsyncReadback" : "readPixels8u" ) << endl;
+	}
+}
+
+void AsyncReadbackTestApp::renderScene()
+{
+	gl::ScopedFramebuffer fboScp( mFbo );
+	gl::ScopedViewport viewportScp( mFbo->getSize() );
+	gl::ScopedMatrices matricesScp;
+	gl::setMatricesWindow( mFbo->getSize() );
+
+	gl::clear( Color( 0.1f, 0.1f, 0.15f ) );
+	gl::color( Color( 1, 0, 0 ) );
+	gl::drawSolidRect( Rectf( 0, 0, 64, 64 ) );
+	gl::color( Color( 0, 1, 0 ) );
+	gl::drawSolidCircle( vec2( mFbo->getSize() ) / 2.0f + 300.0f * vec2( cos( (float)getElapsedSeconds() ), sin( (float)getElapsedSeconds() ) ), 100 );
+}
+
+void AsyncReadbackTestApp::update()
+{
+	renderScene();
+
+	mTimer.start();
+	if( mUseAsync ) {
+		mReadback->update();
+		mReadback->readPixels( mFbo );
+	}
+	else {
+		auto surface = mFbo->readPixels8u( mFbo->getBounds() );
+		mChecksum += surface.getPixel( ivec2( 0, 0 ) ).r;
+	}
+	mTimer.stop();
+
+	mReadSeconds += mTimer.getSeconds();
+	++mNumReads;
+
+	if( mNumReads % 120 == 0 ) {
+		console() << ( mUseAsync ? "AsyncReadback" : "readPixels8u" ) << ": " << mReadSeconds / mNumReads * 1000.0 << " ms per frame on the GL thread, "
+				<< getAverageFps() << " fps, delivered: " << mNumDelivered << " (" << mChecksum << ")" << endl;
+	}
+}
+
+void AsyncReadbackTestApp::draw()
+{
+	gl::clear();
+	gl::draw( mFbo->getColorTexture(), getWindowBounds() );
+}
+
+CINDER_APP( AsyncReadbackTestApp, RendererGl( RendererGl::Options().msaa( 0 ) ), []( App::Settings *settings ) {
+	settings->disableFrameRate();
+	settings->setWindowSize( 960, 540 );
+} )
@@ -0,0 +1,78 @@
+#include "cinder/app/linux/AppHeadless.h"
+#include "cinder/gl/gl.h"
+#include "cinder/Log.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Renders frames through a surfaceless EGL or OSMesa context and verifies the output. Run with "--frames N" to measure throughput; llvmpipe is sufficient.
+class HeadlessTestApp : public AppHeadless {
+  public:
+	void setup() override;
+	void draw() override;
+	void cleanup() override;
+
+  private:
+	gl::BatchRef	mBatch;
+	gl::FboRef		mSceneFbo;
+	size_t			mNumFailures;
+};
+
+void HeadlessTestApp::setup()
+{
+	console() << "GL_RENDERER: " << glGetString( GL_RENDERER ) << ", GL_VERSION: " << gl::getVersionString() << endl;
+
+	mBatch = gl::Batch::create( geom::Teapot().subdivisions( 8 ), gl::getStockShader( gl::ShaderDef().lambert() ) );
+	// an explicit Fbo as well, to make sure user Fbos compose with the renderer's default one
+	mSceneFbo = gl::Fbo::create( 256, 256 );
+	mNumFailures = 0;
+}
+
+void HeadlessTestApp::draw()
+{
+	{
+		gl::ScopedFramebuffer fboScp( mSceneFbo );
+		gl::ScopedViewport viewportScp( mSceneFbo->getSize() );
+		gl::ScopedMatrices matricesScp;
+		gl::setMatricesWindow( mSceneFbo->getSize() );
+		gl::clear( Color( 0, 0, 1 ) );
+	}
+
+	gl::clear( Color( 1, 0, 0 ) );
+	gl::enableDepthRead();
+	gl::enableDepthWrite();
+
+	CameraPersp cam( getWindowWidth(), getWindowHeight(), 50 );
+	cam.lookAt( vec3( 0, 2, 5 ), vec3( 0 ) );
+	gl::setMatrices( cam );
+	gl::rotate( (float)getElapsedSeconds(), 0, 1, 0 );
+	mBatch->draw();
+
+	gl::disableDepthRead();
+	gl::disableDepthWrite();
+	gl::setMatricesWindow( getWindowSize() );
+	gl::draw( mSceneFbo->getColorTexture(), Rectf( 0, 0, 32, 32 ) );
+
+	// verify the corners every so often; the top-left should show the blue Fbo, bottom-right the red clear color
+	if( getElapsedFrames() % 60 == 0 ) {
+		Surface8u frame = copyWindowSurface();
+		ColorA8u topLeft = frame.getPixel( ivec2( 1, 1 ) );
+		ColorA8u bottomRight = frame.getPixel( frame.getSize() - ivec2( 2 ) );
+		if( topLeft.b < 200 || topLeft.r > 50 || bottomRight.r < 200 || bottomRight.b > 50 ) {
+			CI_LOG_E( "frame " << getElapsedFrames() << ": unexpected pixels " << topLeft << " / " << bottomRight );
+			++mNumFailures;
+		}
+	}
+}
+
+void HeadlessTestApp::cleanup()
+{
+	console() << ( mNumFailures ? "FAILED" : "passed" ) << ": " << getElapsedFrames() << " frames at " << getAverageFps() << " fps" << endl;
+}
+
+CINDER_APP_HEADLESS( HeadlessTestApp, RendererGl( RendererGl::Options().msaa( 0 ) ), []( AppHeadless::Settings *settings ) {
+	settings->setWindowSize( 640, 480 );
+	settings->setNumFrames( 300 );
+	settings->setFixedTimestep( 1 / 60.0 );
+} )
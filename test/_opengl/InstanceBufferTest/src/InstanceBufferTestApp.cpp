@@ -0,0 +1,166 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/gl/InstanceBuffer.h"
+#include "cinder/Timer.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Animates 100k instanced cubes whose transforms and colors are rewritten every frame, either into a std::vector uploaded with bufferData(),
+// or straight into a gl::InstanceBuffer from one thread or from every hardware thread. Press 'm' to cycle modes.
+class InstanceBufferTestApp : public App {
+  public:
+	void setup() override;
+	void keyDown( KeyEvent event ) override;
+	void update() override;
+	void draw() override;
+
+  private:
+	struct Instance {
+		mat4		mModelMatrix;
+		uint32_t	mColor;
+	};
+
+	enum Mode { BUFFER_DATA, INSTANCE_BUFFER, INSTANCE_BUFFER_PARALLEL, NUM_MODES };
+
+	static const uint32_t NUM_INSTANCES = 100000;
+
+	gl::InstanceBufferRef	mInstances;
+	gl::BatchRef			mBatch;
+
+	vector<Instance>		mCpuInstances;
+	gl::VboRef				mCpuVbo;
+	gl::BatchRef			mCpuBatch;
+
+	int						mMode;
+	double					mFillSeconds;
+	size_t					mNumFrames;
+};
+
+static mat4 instanceTransform( uint32_t index, float time )
+{
+	vec3 position( index % 100 - 49.5f, ( index / 100 ) % 100 - 49.5f, index / 10000 - 4.5f );
+	position.z += sin( time + index * 0.01f ) * 0.5f;
+	return glm::translate( position * 1.5f ) * glm::rotate( time + index * 0.001f, vec3( 1, 1, 0 ) ) * glm::scale( vec3( 0.5f ) );
+}
+
+static uint32_t instanceColor( uint32_t index, float time )
+{
+	uint8_t shade = (uint8_t)( 128 + 127 * sin( time * 2 + index * 0.05f ) );
+	return 0xff000000 | ( shade << 16 ) | ( ( index & 0xff ) << 8 ) | ( 255 - shade );
+}
+
+void InstanceBufferTestApp::setup()
+{
+	auto glsl = gl::GlslProg::create( gl::GlslProg::Format()
+		.vertex( CI_GLSL( 150,
+			uniform mat4 ciViewProjection;
+			in vec4 ciPosition;
+			in vec3 ciNormal;
+			in mat4 iModelMatrix;
+			in vec4 ciColor;
+			out vec4 vColor;
+			void main() {
+				vec3 normal = normalize( mat3( iModelMatrix ) * ciNormal );
+				vColor = ciColor * ( 0.4 + 0.6 * max( normal.z, 0.0 ) );
+				gl_Position = ciViewProjection * iModelMatrix * ciPosition;
+			} ) )
+		.fragment( CI_GLSL( 150,
+			in vec4 vColor;
+			out vec4 oColor;
+			void main() {
+				oColor = vColor;
+			} ) ) );
+
+	auto mesh = gl::VboMesh::create( geom::Cube() );
+	mBatch = gl::Batch::create( mesh, glsl, { { geom::CUSTOM_0, "iModelMatrix" } } );
+	mInstances = gl::InstanceBuffer::create( NUM_INSTANCES, gl::InstanceBuffer::Format().attrib( geom::CUSTOM_0, 16 ).attrib( geom::COLOR, 4, geom::UNORM8 ) );
+
+	// the hand-built equivalent
+	mCpuInstances.resize( NUM_INSTANCES );
+	mCpuVbo = gl::Vbo::create( GL_ARRAY_BUFFER, NUM_INSTANCES * sizeof( Instance ), nullptr, GL_STREAM_DRAW );
+	geom::BufferLayout layout;
+	layout.append( geom::CUSTOM_0, 16, sizeof( Instance ), offsetof( Instance, mModelMatrix ), 1 );
+	layout.append( geom::COLOR, geom::UNORM8, 4, sizeof( Instance ), offsetof( Instance, mColor ), 1 );
+	auto cpuMesh = gl::VboMesh::create( geom::Cube() );
+	cpuMesh->appendVbo( layout, mCpuVbo );
+	mCpuBatch = gl::Batch::create( cpuMesh, glsl, { { geom::CUSTOM_0, "iModelMatrix" } } );
+
+	// a throwing fill() leaves the buffer unmapped, so the next fill() succeeds
+	try {
+		mInstances->fill( NUM_INSTANCES, []( uint32_t begin, uint32_t ) {
+			if( begin == 0 )
+				throw runtime_error( "fill failed" );
+		}, 4 );
+	}
+	catch( runtime_error & ) {
+		console() << "fill() rethrew, " << mInstances->getNumInstances() << " instances current" << endl;
+	}
+
+	mMode = INSTANCE_BUFFER_PARALLEL;
+	mFillSeconds = 0;
+	mNumFrames = 0;
+
+	gl::enableDepthRead();
+	gl::enableDepthWrite();
+}
+
+void InstanceBufferTestApp::keyDown( KeyEvent event )
+{
+	if( event.getChar() == 'm' ) {
+		mMode = ( mMode + 1 ) % NUM_MODES;
+		mFillSeconds = 0;
+		mNumFrames = 0;
+	}
+}
+
+void InstanceBufferTestApp::update()
+{
+	const float time = (float)getElapsedSeconds();
+	Timer timer( true );
+	if( mMode == BUFFER_DATA ) {
+		for( uint32_t i = 0; i < NUM_INSTANCES; ++i ) {
+			mCpuInstances[i].mModelMatrix = instanceTransform( i, time );
+			mCpuInstances[i].mColor = instanceColor( i, time );
+		}
+		mCpuVbo->bufferData( NUM_INSTANCES * sizeof( Instance ), mCpuInstances.data(), GL_STREAM_DRAW );
+	}
+	else {
+		mInstances->fill( NUM_INSTANCES, [=]( uint32_t begin, uint32_t end ) {
+			auto modelMatrices = mInstances->getMappedAttrib<mat4>( geom::CUSTOM_0 );
+			auto colors = mInstances->getMappedAttrib<uint32_t>( geom::COLOR );
+			for( uint32_t i = begin; i < end; ++i ) {
+				modelMatrices[i] = instanceTransform( i, time );
+				colors[i] = instanceColor( i, time );
+			}
+		}, mMode == INSTANCE_BUFFER ? 1 : 0 );
+	}
+	mFillSeconds += timer.getSeconds();
+
+	if( ++mNumFrames % 120 == 0 ) {
+		const char *names[] = { "vector + bufferData", "InstanceBuffer, 1 thread", "InstanceBuffer, all threads" };
+		console() << names[mMode] << ": " << mFillSeconds / mNumFrames * 1000 << " ms per frame writing " << NUM_INSTANCES << " instances" << endl;
+	}
+}
+
+void InstanceBufferTestApp::draw()
+{
+	gl::clear();
+
+	CameraPersp cam;
+	cam.setPerspective( 50, getWindowAspectRatio(), 1, 1000 );
+	cam.lookAt( vec3( 0, 0, 180 ), vec3( 0 ) );
+	gl::setMatrices( cam );
+
+	if( mMode == BUFFER_DATA )
+		mCpuBatch->drawInstanced( NUM_INSTANCES );
+	else
+		mInstances->drawInstanced( mBatch );
+}
+
+CINDER_APP( InstanceBufferTestApp, RendererGl, []( App::Settings *settings ) {
+	settings->disableFrameRate();
+	settings->setWindowSize( 1280, 720 );
+} )
@@ -0,0 +1,197 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/gl/MultiBatch.h"
+#include "cinder/gl/Query.h"
+#include "cinder/CameraUi.h"
+#include "cinder/Rand.h"
+#include "cinder/Timer.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+#define STRINGIFY( CODE ) #CODE
+
+// Draws 10k distinct meshes either as a single gl::MultiBatch or as 10k gl::Batches and reports CPU and GPU time per frame.
+// Press 'm' to toggle modes and 'f' to toggle the glDrawElementsBaseVertex() fallback.
+class MultiBatchTestApp : public App {
+  public:
+	void setup() override;
+	void keyDown( KeyEvent event ) override;
+	void update() override;
+	void draw() override;
+
+  private:
+	void	createMultiBatch( bool forceFallback );
+
+	static const size_t		NUM_MESHES = 10000;
+
+	vector<gl::VboMeshRef>	mMeshes;
+	vector<mat4>			mTransforms;
+	vector<Colorf>			mColors;
+	vector<gl::BatchRef>	mBatches;
+	gl::GlslProgRef			mBatchGlsl, mMultiBatchGlsl;
+	gl::MultiBatchRef		mMultiBatch;
+	bool					mUseMultiBatch;
+
+	CameraPersp				mCam;
+	CameraUi				mCamUi;
+	gl::QueryTimeSwappedRef	mGpuTimer;
+	Timer					mCpuTimer;
+	double					mCpuSeconds, mGpuSeconds;
+	size_t					mNumFrames;
+};
+
+const size_t MultiBatchTestApp::NUM_MESHES;
+
+void MultiBatchTestApp::setup()
+{
+	// every mesh is distinct; they share the position + normal interleaved layout
+	Rand rnd( 123 );
+	for( size_t i = 0; i < NUM_MESHES; ++i ) {
+		geom::AttribSet attribs = { geom::POSITION, geom::NORMAL };
+		switch( i % 4 ) {
+			case 0: mMeshes.push_back( gl::VboMesh::create( geom::Sphere().subdivisions( 6 + i % 13 ), attribs ) ); break;
+			case 1: mMeshes.push_back( gl::VboMesh::create( geom::Cube().subdivisions( 1 + i % 3 ), attribs ) ); break;
+			case 2: mMeshes.push_back( gl::VboMesh::create( geom::Torus().subdivisionsAxis( 8 + i % 11 ).subdivisionsHeight( 6 ), attribs ) ); break;
+			case 3: mMeshes.push_back( gl::VboMesh::create( geom::Cylinder().subdivisionsAxis( 5 + i % 17 ), attribs ) ); break;
+		}
+		mTransforms.push_back( glm::translate( rnd.randVec3() * rnd.randFloat( 5, 60 ) ) * glm::scale( vec3( rnd.randFloat( 0.3f, 1.0f ) ) ) );
+		mColors.push_back( Colorf( CM_HSV, rnd.randFloat(), 0.7f, 1.0f ) );
+	}
+
+	mBatchGlsl = gl::GlslProg::create( gl::GlslProg::Format()
+		.vertex( CI_GLSL( 150,
+			uniform mat4 ciModelViewProjection;
+			uniform mat3 ciNormalMatrix;
+			in vec4 ciPosition;
+			in vec3 ciNormal;
+			out vec3 vNormal;
+			void main() {
+				vNormal = ciNormalMatrix * ciNormal;
+				gl_Position = ciModelViewProjection * ciPosition;
+			} ) )
+		.fragment( CI_GLSL( 150,
+			uniform vec3 uColor;
+			in vec3 vNormal;
+			out vec4 oColor;
+			void main() {
+				oColor = vec4( uColor * max( 0.2, normalize( vNormal ).z ), 1.0 );
+			} ) ) );
+
+	// the material id indexes a palette uniform; the transform comes from the per-draw data
+	mMultiBatchGlsl = gl::GlslProg::create( gl::GlslProg::Format()
+		.vertex( "#version 150\n" + gl::MultiBatch::getGlslDeclarations() + STRINGIFY(
+			uniform mat4 ciViewProjection;
+			uniform mat4 ciViewMatrix;
+			uniform vec3 uPalette[16];
+			in vec4 ciPosition;
+			in vec3 ciNormal;
+			out vec3 vNormal;
+			out vec3 vColor;
+			void main() {
+				mat4 model = ciDrawTransform();
+				vNormal = mat3( ciViewMatrix * model ) * ciNormal;
+				vColor = uPalette[ciDrawMaterialId() % 16u];
+				gl_Position = ciViewProjection * model * ciPosition;
+			} ) )
+		.fragment( CI_GLSL( 150,
+			in vec3 vNormal;
+			in vec3 vColor;
+			out vec4 oColor;
+			void main() {
+				oColor = vec4( vColor * max( 0.2, normalize( vNormal ).z ), 1.0 );
+			} ) ) );
+
+	vector<vec3> palette;
+	for( size_t i = 0; i < 16; ++i )
+		palette.push_back( vec3( mColors[i].r, mColors[i].g, mColors[i].b ) );
+	mMultiBatchGlsl->uniform( "uPalette", palette.data(), (int)palette.size() );
+
+	for( size_t i = 0; i < NUM_MESHES; ++i )
+		mBatches.push_back( gl::Batch::create( mMeshes[i], mBatchGlsl ) );
+	createMultiBatch( false );
+
+	mCam.setPerspective( 50, getWindowAspectRatio(), 1, 500 );
+	mCam.lookAt( vec3( 0, 0, 150 ), vec3( 0 ) );
+	mCamUi = CameraUi( &mCam, getWindow() );
+
+	mGpuTimer = gl::QueryTimeSwapped::create();
+	mUseMultiBatch = true;
+	mCpuSeconds = mGpuSeconds = 0;
+	mNumFrames = 0;
+
+	gl::enableDepthRead();
+	gl::enableDepthWrite();
+}
+
+void MultiBatchTestApp::createMultiBatch( bool forceFallback )
+{
+	Timer timer( true );
+	mMultiBatch = gl::MultiBatch::create( mMeshes, mMultiBatchGlsl, gl::MultiBatch::Format().forceFallback( forceFallback ) );
+	for( size_t i = 0; i < NUM_MESHES; ++i ) {
+		mMultiBatch->setTransform( i, mTransforms[i] );
+		mMultiBatch->setMaterialId( i, uint32_t( i % 16 ) );
+	}
+	console() << "packed " << NUM_MESHES << " meshes, " << mMultiBatch->getVboMesh()->getNumVertices() << " vertices, in " << timer.getSeconds() * 1000 << "ms; "
+			<< ( mMultiBatch->isMultiDrawIndirect() ? "glMultiDrawElementsIndirect" : "glDrawElementsBaseVertex fallback" ) << endl;
+}
+
+void MultiBatchTestApp::keyDown( KeyEvent event )
+{
+	if( event.getChar() == 'm' )
+		mUseMultiBatch = ! mUseMultiBatch;
+	else if( event.getChar() == 'f' )
+		createMultiBatch( mMultiBatch->isMultiDrawIndirect() );
+	else
+		return;
+
+	mCpuSeconds = mGpuSeconds = 0;
+	mNumFrames = 0;
+}
+
+void MultiBatchTestApp::update()
+{
+	// hide a rotating tenth of the meshes to exercise visibility changes
+	size_t hidden = ( getElapsedFrames() / 30 ) % 10;
+	for( size_t i = 0; i < NUM_MESHES; ++i )
+		mMultiBatch->setVisible( i, i % 10 != hidden );
+}
+
+void MultiBatchTestApp::draw()
+{
+	gl::clear( Color( 0.1f, 0.1f, 0.1f ) );
+	gl::setMatrices( mCam );
+
+	size_t hidden = ( getElapsedFrames() / 30 ) % 10;
+	mGpuTimer->begin();
+	mCpuTimer.start();
+	if( mUseMultiBatch )
+		mMultiBatch->draw();
+	else {
+		for( size_t i = 0; i < NUM_MESHES; ++i ) {
+			if( i % 10 == hidden )
+				continue;
+			gl::ScopedModelMatrix modelScp;
+			gl::multModelMatrix( mTransforms[i] );
+			mBatchGlsl->uniform( "uColor", vec3( mColors[i % 16].r, mColors[i % 16].g, mColors[i % 16].b ) );
+			mBatches[i]->draw();
+		}
+	}
+	mCpuTimer.stop();
+	mGpuTimer->end();
+
+	mCpuSeconds += mCpuTimer.getSeconds();
+	if( mNumFrames > 0 )
+		mGpuSeconds += mGpuTimer->getElapsedSeconds();
+	if( ++mNumFrames % 60 == 0 ) {
+		console() << ( mUseMultiBatch ? "MultiBatch" : "Batches" ) << ": CPU " << mCpuSeconds / mNumFrames * 1000 << "ms, GPU "
+				<< mGpuSeconds / ( mNumFrames - 1 ) * 1000 << "ms per frame, " << getAverageFps() << " fps" << endl;
+	}
+}
+
+CINDER_APP( MultiBatchTestApp, RendererGl( RendererGl::Options().msaa( 4 ) ), []( App::Settings *settings ) {
+	settings->disableFrameRate();
+	settings->setWindowSize( 1280, 720 );
+} )
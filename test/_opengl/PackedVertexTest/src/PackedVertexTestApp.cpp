@@ -0,0 +1,160 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/gl/Query.h"
+#include "cinder/Timer.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Draws a dense sphere many times from VboMeshes whose vertex data is stored as full floats or as packed geom::DataTypes,
+// and reports VBO memory, upload time and GPU draw time for each. Press 'm' to cycle modes.
+class PackedVertexTestApp : public App {
+  public:
+	void setup() override;
+	void keyDown( KeyEvent event ) override;
+	void draw() override;
+
+  private:
+	struct Mode {
+		string				mName;
+		gl::BatchRef		mBatch;
+		size_t				mVboBytes;
+	};
+
+	void	addMode( const string &name, const gl::VboMesh::Layout &layout, const gl::GlslProgRef &glsl );
+
+	vector<Mode>			mModes;
+	size_t					mModeIndex;
+
+	gl::QueryTimeSwappedRef	mGpuTimer;
+	double					mGpuSeconds;
+	size_t					mNumFrames;
+};
+
+static const char *sVertexShader = R"(
+#version 150
+uniform mat4 ciModelViewProjection;
+uniform mat3 ciNormalMatrix;
+in vec4 ciPosition;
+in vec2 ciTexCoord0;
+#if defined( OCTAHEDRAL_NORMALS )
+in vec2 ciNormal;
+vec3 decodeNormal() {
+	vec3 n = vec3( ciNormal, 1.0 - abs( ciNormal.x ) - abs( ciNormal.y ) );
+	if( n.z < 0.0 )
+		n.xy = ( 1.0 - abs( n.yx ) ) * vec2( n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0 );
+	return normalize( n );
+}
+#else
+in vec3 ciNormal;
+vec3 decodeNormal() { return ciNormal; }
+#endif
+out vec3 vNormal;
+out vec2 vTexCoord;
+void main() {
+	vNormal = ciNormalMatrix * decodeNormal();
+	vTexCoord = ciTexCoord0;
+	gl_Position = ciModelViewProjection * ciPosition;
+}
+)";
+
+static const char *sFragmentShader = R"(
+#version 150
+in vec3 vNormal;
+in vec2 vTexCoord;
+out vec4 oColor;
+void main() {
+	float checker = mod( floor( vTexCoord.x * 32.0 ) + floor( vTexCoord.y * 16.0 ), 2.0 );
+	oColor = vec4( vec3( 0.5 + 0.5 * checker ) * max( 0.1, normalize( vNormal ).z ), 1.0 );
+}
+)";
+
+void PackedVertexTestApp::setup()
+{
+	auto glsl = gl::GlslProg::create( gl::GlslProg::Format().vertex( sVertexShader ).fragment( sFragmentShader ) );
+	auto octahedralGlsl = gl::GlslProg::create( gl::GlslProg::Format().vertex( sVertexShader ).fragment( sFragmentShader ).define( "OCTAHEDRAL_NORMALS" ) );
+
+	addMode( "float", gl::VboMesh::Layout().attrib( geom::POSITION, 3 ).attrib( geom::NORMAL, 3 ).attrib( geom::TEX_COORD_0, 2 ), glsl );
+	addMode( "half positions, 10:10:10:2 normals, unorm16 texcoords", gl::VboMesh::Layout()
+				.attrib( geom::POSITION, 3, geom::HALF_FLOAT ).attrib( geom::NORMAL, 3, geom::SNORM_10_10_10_2 ).attrib( geom::TEX_COORD_0, 2, geom::UNORM16 ), glsl );
+	addMode( "float positions, octahedral normals, half texcoords", gl::VboMesh::Layout()
+				.attrib( geom::POSITION, 3 ).attrib( geom::NORMAL, 3, geom::OCTAHEDRAL ).attrib( geom::TEX_COORD_0, 2, geom::HALF_FLOAT ), octahedralGlsl );
+	addMode( "snorm8 normals, planar", gl::VboMesh::Layout().interleave( false )
+				.attrib( geom::POSITION, 3 ).attrib( geom::NORMAL, 3, geom::SNORM8 ).attrib( geom::TEX_COORD_0, 2, geom::UNORM16 ), glsl );
+
+	mModeIndex = 0;
+	mGpuTimer = gl::QueryTimeSwapped::create();
+	mGpuSeconds = 0;
+	mNumFrames = 0;
+
+	gl::enableDepthRead();
+	gl::enableDepthWrite();
+}
+
+void PackedVertexTestApp::addMode( const string &name, const gl::VboMesh::Layout &layout, const gl::GlslProgRef &glsl )
+{
+	Timer timer( true );
+	auto mesh = gl::VboMesh::create( geom::Sphere().subdivisions( 400 ), { layout } );
+	timer.stop();
+
+	Mode mode;
+	mode.mName = name;
+	mode.mBatch = gl::Batch::create( mesh, glsl );
+	mode.mVboBytes = 0;
+	for( auto &vbo : mesh->getVertexArrayVbos() )
+		mode.mVboBytes += vbo->getSize();
+	mModes.push_back( mode );
+
+	console() << name << ": " << mesh->getNumVertices() << " vertices, " << mode.mVboBytes / 1024 << " KB of vertex data, built in " << timer.getSeconds() * 1000 << " ms" << endl;
+
+	// reading the VboMesh back as a geom::Source expands packed attributes to floats
+	TriMesh reference( geom::Sphere().subdivisions( 400 ) ), readBack( *mesh->createSource() );
+	float maxError[3] = { 0, 0, 0 };
+	for( size_t v = 0; v < reference.getNumVertices(); ++v ) {
+		maxError[0] = std::max( maxError[0], length( reference.getPositions<3>()[v] - readBack.getPositions<3>()[v] ) );
+		maxError[1] = std::max( maxError[1], length( reference.getNormals()[v] - readBack.getNormals()[v] ) );
+		maxError[2] = std::max( maxError[2], length( reference.getTexCoords0<2>()[v] - readBack.getTexCoords0<2>()[v] ) );
+	}
+	console() << "  read back as a geom::Source, largest error: position " << maxError[0] << ", normal " << maxError[1] << ", texcoord " << maxError[2] << endl;
+}
+
+void PackedVertexTestApp::keyDown( KeyEvent event )
+{
+	if( event.getChar() == 'm' ) {
+		mModeIndex = ( mModeIndex + 1 ) % mModes.size();
+		mGpuSeconds = 0;
+		mNumFrames = 0;
+	}
+}
+
+void PackedVertexTestApp::draw()
+{
+	gl::clear( Color( 0.1f, 0.1f, 0.15f ) );
+
+	CameraPersp cam;
+	cam.setPerspective( 50, getWindowAspectRatio(), 0.1f, 100 );
+	cam.lookAt( vec3( 0, 0, 14 ), vec3( 0 ) );
+	gl::setMatrices( cam );
+	gl::rotate( (float)getElapsedSeconds() * 0.3f, vec3( 0, 1, 0 ) );
+
+	const Mode &mode = mModes[mModeIndex];
+	mGpuTimer->begin();
+	for( int i = 0; i < 25; ++i ) {
+		gl::ScopedModelMatrix modelScp;
+		gl::translate( vec3( i % 5 - 2.0f, i / 5 - 2.0f, 0 ) * 2.2f );
+		mode.mBatch->draw();
+	}
+	mGpuTimer->end();
+
+	if( mNumFrames > 0 )
+		mGpuSeconds += mGpuTimer->getElapsedSeconds();
+	if( ++mNumFrames % 60 == 0 )
+		console() << mode.mName << ": " << mode.mVboBytes / 1024 << " KB, GPU " << mGpuSeconds / ( mNumFrames - 1 ) * 1000 << " ms per frame" << endl;
+}
+
+CINDER_APP( PackedVertexTestApp, RendererGl, []( App::Settings *settings ) {
+	settings->disableFrameRate();
+	settings->setWindowSize( 1280, 720 );
+} )
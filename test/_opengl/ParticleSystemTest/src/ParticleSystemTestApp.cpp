@@ -0,0 +1,130 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/gl/ParticleSystem.h"
+#include "cinder/gl/Query.h"
+#include "cinder/Camera.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Runs a gl::ParticleSystem fountain under gravity, noise and an orbiting attractor, and reports GPU time for the update and draw.
+// Press 1, 2, 5 or 0 for 1M, 2M, 5M or 10M particles, 'i' to toggle drawing instanced icosahedra instead of points, and 'c' to clear.
+class ParticleSystemTestApp : public App {
+  public:
+	void setup() override;
+	void keyDown( KeyEvent event ) override;
+	void update() override;
+	void draw() override;
+
+  private:
+	void	createSystem( uint32_t numParticles );
+
+	gl::ParticleSystemRef	mParticles;
+	gl::GlslProgRef			mInstanceGlsl;
+	bool					mDrawInstanced;
+
+	gl::QueryTimeSwappedRef	mUpdateTimer, mDrawTimer;
+	double					mUpdateSeconds, mDrawSeconds;
+	size_t					mNumFrames;
+};
+
+void ParticleSystemTestApp::setup()
+{
+	mInstanceGlsl = gl::GlslProg::create( gl::GlslProg::Format()
+		.vertex( CI_GLSL( 150,
+			uniform mat4 ciModelViewProjection;
+			in vec4 ciPosition;
+			in vec4 ciParticlePosition;
+			in vec4 ciParticleVelocity;
+			in vec4 ciParticleColor;
+			out vec4 vColor;
+			void main() {
+				float scale = ciParticlePosition.w < ciParticleVelocity.w ? 0.02 : 0.0;
+				vColor = ciParticleColor;
+				gl_Position = ciModelViewProjection * vec4( ciPosition.xyz * scale + ciParticlePosition.xyz, 1.0 );
+			} ) )
+		.fragment( CI_GLSL( 150,
+			in vec4 vColor;
+			out vec4 oColor;
+			void main() {
+				oColor = vColor;
+			} ) ) );
+
+	mDrawInstanced = false;
+	mUpdateTimer = gl::QueryTimeSwapped::create();
+	mDrawTimer = gl::QueryTimeSwapped::create();
+	createSystem( 1000000 );
+}
+
+void ParticleSystemTestApp::createSystem( uint32_t numParticles )
+{
+	// particles fade out and shift towards red as they age
+	mParticles = gl::ParticleSystem::create( gl::ParticleSystem::Format().maxParticles( numParticles )
+		.updateSnippet( "float t = p.age / p.lifetime; p.color = vec4( mix( vec3( 0.3, 0.6, 1.0 ), vec3( 1.0, 0.3, 0.1 ), t ), 1.0 - t );" ) );
+	mParticles->setEmitter( gl::ParticleSystem::Emitter().radius( 0.2f ).velocity( vec3( 0, 6, 0 ) ).velocitySpread( 1.5f ).lifetime( 2, 4 ) );
+	// emit the whole capacity over the longest lifetime, so the system runs full
+	mParticles->setEmissionRate( numParticles / 4.0f );
+	mParticles->setGravity( vec3( 0, -3, 0 ) );
+	mParticles->setDrag( 0.2f );
+	mParticles->setNoise( 2, 0.5f, 0.3f );
+	mParticles->setInstanceMesh( gl::VboMesh::create( geom::Icosahedron() ), mInstanceGlsl );
+
+	mUpdateSeconds = mDrawSeconds = 0;
+	mNumFrames = 0;
+}
+
+void ParticleSystemTestApp::keyDown( KeyEvent event )
+{
+	switch( event.getChar() ) {
+		case '1': createSystem( 1000000 ); break;
+		case '2': createSystem( 2000000 ); break;
+		case '5': createSystem( 5000000 ); break;
+		case '0': createSystem( 10000000 ); break;
+		case 'i': mDrawInstanced = ! mDrawInstanced; mUpdateSeconds = mDrawSeconds = 0; mNumFrames = 0; break;
+		case 'c': mParticles->clear(); break;
+	}
+}
+
+void ParticleSystemTestApp::update()
+{
+	float t = (float)getElapsedSeconds();
+	mParticles->setAttractor( 0, vec3( cos( t ) * 3, 3, sin( t ) * 3 ), 4 );
+
+	mUpdateTimer->begin();
+	mParticles->update( 1 / 60.0f );
+	mUpdateTimer->end();
+}
+
+void ParticleSystemTestApp::draw()
+{
+	gl::clear();
+
+	CameraPersp cam;
+	cam.setPerspective( 50, getWindowAspectRatio(), 0.1f, 100 );
+	cam.lookAt( vec3( 0, 4, 14 ), vec3( 0, 3, 0 ) );
+	gl::setMatrices( cam );
+
+	gl::ScopedBlendAlpha blendScp;
+	mDrawTimer->begin();
+	if( mDrawInstanced )
+		mParticles->drawInstanced();
+	else
+		mParticles->draw();
+	mDrawTimer->end();
+
+	if( mNumFrames > 0 ) {
+		mUpdateSeconds += mUpdateTimer->getElapsedSeconds();
+		mDrawSeconds += mDrawTimer->getElapsedSeconds();
+	}
+	if( ++mNumFrames % 120 == 0 ) {
+		console() << mParticles->getMaxParticles() / 1000000 << "M particles" << ( mDrawInstanced ? " (instanced)" : "" ) << ": update " << mUpdateSeconds / ( mNumFrames - 1 ) * 1000
+				<< " ms, draw " << mDrawSeconds / ( mNumFrames - 1 ) * 1000 << " ms per frame on the GPU" << endl;
+	}
+}
+
+CINDER_APP( ParticleSystemTestApp, RendererGl, []( App::Settings *settings ) {
+	settings->disableFrameRate();
+	settings->setWindowSize( 1280, 720 );
+} )
@@ -0,0 +1,116 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/gl/Query.h"
+#include "cinder/Profiler.h"
+#include "cinder/Rand.h"
+#include "cinder/Timer.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Exercises the Profiler's built-in markers (App::update, App::draw, Batch::draw, Fbo pass, Texture2d upload) alongside some of its own.
+// Press 's' to print rolling statistics, 't' to write a Chrome trace to the app's folder and 'e' to toggle profiling.
+class ProfilerTestApp : public App {
+  public:
+	void setup() override;
+	void keyDown( KeyEvent event ) override;
+	void update() override;
+	void draw() override;
+
+  private:
+	void	measureOverhead();
+
+	gl::BatchRef		mBatch;
+	gl::FboRef			mFbo;
+	gl::TextureRef		mTexture;
+	Surface8u			mSurface;
+};
+
+void ProfilerTestApp::setup()
+{
+	mBatch = gl::Batch::create( geom::Sphere().subdivisions( 32 ), gl::getStockShader( gl::ShaderDef().lambert() ) );
+	mFbo = gl::Fbo::create( 512, 512 );
+	mSurface = Surface8u( 512, 512, false );
+	mTexture = gl::Texture::create( mSurface );
+
+	measureOverhead();
+
+	Profiler::get()->setGpuTimer( gl::ProfilerGpuTimer::create() );
+	Profiler::get()->setEnabled();
+}
+
+void ProfilerTestApp::measureOverhead()
+{
+	const int NUM_MARKERS = 1000000;
+	Timer timer( true );
+	for( int i = 0; i < NUM_MARKERS; ++i ) {
+		CI_PROFILE( "overhead" );
+	}
+	console() << "disabled marker: " << timer.getSeconds() * 1e9 / NUM_MARKERS << " ns" << endl;
+}
+
+void ProfilerTestApp::keyDown( KeyEvent event )
+{
+	if( event.getChar() == 's' )
+		Profiler::get()->printStats( console() );
+	else if( event.getChar() == 't' ) {
+		fs::path path = getAppPath() / "trace.json";
+		Profiler::get()->writeChromeTrace( path );
+		console() << "wrote " << path << endl;
+	}
+	else if( event.getChar() == 'e' )
+		Profiler::get()->setEnabled( ! Profiler::get()->isEnabled() );
+}
+
+void ProfilerTestApp::update()
+{
+	{
+		CI_PROFILE( "fill surface" );
+		Rand rnd( getElapsedFrames() );
+		auto iter = mSurface.getIter();
+		while( iter.line() ) {
+			while( iter.pixel() )
+				iter.r() = iter.g() = iter.b() = rnd.nextUint() & 0xff;
+		}
+	}
+
+	mTexture->update( mSurface );
+}
+
+void ProfilerTestApp::draw()
+{
+	{
+		gl::ScopedFramebuffer fboScp( mFbo );
+		gl::ScopedViewport viewportScp( mFbo->getSize() );
+		gl::ScopedMatrices matricesScp;
+		gl::setMatricesWindow( mFbo->getSize() );
+		gl::clear();
+		gl::draw( mTexture );
+	}
+
+	gl::clear( Color( 0.2f, 0.2f, 0.2f ) );
+	gl::draw( mFbo->getColorTexture(), Rectf( 0, 0, 256, 256 ) );
+
+	gl::enableDepthRead();
+	gl::enableDepthWrite();
+	CameraPersp cam;
+	cam.setPerspective( 50, getWindowAspectRatio(), 0.1f, 100 );
+	cam.lookAt( vec3( 0, 0, 25 ), vec3( 0 ) );
+	gl::setMatrices( cam );
+	{
+		CI_PROFILE_GPU( "spheres" );
+		for( int i = 0; i < 100; ++i ) {
+			gl::ScopedModelMatrix modelScp;
+			gl::translate( vec3( i % 10 - 4.5f, i / 10 - 4.5f, 0 ) * 2.0f );
+			mBatch->draw();
+		}
+	}
+	gl::disableDepthRead();
+	gl::disableDepthWrite();
+}
+
+CINDER_APP( ProfilerTestApp, RendererGl, []( App::Settings *settings ) {
+	settings->disableFrameRate();
+} )
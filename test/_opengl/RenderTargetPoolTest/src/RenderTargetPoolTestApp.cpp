@@ -0,0 +1,149 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/gl/RenderTargetPool.h"
+#include "cinder/Timer.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Runs a bloom-style chain of downsample and blur passes whose intermediate Fbos come either from a gl::RenderTargetPool or from Fbo::create() every frame.
+// Press 'p' to toggle modes and resize the window to watch stale sizes age out of the pool.
+class RenderTargetPoolTestApp : public App {
+  public:
+	void setup() override;
+	void keyDown( KeyEvent event ) override;
+	void draw() override;
+
+  private:
+	gl::FboRef		acquireFbo( const ivec2 &size );
+	gl::FboRef		blur( const gl::FboRef &source, const ivec2 &size, const vec2 &direction );
+
+	static const int	NUM_LEVELS = 5;
+
+	gl::RenderTargetPoolRef	mPool;
+	gl::GlslProgRef			mBlurGlsl;
+	bool					mUsePool;
+
+	Timer					mTimer;
+	double					mChainSeconds;
+	size_t					mNumFrames;
+};
+
+void RenderTargetPoolTestApp::setup()
+{
+	mPool = gl::RenderTargetPool::create();
+	mBlurGlsl = gl::GlslProg::create( gl::GlslProg::Format()
+		.vertex( CI_GLSL( 150,
+			uniform mat4 ciModelViewProjection;
+			in vec4 ciPosition;
+			in vec2 ciTexCoord0;
+			out vec2 vTexCoord;
+			void main() {
+				vTexCoord = ciTexCoord0;
+				gl_Position = ciModelViewProjection * ciPosition;
+			} ) )
+		.fragment( CI_GLSL( 150,
+			uniform sampler2D uTex0;
+			uniform vec2 uDirection;
+			in vec2 vTexCoord;
+			out vec4 oColor;
+			void main() {
+				vec2 step = uDirection / vec2( textureSize( uTex0, 0 ) );
+				oColor = texture( uTex0, vTexCoord ) * 0.4;
+				oColor += ( texture( uTex0, vTexCoord + step ) + texture( uTex0, vTexCoord - step ) ) * 0.2;
+				oColor += ( texture( uTex0, vTexCoord + step * 2.0 ) + texture( uTex0, vTexCoord - step * 2.0 ) ) * 0.1;
+			} ) ) );
+	mBlurGlsl->uniform( "uTex0", 0 );
+
+	mUsePool = true;
+	mChainSeconds = 0;
+	mNumFrames = 0;
+}
+
+void RenderTargetPoolTestApp::keyDown( KeyEvent event )
+{
+	if( event.getChar() == 'p' ) {
+		mUsePool = ! mUsePool;
+		mChainSeconds = 0;
+		mNumFrames = 0;
+	}
+}
+
+gl::FboRef RenderTargetPoolTestApp::acquireFbo( const ivec2 &size )
+{
+	auto format = gl::Fbo::Format().disableDepth().colorTexture( gl::Texture2d::Format().internalFormat( GL_RGBA16F ).minFilter( GL_LINEAR ) );
+	if( mUsePool )
+		return mPool->acquireFbo( size, format );
+	else
+		return gl::Fbo::create( size.x, size.y, format );
+}
+
+gl::FboRef RenderTargetPoolTestApp::blur( const gl::FboRef &source, const ivec2 &size, const vec2 &direction )
+{
+	gl::FboRef result = acquireFbo( size );
+	gl::ScopedFramebuffer fboScp( result );
+	gl::ScopedViewport viewportScp( result->getSize() );
+	gl::ScopedMatrices matricesScp;
+	gl::setMatricesWindow( result->getSize() );
+	gl::ScopedGlslProg glslScp( mBlurGlsl );
+	gl::ScopedTextureBind texScp( source->getColorTexture(), 0 );
+	mBlurGlsl->uniform( "uDirection", direction );
+	gl::drawSolidRect( result->getBounds(), vec2( 0, 0 ), vec2( 1, 1 ) );
+	return result;
+}
+
+void RenderTargetPoolTestApp::draw()
+{
+	mTimer.start();
+
+	gl::FboRef scene = acquireFbo( getWindowSize() );
+	{
+		gl::ScopedFramebuffer fboScp( scene );
+		gl::ScopedViewport viewportScp( scene->getSize() );
+		gl::clear();
+		gl::color( Color( 1, 0.8f, 0.4f ) );
+		for( int i = 0; i < 12; ++i ) {
+			float angle = (float)getElapsedSeconds() + i * 0.52f;
+			gl::drawSolidCircle( vec2( getWindowCenter() ) + 200.0f * vec2( cos( angle ), sin( angle ) ), 12 );
+		}
+	}
+
+	// each horizontal pass is released once its vertical pass is built, so the pool also reuses targets within a frame
+	vector<gl::FboRef> levels;
+	gl::FboRef current = scene;
+	for( int level = 0; level < NUM_LEVELS; ++level ) {
+		ivec2 size = glm::max( current->getSize() / 2, ivec2( 1 ) );
+		gl::FboRef horizontal = blur( current, size, vec2( 1, 0 ) );
+		current = blur( horizontal, size, vec2( 0, 1 ) );
+		levels.push_back( current );
+	}
+
+	mTimer.stop();
+	mChainSeconds += mTimer.getSeconds();
+
+	gl::clear();
+	gl::color( Color::white() );
+	gl::draw( scene->getColorTexture(), getWindowBounds() );
+	{
+		gl::ScopedBlendAdditive blendScp;
+		for( auto &level : levels )
+			gl::draw( level->getColorTexture(), getWindowBounds() );
+	}
+
+	levels.clear();
+	current.reset();
+	scene.reset();
+	mPool->endFrame();
+
+	if( ++mNumFrames % 120 == 0 ) {
+		console() << ( mUsePool ? "RenderTargetPool" : "Fbo::create" ) << ": " << mChainSeconds / mNumFrames * 1000 << " ms per frame building the chain, "
+				<< mPool->getNumTargets() << " pooled targets (" << mPool->getNumBytes() / 1024 << " KB), " << mPool->getNumAllocations() << " allocations total" << endl;
+	}
+}
+
+CINDER_APP( RenderTargetPoolTestApp, RendererGl, []( App::Settings *settings ) {
+	settings->disableFrameRate();
+	settings->setWindowSize( 1280, 720 );
+} )
@@ -0,0 +1,130 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/gl/TextureStreamer.h"
+#include "cinder/Timer.h"
+
+#include <fstream>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Writes a large mipmapped DXT1 file, then compares loading it with Texture2d::createFromDds() against streaming it with gl::TextureStreamer.
+// The streamed texture is drawn on the left and sharpens as finer levels arrive. Press 'r' to restart streaming.
+class TextureStreamerTestApp : public App {
+  public:
+	void setup() override;
+	void keyDown( KeyEvent event ) override;
+	void update() override;
+	void draw() override;
+
+  private:
+	void	writeTestFile( const fs::path &path, int size );
+	void	startStreaming();
+
+	fs::path				mPath;
+	gl::TextureRef			mLoadedTexture;
+	gl::TextureStreamerRef	mStreamer;
+
+	Timer					mStreamTimer;
+	size_t					mNumStreamFrames;
+};
+
+void TextureStreamerTestApp::setup()
+{
+	mPath = getAppPath() / "TextureStreamerTest.dds";
+	writeTestFile( mPath, 8192 );
+
+	Timer timer( true );
+	mLoadedTexture = gl::Texture::createFromDds( loadFile( mPath ) );
+	glFinish();
+	console() << "createFromDds: " << timer.getSeconds() * 1000 << " ms until usable, " << fs::file_size( mPath ) / 1024 << " KB copied to the heap" << endl;
+
+	startStreaming();
+}
+
+// levels are filled with blocks whose colors follow the block's position, with a checker that's only visible at the finest levels
+void TextureStreamerTestApp::writeTestFile( const fs::path &path, int size )
+{
+	int numLevels = 0;
+	while( ( size >> numLevels ) > 0 )
+		++numLevels;
+
+	uint32_t header[32] = { 0 };
+	header[0] = 0x20534444; // "DDS "
+	header[1] = 124;
+	header[2] = 0x000A1007; // caps, height, width, pixel format, mipmap count, linear size
+	header[3] = size;
+	header[4] = size;
+	header[5] = size * size / 2;
+	header[7] = numLevels;
+	header[19] = 32;
+	header[20] = 0x4; // DDPF_FOURCC
+	header[21] = 0x31545844; // DXT1
+	header[27] = 0x401008; // complex, texture, mipmap
+
+	ofstream out( path.string().c_str(), ios::binary );
+	out.write( reinterpret_cast<const char*>( header ), sizeof( header ) );
+	for( int level = 0; level < numLevels; ++level ) {
+		int blocks = std::max( 1, ( size >> level ) / 4 );
+		vector<uint16_t> data( blocks * blocks * 4 );
+		for( int by = 0; by < blocks; ++by ) {
+			for( int bx = 0; bx < blocks; ++bx ) {
+				uint16_t r = bx * 31 / blocks, g = by * 63 / blocks, b = ( ( bx / 8 + by / 8 ) % 2 ) ? 31 : 8;
+				uint16_t *block = &data[( by * blocks + bx ) * 4];
+				block[0] = ( r << 11 ) | ( g << 5 ) | b;
+				block[1] = ( r << 11 ) | ( g << 5 ) | ( b / 2 );
+				block[2] = block[3] = ( level % 2 ) ? 0x5555 : 0;
+			}
+		}
+		out.write( reinterpret_cast<const char*>( data.data() ), data.size() * sizeof( uint16_t ) );
+	}
+}
+
+void TextureStreamerTestApp::startStreaming()
+{
+	mStreamer.reset();
+
+	Timer timer( true );
+	mStreamer = gl::TextureStreamer::createFromDds( mPath, gl::TextureStreamer::Format().uploadBudget( 8 * 1024 * 1024 ) );
+	glFinish();
+	console() << "TextureStreamer: " << timer.getSeconds() * 1000 << " ms until usable at level " << mStreamer->getResidentLevel() << " of " << mStreamer->getNumLevels()
+			<< ", " << mStreamer->getNumBytesUploaded() / 1024 << " of " << mStreamer->getNumBytesTotal() / 1024 << " KB uploaded" << endl;
+
+	mStreamTimer.start();
+	mNumStreamFrames = 0;
+}
+
+void TextureStreamerTestApp::keyDown( KeyEvent event )
+{
+	if( event.getChar() == 'r' )
+		startStreaming();
+}
+
+void TextureStreamerTestApp::update()
+{
+	if( mStreamer->isComplete() )
+		return;
+
+	int prevLevel = mStreamer->getResidentLevel();
+	bool complete = mStreamer->update();
+	++mNumStreamFrames;
+	if( complete || mStreamer->getResidentLevel() != prevLevel ) {
+		console() << "  level " << mStreamer->getResidentLevel() << " resident after " << mNumStreamFrames << " frames, " << mStreamTimer.getSeconds() * 1000 << " ms" << endl;
+		if( complete )
+			console() << "TextureStreamer: complete after " << mNumStreamFrames << " frames, " << mStreamTimer.getSeconds() * 1000 << " ms" << endl;
+	}
+}
+
+void TextureStreamerTestApp::draw()
+{
+	gl::clear();
+	float halfWidth = getWindowWidth() / 2.0f;
+	gl::draw( mStreamer->getTexture(), Rectf( 0, 0, halfWidth, halfWidth ) );
+	gl::draw( mLoadedTexture, Rectf( halfWidth, 0, getWindowWidth(), halfWidth ) );
+}
+
+CINDER_APP( TextureStreamerTestApp, RendererGl, []( App::Settings *settings ) {
+	settings->setWindowSize( 1024, 512 );
+} )
@@ -0,0 +1,96 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/Timer.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Draws a static 100k vertex VertBatch which owns its buffers, and animates a small range of it with setVertex(), reporting CPU time per draw.
+// Press 'd' to compare against a VertBatch using the context's default buffers, which uploads every vertex on every draw.
+class VertBatchRetainedTestApp : public App {
+  public:
+	void setup() override;
+	void keyDown( KeyEvent event ) override;
+	void update() override;
+	void draw() override;
+
+  private:
+	void	fill( gl::VertBatch *vertBatch );
+
+	unique_ptr<gl::VertBatch>	mRetained, mDefault;
+	bool						mUseDefault;
+
+	double						mDrawSeconds;
+	size_t						mNumFrames;
+};
+
+static const int NUM_VERTICES = 100000;
+static const int NUM_ANIMATED = 1000;
+
+void VertBatchRetainedTestApp::setup()
+{
+	mRetained.reset( new gl::VertBatch( GL_POINTS ) );
+	mDefault.reset( new gl::VertBatch( GL_POINTS, true ) );
+	fill( mRetained.get() );
+	fill( mDefault.get() );
+
+	mUseDefault = false;
+	mDrawSeconds = 0;
+	mNumFrames = 0;
+}
+
+void VertBatchRetainedTestApp::fill( gl::VertBatch *vertBatch )
+{
+	vertBatch->begin( GL_POINTS );
+	for( int i = 0; i < NUM_VERTICES; ++i ) {
+		float t = i / (float)NUM_VERTICES;
+		vertBatch->color( Color( CM_HSV, t, 0.7f, 1 ) );
+		vertBatch->vertex( vec2( 0.5f + cos( t * 200 ) * t * 0.45f, 0.5f + sin( t * 200 ) * t * 0.45f ) );
+	}
+	vertBatch->end();
+}
+
+void VertBatchRetainedTestApp::keyDown( KeyEvent event )
+{
+	if( event.getChar() == 'd' ) {
+		mUseDefault = ! mUseDefault;
+		mDrawSeconds = 0;
+		mNumFrames = 0;
+	}
+}
+
+void VertBatchRetainedTestApp::update()
+{
+	// only this range is re-uploaded by the retained VertBatch
+	float offset = sin( (float)getElapsedSeconds() * 3 ) * 0.05f;
+	gl::VertBatch *vertBatch = mUseDefault ? mDefault.get() : mRetained.get();
+	for( int i = 0; i < NUM_ANIMATED; ++i ) {
+		float t = i / (float)NUM_VERTICES;
+		vertBatch->setVertex( i, vec4( 0.5f + cos( t * 200 ) * t * 0.45f + offset, 0.5f + sin( t * 200 ) * t * 0.45f, 0, 1 ) );
+	}
+}
+
+void VertBatchRetainedTestApp::draw()
+{
+	gl::clear();
+	gl::setMatricesWindow( 1, 1 );
+	gl::ScopedGlslProg glslScp( gl::getStockShader( gl::ShaderDef().color() ) );
+
+	Timer timer( true );
+	if( mUseDefault )
+		mDefault->draw();
+	else
+		mRetained->draw();
+	timer.stop();
+
+	if( mNumFrames > 0 )
+		mDrawSeconds += timer.getSeconds();
+	if( ++mNumFrames % 120 == 0 )
+		console() << ( mUseDefault ? "default buffers" : "retained" ) << ": " << mDrawSeconds / ( mNumFrames - 1 ) * 1000 << " ms CPU per draw" << endl;
+}
+
+CINDER_APP( VertBatchRetainedTestApp, RendererGl, []( App::Settings *settings ) {
+	settings->disableFrameRate();
+} )
@@ -3,8 +3,12 @@
 #include "cinder/gl/gl.h"
 #include "cinder/Utilities.h"
 #include "cinder/Stream.h"
+#include "cinder/CompressedStream.h"
 #include "cinder/Rand.h"
 #include "cinder/Log.h"
+#include "cinder/Timer.h"
+
+#include <thread>
 
 using namespace ci;
 using namespace ci::app;
@@ -14,8 +18,13 @@ class streamFileTestApp : public App {
   public:
 	void setup();
 	fs::path	createReadTestFile();
-	template<typename S>
-	void		readTest( fs::path filePath );
+	void		readTest( fs::path filePath, const function<IStreamRef()> &openStream );
+	void		seekTest( fs::path filePath, const IStreamFileBlock::Options &options );
+	void		dataSourceTest( fs::path filePath );
+	void		benchmarkLoadFile();
+	void		benchmarkStreams();
+	void		compressionTest();
+	void		benchmarkCompression();
 	
 	static const int	DATA_SIZE = 32768 * 8;
 };
@@ -41,12 +50,11 @@ bool dataChecksOut( void *data, size_t dataSize, size_t curOffset )
 	return true;
 }
 
-template<typename S>
-void streamFileTestApp::readTest( fs::path filePath )
+void streamFileTestApp::readTest( fs::path filePath, const function<IStreamRef()> &openStream )
 {
 	console() << "  File: " << filePath << std::endl;
 	{
-		shared_ptr<S> s = S::create( fopen( filePath.string().c_str(), "rb" ) );
+		IStreamRef s = openStream();
 		for( size_t d = 0; d < DATA_SIZE; ++d ) {
 			uint8_t b;
 			s->read( &b );
@@ -57,7 +65,7 @@ void streamFileTestApp::readTest( fs::path filePath )
 	}
 	
 	{
-		shared_ptr<S> s = S::create( fopen( filePath.string().c_str(), "rb" ) );
+		IStreamRef s = openStream();
 		for( size_t d = 0; d < DATA_SIZE; d += 4 ) {
 			uint8_t b[4];
 			s->readLittle( reinterpret_cast<uint32_t*>( &b ) );
@@ -68,7 +76,7 @@ void streamFileTestApp::readTest( fs::path filePath )
 	}
 
 	for( int pass = 0; pass < 1000; ++pass ) {
-		shared_ptr<S> s = S::create( fopen( filePath.string().c_str(), "rb" ) );
+		IStreamRef s = openStream();
 		size_t readSize;
 		const int MAX_READ_SIZE = 1024;
 		uint8_t buffer[MAX_READ_SIZE];
@@ -82,7 +90,7 @@ void streamFileTestApp::readTest( fs::path filePath )
 	console() << "  Passed random readData" << std::endl;
 
 	for( int pass = 0; pass < 1000; ++pass ) {
-		shared_ptr<S> s = S::create( fopen( filePath.string().c_str(), "rb" ) );
+		IStreamRef s = openStream();
 		size_t readSize;
 		const int MAX_READ_SIZE = 1024;
 		uint8_t buffer[MAX_READ_SIZE];
@@ -95,7 +103,7 @@ void streamFileTestApp::readTest( fs::path filePath )
 	console() << "  Passed random readDataAvailable" << std::endl;
 
 	for( int pass = 0; pass < 1000; ++pass ) {
-		shared_ptr<S> s = S::create( fopen( filePath.string().c_str(), "rb" ) );
+		IStreamRef s = openStream();
 		size_t readSize;
 		const int MAX_READ_SIZE = 1024;
 		uint8_t buffer[MAX_READ_SIZE];
@@ -113,14 +121,311 @@ void streamFileTestApp::readTest( fs::path filePath )
 	console() << "  Passed random readData/readDataAvailable combo" << std::endl;
 }
 
+void streamFileTestApp::seekTest( fs::path filePath, const IStreamFileBlock::Options &options )
+{
+	IStreamFileBlockRef s = IStreamFileBlock::create( filePath, options );
+	if( s->size() != DATA_SIZE )
+		throw;
+	for( int pass = 0; pass < 10000; ++pass ) {
+		size_t offset = randInt( DATA_SIZE );
+		if( randBool() )
+			s->seekAbsolute( offset );
+		else
+			s->seekRelative( (off_t)offset - s->tell() );
+		if( s->tell() != offset )
+			throw;
+
+		uint8_t buffer[64];
+		size_t readSize = std::min<size_t>( DATA_SIZE - offset, randInt( 64 ) );
+		s->readData( buffer, readSize );
+		if( ! dataChecksOut( buffer, readSize, offset ) || s->tell() != offset + readSize )
+			throw;
+	}
+	console() << "  Passed random seeks" << std::endl;
+
+	// reading past the end throws without the stream losing its place
+	s->seekAbsolute( -2 );
+	if( s->tell() != DATA_SIZE - 2 )
+		throw;
+	uint32_t word;
+	try {
+		s->read( &word );
+		throw;
+	}
+	catch( StreamExc & ) {
+	}
+	if( ! s->isEof() || s->readDataAvailable( &word, 4 ) != 0 )
+		throw;
+
+	vector<uint8_t> data( DATA_SIZE );
+	if( s->readAt( 0, data.data(), DATA_SIZE + 100 ) != DATA_SIZE || ! dataChecksOut( data.data(), DATA_SIZE, 0 ) || s->readAt( DATA_SIZE, data.data(), 1 ) != 0 )
+		throw;
+	console() << "  Passed reads at the end and readAt" << std::endl;
+}
+
+
+void streamFileTestApp::dataSourceTest( fs::path filePath )
+{
+	console() << "  File: " << filePath << std::endl;
+	BufferRef read = loadFile( filePath )->getBuffer();
+	BufferRef mapped = loadFile( filePath, DataSourcePath::Options().mapped().minMappedSize( 0 ).prefetch() )->getBuffer();
+	if( read->getSize() != DATA_SIZE || mapped->getSize() != DATA_SIZE || ! dataChecksOut( mapped->getData(), DATA_SIZE, 0 ) )
+		throw;
+	console() << "  Passed mapped getBuffer()" << std::endl;
+
+	// the mapping is copy-on-write, so the file is unchanged
+	static_cast<uint8_t*>( mapped->getData() )[0] = 255;
+	mapped.reset();
+	if( ! dataChecksOut( loadFile( filePath )->getBuffer()->getData(), DATA_SIZE, 0 ) )
+		throw;
+	console() << "  Passed writing to a mapped Buffer" << std::endl;
+
+	if( loadString( loadFile( filePath ) ).size() != DATA_SIZE || loadString( loadFile( filePath, DataSourcePath::Options().readAhead() ) ).size() != DATA_SIZE )
+		throw;
+	console() << "  Passed loadString" << std::endl;
+}
+
+// compares reading and mapping a 256 MB file with getBuffer(), reading every byte. The file is in the page cache after it is written, so this
+// measures the cost of the copy and allocation rather than the disk.
+void streamFileTestApp::benchmarkLoadFile()
+{
+	const size_t size = 256 * 1024 * 1024;
+	fs::path path = fs::unique_path( getAppPath() / "cinder_streamFileTest-%%%%-%%%%-%%%%-%%%%" );
+	{
+		vector<uint8_t> data( size );
+		for( size_t i = 0; i < size; ++i )
+			data[i] = uint8_t( i * 7 );
+		FILE *f = fopen( path.string().c_str(), "wb" );
+		fwrite( data.data(), 1, size, f );
+		fclose( f );
+	}
+
+	const char *names[] = { "read", "mapped", "mapped, prefetched" };
+	DataSourcePath::Options options[] = { DataSourcePath::Options(), DataSourcePath::Options().mapped(), DataSourcePath::Options().mapped().prefetch() };
+	for( int i = 0; i < 3; ++i ) {
+		Timer timer( true );
+		BufferRef buffer = loadFile( path, options[i] )->getBuffer();
+		double loadSeconds = timer.getSeconds();
+		uint64_t sum = 0;
+		const uint64_t *words = static_cast<const uint64_t*>( buffer->getData() );
+		for( size_t w = 0; w < buffer->getSize() / 8; ++w )
+			sum += words[w];
+		timer.stop();
+		console() << "  " << names[i] << ": getBuffer() " << loadSeconds * 1000 << " ms, with reading every byte " << timer.getSeconds() * 1000 << " ms, "
+				<< size / 1e6 / timer.getSeconds() << " MB/s (" << sum << ")" << std::endl;
+	}
+
+	fs::remove( path );
+}
+
+// compares reading a 256 MB file through IStreamFile and IStreamFileBlock a byte, a float and a megabyte at a time. As in benchmarkLoadFile(),
+// the file is in the page cache.
+void streamFileTestApp::benchmarkStreams()
+{
+	const size_t size = 256 * 1024 * 1024;
+	fs::path path = fs::unique_path( getAppPath() / "cinder_streamFileTest-%%%%-%%%%-%%%%-%%%%" );
+	{
+		vector<uint8_t> data( size );
+		for( size_t i = 0; i < size; ++i )
+			data[i] = uint8_t( i * 7 );
+		FILE *f = fopen( path.string().c_str(), "wb" );
+		fwrite( data.data(), 1, size, f );
+		fclose( f );
+	}
+
+	const char *names[] = { "IStreamFile", "IStreamFileBlock", "IStreamFileBlock, read ahead" };
+	function<IStreamRef()> openStreams[] = {
+		[&] { return IStreamFile::create( fopen( path.string().c_str(), "rb" ) ); },
+		[&] { return IStreamFileBlock::create( path ); },
+		[&] { return IStreamFileBlock::create( path, IStreamFileBlock::Options().readAhead() ); }
+	};
+	for( int i = 0; i < 3; ++i ) {
+		IStreamRef s = openStreams[i]();
+		Timer timer( true );
+		uint64_t sum = 0;
+		for( size_t b = 0; b < size; ++b ) {
+			uint8_t value;
+			s->read( &value );
+			sum += value;
+		}
+		double byteSeconds = timer.getSeconds();
+
+		s = openStreams[i]();
+		timer.start();
+		for( size_t f = 0; f < size / 4; ++f ) {
+			float value;
+			s->readLittle( &value );
+			sum += value < 0;
+		}
+		double floatSeconds = timer.getSeconds();
+
+		s = openStreams[i]();
+		vector<uint8_t> chunk( 1024 * 1024 );
+		timer.start();
+		for( size_t c = 0; c < size / chunk.size(); ++c ) {
+			s->readData( chunk.data(), chunk.size() );
+			sum += chunk[c];
+		}
+		double chunkSeconds = timer.getSeconds();
+
+		console() << "  " << names[i] << ": bytes " << size / 1e6 / byteSeconds << " MB/s, floats " << size / 1e6 / floatSeconds << " MB/s, 1 MB readData "
+				<< size / 1e6 / chunkSeconds << " MB/s (" << sum << ")" << std::endl;
+	}
+
+	fs::remove( path );
+}
+
+// text-like data which compresses about as well as a typical cache file
+static Buffer createCompressibleData( size_t size )
+{
+	Buffer result( size );
+	char *data = static_cast<char*>( result.getData() );
+	Rand rand( 1 );
+	float value = 0;
+	size_t offset = 0;
+	while( offset < size ) {
+		value += rand.nextFloat( -1, 1 );
+		char text[32];
+		int length = snprintf( text, sizeof(text), "%d %.3f\n", rand.nextInt( 100 ), value );
+		size_t amount = std::min<size_t>( length, size - offset );
+		memcpy( data + offset, text, amount );
+		offset += amount;
+	}
+	return result;
+}
+
+void streamFileTestApp::compressionTest()
+{
+	const size_t size = 4 * 1024 * 1024 + 1234;
+	Buffer data = createCompressibleData( size );
+	auto options = BlockCompressionOptions().blockSize( 64 * 1024 );
+
+	Buffer compressed = compressBufferBlocks( data, options );
+	Buffer decompressed = decompressBuffer( compressed );
+	if( decompressed.getSize() != size || memcmp( decompressed.getData(), data.getData(), size ) != 0 )
+		throw;
+	if( decompressBuffer( compressBufferBlocks( Buffer( nullptr, 0 ) ) ).getSize() != 0 )
+		throw;
+	console() << "  Passed compressBufferBlocks / decompressBuffer, " << size << " bytes to " << compressed.getSize() << std::endl;
+
+	vector<uint8_t> range( 300000 );
+	for( int pass = 0; pass < 100; ++pass ) {
+		size_t offset = randInt( size ), rangeSize = randInt( range.size() );
+		size_t read = decompressBufferBlocks( compressed, offset, range.data(), rangeSize );
+		if( read != std::min( rangeSize, size - offset ) || memcmp( range.data(), (uint8_t*)data.getData() + offset, read ) != 0 )
+			throw;
+	}
+	console() << "  Passed decompressBufferBlocks ranges" << std::endl;
+
+	// footers whose offsets and sizes would wrap around when added
+	const uint64_t corruptFooters[][3] = { { size, uint64_t( -8 ), 1 }, { uint64_t( -1 ), compressed.getSize() - 24, 0 }, { size, compressed.getSize() - 24, 0 } };
+	for( const auto &footer : corruptFooters ) {
+		Buffer corrupt( compressed.getSize() );
+		memcpy( corrupt.getData(), compressed.getData(), compressed.getSize() );
+		uint8_t *end = (uint8_t*)corrupt.getData() + corrupt.getSize() - 24;
+		uint32_t numBlocks = (uint32_t)footer[2];
+		memcpy( end, &footer[0], 8 );
+		memcpy( end + 8, &footer[1], 8 );
+		memcpy( end + 16, &numBlocks, 4 );
+		try {
+			decompressBuffer( corrupt );
+			throw std::logic_error( "corrupt footer accepted" );
+		}
+		catch( CompressedStreamExc & ) {
+		}
+	}
+	console() << "  Passed corrupt footers" << std::endl;
+
+	// written a piece at a time through OStreamCompressed, and read back with seeks through IStreamCompressed
+	fs::path path = fs::unique_path( getAppPath() / "cinder_streamFileTest-%%%%-%%%%-%%%%-%%%%" );
+	{
+		OStreamCompressedRef os = OStreamCompressed::create( writeFileStream( path ), options.numThreads( 3 ) );
+		for( size_t offset = 0; offset < size; ) {
+			size_t amount = std::min<size_t>( size - offset, randInt( 200000 ) );
+			os->writeData( (uint8_t*)data.getData() + offset, amount );
+			offset += amount;
+		}
+		os->close();
+	}
+	if( ! isBufferBlockCompressed( *loadFile( path )->getBuffer() ) || decompressBuffer( *loadFile( path )->getBuffer() ).getSize() != size )
+		throw;
+
+	IStreamCompressedRef is = IStreamCompressed::create( loadFile( path )->createStream(), 2 );
+	if( is->size() != size )
+		throw;
+	vector<uint8_t> chunk( 100000 );
+	for( size_t offset = 0; offset < size; ) {
+		size_t read = is->readDataAvailable( chunk.data(), randInt( chunk.size() ) );
+		if( memcmp( chunk.data(), (uint8_t*)data.getData() + offset, read ) != 0 )
+			throw;
+		offset += read;
+	}
+	if( ! is->isEof() || is->readDataAvailable( chunk.data(), 1 ) != 0 )
+		throw;
+	for( int pass = 0; pass < 1000; ++pass ) {
+		size_t offset = randInt( size ), readSize = std::min<size_t>( size - offset, randInt( 100000 ) );
+		is->seekAbsolute( offset );
+		is->readData( chunk.data(), readSize );
+		if( memcmp( chunk.data(), (uint8_t*)data.getData() + offset, readSize ) != 0 || is->tell() != offset + readSize )
+			throw;
+	}
+	console() << "  Passed OStreamCompressed / IStreamCompressed" << std::endl;
+	fs::remove( path );
+}
+
+// compares zlib over the whole buffer with block compression on one thread and on every core, for 64 MB of text
+void streamFileTestApp::benchmarkCompression()
+{
+	const size_t size = 64 * 1024 * 1024;
+	Buffer data = createCompressibleData( size );
+	int numThreads = std::thread::hardware_concurrency();
+
+	Timer timer( true );
+	Buffer compressed = compressBuffer( data );
+	double compressSeconds = timer.getSeconds();
+	timer.start();
+	decompressBuffer( compressed );
+	console() << "  compressBuffer: " << compressSeconds * 1000 << " ms, decompressBuffer: " << timer.getSeconds() * 1000 << " ms, "
+			<< size / (double)compressed.getSize() << ":1" << std::endl;
+
+	for( int threads : { 1, numThreads } ) {
+		timer.start();
+		compressed = compressBufferBlocks( data, BlockCompressionOptions().numThreads( threads ) );
+		compressSeconds = timer.getSeconds();
+		timer.start();
+		decompressBufferBlocks( compressed, threads );
+		console() << "  compressBufferBlocks, " << threads << " threads: " << compressSeconds * 1000 << " ms, decompressBufferBlocks: " << timer.getSeconds() * 1000
+				<< " ms, " << size / (double)compressed.getSize() << ":1" << std::endl;
+	}
+}
 
 void streamFileTestApp::setup()
 {
 	fs::path testPath = createReadTestFile();
 	console() << "Testing IStreamFile" << std::endl;
-	readTest<IStreamFile>( testPath );
+	readTest( testPath, [&] { return IStreamFile::create( fopen( testPath.string().c_str(), "rb" ) ); } );
 	console() << "Testing IoStreamFile" << std::endl;
-	readTest<IoStreamFile>( testPath );
+	readTest( testPath, [&] { return IoStreamFile::create( fopen( testPath.string().c_str(), "rb" ) ); } );
+	console() << "Testing IStreamMem" << std::endl;
+	BufferRef testBuffer = loadFile( testPath )->getBuffer();
+	readTest( testPath, [&] { return IStreamMem::create( testBuffer->getData(), testBuffer->getSize() ); } );
+	// a small block size, so that reads often straddle blocks or bypass them
+	for( bool readAhead : { false, true } ) {
+		auto options = IStreamFileBlock::Options().blockSize( 4096 ).readAhead( readAhead );
+		console() << "Testing IStreamFileBlock" << ( readAhead ? ", read ahead" : "" ) << std::endl;
+		readTest( testPath, [&] { return IStreamFileBlock::create( testPath, options ); } );
+		seekTest( testPath, options );
+	}
+	console() << "Testing DataSourcePath" << std::endl;
+	dataSourceTest( testPath );
+	console() << "Testing block compression" << std::endl;
+	compressionTest();
+	console() << "Benchmarking DataSourcePath" << std::endl;
+	benchmarkLoadFile();
+	console() << "Benchmarking streams" << std::endl;
+	benchmarkStreams();
+	console() << "Benchmarking block compression" << std::endl;
+	benchmarkCompression();
 }
 
 CINDER_APP( streamFileTestApp, RendererGl )